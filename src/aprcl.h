@@ -23,6 +23,10 @@
 
 #define SQUARING_SPACE 70
 
+/* smallest number of residues n^i mod s for which the final division is
+   shared out between threads */
+#define APRCL_FINAL_DIVISION_THREAD_CUTOFF 1000
+
 /* Configuration struct */
 typedef struct
 {
@@ -31,6 +35,7 @@ typedef struct
     n_factor_t rs;
     fmpz_factor_t qs;
     int * qs_used;
+    int verbose;    /* if nonzero, the tests print their progress */
 } _aprcl_config;
 
 typedef _aprcl_config aprcl_config[1];
@@ -97,6 +102,8 @@ void aprcl_config_jacobi_init(aprcl_config conf, const fmpz_t n);
 
 void aprcl_config_jacobi_clear(aprcl_config conf);
 
+void aprcl_config_set_verbose(aprcl_config conf, int verbose);
+
 /*  Gauss sums primality test */
 int aprcl_is_prime_gauss(const fmpz_t n);
 
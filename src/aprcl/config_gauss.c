@@ -56,6 +56,7 @@ aprcl_config_gauss_init(aprcl_config conf, const fmpz_t n)
     n_factor(&conf->rs, conf->R, 1);
 
     conf->qs_used = NULL;  /* not used */
+    conf->verbose = 0;
 
     fmpz_clear(s2);
 }
@@ -81,6 +82,7 @@ aprcl_config_gauss_init_min_R(aprcl_config conf, const fmpz_t n, ulong R)
     n_factor(&conf->rs, conf->R, 1);
 
     conf->qs_used = NULL;  /* not used */
+    conf->verbose = 0;
 
     fmpz_clear(s2);
 }
@@ -195,6 +195,7 @@ aprcl_config_jacobi_init(aprcl_config conf, const fmpz_t n)
     n_factor(&conf->rs, conf->R, 1);
 
     conf->qs_used = (int *) flint_malloc(sizeof(int) * conf->qs->num);
+    conf->verbose = 0;
     _aprcl_config_jacobi_reduce_s2(conf, n);
 }
 
@@ -205,3 +206,9 @@ aprcl_config_jacobi_clear(aprcl_config conf)
     fmpz_factor_clear(conf->qs);
     flint_free(conf->qs_used);
 }
+
+void
+aprcl_config_set_verbose(aprcl_config conf, int verbose)
+{
+    conf->verbose = verbose;
+}
@@ -9,25 +9,39 @@
     (at your option) any later version.  See <https://www.gnu.org/licenses/>.
 */
 
+#include "thread_support.h"
 #include "fmpz.h"
 #include "aprcl.h"
 
-int
-aprcl_is_prime_final_division(const fmpz_t n, const fmpz_t s, ulong r)
+/*
+    Check the residues n^i mod s for start <= i < stop. Returns 0 if one
+    of them is a proper divisor of n, otherwise 1. Gives up once *stop_at
+    is at most i; if n^i = 1 mod s the later residues repeat the earlier
+    ones, so *stop_at is lowered to i.
+*/
+static int
+_aprcl_final_division_range(const fmpz_t n, const fmpz_t s,
+                           ulong start, ulong stop, volatile ulong * stop_at)
 {
     int result = 1;
     ulong i;
     fmpz_t npow, nmul, rem;
 
     fmpz_init(rem);
-    fmpz_init_set(npow, n);
-    fmpz_mod(npow, npow, s); /* npow = n mod s */
-    fmpz_init_set(nmul, npow);
+    fmpz_init(nmul);
+    fmpz_init(npow);
 
-    for (i = 1; i <= r; i++)
+    fmpz_mod(nmul, n, s);    /* nmul = n mod s */
+    fmpz_powm_ui(npow, nmul, start, s);
+
+    for (i = start; i < stop && i < *stop_at; i++)
     {
         if (fmpz_is_one(npow))
+        {
+            if (i < *stop_at)
+                *stop_at = i;
             break;
+        }
 
         fmpz_mod(rem, n, npow);
 
@@ -39,6 +53,7 @@ aprcl_is_prime_final_division(const fmpz_t n, const fmpz_t s, ulong r)
             {
                 /* npow | n, so n is composite */
                 result = 0;
+                *stop_at = 0;
                 break;
             }
         }
@@ -54,3 +69,57 @@ aprcl_is_prime_final_division(const fmpz_t n, const fmpz_t s, ulong r)
 
     return result;
 }
+
+typedef struct
+{
+    const fmpz * n;
+    const fmpz * s;
+    ulong r;
+    slong num;
+    volatile ulong stop_at;
+    volatile int result;
+}
+_final_division_work_struct;
+
+static void
+_final_division_worker(slong i, void * arg)
+{
+    _final_division_work_struct * w = (_final_division_work_struct *) arg;
+    ulong start, stop;
+
+    start = 1 + (w->r / w->num) * i;
+    stop = (i == w->num - 1) ? w->r + 1 : start + w->r / w->num;
+
+    /* races on stop_at only cost some extra residues */
+    if (!_aprcl_final_division_range(w->n, w->s, start, stop, &w->stop_at))
+        w->result = 0;
+}
+
+int
+aprcl_is_prime_final_division(const fmpz_t n, const fmpz_t s, ulong r)
+{
+    slong num_threads = flint_get_num_threads();
+
+    if (num_threads > 1 && r >= APRCL_FINAL_DIVISION_THREAD_CUTOFF)
+    {
+        _final_division_work_struct w[1];
+
+        w->n = n;
+        w->s = s;
+        w->r = r;
+        w->num = 4 * num_threads;
+        w->stop_at = r + 1;
+        w->result = 1;
+
+        flint_parallel_do(_final_division_worker, w, w->num, 0,
+                                                      FLINT_PARALLEL_STRIDED);
+
+        return w->result;
+    }
+    else
+    {
+        volatile ulong stop_at = r + 1;
+
+        return _aprcl_final_division_range(n, s, 1, r + 1, &stop_at);
+    }
+}
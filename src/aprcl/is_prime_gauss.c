@@ -317,6 +317,14 @@ _aprcl_is_prime_gauss(const fmpz_t n, const aprcl_config config)
                 }
             }
         }
+
+        if (config->verbose)
+        {
+            flint_printf("aprcl: %wu/%wd primes q done (q = %wu)%s\n",
+                i + 1, config->qs->num, q,
+                result == COMPOSITE ? ", composite" : "");
+            fflush(stdout);
+        }
     }
 
     /*
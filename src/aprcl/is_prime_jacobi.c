@@ -9,6 +9,8 @@
     (at your option) any later version.  See <https://www.gnu.org/licenses/>.
 */
 
+#include <stdlib.h>
+#include "thread_support.h"
 #include "fmpz.h"
 #include "fmpz_mod.h"
 #include "aprcl.h"
@@ -537,13 +539,225 @@ _aprcl_is_prime_jacobi_additional_test(const fmpz_t n, ulong p)
     return result;
 }
 
+/*
+    The checks for the pairs (p, q) with p | q - 1 and q | s are independent
+    and are shared out between threads, the most expensive (largest p^k)
+    first. A pair which shows n to be composite makes the other threads skip
+    the pairs they have not started yet.
+*/
+
+typedef struct
+{
+    ulong q;
+    ulong p;
+    ulong k;
+    int pind;
+}
+_aprcl_jacobi_pair_struct;
+
+typedef struct
+{
+    const fmpz * n;
+    const fmpz * ndec;      /* n - 1 */
+    const fmpz * ndecdiv;   /* (n - 1) / 2 */
+    ulong nmod4;
+    const _aprcl_jacobi_pair_struct * pairs;
+    slong num;
+    int * lambdas;
+    volatile int composite;
+    slong done;
+    int verbose;
+#if FLINT_USES_PTHREAD
+    pthread_mutex_t mutex;
+#endif
+}
+_aprcl_jacobi_work_struct;
+
+static int
+_aprcl_jacobi_lambda(_aprcl_jacobi_work_struct * w, int pind)
+{
+    int l;
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_lock(&w->mutex);
+#endif
+    l = w->lambdas[pind];
+#if FLINT_USES_PTHREAD
+    pthread_mutex_unlock(&w->mutex);
+#endif
+
+    return l;
+}
+
+/* check whether q^{(n - 1) / 2} = -1 mod n */
+static int
+_aprcl_jacobi_q_pow_is_minus_one(ulong q, _aprcl_jacobi_work_struct * w)
+{
+    int res;
+    fmpz_t q_pow;
+
+    fmpz_init_set_ui(q_pow, q);
+    fmpz_powm(q_pow, q_pow, w->ndecdiv, w->n);
+    res = fmpz_equal(q_pow, w->ndec);
+    fmpz_clear(q_pow);
+
+    return res;
+}
+
+/*
+    Steps (2.) and (3.) of the test for one pair (p, q). Returns -1 if n is
+    shown to be composite, 1 if the pair shows that (Lp) is satisfied and
+    0 otherwise.
+*/
+static int
+_aprcl_is_prime_jacobi_pair(_aprcl_jacobi_work_struct * w,
+                                 const _aprcl_jacobi_pair_struct * pair)
+{
+    int res = 0;
+    slong h;
+    ulong v, p, r, k, q;
+    fmpz_t u;
+    unity_zp jacobi_sum, jacobi_sum2_1, jacobi_sum2_2;
+
+    q = pair->q;
+    p = pair->p;
+    k = pair->k;
+    r = n_pow(p, k);
+
+    if (p == 2 && k == 1)
+    {
+        h = _aprcl_is_prime_jacobi_check_21(q, w->n);
+
+        /* if h not found then n is composite */
+        if (h < 0)
+            return -1;
+
+        /*
+            check (Lp);
+            if h == 1 (unity root = -1)
+            and n % 4 == 1 then lambdas_2 = 1
+        */
+        return (h == 1 && w->nmod4 == 1);
+    }
+
+    /* compute u = n / r and v = n % r */
+    fmpz_init(u);
+    fmpz_tdiv_q_ui(u, w->n, r);
+    v = fmpz_tdiv_ui(w->n, r);
+
+    /* init unity_zp for jacobi sums */
+    unity_zp_init(jacobi_sum, p, k, w->n);
+    unity_zp_init(jacobi_sum2_1, p, k, w->n);
+    unity_zp_init(jacobi_sum2_2, p, k, w->n);
+
+    /* compute set jacobi_sum = J(p, q) */
+    unity_zp_jacobi_sum_pq(jacobi_sum, q, p);
+
+    if (p == 2)
+    {
+        if (k == 2)
+        {
+            h = _aprcl_is_prime_jacobi_check_22(jacobi_sum, u, v, q);
+        }
+        else
+        {
+            /* if p == 2 and k >= 3 we also need J_2(q) and J_3(q) */
+            unity_zp_jacobi_sum_2q_one(jacobi_sum2_1, q);
+            unity_zp_jacobi_sum_2q_two(jacobi_sum2_2, q);
+
+            h = _aprcl_is_prime_jacobi_check_2k(jacobi_sum,
+                    jacobi_sum2_1, jacobi_sum2_2, u, v);
+        }
+
+        /*
+            check (Lp);
+            if h % 2 != 0 (primitive unity root)
+            and q^{(n - 1) / 2} = -1 mod n then lambdas_2 = 1
+        */
+        if (h < 0)
+            res = -1;
+        else if (h % 2 != 0 && _aprcl_jacobi_lambda(w, pair->pind) == 0)
+            res = _aprcl_jacobi_q_pow_is_minus_one(q, w);
+    }
+    else
+    {
+        h = _aprcl_is_prime_jacobi_check_pk(jacobi_sum, u, v);
+
+        /*
+            check (Lp);
+            if h % p != 0 (primitive unity root)
+            then lambdas_p = 1
+        */
+        if (h < 0)
+            res = -1;
+        else
+            res = (h % p != 0);
+    }
+
+    /* clear unity_zp for jacobi sums */
+    unity_zp_clear(jacobi_sum);
+    unity_zp_clear(jacobi_sum2_1);
+    unity_zp_clear(jacobi_sum2_2);
+    fmpz_clear(u);
+
+    return res;
+}
+
+static void
+_aprcl_jacobi_worker(slong i, void * arg)
+{
+    _aprcl_jacobi_work_struct * w = (_aprcl_jacobi_work_struct *) arg;
+    const _aprcl_jacobi_pair_struct * pair = w->pairs + i;
+    int res;
+
+    if (w->composite)
+        return;
+
+    res = _aprcl_is_prime_jacobi_pair(w, pair);
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_lock(&w->mutex);
+#endif
+
+    if (res < 0)
+        w->composite = 1;
+    else if (res > 0)
+        w->lambdas[pair->pind] = 1;
+
+    w->done++;
+
+    if (w->verbose)
+    {
+        flint_printf("aprcl: %wd/%wd pairs done (p^k = %wu^%wu, q = %wu)%s\n",
+                  w->done, w->num, pair->p, pair->k, pair->q,
+                  res < 0 ? ", composite" : "");
+        fflush(stdout);
+    }
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_unlock(&w->mutex);
+#endif
+}
+
+static int
+_aprcl_jacobi_pair_cmp(const void * a, const void * b)
+{
+    const _aprcl_jacobi_pair_struct * x = a;
+    const _aprcl_jacobi_pair_struct * y = b;
+    ulong rx = n_pow(x->p, x->k), ry = n_pow(y->p, y->k);
+
+    return (rx < ry) - (rx > ry);
+}
+
 primality_test_status
 _aprcl_is_prime_jacobi(const fmpz_t n, const aprcl_config config)
 {
     int *lambdas;
     ulong i, j, nmod4;
+    slong num;
     primality_test_status result;
-    fmpz_t temp, p2, ndec, ndecdiv, u, q_pow;
+    fmpz_t temp, p2, ndec, ndecdiv;
+    _aprcl_jacobi_pair_struct * pairs;
 
     /* deal with primes that can divide R */
     if (fmpz_cmp_ui(n, 2) == 0)
@@ -553,8 +767,6 @@ _aprcl_is_prime_jacobi(const fmpz_t n, const aprcl_config config)
        return PRIME;
 
     /* initialization */
-    fmpz_init(q_pow);
-    fmpz_init(u);
     fmpz_init(temp);
     fmpz_init(p2);
     fmpz_init(ndecdiv);
@@ -602,9 +814,16 @@ _aprcl_is_prime_jacobi(const fmpz_t n, const aprcl_config config)
     if (aprcl_is_mul_coprime_ui_fmpz(config->R, config->s, n) == 0)
         result = COMPOSITE;
 
-    /* Begin pseudoprime tests with Jacobi sums step. */
-    /* for every prime q | s */
+    /* collect the pairs (p, q) for every prime q | s and p | q - 1 */
+    num = 0;
     for (i = 0; i < config->qs->num; i++)
+        if (config->qs_used[i])
+            num += FLINT_BITS;   /* q - 1 has fewer prime factors */
+
+    pairs = flint_malloc(FLINT_MAX(num, 1) * sizeof(_aprcl_jacobi_pair_struct));
+    num = 0;
+
+    for (i = 0; i < config->qs->num && result != COMPOSITE; i++)
     {
         n_factor_t q_factors;
         ulong q;
@@ -612,9 +831,6 @@ _aprcl_is_prime_jacobi(const fmpz_t n, const aprcl_config config)
         if (config->qs_used[i] == 0)
             continue;
 
-        if (result == COMPOSITE)
-            break;
-
         q = fmpz_get_ui(config->qs->p + i); /* set q; q must get into ulong */
 
         /* if n == q; q - prime => n - prime */
@@ -631,121 +847,49 @@ _aprcl_is_prime_jacobi(const fmpz_t n, const aprcl_config config)
         /* for every prime p | q - 1 */
         for (j = 0; j < q_factors.num; j++)
         {
-            int pind;
-            slong h;
-            ulong v, p, r, k;
-            unity_zp jacobi_sum, jacobi_sum2_1, jacobi_sum2_2;
-
-            if (result == COMPOSITE)
-                break;
-
-            p = q_factors.p[j];     /* set p; p | q - 1 */
-            k = q_factors.exp[j];   /* set max k for which p^k | q - 1 */
-            r = n_pow(p, k);        /* set r = p^k */
-            pind = _aprcl_p_ind(config, p);  /* find index of p in lambdas */
-
-            /* if lambdas_p == 0 set q_pow = q^{(n - 1) / 2} and p == 2 */
-            fmpz_set_ui(q_pow, q);
-            if (lambdas[pind] == 0 && p == 2)
-                fmpz_powm(q_pow, q_pow, ndecdiv, n);
-
-            /* compute u = n / r and v = n % r */
-            fmpz_tdiv_q_ui(u, n, r);
-            v = fmpz_tdiv_ui(n, r);
-
-            /* init unity_zp for jacobi sums */
-            unity_zp_init(jacobi_sum, p, k, n);
-            unity_zp_init(jacobi_sum2_1, p, k, n);
-            unity_zp_init(jacobi_sum2_2, p, k, n);
-
-            /* compute set jacobi_sum = J(p, q) */
-            unity_zp_jacobi_sum_pq(jacobi_sum, q, p);
-            /* if p == 2 and k >= 3 we also need to compute J_2(q) and J_3(q) */
-            if (p == 2 && k >= 3)
-            {
-                /* compute J_3(q) */
-                unity_zp_jacobi_sum_2q_one(jacobi_sum2_1, q);
-                /* compute J_2(q) */
-                unity_zp_jacobi_sum_2q_two(jacobi_sum2_2, q);
-            }
-
-            if (p == 2 && k == 1)
-            {
-                h = _aprcl_is_prime_jacobi_check_21(q, n);
-
-                /* if h not found then n is composite */
-                if (h < 0)
-                    result = COMPOSITE;
-
-                /*
-                    check (Lp);
-                    if h == 1 (unity root = -1)
-                    and n % 4 == 1 then lambdas_2 = 1
-                */
-                if (lambdas[pind] == 0 && h == 1 && nmod4 == 1)
-                    lambdas[pind] = 1;
-            }
-
-            if (p == 2 && k == 2)
-            {
-                h = _aprcl_is_prime_jacobi_check_22(jacobi_sum, u, v, q);
-
-                /* if h not found then n is composite */
-                if (h < 0)
-                    result = COMPOSITE;
-
-                /*
-                    check (Lp);
-                    if h == 1 or 3 (unity root = -i or i)
-                    and q^{(n - 1) / 2} = -1 mod n then lambdas_2 = 1
-                */
-                if (h % 2 != 0 && lambdas[pind] == 0 && fmpz_equal(q_pow, ndec))
-                    lambdas[pind] = 1;
-            }
-
-            if (p == 2 && k >= 3)
-            {
-                h = _aprcl_is_prime_jacobi_check_2k(jacobi_sum,
-                        jacobi_sum2_1, jacobi_sum2_2, u, v);
-
-                /* if h not found then n is composite */
-                if (h < 0)
-                    result = COMPOSITE;
-
-                /*
-                    check (Lp);
-                    if h % 2 != 0 (primitive unity root)
-                    and q^{(n - 1) / 2} = -1 mod n then lambdas_2 = 1
-                */
-                if (h % 2 != 0 && lambdas[pind] == 0 && fmpz_equal(q_pow, ndec))
-                    lambdas[pind] = 1;
-            }
-
-            if (p != 2)
-            {
-                h = _aprcl_is_prime_jacobi_check_pk(jacobi_sum, u, v);
-
-                /* if h not found then n is composite */
-                if (h < 0)
-                    result = COMPOSITE;
-
-                /*
-                    check (Lp);
-                    if h % p != 0 (primitive unity root)
-                    then lambdas_p = 1
-                */
-                if (h % p != 0 && lambdas[pind] == 0)
-                    lambdas[pind] = 1;
-            }
-
-            /* clear unity_zp for jacobi sums */
-            unity_zp_clear(jacobi_sum);
-            unity_zp_clear(jacobi_sum2_1);
-            unity_zp_clear(jacobi_sum2_2);
+            pairs[num].q = q;
+            pairs[num].p = q_factors.p[j];     /* set p; p | q - 1 */
+            pairs[num].k = q_factors.exp[j];   /* max k for which p^k | q - 1 */
+            pairs[num].pind = _aprcl_p_ind(config, q_factors.p[j]);
+            num++;
         }
+    }
 
+    /* Begin pseudoprime tests with Jacobi sums step. */
+    if (result == PROBABPRIME && num > 0)
+    {
+        _aprcl_jacobi_work_struct w[1];
+
+        qsort(pairs, num, sizeof(_aprcl_jacobi_pair_struct),
+                                                  _aprcl_jacobi_pair_cmp);
+
+        w->n = n;
+        w->ndec = ndec;
+        w->ndecdiv = ndecdiv;
+        w->nmod4 = nmod4;
+        w->pairs = pairs;
+        w->num = num;
+        w->lambdas = lambdas;
+        w->composite = 0;
+        w->done = 0;
+        w->verbose = config->verbose;
+#if FLINT_USES_PTHREAD
+        pthread_mutex_init(&w->mutex, NULL);
+#endif
+
+        flint_parallel_do(_aprcl_jacobi_worker, w, num, 0,
+                                                     FLINT_PARALLEL_STRIDED);
+
+#if FLINT_USES_PTHREAD
+        pthread_mutex_destroy(&w->mutex);
+#endif
+
+        if (w->composite)
+            result = COMPOSITE;
     }
 
+    flint_free(pairs);
+
     /* Begin L_p tests */
 
     /* if n can be prime */
@@ -801,8 +945,6 @@ _aprcl_is_prime_jacobi(const fmpz_t n, const aprcl_config config)
 
     /* clear */
     flint_free(lambdas);
-    fmpz_clear(u);
-    fmpz_clear(q_pow);
     fmpz_clear(p2);
     fmpz_clear(ndec);
     fmpz_clear(ndecdiv);
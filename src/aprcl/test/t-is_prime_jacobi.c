@@ -232,6 +232,70 @@ int main(void)
         }
     }
 
+    /* Test the pairs (p, q) and the final division shared out between threads */
+    for (i = 0; i < 20 * flint_test_multiplier(); i++)
+    {
+        int pbprime, cycloprime, r1, r2;
+        fmpz_t n, p, s;
+        ulong R;
+
+        fmpz_init(n);
+        fmpz_init(p);
+        fmpz_init(s);
+
+        flint_set_num_threads(n_randint(state, 4) + 1);
+
+        fmpz_randprime(n, state, 100 + n_randint(state, 300), 0);
+        if (n_randint(state, 2))
+        {
+            fmpz_randprime(p, state, 20 + n_randint(state, 100), 0);
+            fmpz_mul(n, n, p);
+        }
+
+        pbprime = fmpz_is_probabprime(n);
+        cycloprime = aprcl_is_prime_jacobi(n);
+
+        if (pbprime != cycloprime)
+        {
+            flint_printf("FAIL (threads)\n");
+            flint_printf("Testing number = ");
+            fmpz_print(n);
+            flint_printf("\nis_probabprime = %i, aprcl_is_prime_jacobi = %i\n", pbprime, cycloprime);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        /* n = p * (p^j mod s), with p coprime to s, has a divisor among the residues */
+        R = 5000 + n_randint(state, 5000);
+        fmpz_randtest_unsigned(s, state, 60);
+        fmpz_add_ui(s, s, 2);
+        do {
+            fmpz_randtest_unsigned(p, state, 60);
+            fmpz_add_ui(p, p, 2);
+            fmpz_gcd(n, p, s);
+        } while (!fmpz_is_one(n));
+        fmpz_powm_ui(n, p, 1 + n_randint(state, R), s);
+        fmpz_mul(n, n, p);
+
+        r1 = aprcl_is_prime_final_division(n, s, R);
+        flint_set_num_threads(1);
+        r2 = aprcl_is_prime_final_division(n, s, R);
+
+        if (r1 != r2)
+        {
+            flint_printf("FAIL (final division)\n");
+            flint_printf("n = "); fmpz_print(n);
+            flint_printf("\ns = "); fmpz_print(s);
+            flint_printf("\nR = %wu, r1 = %i, r2 = %i\n", R, r1, r2);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        fmpz_clear(n);
+        fmpz_clear(p);
+        fmpz_clear(s);
+    }
+
     FLINT_TEST_CLEANUP(state);
 
     flint_printf("PASS\n");
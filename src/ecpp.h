@@ -0,0 +1,82 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef ECPP_H
+#define ECPP_H
+
+#include "fmpz_types.h"
+#include "fmpz_mod_types.h"
+
+#ifdef __cplusplus
+ extern "C" {
+#endif
+
+/*
+    One step of a certificate: the curve y^2 = x^3 + a*x + b modulo N with
+    the point P = (x, y), such that [m]P = O, [m/q]P != O and
+    q > (N^(1/4) + 1)^2. If q is prime, so is N.
+*/
+typedef struct
+{
+    fmpz_t N;
+    fmpz_t a;
+    fmpz_t b;
+    fmpz_t m;
+    fmpz_t q;
+    fmpz_t x;
+    fmpz_t y;
+} ecpp_step_struct;
+
+/*
+    A certificate for n is a chain of steps with steps[0].N = n and
+    steps[i + 1].N = steps[i].q, the last q being a single limb prime.
+*/
+typedef struct
+{
+    ecpp_step_struct * steps;
+    slong length;
+    slong alloc;
+} ecpp_cert_struct;
+
+typedef ecpp_cert_struct ecpp_cert_t[1];
+
+/* Memory management */
+void ecpp_cert_init(ecpp_cert_t cert);
+
+void ecpp_cert_clear(ecpp_cert_t cert);
+
+void ecpp_cert_fit_length(ecpp_cert_t cert, slong len);
+
+/* Output */
+void ecpp_cert_print(const ecpp_cert_t cert);
+
+/* Elliptic curve arithmetic */
+void _ecpp_ec_mul(fmpz_t X, fmpz_t Y, fmpz_t Z, const fmpz_t x,
+              const fmpz_t y, const fmpz_t e, const fmpz_t a,
+                                                  const fmpz_mod_ctx_t ctx);
+
+/* Verification */
+int _ecpp_q_is_large_enough(const fmpz_t q, const fmpz_t N);
+
+int ecpp_step_verify(const ecpp_step_struct * step);
+
+int ecpp_cert_verify(const ecpp_cert_t cert, const fmpz_t n);
+
+/* Proving */
+int ecpp_prove(ecpp_cert_t cert, const fmpz_t n);
+
+int ecpp_is_prime(const fmpz_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
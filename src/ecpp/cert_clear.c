@@ -0,0 +1,32 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "fmpz.h"
+#include "ecpp.h"
+
+void
+ecpp_cert_clear(ecpp_cert_t cert)
+{
+    slong i;
+
+    for (i = 0; i < cert->alloc; i++)
+    {
+        fmpz_clear(cert->steps[i].N);
+        fmpz_clear(cert->steps[i].a);
+        fmpz_clear(cert->steps[i].b);
+        fmpz_clear(cert->steps[i].m);
+        fmpz_clear(cert->steps[i].q);
+        fmpz_clear(cert->steps[i].x);
+        fmpz_clear(cert->steps[i].y);
+    }
+
+    flint_free(cert->steps);
+}
@@ -0,0 +1,40 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "fmpz.h"
+#include "ecpp.h"
+
+void
+ecpp_cert_fit_length(ecpp_cert_t cert, slong len)
+{
+    slong i;
+
+    if (len > cert->alloc)
+    {
+        if (len < 2 * cert->alloc)
+            len = 2 * cert->alloc;
+
+        cert->steps = flint_realloc(cert->steps, len * sizeof(ecpp_step_struct));
+
+        for (i = cert->alloc; i < len; i++)
+        {
+            fmpz_init(cert->steps[i].N);
+            fmpz_init(cert->steps[i].a);
+            fmpz_init(cert->steps[i].b);
+            fmpz_init(cert->steps[i].m);
+            fmpz_init(cert->steps[i].q);
+            fmpz_init(cert->steps[i].x);
+            fmpz_init(cert->steps[i].y);
+        }
+
+        cert->alloc = len;
+    }
+}
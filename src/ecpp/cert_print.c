@@ -0,0 +1,32 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "fmpz.h"
+#include "ecpp.h"
+
+void
+ecpp_cert_print(const ecpp_cert_t cert)
+{
+    slong i;
+
+    for (i = 0; i < cert->length; i++)
+    {
+        const ecpp_step_struct * S = cert->steps + i;
+
+        flint_printf("N[%wd] = ", i); fmpz_print(S->N); flint_printf("\n");
+        flint_printf("a = "); fmpz_print(S->a); flint_printf("\n");
+        flint_printf("b = "); fmpz_print(S->b); flint_printf("\n");
+        flint_printf("m = "); fmpz_print(S->m); flint_printf("\n");
+        flint_printf("q = "); fmpz_print(S->q); flint_printf("\n");
+        flint_printf("P = ("); fmpz_print(S->x); flint_printf(", ");
+        fmpz_print(S->y); flint_printf(")\n");
+    }
+}
@@ -0,0 +1,72 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "ulong_extras.h"
+#include "thread_support.h"
+#include "fmpz.h"
+#include "ecpp.h"
+
+typedef struct
+{
+    const ecpp_step_struct * steps;
+    volatile int res;
+}
+_ecpp_verify_work_struct;
+
+static void
+_ecpp_verify_worker(slong i, void * arg)
+{
+    _ecpp_verify_work_struct * w = (_ecpp_verify_work_struct *) arg;
+
+    /* another step has already failed */
+    if (!w->res)
+        return;
+
+    if (!ecpp_step_verify(w->steps + i))
+        w->res = 0;
+}
+
+int
+ecpp_cert_verify(const ecpp_cert_t cert, const fmpz_t n)
+{
+    const fmpz * q;
+    slong i;
+    _ecpp_verify_work_struct w[1];
+
+    /* the chain links n to a single limb prime */
+    if (cert->length == 0)
+    {
+        q = n;
+    }
+    else
+    {
+        if (!fmpz_equal(cert->steps[0].N, n))
+            return 0;
+
+        for (i = 1; i < cert->length; i++)
+            if (!fmpz_equal(cert->steps[i].N, cert->steps[i - 1].q))
+                return 0;
+
+        q = cert->steps[cert->length - 1].q;
+    }
+
+    if (fmpz_sgn(q) <= 0 || !fmpz_abs_fits_ui(q) || !n_is_prime(fmpz_get_ui(q)))
+        return 0;
+
+    /* the steps are independent */
+    w->steps = cert->steps;
+    w->res = 1;
+
+    flint_parallel_do(_ecpp_verify_worker, w, cert->length, 0,
+                                                     FLINT_PARALLEL_DYNAMIC);
+
+    return w->res;
+}
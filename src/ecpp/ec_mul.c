@@ -0,0 +1,139 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "fmpz.h"
+#include "fmpz_mod.h"
+#include "ecpp.h"
+
+/*
+    Arithmetic on y^2 = x^3 + a*x + b in Jacobian coordinates, where (X:Y:Z)
+    stands for (X/Z^2, Y/Z^3), modulo N which need not be prime.
+
+    No case distinctions are made. Modulo any prime p | N the formulas give
+    the correct result, except that adding a point to itself or to O gives
+    (0:0:0). Since (0:0:0) is mapped to itself by both formulas, a result
+    with Z or Y coprime to N was computed correctly modulo every p | N. This
+    is what makes the checks in ecpp_step_verify sound.
+*/
+
+/* (X, Y, Z) = 2(X, Y, Z) */
+static void
+_ecpp_ec_dbl(fmpz_t X, fmpz_t Y, fmpz_t Z, const fmpz_t a,
+                                         fmpz * t, const fmpz_mod_ctx_t ctx)
+{
+    fmpz * XX = t + 0, * YY = t + 1, * ZZ = t + 2, * S = t + 3, * M = t + 4;
+
+    fmpz_mod_mul(XX, X, X, ctx);
+    fmpz_mod_mul(YY, Y, Y, ctx);
+    fmpz_mod_mul(ZZ, Z, Z, ctx);
+
+    /* Z = 2*Y*Z */
+    fmpz_mod_mul(Z, Y, Z, ctx);
+    fmpz_mod_add(Z, Z, Z, ctx);
+
+    /* S = 4*X*Y^2 */
+    fmpz_mod_mul(S, X, YY, ctx);
+    fmpz_mod_add(S, S, S, ctx);
+    fmpz_mod_add(S, S, S, ctx);
+
+    /* M = 3*X^2 + a*Z^4 */
+    fmpz_mod_mul(ZZ, ZZ, ZZ, ctx);
+    fmpz_mod_mul(M, a, ZZ, ctx);
+    fmpz_mod_add(M, M, XX, ctx);
+    fmpz_mod_add(M, M, XX, ctx);
+    fmpz_mod_add(M, M, XX, ctx);
+
+    /* X = M^2 - 2*S */
+    fmpz_mod_mul(X, M, M, ctx);
+    fmpz_mod_sub(X, X, S, ctx);
+    fmpz_mod_sub(X, X, S, ctx);
+
+    /* Y = M*(S - X) - 8*Y^4 */
+    fmpz_mod_mul(YY, YY, YY, ctx);
+    fmpz_mod_add(YY, YY, YY, ctx);
+    fmpz_mod_add(YY, YY, YY, ctx);
+    fmpz_mod_add(YY, YY, YY, ctx);
+    fmpz_mod_sub(S, S, X, ctx);
+    fmpz_mod_mul(Y, M, S, ctx);
+    fmpz_mod_sub(Y, Y, YY, ctx);
+}
+
+/* (X, Y, Z) = (X, Y, Z) + (x, y, 1) */
+static void
+_ecpp_ec_add_affine(fmpz_t X, fmpz_t Y, fmpz_t Z, const fmpz_t x,
+                        const fmpz_t y, fmpz * t, const fmpz_mod_ctx_t ctx)
+{
+    fmpz * ZZ = t + 0, * H = t + 1, * r = t + 2, * HH = t + 3, * V = t + 4;
+
+    /* H = x*Z^2 - X, r = y*Z^3 - Y */
+    fmpz_mod_mul(ZZ, Z, Z, ctx);
+    fmpz_mod_mul(H, x, ZZ, ctx);
+    fmpz_mod_sub(H, H, X, ctx);
+    fmpz_mod_mul(r, ZZ, Z, ctx);
+    fmpz_mod_mul(r, r, y, ctx);
+    fmpz_mod_sub(r, r, Y, ctx);
+
+    /* Z = Z*H */
+    fmpz_mod_mul(Z, Z, H, ctx);
+
+    /* V = X*H^2, HH = H^3 */
+    fmpz_mod_mul(HH, H, H, ctx);
+    fmpz_mod_mul(V, X, HH, ctx);
+    fmpz_mod_mul(HH, HH, H, ctx);
+
+    /* X = r^2 - H^3 - 2*V */
+    fmpz_mod_mul(X, r, r, ctx);
+    fmpz_mod_sub(X, X, HH, ctx);
+    fmpz_mod_sub(X, X, V, ctx);
+    fmpz_mod_sub(X, X, V, ctx);
+
+    /* Y = r*(V - X) - Y*H^3 */
+    fmpz_mod_mul(HH, HH, Y, ctx);
+    fmpz_mod_sub(V, V, X, ctx);
+    fmpz_mod_mul(Y, r, V, ctx);
+    fmpz_mod_sub(Y, Y, HH, ctx);
+}
+
+void
+_ecpp_ec_mul(fmpz_t X, fmpz_t Y, fmpz_t Z, const fmpz_t x,
+              const fmpz_t y, const fmpz_t e, const fmpz_t a,
+                                                   const fmpz_mod_ctx_t ctx)
+{
+    slong i;
+    fmpz t[5];
+
+    if (fmpz_sgn(e) <= 0)
+    {
+        /* O = (1:1:0) */
+        fmpz_one(X);
+        fmpz_one(Y);
+        fmpz_zero(Z);
+        return;
+    }
+
+    for (i = 0; i < 5; i++)
+        fmpz_init(t + i);
+
+    fmpz_set(X, x);
+    fmpz_set(Y, y);
+    fmpz_one(Z);
+
+    for (i = fmpz_bits(e) - 2; i >= 0; i--)
+    {
+        _ecpp_ec_dbl(X, Y, Z, a, t, ctx);
+
+        if (fmpz_tstbit(e, i))
+            _ecpp_ec_add_affine(X, Y, Z, x, y, t, ctx);
+    }
+
+    for (i = 0; i < 5; i++)
+        fmpz_clear(t + i);
+}
@@ -0,0 +1,31 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "fmpz.h"
+#include "aprcl.h"
+#include "ecpp.h"
+
+int
+ecpp_is_prime(const fmpz_t n)
+{
+    ecpp_cert_t cert;
+    int res;
+
+    ecpp_cert_init(cert);
+    res = ecpp_prove(cert, n);
+    ecpp_cert_clear(cert);
+
+    /* no curve was found, fall back to a proof not needing one */
+    if (res < 0)
+        res = aprcl_is_prime(n);
+
+    return res;
+}
@@ -0,0 +1,528 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "fmpz_poly.h"
+#include "fmpz_mod.h"
+#include "fmpz_mod_poly.h"
+#include "fmpz_mod_poly_factor.h"
+#include "fmpz_factor.h"
+#include "qfb.h"
+#include "acb_modular.h"
+#include "ecpp.h"
+
+/*
+    The Atkin-Morain method. For a probable prime N we look for a
+    fundamental discriminant D < 0 such that 4N = u^2 - D*v^2. The curves
+    with complex multiplication by the order of discriminant D then have
+    m = N + 1 - u or N + 1 + u points. If m = k*q with q a probable prime
+    larger than (N^(1/4) + 1)^2, such a curve is built from a root modulo N
+    of the Hilbert class polynomial H_D, and a point on it gives a step of
+    the certificate. We continue with N = q.
+
+    The discriminants are tried in order of increasing class number, and
+    the small factors of the candidate orders of a batch of discriminants
+    are removed at once by fmpz_factor_smooth_vec.
+*/
+
+/* number of discriminants whose candidate orders are batched */
+#define ECPP_DISC_BATCH 32
+
+/* initial bound on |D| and on the class number */
+#define ECPP_DMAX_INIT 1000
+#define ECPP_HMAX_INIT 10
+
+/* give up once |D| would exceed this */
+#define ECPP_DMAX_LIMIT (WORD(1) << 22)
+
+/* random points tried on each twist */
+#define ECPP_POINT_TRIES 8
+
+/* curves and bounds used to look for a medium sized factor of a cofactor */
+#define ECPP_ECM_CURVES 2
+#define ECPP_ECM_B1 300
+#define ECPP_ECM_B2 30000
+
+typedef struct
+{
+    slong D;
+    slong h;
+    int have_H;
+    fmpz_poly_t H;
+}
+_ecpp_disc_struct;
+
+typedef struct
+{
+    _ecpp_disc_struct * discs;
+    slong num;
+    slong alloc;
+    slong Dmax;
+    slong hmax;
+    flint_rand_t state;
+}
+_ecpp_state_struct;
+
+static int
+_ecpp_disc_cmp(const void * a, const void * b)
+{
+    const _ecpp_disc_struct * x = a;
+    const _ecpp_disc_struct * y = b;
+
+    if (x->h != y->h)
+        return (x->h > y->h) - (x->h < y->h);
+
+    return (x->D < y->D) - (x->D > y->D);
+}
+
+/* fundamental discriminants D < -4 */
+static int
+_ecpp_is_fundamental(slong d)
+{
+    if (d % 4 == 3)
+        return n_is_squarefree(d);
+
+    if (d % 4 == 0 && ((d/4) % 4 == 1 || (d/4) % 4 == 2))
+        return n_is_squarefree(d/4);
+
+    return 0;
+}
+
+/*
+    Append the fundamental discriminants with |D| <= Dmax and class number
+    at most hmax which are not yet in the list.
+*/
+static void
+_ecpp_discs_extend(_ecpp_state_struct * S, slong Dmax, slong hmax)
+{
+    slong d, h, start = S->num;
+    qfb * forms;
+
+    for (d = 5; d <= Dmax; d++)
+    {
+        if (!_ecpp_is_fundamental(d))
+            continue;
+
+        h = qfb_reduced_forms(&forms, -d);
+        qfb_array_clear(&forms, h);
+
+        if (h > hmax || (d <= S->Dmax && h <= S->hmax))
+            continue;
+
+        if (S->num == S->alloc)
+        {
+            S->alloc = FLINT_MAX(2*S->alloc, 64);
+            S->discs = flint_realloc(S->discs,
+                                      S->alloc * sizeof(_ecpp_disc_struct));
+        }
+
+        S->discs[S->num].D = -d;
+        S->discs[S->num].h = h;
+        S->discs[S->num].have_H = 0;
+        S->num++;
+    }
+
+    qsort(S->discs + start, S->num - start, sizeof(_ecpp_disc_struct),
+                                                          _ecpp_disc_cmp);
+
+    S->Dmax = Dmax;
+    S->hmax = hmax;
+}
+
+/*
+    Solve u^2 + |D|*v^2 = 4N for u, with N a probable prime, by the
+    modified Cornacchia algorithm (Cohen, Algorithm 1.5.3).
+*/
+static int
+_ecpp_cornacchia(fmpz_t u, const fmpz_t N, slong D)
+{
+    fmpz_t a, b, c, l;
+    int res = 0;
+
+    fmpz_init(a);
+    fmpz_init(b);
+    fmpz_init(c);
+    fmpz_init(l);
+
+    fmpz_set_si(c, D);
+    fmpz_mod(c, c, N);
+
+    if (!fmpz_sqrtmod(b, c, N))
+        goto cleanup;
+
+    /* b = D mod 2 */
+    if (fmpz_is_odd(b) != (D % 2 != 0))
+        fmpz_sub(b, N, b);
+
+    fmpz_mul_2exp(a, N, 1);
+    fmpz_mul_2exp(c, N, 2);
+    fmpz_sqrt(l, c);
+
+    while (fmpz_cmp(b, l) > 0)
+    {
+        fmpz_mod(a, a, b);
+        fmpz_swap(a, b);
+    }
+
+    /* c = (4N - b^2)/|D| must be a square */
+    fmpz_submul(c, b, b);
+
+    if (fmpz_fdiv_ui(c, -D) == 0)
+    {
+        fmpz_divexact_ui(c, c, -D);
+
+        if (fmpz_is_square(c))
+        {
+            fmpz_set(u, b);
+            res = 1;
+        }
+    }
+
+cleanup:
+
+    fmpz_clear(a);
+    fmpz_clear(b);
+    fmpz_clear(c);
+    fmpz_clear(l);
+
+    return res;
+}
+
+/*
+    Given a curve order m = k*q for discriminant D, find a curve and a point
+    which complete the step.
+*/
+static int
+_ecpp_make_curve(ecpp_step_struct * step, _ecpp_disc_struct * disc,
+                         const fmpz_t m, const fmpz_t q, flint_rand_t state)
+{
+    fmpz_mod_ctx_t ctx;
+    fmpz_mod_poly_t H;
+    fmpz_mod_poly_factor_t roots;
+    fmpz_t j, k, c, t, X, Y, Z;
+    slong i, tries;
+    int twist, res = 0;
+
+    if (!disc->have_H)
+    {
+        fmpz_poly_init(disc->H);
+        acb_modular_hilbert_class_poly(disc->H, disc->D);
+        disc->have_H = 1;
+    }
+
+    fmpz_mod_ctx_init(ctx, step->N);
+    fmpz_mod_poly_init(H, ctx);
+    fmpz_mod_poly_factor_init(roots, ctx);
+    fmpz_init(j);
+    fmpz_init(k);
+    fmpz_init(c);
+    fmpz_init(t);
+    fmpz_init(X);
+    fmpz_init(Y);
+    fmpz_init(Z);
+
+    fmpz_set(step->m, m);
+    fmpz_set(step->q, q);
+
+    fmpz_mod_poly_set_fmpz_poly(H, disc->H, ctx);
+    fmpz_mod_poly_roots(roots, H, 0, ctx);
+
+    /* a root j != 1728 gives the curve y^2 = x^3 + 3k*x + 2k, k = j/(1728 - j) */
+    for (i = 0; i < roots->num; i++)
+    {
+        fmpz_mod_poly_get_coeff_fmpz(j, roots->poly + i, 0, ctx);
+        fmpz_mod_neg(j, j, ctx);
+
+        fmpz_set_ui(t, 1728);
+        fmpz_mod_sub(t, t, j, ctx);
+
+        if (!fmpz_is_zero(j) && fmpz_invmod(t, t, step->N))
+            break;
+    }
+
+    if (i == roots->num)
+        goto cleanup;
+
+    fmpz_mod_mul(k, j, t, ctx);
+    fmpz_mod_mul_ui(step->a, k, 3, ctx);
+    fmpz_mod_mul_ui(step->b, k, 2, ctx);
+
+    /* c is a quadratic nonresidue, used to move to the twist */
+    do {
+        fmpz_randm(c, state, step->N);
+    } while (fmpz_jacobi(c, step->N) != -1);
+
+    /* the curve has m points or its twist has */
+    for (twist = 0; twist < 2 && !res; twist++)
+    {
+        if (twist)
+        {
+            fmpz_mod_mul(t, c, c, ctx);
+            fmpz_mod_mul(step->a, step->a, t, ctx);
+            fmpz_mod_mul(t, t, c, ctx);
+            fmpz_mod_mul(step->b, step->b, t, ctx);
+        }
+
+        for (tries = 0; tries < ECPP_POINT_TRIES; tries++)
+        {
+            /* random point P */
+            fmpz_randm(step->x, state, step->N);
+            fmpz_mod_mul(t, step->x, step->x, ctx);
+            fmpz_mod_add(t, t, step->a, ctx);
+            fmpz_mod_mul(t, t, step->x, ctx);
+            fmpz_mod_add(t, t, step->b, ctx);
+
+            if (fmpz_jacobi(t, step->N) != 1 || !fmpz_sqrtmod(step->y, t, step->N))
+                continue;
+
+            /* try another point if [m/q]P = O */
+            fmpz_divexact(t, m, q);
+            _ecpp_ec_mul(X, Y, Z, step->x, step->y, t, step->a, ctx);
+            fmpz_gcd(t, Z, step->N);
+
+            if (!fmpz_is_one(t))
+                continue;
+
+            /* otherwise P proves the step unless we have the wrong twist */
+            res = ecpp_step_verify(step);
+            break;
+        }
+    }
+
+cleanup:
+
+    fmpz_mod_poly_factor_clear(roots, ctx);
+    fmpz_mod_poly_clear(H, ctx);
+    fmpz_mod_ctx_clear(ctx);
+    fmpz_clear(j);
+    fmpz_clear(k);
+    fmpz_clear(c);
+    fmpz_clear(t);
+    fmpz_clear(X);
+    fmpz_clear(Y);
+    fmpz_clear(Z);
+
+    return res;
+}
+
+/* try a batch of candidate orders, returns 1 if the step is complete */
+static int
+_ecpp_try_orders(ecpp_step_struct * step, _ecpp_state_struct * S,
+                    const fmpz * m, const slong * didx, slong num, ulong B)
+{
+    fmpz * q;
+    fmpz_t f, g;
+    slong i, l, * perm;
+    int * prp;
+    int res = 0;
+
+    q = _fmpz_vec_init(num);
+    perm = flint_malloc(num * sizeof(slong));
+    prp = flint_malloc(num * sizeof(int));
+    fmpz_init(f);
+    fmpz_init(g);
+
+    /* q = m with the B-smooth part removed */
+    fmpz_factor_smooth_vec(q, m, num, B);
+    for (i = 0; i < num; i++)
+    {
+        fmpz_divexact(q + i, m + i, q + i);
+        perm[i] = i;
+        prp[i] = 0;
+    }
+
+    /* try the smallest q first, which give the shortest certificates */
+    for (i = 1; i < num; i++)
+    {
+        slong p = perm[i];
+
+        for (l = i; l > 0 && fmpz_cmp(q + perm[l - 1], q + p) > 0; l--)
+            perm[l] = perm[l - 1];
+
+        perm[l] = p;
+    }
+
+    for (l = 0; l < num && !res; l++)
+    {
+        i = perm[l];
+
+        if (!_ecpp_q_is_large_enough(q + i, step->N))
+            continue;
+
+        prp[i] = fmpz_is_probabprime(q + i);
+
+        if (prp[i])
+            res = _ecpp_make_curve(step, S->discs + didx[i], m + i, q + i,
+                                                                   S->state);
+    }
+
+    /* look for a medium sized factor of the cofactors */
+    for (l = 0; l < num && !res; l++)
+    {
+        i = perm[l];
+
+        if (prp[i] || !_ecpp_q_is_large_enough(q + i, step->N))
+            continue;
+
+        if (!fmpz_factor_ecm(f, ECPP_ECM_CURVES, ECPP_ECM_B1, ECPP_ECM_B2,
+                                                          S->state, q + i))
+            continue;
+
+        fmpz_divexact(g, q + i, f);
+        if (fmpz_cmp(f, g) > 0)
+            fmpz_swap(f, g);
+
+        /* f <= g, try the smaller one first */
+        if (_ecpp_q_is_large_enough(f, step->N) && fmpz_is_probabprime(f))
+            res = _ecpp_make_curve(step, S->discs + didx[i], m + i, f,
+                                                                   S->state);
+
+        if (!res && _ecpp_q_is_large_enough(g, step->N) &&
+                                                  fmpz_is_probabprime(g))
+            res = _ecpp_make_curve(step, S->discs + didx[i], m + i, g,
+                                                                   S->state);
+    }
+
+    _fmpz_vec_clear(q, num);
+    flint_free(perm);
+    flint_free(prp);
+    fmpz_clear(f);
+    fmpz_clear(g);
+
+    return res;
+}
+
+/* find a step for step->N, returns 1 on success */
+static int
+_ecpp_step(ecpp_step_struct * step, _ecpp_state_struct * S)
+{
+    fmpz * m;
+    fmpz_t u;
+    slong i, num, * didx;
+    flint_bitcnt_t bits;
+    ulong B;
+    int res = 0;
+
+    m = _fmpz_vec_init(2*ECPP_DISC_BATCH);
+    didx = flint_malloc(2*ECPP_DISC_BATCH*sizeof(slong));
+    fmpz_init(u);
+
+    bits = fmpz_bits(step->N);
+    B = FLINT_MIN(FLINT_MAX(bits*bits, 1000), UWORD(1) << 20);
+
+    i = 0;
+
+    while (!res)
+    {
+        /* more discriminants */
+        if (i == S->num)
+        {
+            if (2*S->Dmax > ECPP_DMAX_LIMIT)
+                break;
+
+            _ecpp_discs_extend(S, 2*S->Dmax, S->hmax + ECPP_HMAX_INIT);
+            continue;
+        }
+
+        /* candidate orders N + 1 -+ u for a batch of discriminants */
+        for (num = 0; i < S->num && num < 2*ECPP_DISC_BATCH; i++)
+        {
+            slong D = S->discs[i].D;
+
+            fmpz_set_si(u, D);
+            fmpz_mod(u, u, step->N);
+            if (fmpz_jacobi(u, step->N) != 1 || !_ecpp_cornacchia(u, step->N, D))
+                continue;
+
+            fmpz_add_ui(m + num, step->N, 1);
+            fmpz_sub(m + num, m + num, u);
+            didx[num++] = i;
+
+            fmpz_add_ui(m + num, step->N, 1);
+            fmpz_add(m + num, m + num, u);
+            didx[num++] = i;
+        }
+
+        if (num > 0)
+            res = _ecpp_try_orders(step, S, m, didx, num, B);
+    }
+
+    _fmpz_vec_clear(m, 2*ECPP_DISC_BATCH);
+    flint_free(didx);
+    fmpz_clear(u);
+
+    return res;
+}
+
+int
+ecpp_prove(ecpp_cert_t cert, const fmpz_t n)
+{
+    _ecpp_state_struct S[1];
+    fmpz_t N;
+    slong i;
+    int res = 1;
+
+    cert->length = 0;
+
+    if (fmpz_cmp_ui(n, 1) <= 0)
+        return 0;
+
+    if (fmpz_abs_fits_ui(n))
+        return n_is_prime(fmpz_get_ui(n));
+
+    if (!fmpz_is_probabprime(n))
+        return 0;
+
+    S->discs = NULL;
+    S->num = 0;
+    S->alloc = 0;
+    S->Dmax = 0;
+    S->hmax = 0;
+    flint_randinit(S->state);
+    _ecpp_discs_extend(S, ECPP_DMAX_INIT, ECPP_HMAX_INIT);
+
+    fmpz_init_set(N, n);
+
+    while (!fmpz_abs_fits_ui(N))
+    {
+        ecpp_step_struct * step;
+
+        ecpp_cert_fit_length(cert, cert->length + 1);
+        step = cert->steps + cert->length;
+        fmpz_set(step->N, N);
+
+        if (!_ecpp_step(step, S))
+        {
+            res = -1;
+            break;
+        }
+
+        cert->length++;
+        fmpz_set(N, step->q);
+    }
+
+    /* q was a probable prime, and probable primes of one limb are prime */
+    if (res == 1 && !n_is_prime(fmpz_get_ui(N)))
+        res = -1;
+
+    for (i = 0; i < S->num; i++)
+        if (S->discs[i].have_H)
+            fmpz_poly_clear(S->discs[i].H);
+
+    flint_free(S->discs);
+    flint_randclear(S->state);
+    fmpz_clear(N);
+
+    return res;
+}
@@ -0,0 +1,137 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "fmpz_mod.h"
+#include "ecpp.h"
+
+/*
+    Sufficient condition for q > (N^(1/4) + 1)^2: with s = floor(sqrt(q)),
+    (s - 1)^4 > N.
+*/
+int
+_ecpp_q_is_large_enough(const fmpz_t q, const fmpz_t N)
+{
+    fmpz_t s;
+    int res;
+
+    fmpz_init(s);
+    fmpz_sqrt(s, q);
+    fmpz_sub_ui(s, s, 1);
+
+    if (fmpz_sgn(s) <= 0)
+    {
+        res = 0;
+    }
+    else
+    {
+        fmpz_pow_ui(s, s, 4);
+        res = (fmpz_cmp(s, N) > 0);
+    }
+
+    fmpz_clear(s);
+
+    return res;
+}
+
+/*
+    Checks the conditions of the theorem of Goldwasser, Kilian, Atkin and
+    Morain: if they hold and q is prime, any prime p | N has
+    q <= #E(F_p) <= (p^(1/2) + 1)^2, so that p > N^(1/2) and N is prime.
+*/
+int
+ecpp_step_verify(const ecpp_step_struct * step)
+{
+    fmpz_mod_ctx_t ctx;
+    fmpz_t t, u, X, Y, Z, x, y;
+    int res = 0;
+
+    /* N > 1 coprime to 6, and a, b, x, y reduced modulo N */
+    if (fmpz_cmp_ui(step->N, 5) < 0 || n_gcd(fmpz_fdiv_ui(step->N, 6), 6) != 1)
+        return 0;
+
+    if (fmpz_sgn(step->a) < 0 || fmpz_cmp(step->a, step->N) >= 0 ||
+        fmpz_sgn(step->b) < 0 || fmpz_cmp(step->b, step->N) >= 0 ||
+        fmpz_sgn(step->x) < 0 || fmpz_cmp(step->x, step->N) >= 0 ||
+        fmpz_sgn(step->y) < 0 || fmpz_cmp(step->y, step->N) >= 0)
+        return 0;
+
+    /* q | m and q > (N^(1/4) + 1)^2 */
+    if (fmpz_sgn(step->m) <= 0 || fmpz_sgn(step->q) <= 0 ||
+        !fmpz_divisible(step->m, step->q) ||
+        !_ecpp_q_is_large_enough(step->q, step->N))
+        return 0;
+
+    fmpz_mod_ctx_init(ctx, step->N);
+    fmpz_init(t);
+    fmpz_init(u);
+    fmpz_init(X);
+    fmpz_init(Y);
+    fmpz_init(Z);
+    fmpz_init(x);
+    fmpz_init(y);
+
+    /* the curve is nonsingular modulo every p | N */
+    fmpz_mod_mul(t, step->a, step->a, ctx);
+    fmpz_mod_mul(t, t, step->a, ctx);
+    fmpz_mod_mul_ui(t, t, 4, ctx);
+    fmpz_mod_mul(u, step->b, step->b, ctx);
+    fmpz_mod_mul_ui(u, u, 27, ctx);
+    fmpz_mod_add(t, t, u, ctx);
+    fmpz_gcd(t, t, step->N);
+
+    if (!fmpz_is_one(t))
+        goto cleanup;
+
+    /* P is on the curve */
+    fmpz_mod_mul(t, step->x, step->x, ctx);
+    fmpz_mod_add(t, t, step->a, ctx);
+    fmpz_mod_mul(t, t, step->x, ctx);
+    fmpz_mod_add(t, t, step->b, ctx);
+    fmpz_mod_mul(u, step->y, step->y, ctx);
+
+    if (!fmpz_equal(t, u))
+        goto cleanup;
+
+    /* Q = [m/q]P != O modulo every p | N */
+    fmpz_divexact(t, step->m, step->q);
+    _ecpp_ec_mul(X, Y, Z, step->x, step->y, t, step->a, ctx);
+
+    fmpz_gcd(t, Z, step->N);
+    if (!fmpz_is_one(t))
+        goto cleanup;
+
+    /* [q]Q = O modulo every p | N */
+    fmpz_invmod(u, Z, step->N);
+    fmpz_mod_mul(t, u, u, ctx);
+    fmpz_mod_mul(x, X, t, ctx);
+    fmpz_mod_mul(t, t, u, ctx);
+    fmpz_mod_mul(y, Y, t, ctx);
+
+    _ecpp_ec_mul(X, Y, Z, x, y, step->q, step->a, ctx);
+
+    fmpz_gcd(t, Y, step->N);
+    res = fmpz_is_zero(Z) && fmpz_is_one(t);
+
+cleanup:
+
+    fmpz_mod_ctx_clear(ctx);
+    fmpz_clear(t);
+    fmpz_clear(u);
+    fmpz_clear(X);
+    fmpz_clear(Y);
+    fmpz_clear(Z);
+    fmpz_clear(x);
+    fmpz_clear(y);
+
+    return res;
+}
@@ -0,0 +1,95 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "fmpz.h"
+#include "ecpp.h"
+
+int main(void)
+{
+    slong iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("cert_verify....");
+    fflush(stdout);
+
+    /* altered certificates are rejected */
+    for (iter = 0; iter < 10 * flint_test_multiplier(); iter++)
+    {
+        ecpp_cert_t cert;
+        ecpp_step_struct * S;
+        fmpz_t n;
+        slong i;
+        int which;
+
+        ecpp_cert_init(cert);
+        fmpz_init(n);
+
+        fmpz_randprime(n, state, 80 + n_randint(state, 120), 0);
+
+        if (ecpp_prove(cert, n) != 1 || cert->length == 0 ||
+            !ecpp_cert_verify(cert, n))
+        {
+            flint_printf("FAIL (prove):\n");
+            flint_printf("n = "); fmpz_print(n); flint_printf("\n");
+            fflush(stdout);
+            flint_abort();
+        }
+
+        i = n_randint(state, cert->length);
+        S = cert->steps + i;
+        which = n_randint(state, 5);
+
+        if (which == 0)
+        {
+            /* the point is no longer on the curve */
+            fmpz_add_ui(S->y, S->y, 1);
+            fmpz_mod(S->y, S->y, S->N);
+        }
+        else if (which == 1)
+        {
+            /* a wrong order */
+            fmpz_add(S->m, S->m, S->q);
+        }
+        else if (which == 2)
+        {
+            /* q too small */
+            fmpz_set(S->m, S->q);
+            fmpz_one(S->q);
+        }
+        else if (which == 3)
+        {
+            /* broken chain */
+            fmpz_add_ui(S->N, S->N, 2);
+        }
+        else
+        {
+            /* certificate for another number */
+            fmpz_add_ui(n, n, 2);
+        }
+
+        if (ecpp_cert_verify(cert, n))
+        {
+            flint_printf("FAIL (altered, %d):\n", which);
+            flint_printf("n = "); fmpz_print(n); flint_printf("\n");
+            ecpp_cert_print(cert);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        ecpp_cert_clear(cert);
+        fmpz_clear(n);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,112 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "fmpz.h"
+#include "ecpp.h"
+
+int main(void)
+{
+    slong iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("prove....");
+    fflush(stdout);
+
+    /* primes have a valid certificate */
+    for (iter = 0; iter < 10 * flint_test_multiplier(); iter++)
+    {
+        ecpp_cert_t cert;
+        fmpz_t n;
+        int res;
+
+        ecpp_cert_init(cert);
+        fmpz_init(n);
+
+        flint_set_num_threads(n_randint(state, 4) + 1);
+
+        fmpz_randprime(n, state, 2 + n_randint(state, 250), 0);
+
+        res = ecpp_prove(cert, n);
+
+        if (res != 1 || !ecpp_cert_verify(cert, n))
+        {
+            flint_printf("FAIL (prime):\n");
+            flint_printf("n = "); fmpz_print(n); flint_printf("\n");
+            flint_printf("res = %d\n", res);
+            ecpp_cert_print(cert);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        ecpp_cert_clear(cert);
+        fmpz_clear(n);
+    }
+
+    /* composites are recognised */
+    for (iter = 0; iter < 100 * flint_test_multiplier(); iter++)
+    {
+        ecpp_cert_t cert;
+        fmpz_t n, p;
+        int res;
+
+        ecpp_cert_init(cert);
+        fmpz_init(n);
+        fmpz_init(p);
+
+        fmpz_randprime(n, state, 2 + n_randint(state, 150), 0);
+        fmpz_randprime(p, state, 2 + n_randint(state, 150), 0);
+        fmpz_mul(n, n, p);
+
+        res = ecpp_prove(cert, n);
+
+        if (res != 0 || ecpp_is_prime(n) != 0)
+        {
+            flint_printf("FAIL (composite):\n");
+            flint_printf("n = "); fmpz_print(n); flint_printf("\n");
+            flint_printf("res = %d\n", res);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        ecpp_cert_clear(cert);
+        fmpz_clear(n);
+        fmpz_clear(p);
+    }
+
+    /* a larger prime */
+    {
+        ecpp_cert_t cert;
+        fmpz_t n;
+
+        ecpp_cert_init(cert);
+        fmpz_init(n);
+
+        /* 2^521 - 1 */
+        fmpz_one(n);
+        fmpz_mul_2exp(n, n, 521);
+        fmpz_sub_ui(n, n, 1);
+
+        if (ecpp_prove(cert, n) != 1 || !ecpp_cert_verify(cert, n))
+        {
+            flint_printf("FAIL (2^521 - 1)\n");
+            fflush(stdout);
+            flint_abort();
+        }
+
+        ecpp_cert_clear(cert);
+        fmpz_clear(n);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
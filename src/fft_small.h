@@ -241,12 +241,28 @@ FLINT_INLINE double sd_fft_ctx_get_fft_index(double* d, ulong i)
     return sd_fft_ctx_blk_index(d, i/BLK_SZ)[j];
 }
 
+/*
+    Unless AVX512F is enabled at compile time, GCC builds the transforms a
+    second time with 512-bit vec8d (sd_fft_avx512.c, sd_ifft_avx512.c) and
+    sd_fft_trunc and sd_ifft_trunc select them with flint_cpu_level.
+*/
+#if FLINT_HAVE_CPU_DISPATCH && !defined(__clang__) && !defined(__AVX512F__)
+# define FFT_SMALL_HAVE_AVX512_DISPATCH 1
+#else
+# define FFT_SMALL_HAVE_AVX512_DISPATCH 0
+#endif
+
 /* sd_fft.c */
 FLINT_DLL void sd_fft_trunc(const sd_fft_lctx_t Q, ulong I, ulong S, ulong k, ulong j, ulong itrunc, ulong otrunc);
 
 /* sd_ifft.c */
 FLINT_DLL void sd_ifft_trunc(const sd_fft_lctx_t Q, ulong I, ulong S, ulong k, ulong j, ulong z, ulong n, int f);
 
+#if FFT_SMALL_HAVE_AVX512_DISPATCH
+void _sd_fft_trunc_avx512(const sd_fft_lctx_t Q, ulong I, ulong S, ulong k, ulong j, ulong itrunc, ulong otrunc);
+void _sd_ifft_trunc_avx512(const sd_fft_lctx_t Q, ulong I, ulong S, ulong k, ulong j, ulong z, ulong n, int f);
+#endif
+
 /* sd_fft_ctx.c */
 FLINT_DLL void sd_fft_ctx_clear(sd_fft_ctx_t Q);
 FLINT_DLL void sd_fft_ctx_init_prime(sd_fft_ctx_t Q, ulong pp);
@@ -492,7 +508,7 @@ FLINT_INLINE void _mul_precomp_clear(mul_precomp_struct* M)
 int _nmod_poly_mul_mid_precomp(
     ulong* z, ulong zl, ulong zh,
     const ulong* a, ulong an,
-    mul_precomp_struct* M,
+    const mul_precomp_struct* M,
     nmod_t mod,
     mpn_ctx_t R);
 
@@ -540,6 +556,36 @@ int _fmpz_poly_mul_mid_default_mpn_ctx(
     const fmpz * a, slong an,
     const fmpz * b, slong bn);
 
+typedef struct {
+    ulong p;
+    ulong depth;
+    ulong np;
+    ulong stride;
+    ulong an;
+    ulong abits;
+    ulong bn;
+    ulong btrunc;
+    double* bbuf;
+} fmpz_poly_mul_precomp_struct;
+
+int _fmpz_poly_mul_precomp_init(
+    fmpz_poly_mul_precomp_struct* M,
+    const fmpz * b, ulong bn,
+    ulong an, ulong abits,
+    mpn_ctx_t R);
+
+FLINT_INLINE void _fmpz_poly_mul_precomp_clear(fmpz_poly_mul_precomp_struct* M)
+{
+    if (M->bbuf != NULL)
+        flint_aligned_free(M->bbuf);
+}
+
+int _fmpz_poly_mul_mid_precomp(
+    fmpz * z, ulong zl, ulong zh,
+    const fmpz * a, ulong an,
+    const fmpz_poly_mul_precomp_struct* M,
+    mpn_ctx_t R);
+
 #ifdef __cplusplus
 }
 #endif
@@ -605,3 +605,239 @@ int _fmpz_poly_mul_mid_mpn_ctx(
 
     return 1;
 }
+
+typedef struct {
+    ulong np;
+    ulong start_pi;
+    ulong stop_pi;
+    double* abuf;
+    const double* bbuf;
+    ulong depth;
+    ulong stride;
+    ulong atrunc;
+    ulong ztrunc;
+    const fmpz * a;
+    ulong an;
+    slong abits;
+    sd_fft_ctx_struct* ffts;
+    crt_data_struct* crts;
+} s1pworker_struct;
+
+static void s1pworker_func(void* varg)
+{
+    s1pworker_struct* X = (s1pworker_struct*) varg;
+    sd_fft_lctx_t Q;
+    ulong i, m;
+
+    for (i = X->start_pi; i < X->stop_pi; i++)
+    {
+        double* abuf = X->abuf + X->stride*i;
+
+        sd_fft_lctx_init(Q, X->ffts + i, X->depth);
+
+        _mod(abuf, X->atrunc, X->a, X->an, X->abits, X->ffts + i);
+        sd_fft_lctx_fft_trunc(Q, abuf, X->depth, X->atrunc, X->ztrunc);
+
+        ulong cop = X->np == 1 ? 1 : *crt_data_co_prime_red(X->crts + X->np - 1, i);
+        NMOD_RED2(m, cop >> (FLINT_BITS - X->depth), cop << X->depth, X->ffts[i].mod);
+        m = nmod_inv(m, X->ffts[i].mod);
+        sd_fft_lctx_point_mul(Q, abuf, X->bbuf + X->stride*i, m, X->depth);
+
+        sd_fft_lctx_ifft_trunc(Q, abuf, X->depth, X->ztrunc);
+
+        sd_fft_lctx_clear(Q, X->ffts + i);
+    }
+}
+
+int _fmpz_poly_mul_precomp_init(
+    fmpz_poly_mul_precomp_struct* M,
+    const fmpz * b, ulong bn,
+    ulong an, ulong abits,
+    mpn_ctx_t R)
+{
+    ulong i, np, depth, stride, modbits;
+    slong bbits;
+    sd_fft_lctx_t Q;
+
+    FLINT_ASSERT(an > 0);
+    FLINT_ASSERT(bn > 0);
+
+    M->bbuf = NULL;
+
+    bbits = _fmpz_vec_max_bits(b, bn);
+    modbits = abits + FLINT_ABS(bbits) + 1;
+
+    /* need prod_of_primes >= min(an, bn) * 2^modbits */
+    for (np = 1; ; np++)
+    {
+        if (np > MPN_CTX_NCRTS)
+            return 0;
+
+        if (flint_mpn_cmp_ui_2exp(crt_data_prod_primes(R->crts + np - 1),
+              R->crts[np - 1].coeff_len, FLINT_MIN(an, bn), modbits) >= 0)
+        {
+            break;
+        }
+    }
+
+    depth = n_max(LG_BLK_SZ, n_clog2(n_round_up(an + bn - 1, BLK_SZ)));
+    stride = n_round_up(sd_fft_ctx_data_size(depth), 128);
+
+    M->p = R->ffts[0].mod.n;
+    M->depth = depth;
+    M->np = np;
+    M->stride = stride;
+    M->an = an;
+    M->abits = abits;
+    M->bn = bn;
+    M->btrunc = n_round_up(bn, BLK_SZ);
+    M->bbuf = flint_aligned_alloc(4096, n_round_up(np*stride*sizeof(double), 4096));
+
+    for (i = 0; i < np; i++)
+    {
+        double* bbuf = M->bbuf + stride*i;
+
+        sd_fft_lctx_init(Q, R->ffts + i, depth);
+
+        _mod(bbuf, M->btrunc, b, bn, bbits, R->ffts + i);
+        sd_fft_lctx_fft_trunc(Q, bbuf, depth, M->btrunc, n_pow2(depth));
+
+        sd_fft_lctx_clear(Q, R->ffts + i);
+    }
+
+    return 1;
+}
+
+int _fmpz_poly_mul_mid_precomp(
+    fmpz * z, ulong zl, ulong zh,
+    const fmpz * a, ulong an,
+    const fmpz_poly_mul_precomp_struct* M,
+    mpn_ctx_t R)
+{
+    ulong bn = M->bn;
+    ulong zn = an + bn - 1;
+    ulong depth = M->depth;
+    ulong np = M->np;
+    ulong i, atrunc, ztrunc;
+    slong abits;
+    double* buf;
+
+    FLINT_ASSERT(an > 0);
+
+    if (M->bbuf == NULL || R->ffts[0].mod.n != M->p)
+        return 0;
+
+    abits = _fmpz_vec_max_bits(a, an);
+
+    if (an > M->an || FLINT_ABS(abits) > M->abits)
+        return 0;
+
+    if (zl >= zh)
+        return 1;
+
+    if (zh > zn)
+    {
+        if (zl >= zn)
+        {
+            _fmpz_vec_zero(z, zh - zl);
+            return 1;
+        }
+
+        _fmpz_vec_zero(z + zn - zl, zh - zn);
+        zh = zn;
+    }
+
+    FLINT_ASSERT(zl < zh);
+    FLINT_ASSERT(zh <= zn);
+
+    atrunc = n_round_up(an, BLK_SZ);
+    ztrunc = n_round_up(zn, BLK_SZ);
+
+    /* an <= M->an means that the full product always fits */
+    FLINT_ASSERT(ztrunc <= n_pow2(depth));
+
+    ulong want_threads;
+
+    if ((np >= 2 && an >= 1000) || (np >= 4 && an >= 300))
+        want_threads = np;
+    else
+        want_threads = 1;
+
+    thread_pool_handle* handles;
+    slong nworkers = flint_request_threads(&handles, want_threads);
+    ulong nthreads = nworkers + 1;
+
+    buf = (double*) mpn_ctx_fit_buffer(R, np*M->stride*sizeof(double));
+
+    s1pworker_struct s1pargs[8];
+    FLINT_ASSERT(nthreads <= 8);
+    for (i = 0; i < nthreads; i++)
+    {
+        s1pworker_struct* X = s1pargs + i;
+        X->np = np;
+        X->start_pi = (i+0)*np/nthreads;
+        X->stop_pi  = (i+1)*np/nthreads;
+        X->abuf = buf;
+        X->bbuf = M->bbuf;
+        X->depth = depth;
+        X->stride = M->stride;
+        X->atrunc = atrunc;
+        X->ztrunc = ztrunc;
+        X->a = a;
+        X->an = an;
+        X->abits = abits;
+        X->ffts = R->ffts;
+        X->crts = R->crts;
+    }
+
+    for (i = nworkers; i > 0; i--)
+        thread_pool_wake(global_thread_pool, handles[i - 1], 0, s1pworker_func, s1pargs + i);
+    s1pworker_func(s1pargs + 0);
+    for (i = nworkers; i > 0; i--)
+        thread_pool_wait(global_thread_pool, handles[i - 1]);
+
+    if (zn > 50000 || (np >= 2 && zn > 20000) || (np >= 4 && zn > 800))
+    {
+        flint_give_back_threads(handles, nworkers);
+        nworkers = flint_request_threads(&handles, 8);
+        nthreads = nworkers + 1;
+    }
+
+    s2worker_struct s2args[8];
+    FLINT_ASSERT(nthreads <= 8);
+
+    ulong o = zl;
+    for (i = 0; i < nthreads; i++)
+    {
+        s2worker_struct* X = s2args + i;
+        X->z = z;
+        X->zl = zl;
+        X->start_zi = o;
+        ulong newo = n_round_down(zl + (i+1)*(zh-zl)/nthreads, BLK_SZ);
+        o = i+1 < nthreads ? FLINT_MAX(o, newo) : zh;
+        X->stop_zi = o;
+        X->buf = buf;
+        X->offset = 0;
+        X->stride = M->stride;
+        X->ffts = R->ffts;
+        X->crts = R->crts;
+        X->f =  np == 1 ? _crt_1 :
+                np == 2 ? _crt_2 :
+                np == 3 ? _crt_3 :
+                np == 4 ? _crt_4 :
+                np == 5 ? _crt_5 :
+                np == 6 ? _crt_6 :
+                np == 7 ? _crt_7 :
+                          _crt_8;
+    }
+
+    for (i = nworkers; i > 0; i--)
+        thread_pool_wake(global_thread_pool, handles[i - 1], 0, s2worker_func, s2args + i);
+    s2worker_func(s2args + 0);
+    for (i = nworkers; i > 0; i--)
+        thread_pool_wait(global_thread_pool, handles[i - 1]);
+
+    flint_give_back_threads(handles, nworkers);
+
+    return 1;
+}
@@ -217,14 +217,14 @@ void slow_mpn_to_fft_easy(
             X = vec8d_reduce_to_pm1n(X, p, pinv);
 
             /* _vec8i32_convert_vec8d make the Xs slightly out of order */
-            zI[ir+0*BLK_SZ/8] = X.e1[0];
-            zI[ir+1*BLK_SZ/8] = X.e1[1];
-            zI[ir+4*BLK_SZ/8] = X.e1[2];
-            zI[ir+5*BLK_SZ/8] = X.e1[3];
-            zI[ir+2*BLK_SZ/8] = X.e2[0];
-            zI[ir+3*BLK_SZ/8] = X.e2[1];
-            zI[ir+6*BLK_SZ/8] = X.e2[2];
-            zI[ir+7*BLK_SZ/8] = X.e2[3];
+            zI[ir+0*BLK_SZ/8] = vec8d_get_index(X, 0);
+            zI[ir+1*BLK_SZ/8] = vec8d_get_index(X, 1);
+            zI[ir+4*BLK_SZ/8] = vec8d_get_index(X, 2);
+            zI[ir+5*BLK_SZ/8] = vec8d_get_index(X, 3);
+            zI[ir+2*BLK_SZ/8] = vec8d_get_index(X, 4);
+            zI[ir+3*BLK_SZ/8] = vec8d_get_index(X, 5);
+            zI[ir+6*BLK_SZ/8] = vec8d_get_index(X, 6);
+            zI[ir+7*BLK_SZ/8] = vec8d_get_index(X, 7);
         }
     }
 }
@@ -1088,10 +1088,6 @@ got_one:
     }
 
     ulong np = R->profiles[i].np;
-
-    if (np % P->nthreads != 0)
-        goto find_next;
-
     ulong bits = R->profiles[i].bits;
     ulong alen = n_cdiv(64*an, bits);
     ulong blen = n_cdiv(64*bn, bits);
@@ -1099,9 +1095,15 @@ got_one:
     ulong ztrunc = n_round_up(zlen, BLK_SZ);
     ulong depth = n_max(LG_BLK_SZ, n_clog2(ztrunc));
 
+    /*
+        The transforms for the np primes are spread over the threads, so the
+        wall time goes with the number of rounds n_cdiv(np, nthreads) rather
+        than with np. A profile whose np is not a multiple of nthreads is
+        thereby charged for its idle threads instead of being excluded.
+    */
     double ratio = (double)(ztrunc)/(double)(n_pow2(depth));
     double score = (1-0.25*ratio)*(1.0/1000000);
-    score *= np*depth;
+    score *= n_cdiv(np, P->nthreads)*depth;
     score *= ztrunc;
     if (score < best_score)
     {
@@ -1109,8 +1111,6 @@ got_one:
         best_score = score;
     }
 
-find_next:
-
     do {
         i++;
         if (i >= R->profiles_size)
@@ -1387,7 +1387,7 @@ void mpn_ctx_mpn_mul(mpn_ctx_t R, ulong* z, const ulong* a, ulong an, const ulon
 
 #if TIME_THIS
 timeit_t timer, timer_overall;
-flint_printf("------------ zn = %wu, nthreads = %wu np = %wu, bits = %wu, -------------\n", zn, nthreads, np, bits);
+flint_printf("------------ zn = %wu, nthreads = %wu np = %wu, bits = %wu, -------------\n", zn, P.nthreads, P.np, P.bits);
 #endif
 
 #if TIME_THIS
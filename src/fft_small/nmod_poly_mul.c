@@ -894,7 +894,7 @@ got_np_and_offset:
 int _nmod_poly_mul_mid_precomp(
     ulong* z, ulong zl, ulong zh,
     const ulong* a, ulong an,
-    mul_precomp_struct* M,
+    const mul_precomp_struct* M,
     nmod_t mod,
     mpn_ctx_t R)
 {
@@ -17,7 +17,7 @@
 
         16x 4-wide AVX registers  => N = 8
         32x 2-wide NEON registers => N = 8
-        32x 8-wide AVX512 registers  => N = ?
+        32x 8-wide AVX512 registers  => N = 8 (vec8d is one register)
 */
 
 #define N 8
@@ -425,7 +425,7 @@ DEFINE_IT(4, 4)
 
 /************************ the recursive stuff ********************************/
 
-void sd_fft_main_block(
+static void sd_fft_main_block(
     const sd_fft_lctx_t Q,
     ulong I, /* starting index */
     ulong S, /* stride */
@@ -571,7 +571,7 @@ void sd_fft_main(
 }
 
 
-void sd_fft_trunc_block(
+static void sd_fft_trunc_block(
     const sd_fft_lctx_t Q,
     ulong I, // starting index
     ulong S, // stride
@@ -695,7 +695,7 @@ void sd_fft_trunc_block(
 }
 
 
-void sd_fft_trunc(
+static void _sd_fft_trunc(
     const sd_fft_lctx_t Q,
     ulong I, /* starting index */
     ulong S, /* stride */
@@ -740,11 +740,11 @@ void sd_fft_trunc(
 
         /* full rows */
         for (ulong b = 0; b < n1; b++)
-            sd_fft_trunc(Q, I + b*(S << k2), S, k2, (j << k1) + b, z2p, l2);
+            _sd_fft_trunc(Q, I + b*(S << k2), S, k2, (j << k1) + b, z2p, l2);
 
         /* last partial row */
         if (n2 > 0)
-            sd_fft_trunc(Q, I + n1*(S << k2), S, k2, (j << k1) + n1, z2p, n2);
+            _sd_fft_trunc(Q, I + n1*(S << k2), S, k2, (j << k1) + n1, z2p, n2);
 
         return;
     }
@@ -769,7 +769,19 @@ void sd_fft_trunc(
     }
 }
 
+void sd_fft_trunc(const sd_fft_lctx_t Q, ulong I, ulong S, ulong k, ulong j,
+                                                 ulong itrunc, ulong otrunc)
+{
+#if FFT_SMALL_HAVE_AVX512_DISPATCH
+    if (flint_cpu_level() >= FLINT_CPU_AVX512)
+    {
+        _sd_fft_trunc_avx512(Q, I, S, k, j, itrunc, otrunc);
+        return;
+    }
+#endif
 
+    _sd_fft_trunc(Q, I, S, k, j, itrunc, otrunc);
+}
 
 
 #undef RADIX_2_FORWARD_PARAM_J_IS_Z
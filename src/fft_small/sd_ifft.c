@@ -395,7 +395,7 @@ DEFINE_IT(1)
 
 /* use with n = m-2 and m >= 6 */
 #define EXTEND_BASECASE(n, m) \
-void CAT3(sd_ifft_basecase, m, 1)(const sd_fft_lctx_t Q, double* X, ulong j_mr, ulong j_bits) \
+static void CAT3(sd_ifft_basecase, m, 1)(const sd_fft_lctx_t Q, double* X, ulong j_mr, ulong j_bits) \
 { \
     ulong l = n_pow2(m - 2); \
     FLINT_ASSERT(j_bits == 0); \
@@ -411,7 +411,7 @@ void CAT3(sd_ifft_basecase, m, 1)(const sd_fft_lctx_t Q, double* X, ulong j_mr,
         FLINT_ASSERT(i == l); \
     } \
 } \
-void CAT3(sd_ifft_basecase, m, 0)(const sd_fft_lctx_t Q, double* X, ulong j_mr, ulong j_bits) \
+static void CAT3(sd_ifft_basecase, m, 0)(const sd_fft_lctx_t Q, double* X, ulong j_mr, ulong j_bits) \
 { \
     ulong l = n_pow2(m - 2); \
     FLINT_ASSERT(j_bits != 0); \
@@ -433,7 +433,7 @@ EXTEND_BASECASE(6, 8)
 #undef EXTEND_BASECASE
 
 /* parameter 1: j can be zero */
-void sd_ifft_base_1(const sd_fft_lctx_t Q, ulong I, ulong j)
+static void sd_ifft_base_1(const sd_fft_lctx_t Q, ulong I, ulong j)
 {
     ulong j_bits, j_mr;
     double* x = sd_fft_lctx_blk_index(Q, I);
@@ -447,7 +447,7 @@ void sd_ifft_base_1(const sd_fft_lctx_t Q, ulong I, ulong j)
 }
 
 /* parameter 0: j cannot be zero */
-void sd_ifft_base_0(const sd_fft_lctx_t Q, ulong I, ulong j)
+static void sd_ifft_base_0(const sd_fft_lctx_t Q, ulong I, ulong j)
 {
     ulong j_bits, j_mr;
     double* x = sd_fft_lctx_blk_index(Q, I);
@@ -1014,7 +1014,7 @@ static void radix_4_moth_inv_trunc_block_0_4_1(
 
 /************************ the recursive stuff ********************************/
 
-void sd_ifft_main_block(
+static void sd_ifft_main_block(
     const sd_fft_lctx_t Q,
     ulong I, /* starting index */
     ulong S, /* stride */
@@ -1087,7 +1087,7 @@ void sd_ifft_main_block(
     }
 }
 
-void sd_ifft_main(
+static void sd_ifft_main(
     const sd_fft_lctx_t Q,
     ulong I, /* starting index */
     ulong S, /* stride */
@@ -1134,7 +1134,7 @@ void sd_ifft_main(
     }
 }
 
-void sd_ifft_trunc_block(
+static void sd_ifft_trunc_block(
     const sd_fft_lctx_t Q,
     ulong I, /* starting index */
     ulong S, /* stride */
@@ -1232,7 +1232,7 @@ void sd_ifft_trunc_block(
 }
 
 
-void sd_ifft_trunc(
+static void _sd_ifft_trunc(
     const sd_fft_lctx_t Q,
     ulong I, // starting index
     ulong S, // stride
@@ -1272,7 +1272,7 @@ void sd_ifft_trunc(
 
         /* last partial row */
         if (fp)
-            sd_ifft_trunc(Q, I + n1*(S << k2), S, k2, (j << k1) + n1, z2p, n2, f);
+            _sd_ifft_trunc(Q, I + n1*(S << k2), S, k2, (j << k1) + n1, z2p, n2, f);
 
         /* leftmost columns */
         for (ulong a = 0; a < n2; a++)
@@ -1288,14 +1288,14 @@ void sd_ifft_trunc(
         if (n > 2) sd_ifft_base_0(Q, I + S*2, 4*j+2);
         if (n > 3) sd_ifft_base_0(Q, I + S*3, 4*j+3);
         sd_ifft_trunc_block(Q, I, S, 2, j, z, n, f);
-        if (f) sd_ifft_trunc(Q, I + S*n, S, 0, 4*j+n, 1, 0, f);
+        if (f) _sd_ifft_trunc(Q, I + S*n, S, 0, 4*j+n, 1, 0, f);
     }
     else if (k == 1)
     {
                    sd_ifft_base_1(Q, I + S*0, 2*j+0);
         if (n > 1) sd_ifft_base_0(Q, I + S*1, 2*j+1);
         sd_ifft_trunc_block(Q, I, S, 1, j, z, n, f);
-        if (f) sd_ifft_trunc(Q, I + S*n, S, 0, 2*j+n, 1, 0, f);
+        if (f) _sd_ifft_trunc(Q, I + S*n, S, 0, 2*j+n, 1, 0, f);
     }
     else
     {
@@ -1304,3 +1304,16 @@ void sd_ifft_trunc(
     }
 }
 
+void sd_ifft_trunc(const sd_fft_lctx_t Q, ulong I, ulong S, ulong k, ulong j,
+                                                      ulong z, ulong n, int f)
+{
+#if FFT_SMALL_HAVE_AVX512_DISPATCH
+    if (flint_cpu_level() >= FLINT_CPU_AVX512)
+    {
+        _sd_ifft_trunc_avx512(Q, I, S, k, j, z, n, f);
+        return;
+    }
+#endif
+
+    _sd_ifft_trunc(Q, I, S, k, j, z, n, f);
+}
@@ -0,0 +1,28 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "flint.h"
+
+/*
+    sd_ifft.c compiled for AVX512F, where vec8d is a single zmm register. The
+    target pragma defines __AVX512F__ for everything included after it, so
+    there the public sd_ifft_trunc, renamed below, just calls the 512-bit
+    static _sd_ifft_trunc.
+*/
+#if FLINT_HAVE_CPU_DISPATCH && !defined(__clang__) && !defined(__AVX512F__)
+
+#pragma GCC target("avx512f,avx512dq")
+
+#define sd_ifft_trunc _sd_ifft_trunc_avx512
+
+#include "sd_ifft.c"
+
+#endif
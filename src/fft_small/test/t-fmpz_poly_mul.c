@@ -130,6 +130,106 @@ int main(void)
         }
     }
 
+    /* precomputed transform of b, reused with a second context */
+    {
+        fmpz * a, * b, * c, * d;
+        ulong an, bn, amax, zn, zl, zh, sz, i, j, reps, abits, amaxbits, bbits;
+        fmpz_poly_mul_precomp_struct M[1];
+        mpn_ctx_t R2;
+
+        mpn_ctx_init(R2, UWORD(0x0003f00000000001));
+
+        for (reps = 0; reps < 100 * flint_test_multiplier(); reps++)
+        {
+            amaxbits = 1 + n_randint(state, 200);
+            bbits = 1 + n_randint(state, 200);
+
+            amax = 1 + n_randint(state, 3000);
+            bn = 1 + n_randint(state, 3000);
+
+            b = _fmpz_vec_init(bn);
+            _fmpz_vec_randtest(b, state, bn, bbits);
+
+            if (!_fmpz_poly_mul_precomp_init(M, b, bn, amax, amaxbits, R))
+            {
+                _fmpz_poly_mul_precomp_clear(M);
+                _fmpz_vec_clear(b, bn);
+                continue;
+            }
+
+            for (j = 0; j < 5; j++)
+            {
+                flint_set_num_threads(1 + n_randint(state, 10));
+
+                abits = 1 + n_randint(state, amaxbits);
+                an = 1 + n_randint(state, amax);
+                zn = an + bn - 1;
+                zl = n_randint(state, zn+10);
+                zh = n_randint(state, zn+20);
+
+                sz = FLINT_MAX(zl, zh);
+                sz = FLINT_MAX(sz, zn);
+
+                a = _fmpz_vec_init(an);
+                c = _fmpz_vec_init(sz);
+                d = _fmpz_vec_init(sz);
+
+                if (n_randint(state, 2))
+                    _fmpz_vec_randtest_unsigned(a, state, an, abits);
+                else
+                    _fmpz_vec_randtest(a, state, an, abits);
+
+                _fmpz_vec_randtest(d, state, sz, bbits);
+
+                if (!_fmpz_poly_mul_mid_precomp(d, zl, zh, a, an, M,
+                                                    n_randint(state, 2) ? R : R2))
+                {
+                    flint_printf("FAIL (precomp rejected valid input)\n");
+                    flint_printf("amaxbits=%wu, abits=%wu, bbits=%wu\n", amaxbits, abits, bbits);
+                    flint_printf("amax=%wu, an=%wu, bn=%wu\n", amax, an, bn);
+                    flint_abort();
+                }
+
+                if (an >= bn)
+                    _fmpz_poly_mul_KS(c, a, an, b, bn);
+                else
+                    _fmpz_poly_mul_KS(c, b, bn, a, an);
+
+                for (i = zl; i < zh; i++)
+                {
+                    if (!fmpz_equal(c + i, d + i-zl))
+                    {
+                        flint_printf("(precomp) mulmid error at index %wu\n", i);
+                        flint_printf("abits=%wu, bbits=%wu\n", abits, bbits);
+                        flint_printf("zl=%wu, zh=%wu, an=%wu, bn=%wu\n", zl, zh, an, bn);
+                        flint_abort();
+                    }
+                }
+
+                _fmpz_vec_clear(a, an);
+                _fmpz_vec_clear(c, sz);
+                _fmpz_vec_clear(d, sz);
+            }
+
+            /* too long or too large inputs are rejected */
+            an = amax + 1;
+            a = _fmpz_vec_init(an);
+            d = _fmpz_vec_init(an + bn - 1);
+            if (_fmpz_poly_mul_mid_precomp(d, 0, an + bn - 1, a, an, M, R))
+            {
+                flint_printf("FAIL (precomp accepted long input)\n");
+                flint_abort();
+            }
+            _fmpz_vec_clear(a, an);
+            _fmpz_vec_clear(d, an + bn - 1);
+
+            _fmpz_poly_mul_precomp_clear(M);
+            _fmpz_vec_clear(b, bn);
+        }
+
+        mpn_ctx_clear(R2);
+    }
+
     mpn_ctx_clear(R);
 
     FLINT_TEST_CLEANUP(state);
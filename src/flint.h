@@ -228,6 +228,22 @@ int flint_restore_thread_affinity(void);
 
 FLINT_CONST double flint_test_multiplier(void);
 
+/* runtime cpu dispatch */
+#if defined(__GNUC__) && (__GNUC__ >= 5 || defined(__clang__)) && \
+    defined(__x86_64__) && !defined(__CYGWIN__)
+# define FLINT_HAVE_CPU_DISPATCH 1
+#else
+# define FLINT_HAVE_CPU_DISPATCH 0
+#endif
+
+#define FLINT_CPU_GENERIC 0
+#define FLINT_CPU_AVX2 1
+#define FLINT_CPU_AVX512 2
+#define FLINT_CPU_AVX512_IFMA 3
+
+int flint_cpu_level(void);
+void flint_set_cpu_level(int level);
+
 typedef struct
 {
     gmp_randstate_t gmp_state;
@@ -54,6 +54,25 @@ void _fmpz_cleanup(void);
 mpz_ptr _fmpz_promote(fmpz_t f);
 mpz_ptr _fmpz_promote_val(fmpz_t f);
 
+typedef struct
+{
+    ulong local_hits;   /* _fmpz_new_mpz served from the thread cache */
+    ulong global_hits;  /* _fmpz_new_mpz served after a refill from the pool */
+    ulong misses;       /* _fmpz_new_mpz that had to allocate */
+    ulong clears;       /* calls to _fmpz_clear_mpz */
+    ulong refills;      /* batches taken from the global pool */
+    ulong flushes;      /* batches given back to the global pool */
+}
+fmpz_mpz_cache_stats_struct;
+
+typedef fmpz_mpz_cache_stats_struct fmpz_mpz_cache_stats_t[1];
+
+#if FLINT_USES_MPZ_CACHE
+void _fmpz_mpz_cache_clear_global(void);
+void fmpz_mpz_cache_get_stats(fmpz_mpz_cache_stats_t stats);
+void fmpz_mpz_cache_reset_stats(void);
+#endif
+
 FMPZ_INLINE
 void _fmpz_demote(fmpz_t f)
 {
@@ -739,6 +758,13 @@ void fmpz_comb_clear(fmpz_comb_t C);
 void fmpz_multi_mod_ui(mp_limb_t * out, const fmpz_t in, const fmpz_comb_t C, fmpz_comb_temp_t CT);
 void fmpz_multi_CRT_ui(fmpz_t output, mp_srcptr residues, const fmpz_comb_t comb, fmpz_comb_temp_t temp, int sign);
 
+/* below this many residues (modular reductions or reconstructions of a
+   word-size modulus) in total, multi-mod and CRT use a single thread */
+#define FMPZ_MULTI_MOD_THREAD_CUTOFF 4000
+
+void fmpz_multi_mod_ui_vec(mp_ptr out, const fmpz * in, slong len, const fmpz_comb_t C);
+void fmpz_multi_CRT_ui_vec(fmpz * out, mp_srcptr residues, slong len, const fmpz_comb_t C, int sign);
+
 /*****************************************************************************/
 
 void fmpz_lucas_chain(fmpz_t Vm, fmpz_t Vm1, const fmpz_t A, const fmpz_t m, const fmpz_t n);
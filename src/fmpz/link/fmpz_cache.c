@@ -0,0 +1,412 @@
+/*
+    Copyright (C) 2009 William Hart
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include "flint.h"
+#include "gmpcompat.h"
+#include "fmpz.h"
+
+#if FLINT_USES_PTHREAD
+#include <pthread.h>
+#endif
+
+/*
+    Each thread keeps a small cache of free mpz's which it uses without any
+    locking. When the cache of a thread overflows, a batch of mpz's is moved
+    to a global pool, from which threads with an empty cache take a batch.
+    The global lock is therefore taken at most once per MPZ_BATCH calls,
+    which matters when mpz's are allocated in one thread and freed in
+    another.
+*/
+
+/* Always free larger mpz's to avoid wasting too much heap space */
+#define FLINT_MPZ_MAX_CACHE_LIMBS 64
+
+/* The maximum number of free mpz's in the cache of a thread */
+#define MPZ_LOCAL_CACHE 256
+
+/* The number of mpz's moved between a thread and the global pool at a time */
+#define MPZ_BATCH 64
+
+/* The maximum number of free mpz's in the global pool */
+#define MPZ_GLOBAL_CACHE 65536
+
+/*
+    The counters of a thread live on the heap and are registered in
+    mpz_stats_arr, so that fmpz_mpz_cache_get_stats can add up those of all
+    threads. A thread registers its counters when its cache is empty, which
+    is the case before it first counts anything, and unregisters them in
+    _fmpz_cleanup. Counters of other threads are read without
+    synchronisation and may lag behind slightly.
+*/
+
+static FLINT_TLS_PREFIX __mpz_struct * mpz_local_arr[MPZ_LOCAL_CACHE];
+static FLINT_TLS_PREFIX slong mpz_local_num = 0;
+static FLINT_TLS_PREFIX fmpz_mpz_cache_stats_struct * mpz_local_stats = NULL;
+
+static __mpz_struct ** mpz_global_arr = NULL;
+static slong mpz_global_num = 0;
+static slong mpz_global_alloc = 0;
+
+static fmpz_mpz_cache_stats_struct ** mpz_stats_arr = NULL;
+static slong mpz_stats_num = 0;
+static slong mpz_stats_alloc = 0;
+/* counters of the threads which have unregistered */
+static fmpz_mpz_cache_stats_struct mpz_stats_retired;
+/* the total at the last call to fmpz_mpz_cache_reset_stats */
+static fmpz_mpz_cache_stats_struct mpz_stats_base;
+
+#if FLINT_USES_PTHREAD
+static pthread_mutex_t mpz_global_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+static void _fmpz_mpz_free(__mpz_struct * z)
+{
+    mpz_clear(z);
+    flint_free(z);
+}
+
+static void _fmpz_mpz_cache_stats_add(fmpz_mpz_cache_stats_struct * s,
+                                        const fmpz_mpz_cache_stats_struct * t)
+{
+    s->local_hits += t->local_hits;
+    s->global_hits += t->global_hits;
+    s->misses += t->misses;
+    s->clears += t->clears;
+    s->refills += t->refills;
+    s->flushes += t->flushes;
+}
+
+static void _fmpz_mpz_cache_register_stats(void)
+{
+    fmpz_mpz_cache_stats_struct * s;
+
+    if (mpz_local_stats != NULL)
+        return;
+
+    s = flint_calloc(1, sizeof(fmpz_mpz_cache_stats_struct));
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_lock(&mpz_global_lock);
+#endif
+
+    if (mpz_stats_num == mpz_stats_alloc)
+    {
+        mpz_stats_alloc = FLINT_MAX(16, 2 * mpz_stats_alloc);
+        mpz_stats_arr = flint_realloc(mpz_stats_arr,
+                      mpz_stats_alloc * sizeof(fmpz_mpz_cache_stats_struct *));
+    }
+
+    mpz_stats_arr[mpz_stats_num++] = s;
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_unlock(&mpz_global_lock);
+#endif
+
+    mpz_local_stats = s;
+}
+
+/* the global lock must be held */
+static void _fmpz_mpz_cache_unregister_stats(void)
+{
+    slong i;
+
+    if (mpz_local_stats == NULL)
+        return;
+
+    _fmpz_mpz_cache_stats_add(&mpz_stats_retired, mpz_local_stats);
+
+    for (i = 0; i < mpz_stats_num; i++)
+    {
+        if (mpz_stats_arr[i] == mpz_local_stats)
+        {
+            mpz_stats_arr[i] = mpz_stats_arr[--mpz_stats_num];
+            break;
+        }
+    }
+
+    flint_free(mpz_local_stats);
+    mpz_local_stats = NULL;
+}
+
+/* move up to MPZ_BATCH mpz's from the global pool to the local cache */
+static void _fmpz_mpz_cache_refill(void)
+{
+    slong i, n;
+
+    _fmpz_mpz_cache_register_stats();
+
+    if (mpz_global_num == 0)  /* racy peek */
+        return;
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_lock(&mpz_global_lock);
+#endif
+
+    n = FLINT_MIN(mpz_global_num, MPZ_BATCH);
+
+    for (i = 0; i < n; i++)
+        mpz_local_arr[mpz_local_num++] = mpz_global_arr[--mpz_global_num];
+
+    if (n > 0)
+        mpz_local_stats->refills++;
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_unlock(&mpz_global_lock);
+#endif
+}
+
+/* move the n oldest mpz's of the local cache to the global pool */
+static void _fmpz_mpz_cache_flush(slong n)
+{
+    slong i, m;
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_lock(&mpz_global_lock);
+#endif
+
+    m = FLINT_MIN(n, MPZ_GLOBAL_CACHE - mpz_global_num);
+
+    if (mpz_global_num + m > mpz_global_alloc)
+    {
+        mpz_global_alloc = FLINT_MAX(mpz_global_num + m, 2 * mpz_global_alloc);
+        mpz_global_alloc = FLINT_MIN(mpz_global_alloc, MPZ_GLOBAL_CACHE);
+        mpz_global_arr = flint_realloc(mpz_global_arr,
+                                  mpz_global_alloc * sizeof(__mpz_struct *));
+    }
+
+    for (i = 0; i < m; i++)
+        mpz_global_arr[mpz_global_num++] = mpz_local_arr[i];
+
+    mpz_local_stats->flushes++;
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_unlock(&mpz_global_lock);
+#endif
+
+    /* the global pool is full */
+    for (i = m; i < n; i++)
+        _fmpz_mpz_free(mpz_local_arr[i]);
+
+    for (i = n; i < mpz_local_num; i++)
+        mpz_local_arr[i - n] = mpz_local_arr[i];
+
+    mpz_local_num -= n;
+}
+
+__mpz_struct * _fmpz_new_mpz(void)
+{
+    __mpz_struct * z;
+
+    if (mpz_local_num != 0)
+    {
+        mpz_local_stats->local_hits++;
+        return mpz_local_arr[--mpz_local_num];
+    }
+
+    _fmpz_mpz_cache_refill();
+
+    if (mpz_local_num != 0)
+    {
+        mpz_local_stats->global_hits++;
+        return mpz_local_arr[--mpz_local_num];
+    }
+
+    mpz_local_stats->misses++;
+    z = (__mpz_struct *) flint_malloc(sizeof(__mpz_struct));
+    mpz_init2(z, 2*FLINT_BITS);
+    return z;
+}
+
+void _fmpz_clear_mpz(fmpz f)
+{
+    __mpz_struct * ptr = COEFF_TO_PTR(f);
+
+    if (mpz_local_num == 0)
+        _fmpz_mpz_cache_register_stats();
+
+    mpz_local_stats->clears++;
+
+    if (ptr->_mp_alloc > FLINT_MPZ_MAX_CACHE_LIMBS)
+        mpz_realloc2(ptr, 2*FLINT_BITS);
+
+    if (mpz_local_num == MPZ_LOCAL_CACHE)
+        _fmpz_mpz_cache_flush(MPZ_BATCH);
+
+    mpz_local_arr[mpz_local_num++] = ptr;
+}
+
+/* give the mpz's cached by this thread back to the global pool */
+void _fmpz_cleanup_mpz_content(void)
+{
+    if (mpz_local_num != 0)
+        _fmpz_mpz_cache_flush(mpz_local_num);
+}
+
+/*
+    called by flint_cleanup, in particular when a pool thread exits; the
+    cached mpz's go to the global pool so that other threads can reuse them
+*/
+void _fmpz_cleanup(void)
+{
+    _fmpz_cleanup_mpz_content();
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_lock(&mpz_global_lock);
+#endif
+
+    _fmpz_mpz_cache_unregister_stats();
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_unlock(&mpz_global_lock);
+#endif
+}
+
+/* called by flint_cleanup_master once the pool threads are gone */
+void _fmpz_mpz_cache_clear_global(void)
+{
+    slong i;
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_lock(&mpz_global_lock);
+#endif
+
+    for (i = 0; i < mpz_global_num; i++)
+        _fmpz_mpz_free(mpz_global_arr[i]);
+
+    flint_free(mpz_global_arr);
+    mpz_global_arr = NULL;
+    mpz_global_num = mpz_global_alloc = 0;
+
+    if (mpz_stats_num == 0)
+    {
+        flint_free(mpz_stats_arr);
+        mpz_stats_arr = NULL;
+        mpz_stats_alloc = 0;
+    }
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_unlock(&mpz_global_lock);
+#endif
+}
+
+/* the global lock must be held */
+static void _fmpz_mpz_cache_total_stats(fmpz_mpz_cache_stats_struct * s)
+{
+    slong i;
+
+    *s = mpz_stats_retired;
+
+    for (i = 0; i < mpz_stats_num; i++)
+        _fmpz_mpz_cache_stats_add(s, mpz_stats_arr[i]);
+}
+
+void fmpz_mpz_cache_get_stats(fmpz_mpz_cache_stats_t stats)
+{
+    fmpz_mpz_cache_stats_struct t;
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_lock(&mpz_global_lock);
+#endif
+
+    _fmpz_mpz_cache_total_stats(&t);
+
+    stats->local_hits = t.local_hits - mpz_stats_base.local_hits;
+    stats->global_hits = t.global_hits - mpz_stats_base.global_hits;
+    stats->misses = t.misses - mpz_stats_base.misses;
+    stats->clears = t.clears - mpz_stats_base.clears;
+    stats->refills = t.refills - mpz_stats_base.refills;
+    stats->flushes = t.flushes - mpz_stats_base.flushes;
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_unlock(&mpz_global_lock);
+#endif
+}
+
+void fmpz_mpz_cache_reset_stats(void)
+{
+#if FLINT_USES_PTHREAD
+    pthread_mutex_lock(&mpz_global_lock);
+#endif
+
+    _fmpz_mpz_cache_total_stats(&mpz_stats_base);
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_unlock(&mpz_global_lock);
+#endif
+}
+
+__mpz_struct * _fmpz_promote(fmpz_t f)
+{
+    if (!COEFF_IS_MPZ(*f)) /* f is small so promote it first */
+    {
+        __mpz_struct * mf = _fmpz_new_mpz();
+        (*f) = PTR_TO_COEFF(mf);
+        return mf;
+    }
+    else /* f is large already, just return the pointer */
+        return COEFF_TO_PTR(*f);
+}
+
+__mpz_struct * _fmpz_promote_val(fmpz_t f)
+{
+    fmpz c = (*f);
+    if (!COEFF_IS_MPZ(c)) /* f is small so promote it */
+    {
+        __mpz_struct * mf = _fmpz_new_mpz();
+        (*f) = PTR_TO_COEFF(mf);
+        flint_mpz_set_si(mf, c);
+        return mf;
+    }
+    else /* f is large already, just return the pointer */
+        return COEFF_TO_PTR(c);
+}
+
+void _fmpz_demote_val(fmpz_t f)
+{
+    __mpz_struct * mf = COEFF_TO_PTR(*f);
+    int size = mf->_mp_size;
+
+    if (size == 1 || size == -1)
+    {
+        ulong uval = mf->_mp_d[0];
+
+        if (uval <= (ulong) COEFF_MAX)
+        {
+            _fmpz_clear_mpz(*f);
+            *f = size * (fmpz) uval;
+        }
+    }
+    else if (size == 0)  /* value is 0 */
+    {
+        _fmpz_clear_mpz(*f);
+        *f = 0;
+    }
+
+    /* don't do anything if value has to be multi precision */
+}
+
+void _fmpz_init_readonly_mpz(fmpz_t f, const mpz_t z)
+{
+   __mpz_struct * mf = (__mpz_struct *) flint_malloc(sizeof(__mpz_struct));
+    *f = PTR_TO_COEFF(mf);
+    *mf = *z;
+}
+
+void _fmpz_clear_readonly_mpz(mpz_t z)
+{
+    if (((z->_mp_size == 1 || z->_mp_size == -1) && (z->_mp_d[0] <= COEFF_MAX))
+        || (z->_mp_size == 0))
+    {
+        mpz_clear(z);
+    }
+}
@@ -0,0 +1,74 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "thread_support.h"
+#include "fmpz.h"
+
+typedef struct
+{
+    mp_ptr out;
+    const fmpz * in;
+    slong len;
+    slong block;
+    const fmpz_comb_struct * C;
+}
+work_t;
+
+static void
+worker(slong b, void * args)
+{
+    work_t * w = (work_t *) args;
+    const fmpz_comb_struct * C = w->C;
+    slong i, start, stop;
+    fmpz_comb_temp_t CT;
+
+    start = b * w->block;
+    stop = FLINT_MIN(w->len, start + w->block);
+
+    fmpz_comb_temp_init(CT, C);
+
+    for (i = start; i < stop; i++)
+        fmpz_multi_mod_ui(w->out + i * C->num_primes, w->in + i, C, CT);
+
+    fmpz_comb_temp_clear(CT);
+}
+
+void
+fmpz_multi_mod_ui_vec(mp_ptr out, const fmpz * in, slong len,
+                                                        const fmpz_comb_t C)
+{
+    work_t work[1];
+    slong nthreads, nblocks;
+
+    if (len <= 0)
+        return;
+
+    nthreads = flint_get_num_threads();
+
+    work->out = out;
+    work->in = in;
+    work->len = len;
+    work->C = C;
+
+    if (nthreads == 1 || len == 1 ||
+            len * C->num_primes < FMPZ_MULTI_MOD_THREAD_CUTOFF)
+    {
+        work->block = len;
+        worker(0, work);
+        return;
+    }
+
+    /* a few blocks per thread so that idle threads can steal work */
+    work->block = (len + 4 * nthreads - 1) / (4 * nthreads);
+    nblocks = (len + work->block - 1) / work->block;
+
+    flint_parallel_do(worker, work, nblocks, 0, FLINT_PARALLEL_DYNAMIC);
+}
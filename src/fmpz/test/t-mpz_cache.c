@@ -0,0 +1,141 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "flint.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "thread_support.h"
+
+typedef struct
+{
+    fmpz * v;
+    slong len;
+    flint_bitcnt_t bits;
+}
+work_struct;
+
+/* set or clear a chunk of v, so that the mpz's move between threads */
+static void
+worker_set(slong i, void * args)
+{
+    work_struct * w = (work_struct *) args;
+
+    fmpz_one(w->v + i);
+    fmpz_mul_2exp(w->v + i, w->v + i, w->bits + i % 100);
+    fmpz_add_ui(w->v + i, w->v + i, i);
+}
+
+static void
+worker_zero(slong i, void * args)
+{
+    work_struct * w = (work_struct *) args;
+
+    fmpz_zero(w->v + i);
+}
+
+int
+main(void)
+{
+    slong iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("mpz_cache....");
+    fflush(stdout);
+
+    /* mpz's allocated in one thread and freed in another */
+    for (iter = 0; iter < 100 * flint_test_multiplier(); iter++)
+    {
+        work_struct w;
+        fmpz_t t;
+        slong i;
+
+        flint_set_num_threads(1 + n_randint(state, 4));
+
+        w.len = n_randint(state, 2000);
+        w.bits = FLINT_BITS + n_randint(state, 200);
+        w.v = _fmpz_vec_init(w.len);
+
+        if (n_randint(state, 2))
+            flint_parallel_do(worker_set, &w, w.len, 0, FLINT_PARALLEL_STRIDED);
+        else
+            for (i = 0; i < w.len; i++)
+                worker_set(i, &w);
+
+        fmpz_init(t);
+
+        for (i = 0; i < w.len; i++)
+        {
+            fmpz_one(t);
+            fmpz_mul_2exp(t, t, w.bits + i % 100);
+            fmpz_add_ui(t, t, i);
+
+            if (!fmpz_equal(t, w.v + i))
+            {
+                flint_printf("FAIL:\n");
+                flint_printf("iter = %wd, i = %wd\n", iter, i);
+                fflush(stdout);
+                flint_abort();
+            }
+        }
+
+        fmpz_clear(t);
+
+        if (n_randint(state, 2))
+            flint_parallel_do(worker_zero, &w, w.len, 0, FLINT_PARALLEL_STRIDED);
+
+        _fmpz_vec_clear(w.v, w.len);
+
+        _fmpz_cleanup_mpz_content();
+    }
+
+#if FLINT_USES_MPZ_CACHE
+    /* counters of all threads */
+    for (iter = 0; iter < 100 * flint_test_multiplier(); iter++)
+    {
+        fmpz_mpz_cache_stats_t stats;
+        work_struct w;
+
+        flint_set_num_threads(1 + n_randint(state, 4));
+
+        w.len = n_randint(state, 3000);
+        w.bits = FLINT_BITS + n_randint(state, 200);
+        w.v = _fmpz_vec_init(w.len);
+
+        fmpz_mpz_cache_reset_stats();
+
+        flint_parallel_do(worker_set, &w, w.len, 0, FLINT_PARALLEL_STRIDED);
+
+        if (n_randint(state, 2))
+            flint_parallel_do(worker_zero, &w, w.len, 0, FLINT_PARALLEL_STRIDED);
+
+        _fmpz_vec_clear(w.v, w.len);
+
+        fmpz_mpz_cache_get_stats(stats);
+
+        if (stats->local_hits + stats->global_hits + stats->misses
+                                                        != (ulong) w.len ||
+            stats->clears != (ulong) w.len)
+        {
+            flint_printf("FAIL (stats):\n");
+            flint_printf("len = %wd, local_hits = %wu, global_hits = %wu, "
+                "misses = %wu, clears = %wu\n", w.len, stats->local_hits,
+                stats->global_hits, stats->misses, stats->clears);
+            fflush(stdout);
+            flint_abort();
+        }
+    }
+#endif
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
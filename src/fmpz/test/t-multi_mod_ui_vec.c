@@ -0,0 +1,118 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+
+int main(void)
+{
+    slong iter;
+
+    FLINT_TEST_INIT(state);
+
+    flint_printf("multi_mod_ui_vec....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 100 * flint_test_multiplier(); iter++)
+    {
+        slong i, k, len, num_primes;
+        flint_bitcnt_t bits;
+        mp_limb_t * primes, * residues, * r;
+        fmpz * in, * out;
+        fmpz_comb_t comb;
+        fmpz_comb_temp_t comb_temp;
+        fmpz_t prod, t;
+        int sign = n_randint(state, 2);
+
+        flint_set_num_threads(1 + n_randint(state, 4));
+
+        num_primes = 1 + n_randint(state, 100);
+        len = n_randint(state, 300);
+
+        primes = FLINT_ARRAY_ALLOC(num_primes, mp_limb_t);
+        residues = FLINT_ARRAY_ALLOC(len * num_primes + 1, mp_limb_t);
+        r = FLINT_ARRAY_ALLOC(num_primes, mp_limb_t);
+        in = _fmpz_vec_init(len);
+        out = _fmpz_vec_init(len);
+        fmpz_init(prod);
+        fmpz_init(t);
+
+        primes[0] = n_nextprime(n_randbits(state, FLINT_BITS - 2), 1);
+        for (k = 1; k < num_primes; k++)
+            primes[k] = n_nextprime(primes[k - 1], 1);
+
+        fmpz_one(prod);
+        for (k = 0; k < num_primes; k++)
+            fmpz_mul_ui(prod, prod, primes[k]);
+
+        /* values which are recovered exactly */
+        bits = fmpz_bits(prod) - 2;
+        if (sign)
+            _fmpz_vec_randtest(in, state, len, 1 + n_randint(state, bits));
+        else
+            _fmpz_vec_randtest_unsigned(in, state, len, 1 + n_randint(state, bits));
+
+        _fmpz_vec_randtest(out, state, len, 100);
+
+        fmpz_comb_init(comb, primes, num_primes);
+        fmpz_comb_temp_init(comb_temp, comb);
+
+        fmpz_multi_mod_ui_vec(residues, in, len, comb);
+
+        for (i = 0; i < len; i++)
+        {
+            fmpz_multi_mod_ui(r, in + i, comb, comb_temp);
+
+            for (k = 0; k < num_primes; k++)
+            {
+                if (residues[i * num_primes + k] != r[k])
+                {
+                    flint_printf("FAIL: multi_mod_ui_vec\n");
+                    flint_printf("iter = %wd, i = %wd, k = %wd\n", iter, i, k);
+                    fflush(stdout);
+                    flint_abort();
+                }
+            }
+        }
+
+        fmpz_multi_CRT_ui_vec(out, residues, len, comb, sign);
+
+        for (i = 0; i < len; i++)
+        {
+            fmpz_multi_CRT_ui(t, residues + i * num_primes, comb, comb_temp, sign);
+
+            if (!fmpz_equal(out + i, in + i) || !fmpz_equal(t, out + i))
+            {
+                flint_printf("FAIL: multi_CRT_ui_vec\n");
+                flint_printf("iter = %wd, i = %wd, sign = %d\n", iter, i, sign);
+                fflush(stdout);
+                flint_abort();
+            }
+        }
+
+        fmpz_comb_temp_clear(comb_temp);
+        fmpz_comb_clear(comb);
+
+        flint_free(primes);
+        flint_free(residues);
+        flint_free(r);
+        _fmpz_vec_clear(in, len);
+        _fmpz_vec_clear(out, len);
+        fmpz_clear(prod);
+        fmpz_clear(t);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -64,6 +64,8 @@ void fmpz_factor_no_trial(fmpz_factor_t factor, const fmpz_t n);
 int fmpz_factor_smooth(fmpz_factor_t factor,
 		                       const fmpz_t n, slong bits, int proved);
 
+void fmpz_factor_smooth_vec(fmpz * res, const fmpz * vec, slong len, ulong B);
+
 void fmpz_factor_si(fmpz_factor_t factor, slong n);
 
 int fmpz_factor_pp1(fmpz_t factor, const fmpz_t n,
@@ -119,6 +121,8 @@ typedef struct ecm_s {
     mp_limb_t n_size;
     mp_limb_t normbits;
 
+    volatile int * stop; /* if not NULL, the stages give up once *stop != 0 */
+
 } ecm_s;
 
 typedef ecm_s ecm_t[1];
@@ -155,6 +159,9 @@ int fmpz_factor_ecm_stage_I(mp_ptr f, const mp_limb_t *prime_array,
 int fmpz_factor_ecm_stage_II(mp_ptr f, mp_limb_t B1, mp_limb_t B2,
                                        mp_limb_t P, mp_ptr n, ecm_t ecm_inf);
 
+int fmpz_factor_ecm_stage_II_fft(mp_ptr f, mp_limb_t B1, mp_limb_t B2,
+                                       mp_limb_t P, mp_ptr n, ecm_t ecm_inf);
+
 int fmpz_factor_ecm(fmpz_t f, mp_limb_t curves, mp_limb_t B1,
                         mp_limb_t B2, flint_rand_t state, const fmpz_t n_in);
 
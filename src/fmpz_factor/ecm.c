@@ -14,6 +14,7 @@
 
 #include "ulong_extras.h"
 #include "mpn_extras.h"
+#include "thread_support.h"
 #include "fmpz.h"
 #include "fmpz_factor.h"
 
@@ -43,16 +44,199 @@ ulong n_ecm_primorial[] =
 #define num_n_ecm_primorials 9
 #endif
 
+/*
+   Use stage II by fast polynomial evaluation once B2 is at least this
+   large, below it the prime by prime stage II is faster
+*/
+#define ECM_STAGE_II_FFT_CUTOFF 100000
+
+/*
+   The curves are shared out between the threads. Each takes the next sigma
+   from the random state, so the curves tried do not depend on the number of
+   threads. Once a factor is found the other threads give up at their next
+   check of the flag.
+*/
+typedef struct
+{
+    const mp_limb_t * prime_array;
+    mp_limb_t num, B1, B2, P;
+    int fft;                 /* use fmpz_factor_ecm_stage_II_fft */
+    mp_ptr n;
+    ecm_s * ecm_inf;         /* n dependent data shared by the threads */
+    flint_rand_s * state;
+    const fmpz * nm8;
+    mp_limb_t curves;
+    mp_limb_t next;          /* number of curves taken so far */
+    volatile int found;      /* nonzero once a factor is found */
+    int ret;
+    fmpz * f;
+#if FLINT_USES_PTHREAD
+    pthread_mutex_t mutex;
+#endif
+}
+_ecm_shared_struct;
+
+/* record the factor f of ret limbs found in the given stage, if first */
+static void
+_ecm_found(_ecm_shared_struct * S, mp_ptr f, mp_size_t ret, int stage)
+{
+    __mpz_struct * fac;
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_lock(&S->mutex);
+#endif
+
+    if (!S->found)
+    {
+        if (S->ecm_inf->normbits)
+           mpn_rshift(f, f, ret, S->ecm_inf->normbits);
+        MPN_NORM(f, ret);
+
+        fac = _fmpz_promote(S->f);
+        mpz_realloc(fac, ret);
+        flint_mpn_copyi(fac->_mp_d, f, ret);
+        fac->_mp_size = ret;
+        _fmpz_demote_val(S->f);
+
+        S->ret = stage;
+        S->found = 1;
+    }
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_unlock(&S->mutex);
+#endif
+}
+
+static void
+_ecm_worker(void * varg)
+{
+    _ecm_shared_struct * S = (_ecm_shared_struct *) varg;
+    mp_limb_t n_size = S->ecm_inf->n_size, cy;
+    ecm_t ecm_inf;
+    fmpz_t sig;
+    __mpz_struct * mptr;
+    mp_ptr f, mpsig;
+    int ret;
+
+    fmpz_factor_ecm_init(ecm_inf, n_size);
+    flint_mpn_copyi(ecm_inf->ninv, S->ecm_inf->ninv, n_size);
+    flint_mpn_copyi(ecm_inf->one, S->ecm_inf->one, n_size);
+    ecm_inf->normbits = S->ecm_inf->normbits;
+    ecm_inf->GCD_table = S->ecm_inf->GCD_table;
+    ecm_inf->prime_table = S->ecm_inf->prime_table;
+    ecm_inf->stop = &S->found;
+
+    f = flint_malloc((n_size + 1) * sizeof(mp_limb_t));
+    mpsig = flint_malloc(n_size * sizeof(mp_limb_t));
+    fmpz_init(sig);
+
+    while (1)
+    {
+#if FLINT_USES_PTHREAD
+        pthread_mutex_lock(&S->mutex);
+#endif
+        if (S->found || S->next >= S->curves)
+        {
+#if FLINT_USES_PTHREAD
+            pthread_mutex_unlock(&S->mutex);
+#endif
+            break;
+        }
+
+        S->next++;
+        fmpz_randm(sig, S->state, S->nm8);
+#if FLINT_USES_PTHREAD
+        pthread_mutex_unlock(&S->mutex);
+#endif
+
+        fmpz_add_ui(sig, sig, 7);
+
+        mpn_zero(mpsig, n_size);
+
+        if ((!COEFF_IS_MPZ(*sig)))
+        {
+            mpsig[0] = fmpz_get_ui(sig);
+            if (ecm_inf->normbits)
+            {
+                cy = mpn_lshift(mpsig, mpsig, 1, ecm_inf->normbits);
+                if (cy)
+                   mpsig[1] = cy;
+            }
+        }
+        else
+        {
+            mptr = COEFF_TO_PTR(*sig);
+
+            if (ecm_inf->normbits)
+            {
+                cy = mpn_lshift(mpsig, mptr->_mp_d, mptr->_mp_size, ecm_inf->normbits);
+                if (cy)
+                    mpsig[mptr->_mp_size] = cy;
+            } else
+            {
+                flint_mpn_copyi(mpsig, mptr->_mp_d, mptr->_mp_size);
+            }
+        }
+
+        /************************ SELECT CURVE ************************/
+
+        ret = fmpz_factor_ecm_select_curve(f, mpsig, S->n, ecm_inf);
+
+        if (ret > 0)
+        {
+            /* Found factor while selecting curve,
+               very very lucky :) */
+            _ecm_found(S, f, ret, -1);
+            break;
+        }
+
+        if (ret == -1) /* no use for this curve */
+            continue;
+
+        /************************** STAGE I ***************************/
+
+        ret = fmpz_factor_ecm_stage_I(f, S->prime_array, S->num, S->B1,
+                                                              S->n, ecm_inf);
+
+        if (ret)
+        {
+            _ecm_found(S, f, ret, 1);
+            break;
+        }
+
+        /************************** STAGE II ***************************/
+
+        if (S->fft)
+            ret = fmpz_factor_ecm_stage_II_fft(f, S->B1, S->B2, S->P, S->n, ecm_inf);
+        else
+            ret = fmpz_factor_ecm_stage_II(f, S->B1, S->B2, S->P, S->n, ecm_inf);
+
+        if (ret)
+        {
+            _ecm_found(S, f, ret, 2);
+            break;
+        }
+    }
+
+    fmpz_clear(sig);
+    flint_free(mpsig);
+    flint_free(f);
+    fmpz_factor_ecm_clear(ecm_inf);
+}
+
 int
 fmpz_factor_ecm(fmpz_t f, mp_limb_t curves, mp_limb_t B1, mp_limb_t B2,
                 flint_rand_t state, const fmpz_t n_in)
 {
-    fmpz_t sig, nm8;
-    mp_limb_t P, num, maxP, mmin, mmax, mdiff, prod, maxj, n_size, cy;
-    int i, j, ret;
+    fmpz_t nm8;
+    mp_limb_t P, num, maxP, mmin, mmax, mdiff, prod, maxj, n_size;
+    slong i, j, num_handles;
+    thread_pool_handle * handles;
+    _ecm_shared_struct S;
     ecm_t ecm_inf;
-    __mpz_struct *fac, *mptr;
-    mp_ptr n, mpsig;
+    __mpz_struct * mptr;
+    mp_ptr n;
+    int fft;
 
     TMP_INIT;
 
@@ -61,7 +245,7 @@ fmpz_factor_ecm(fmpz_t f, mp_limb_t curves, mp_limb_t B1, mp_limb_t B2,
 
     if (n_size == 1)
     {
-        ret = n_factor_ecm(&P, curves, B1, B2, state, fmpz_get_ui(n_in));
+        int ret = n_factor_ecm(&P, curves, B1, B2, state, fmpz_get_ui(n_in));
         fmpz_set_ui(f, P);
         return ret;
     }
@@ -71,7 +255,6 @@ fmpz_factor_ecm(fmpz_t f, mp_limb_t curves, mp_limb_t B1, mp_limb_t B2,
     TMP_START;
 
     n      = TMP_ALLOC(n_size * sizeof(mp_limb_t));
-    mpsig  = TMP_ALLOC(n_size * sizeof(mp_limb_t));
 
     if ((!COEFF_IS_MPZ(* n_in)))
     {
@@ -92,14 +275,9 @@ fmpz_factor_ecm(fmpz_t f, mp_limb_t curves, mp_limb_t B1, mp_limb_t B2,
     flint_mpn_preinvn(ecm_inf->ninv, n, n_size);
     ecm_inf->one[0] = UWORD(1) << ecm_inf->normbits;
 
-    fmpz_init(sig);
     fmpz_init(nm8);
     fmpz_sub_ui(nm8, n_in, 8);
 
-    ret = 0;
-    fac = _fmpz_promote(f);
-    mpz_realloc(fac, fmpz_size(n_in));
-
     /************************ STAGE I PRECOMPUTATIONS ************************/
 
     num = n_prime_pi(B1);   /* number of primes under B1 */
@@ -109,13 +287,29 @@ fmpz_factor_ecm(fmpz_t f, mp_limb_t curves, mp_limb_t B1, mp_limb_t B2,
 
     /************************ STAGE II PRECOMPUTATIONS ***********************/
 
-    maxP = n_sqrt(B2);
+    fft = (B2 >= ECM_STAGE_II_FFT_CUTOFF);
 
     /* Selecting primorial */
 
     j = 1;
-    while ((j < num_n_ecm_primorials) && (n_ecm_primorial[j] < maxP))
-        j += 1;
+
+    if (fft)
+    {
+        /*
+           balance the phi(P)/2 baby steps against the B2/P giant steps,
+           keeping P/2 below B1
+        */
+        while ((j < num_n_ecm_primorials) &&
+               n_ecm_primorial[j] <= 2*B1 &&
+               n_ecm_primorial[j] <= B2 / (n_euler_phi(n_ecm_primorial[j])/2))
+            j += 1;
+    } else
+    {
+        maxP = n_sqrt(B2);
+
+        while ((j < num_n_ecm_primorials) && (n_ecm_primorial[j] < maxP))
+            j += 1;
+    }
 
     P = n_ecm_primorial[j - 1];
 
@@ -141,141 +335,92 @@ fmpz_factor_ecm(fmpz_t f, mp_limb_t curves, mp_limb_t B1, mp_limb_t B2,
             ecm_inf->GCD_table[j] = 0;
     }
 
-    /* compute prime table */
+    /* compute prime table, only used by the prime by prime stage II */
 
-    ecm_inf->prime_table = flint_malloc(mdiff * sizeof(unsigned char*));
+    ecm_inf->prime_table = NULL;
 
-    for (i = 0; i < mdiff; i++)
-        ecm_inf->prime_table[i] = flint_malloc((maxj + 1) * sizeof(unsigned char));
-
-    for (i = 0; i < mdiff; i++)
+    if (!fft)
     {
-        for (j = 1; j <= maxj; j += 2)
-        {
-            ecm_inf->prime_table[i][j] = 0;
+        ecm_inf->prime_table = flint_malloc(mdiff * sizeof(unsigned char*));
 
-            /* if (i + mmin)*P + j
-               is prime, mark 1. Can be possibly prime
-               only if gcd(j, P) = 1 */
+        for (i = 0; i < mdiff; i++)
+            ecm_inf->prime_table[i] = flint_malloc((maxj + 1) * sizeof(unsigned char));
 
-            if (ecm_inf->GCD_table[j] == 1)
+        for (i = 0; i < mdiff; i++)
+        {
+            for (j = 1; j <= maxj; j += 2)
             {
-                prod = (i + mmin)*P + j;
-                if (n_is_prime(prod))
-                    ecm_inf->prime_table[i][j] = 1;
-
-                prod = (i + mmin)*P - j;
-                if (n_is_prime(prod))
-                    ecm_inf->prime_table[i][j] = 1;
+                ecm_inf->prime_table[i][j] = 0;
+
+                /* if (i + mmin)*P + j
+                   is prime, mark 1. Can be possibly prime
+                   only if gcd(j, P) = 1 */
+
+                if (ecm_inf->GCD_table[j] == 1)
+                {
+                    prod = (i + mmin)*P + j;
+                    if (n_is_prime(prod))
+                        ecm_inf->prime_table[i][j] = 1;
+
+                    prod = (i + mmin)*P - j;
+                    if (n_is_prime(prod))
+                        ecm_inf->prime_table[i][j] = 1;
+                }
             }
         }
     }
 
-
     /****************************** TRY "CURVES" *****************************/
 
-    for (j = 0; j < curves; j++)
-    {
-        fmpz_randm(sig, state, nm8);
-        fmpz_add_ui(sig, sig, 7);
-
-        mpn_zero(mpsig, ecm_inf->n_size);
-
-        if ((!COEFF_IS_MPZ(*sig)))
-        {
-            mpsig[0] = fmpz_get_ui(sig);
-            if (ecm_inf->normbits)
-            {
-                cy = mpn_lshift(mpsig, mpsig, 1, ecm_inf->normbits);
-                if (cy)
-                   mpsig[1] = cy;
-            }
-        }
-        else
-        {
-            mptr = COEFF_TO_PTR(*sig);
-
-            if (ecm_inf->normbits)
-            {
-                cy = mpn_lshift(mpsig, mptr->_mp_d, mptr->_mp_size, ecm_inf->normbits);
-                if (cy)
-                    mpsig[mptr->_mp_size] = cy;
-            } else
-            {
-                flint_mpn_copyi(mpsig, mptr->_mp_d, mptr->_mp_size);
-            }
-        }
-
-        /************************ SELECT CURVE ************************/
-
-        ret = fmpz_factor_ecm_select_curve(fac->_mp_d, mpsig, n, ecm_inf);
-
-        if (ret)
-        {
-            /* Found factor while selecting curve,
-               very very lucky :) */
-
-            if (ecm_inf->normbits)
-               mpn_rshift(fac->_mp_d, fac->_mp_d, ret, ecm_inf->normbits);
-            MPN_NORM(fac->_mp_d, ret);
-
-            fac->_mp_size = ret;
-            _fmpz_demote_val(f);
-            ret = -1;
-            goto cleanup;
-        }
+    S.prime_array = prime_array;
+    S.num = num;
+    S.B1 = B1;
+    S.B2 = B2;
+    S.P = P;
+    S.fft = fft;
+    S.n = n;
+    S.ecm_inf = ecm_inf;
+    S.state = state;
+    S.nm8 = nm8;
+    S.curves = curves;
+    S.next = 0;
+    S.found = 0;
+    S.ret = 0;
+    S.f = f;
+#if FLINT_USES_PTHREAD
+    pthread_mutex_init(&S.mutex, NULL);
+#endif
 
-        if (ret != -1)
-        {
+    num_handles = flint_request_threads(&handles,
+                                 FLINT_MIN(curves, flint_get_num_threads()));
 
-            /************************** STAGE I ***************************/
+    for (i = 0; i < num_handles; i++)
+        thread_pool_wake(global_thread_pool, handles[i], 0, _ecm_worker, &S);
 
-            ret = fmpz_factor_ecm_stage_I(fac->_mp_d, prime_array, num, B1, n, ecm_inf);
+    _ecm_worker(&S);
 
-            if (ret)
-            {
-                /* Found factor after stage I */
-                if (ecm_inf->normbits)
-                   mpn_rshift(fac->_mp_d, fac->_mp_d, ret, ecm_inf->normbits);
-                MPN_NORM(fac->_mp_d, ret);
-
-                fac->_mp_size = ret;
-                _fmpz_demote_val(f);
-                ret = 1;
-                goto cleanup;
-            }
-            /************************** STAGE II ***************************/
+    for (i = 0; i < num_handles; i++)
+        thread_pool_wait(global_thread_pool, handles[i]);
 
-            ret = fmpz_factor_ecm_stage_II(fac->_mp_d, B1, B2, P, n, ecm_inf);
-
-            if (ret)
-            {
-                /* Found factor after stage II */
-                if (ecm_inf->normbits)
-                   mpn_rshift(fac->_mp_d, fac->_mp_d, ret, ecm_inf->normbits);
-                MPN_NORM(fac->_mp_d, ret);
-                fac->_mp_size = ret;
-                _fmpz_demote_val(f);
-                ret = 2;
-                goto cleanup;
-            }
-        }
-    }
-
-    cleanup:
+    flint_give_back_threads(handles, num_handles);
 
+#if FLINT_USES_PTHREAD
+    pthread_mutex_destroy(&S.mutex);
+#endif
 
     flint_free(ecm_inf->GCD_table);
-    for (i = 0; i < mdiff; i++)
-        flint_free(ecm_inf->prime_table[i]);
-    flint_free(ecm_inf->prime_table);
+    if (ecm_inf->prime_table != NULL)
+    {
+        for (i = 0; i < mdiff; i++)
+            flint_free(ecm_inf->prime_table[i]);
+        flint_free(ecm_inf->prime_table);
+    }
 
     fmpz_factor_ecm_clear(ecm_inf);
 
     fmpz_clear(nm8);
-    fmpz_clear(sig);
 
     TMP_END;
 
-    return ret;
+    return S.ret;
 }
@@ -0,0 +1,241 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "mpn_extras.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "fmpz_mod.h"
+#include "fmpz_mod_poly.h"
+#include "fmpz_factor.h"
+
+/*
+   Stage II of ECM by fast polynomial evaluation.
+
+   With Q0 the point reached by stage I, let x_j be the x-coordinate of jQ0
+   for odd 0 < j < P/2 coprime to P, and y_m that of mPQ0 for
+   mmin <= m <= mmax. A prime p dividing n divides y_m - x_j if and only if
+   mPQ0 = +-jQ0 modulo p, so every prime mP +- j in (B1, B2] is covered by
+   the product of F(y_m) over all m, where F(X) = prod_j (X - x_j). The
+   values F(y_m) are computed with a product tree.
+*/
+
+/* r = a modulo n, where a is stored shifted left by normbits */
+static void
+_ecm_get_fmpz(fmpz_t r, mp_srcptr a, ecm_t ecm_inf)
+{
+    fmpz_set_ui_array(r, a, ecm_inf->n_size);
+    fmpz_fdiv_q_2exp(r, r, ecm_inf->normbits);
+}
+
+/* f = g shifted left by normbits, return the number of limbs of f */
+static mp_limb_t
+_ecm_set_fmpz(mp_ptr f, const fmpz_t g, ecm_t ecm_inf)
+{
+    fmpz_t t;
+    mp_limb_t sz;
+
+    fmpz_init(t);
+    fmpz_mul_2exp(t, g, ecm_inf->normbits);
+    sz = fmpz_size(t);
+    fmpz_get_ui_array(f, sz, t);
+    fmpz_clear(t);
+
+    return sz;
+}
+
+/*
+   Set xs[i] to xs[i]/zs[i] for 0 <= i < len using one inversion. If some
+   zs[i] is not invertible, set g to the gcd of their product with n and
+   return 0.
+*/
+static int
+_ecm_normalise(fmpz * xs, const fmpz * zs, slong len, fmpz_t g,
+                                                   const fmpz_mod_ctx_t ctx)
+{
+    fmpz * c;
+    fmpz_t inv, t;
+    slong i;
+    int ret = 1;
+
+    c = _fmpz_vec_init(len);
+    fmpz_init(inv);
+    fmpz_init(t);
+
+    fmpz_set(c + 0, zs + 0);
+    for (i = 1; i < len; i++)
+        fmpz_mod_mul(c + i, c + i - 1, zs + i, ctx);
+
+    if (!fmpz_invmod(inv, c + len - 1, fmpz_mod_ctx_modulus(ctx)))
+    {
+        fmpz_gcd(g, c + len - 1, fmpz_mod_ctx_modulus(ctx));
+        ret = 0;
+        goto cleanup;
+    }
+
+    for (i = len - 1; i > 0; i--)
+    {
+        fmpz_mod_mul(t, inv, c + i - 1, ctx);    /* 1/zs[i] */
+        fmpz_mod_mul(inv, inv, zs + i, ctx);     /* 1/(zs[0]...zs[i - 1]) */
+        fmpz_mod_mul(xs + i, xs + i, t, ctx);
+    }
+
+    fmpz_mod_mul(xs + 0, xs + 0, inv, ctx);
+
+cleanup:
+
+    _fmpz_vec_clear(c, len);
+    fmpz_clear(inv);
+    fmpz_clear(t);
+
+    return ret;
+}
+
+int
+fmpz_factor_ecm_stage_II_fft(mp_ptr f, mp_limb_t B1, mp_limb_t B2,
+                              mp_limb_t P, mp_ptr n, ecm_t ecm_inf)
+{
+    mp_ptr Qx, Qz, Rx, Rz, Qdx, Qdz, a, b, Q0x2, Q0z2, arrx, arrz;
+    mp_limb_t mmin, mmax, maxj, i;
+    slong j, d, num;
+    fmpz * xs, * zs, * ys, * ws, * poly;
+    fmpz_t g, N;
+    fmpz_mod_ctx_t ctx;
+    int ret = 0;
+
+    TMP_INIT;
+
+    mmin = (B1 + (P/2)) / P;
+    mmax = ((B2 - P/2) + P - 1)/P;      /* ceil */
+    maxj = (P + 1)/2;
+    num = mmax - mmin + 1;
+
+    TMP_START;
+    Qx   = TMP_ALLOC(ecm_inf->n_size * sizeof(mp_limb_t));
+    Qz   = TMP_ALLOC(ecm_inf->n_size * sizeof(mp_limb_t));
+    Rx   = TMP_ALLOC(ecm_inf->n_size * sizeof(mp_limb_t));
+    Rz   = TMP_ALLOC(ecm_inf->n_size * sizeof(mp_limb_t));
+    Qdx  = TMP_ALLOC(ecm_inf->n_size * sizeof(mp_limb_t));
+    Qdz  = TMP_ALLOC(ecm_inf->n_size * sizeof(mp_limb_t));
+    Q0x2 = TMP_ALLOC(ecm_inf->n_size * sizeof(mp_limb_t));
+    Q0z2 = TMP_ALLOC(ecm_inf->n_size * sizeof(mp_limb_t));
+    a    = TMP_ALLOC(ecm_inf->n_size * sizeof(mp_limb_t));
+    b    = TMP_ALLOC(ecm_inf->n_size * sizeof(mp_limb_t));
+    arrx = flint_malloc(((maxj >> 1) + 1) * ecm_inf->n_size * sizeof(mp_limb_t));
+    arrz = flint_malloc(((maxj >> 1) + 1) * ecm_inf->n_size * sizeof(mp_limb_t));
+
+    fmpz_init(g);
+    fmpz_init(N);
+    _ecm_get_fmpz(N, n, ecm_inf);
+    fmpz_mod_ctx_init(ctx, N);
+
+    /* baby steps: arr[j/2] = jQ0 for odd j, as in stage II */
+    flint_mpn_copyi(arrx, ecm_inf->x, ecm_inf->n_size);
+    flint_mpn_copyi(arrz, ecm_inf->z, ecm_inf->n_size);
+
+    fmpz_factor_ecm_double(Q0x2, Q0z2, arrx, arrz, n, ecm_inf);
+
+    fmpz_factor_ecm_add(arrx + 1 * ecm_inf->n_size, arrz + 1 * ecm_inf->n_size,
+                         Q0x2, Q0z2, arrx, arrz, arrx, arrz, n, ecm_inf);
+
+    for (j = 2; j <= (maxj >> 1); j += 1)
+    {
+        fmpz_factor_ecm_add(arrx + j * ecm_inf->n_size, arrz + j * ecm_inf->n_size,
+                             arrx + (j - 1) * ecm_inf->n_size, arrz + (j - 1) * ecm_inf->n_size,
+                             Q0x2, Q0z2,
+                             arrx + (j - 2) * ecm_inf->n_size, arrz + (j - 2) * ecm_inf->n_size,
+                             n, ecm_inf);
+    }
+
+    d = 0;
+    for (j = 1; j <= maxj; j += 2)
+        d += (ecm_inf->GCD_table[j] == 1);
+
+    xs = _fmpz_vec_init(d);
+    zs = _fmpz_vec_init(d);
+    ys = _fmpz_vec_init(num);
+    ws = _fmpz_vec_init(num);
+    poly = _fmpz_vec_init(d + 1);
+
+    for (j = 1, d = 0; j <= maxj; j += 2)
+    {
+        if (ecm_inf->GCD_table[j] == 1)
+        {
+            _ecm_get_fmpz(xs + d, arrx + (j >> 1) * ecm_inf->n_size, ecm_inf);
+            _ecm_get_fmpz(zs + d, arrz + (j >> 1) * ecm_inf->n_size, ecm_inf);
+            d++;
+        }
+    }
+
+    /* giant steps: R = mQ for Q = PQ0 and mmin <= m <= mmax */
+    fmpz_factor_ecm_mul_montgomery_ladder(Qx, Qz, ecm_inf->x, ecm_inf->z,
+                                           P, n, ecm_inf);
+    fmpz_factor_ecm_mul_montgomery_ladder(Rx, Rz, Qx, Qz, mmin, n, ecm_inf);
+    fmpz_factor_ecm_mul_montgomery_ladder(Qdx, Qdz, Qx, Qz, mmin - 1, n, ecm_inf);
+
+    for (i = 0; i < num; i++)
+    {
+        if (ecm_inf->stop != NULL && *ecm_inf->stop)
+            goto cleanup;
+
+        _ecm_get_fmpz(ys + i, Rx, ecm_inf);
+        _ecm_get_fmpz(ws + i, Rz, ecm_inf);
+
+        flint_mpn_copyi(a, Rx, ecm_inf->n_size);
+        flint_mpn_copyi(b, Rz, ecm_inf->n_size);
+
+        fmpz_factor_ecm_add(Rx, Rz, Rx, Rz, Qx, Qz, Qdx, Qdz, n, ecm_inf);
+
+        flint_mpn_copyi(Qdx, a, ecm_inf->n_size);
+        flint_mpn_copyi(Qdz, b, ecm_inf->n_size);
+    }
+
+    /* a point at infinity modulo some p gives the factor directly */
+    if (!_ecm_normalise(xs, zs, d, g, ctx) ||
+        !_ecm_normalise(ys, ws, num, g, ctx))
+    {
+        if (!fmpz_equal(g, N))
+            ret = _ecm_set_fmpz(f, g, ecm_inf);
+
+        goto cleanup;
+    }
+
+    /* F(X) = prod_j (X - x_j), evaluated at every y_m */
+    _fmpz_mod_poly_product_roots_fmpz_vec(poly, xs, d, ctx);
+    _fmpz_mod_poly_evaluate_fmpz_vec(ws, poly, d + 1, ys, num, ctx);
+
+    fmpz_one(g);
+    for (i = 0; i < num; i++)
+        fmpz_mod_mul(g, g, ws + i, ctx);
+
+    fmpz_gcd(g, g, N);
+
+    if (!fmpz_is_one(g) && !fmpz_equal(g, N))
+        ret = _ecm_set_fmpz(f, g, ecm_inf);
+
+cleanup:
+
+    _fmpz_vec_clear(xs, d);
+    _fmpz_vec_clear(zs, d);
+    _fmpz_vec_clear(ys, num);
+    _fmpz_vec_clear(ws, num);
+    _fmpz_vec_clear(poly, d + 1);
+
+    fmpz_mod_ctx_clear(ctx);
+    fmpz_clear(g);
+    fmpz_clear(N);
+
+    flint_free(arrx);
+    flint_free(arrz);
+
+    TMP_END;
+
+    return ret;
+}
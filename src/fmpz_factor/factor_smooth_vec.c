@@ -0,0 +1,210 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "thread_support.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "fmpz_factor.h"
+
+/*
+   Bernstein's batch smoothness test. With P the product of the primes up
+   to B, the remainders P mod x_i are computed with a remainder tree over
+   the product tree of the inputs. The B-smooth part of x is then
+   gcd(P^(2^e) mod x, x) for any e with 2^e at least the number of bits
+   of x.
+
+   The inputs are split into chunks whose product has about as many bits
+   as P, so that reducing P modulo the top of the tree is not much more
+   expensive than the tree itself. The chunks are independent and are
+   shared out between threads.
+*/
+
+/* don't make chunks smaller than this many bits */
+#define SMOOTH_VEC_MIN_CHUNK_BITS 4096
+
+/* smooth parts of the len entries of vec, all of absolute value > 1 */
+static void
+_fmpz_factor_smooth_vec_tree(fmpz * res, const fmpz * vec, slong len,
+                                                            const fmpz_t P)
+{
+    fmpz * tree, * rem, * rem2, * t;
+    slong * off;
+    slong i, k, depth, m;
+    flint_bitcnt_t b, bits;
+
+    /* number of levels above the leaves */
+    for (depth = 0, m = len; m > 1; depth++)
+        m = (m + 1)/2;
+
+    off = flint_malloc((depth + 2)*sizeof(slong));
+
+    off[0] = 0;
+    for (k = 0, m = len; k <= depth; k++, m = (m + 1)/2)
+        off[k + 1] = off[k] + m;
+
+    tree = _fmpz_vec_init(off[depth + 1]);
+    rem = _fmpz_vec_init(len);
+    rem2 = _fmpz_vec_init(len);
+
+    /* product tree */
+    for (i = 0; i < len; i++)
+        fmpz_abs(tree + i, vec + i);
+
+    for (k = 0, m = len; k < depth; k++, m = (m + 1)/2)
+    {
+        for (i = 0; i + 1 < m; i += 2)
+            fmpz_mul(tree + off[k + 1] + i/2, tree + off[k] + i,
+                                              tree + off[k] + i + 1);
+        if (m % 2 == 1)
+            fmpz_set(tree + off[k + 1] + m/2, tree + off[k] + m - 1);
+    }
+
+    /* remainder tree */
+    fmpz_mod(rem + 0, P, tree + off[depth]);
+
+    for (k = depth - 1; k >= 0; k--)
+    {
+        m = off[k + 1] - off[k];
+
+        for (i = 0; i < m; i++)
+            fmpz_mod(rem2 + i, rem + i/2, tree + off[k] + i);
+
+        t = rem;
+        rem = rem2;
+        rem2 = t;
+    }
+
+    for (i = 0; i < len; i++)
+    {
+        bits = fmpz_bits(tree + i);
+
+        for (b = 1; b < bits && !fmpz_is_zero(rem + i); b *= 2)
+        {
+            fmpz_mul(rem + i, rem + i, rem + i);
+            fmpz_mod(rem + i, rem + i, tree + i);
+        }
+
+        fmpz_gcd(res + i, rem + i, tree + i);
+    }
+
+    _fmpz_vec_clear(tree, off[depth + 1]);
+    _fmpz_vec_clear(rem, len);
+    _fmpz_vec_clear(rem2, len);
+    flint_free(off);
+}
+
+typedef struct
+{
+    fmpz * res;
+    const fmpz * vec;
+    const slong * start;  /* chunk i is start[i] <= j < start[i + 1] */
+    const fmpz * P;
+}
+work_t;
+
+static void
+_fmpz_factor_smooth_vec_chunk(fmpz * res, const fmpz * vec, slong len,
+                                                            const fmpz_t P)
+{
+    fmpz * t, * s;
+    slong * idx;
+    slong i, m;
+
+    t = _fmpz_vec_init(len);
+    s = _fmpz_vec_init(len);
+    idx = flint_malloc(len*sizeof(slong));
+
+    for (i = 0, m = 0; i < len; i++)
+    {
+        if (fmpz_bits(vec + i) <= 1)   /* 0 and +-1 */
+        {
+            fmpz_abs(res + i, vec + i);
+        }
+        else
+        {
+            fmpz_set(t + m, vec + i);
+            idx[m++] = i;
+        }
+    }
+
+    if (m > 0)
+    {
+        _fmpz_factor_smooth_vec_tree(s, t, m, P);
+
+        for (i = 0; i < m; i++)
+            fmpz_swap(res + idx[i], s + i);
+    }
+
+    _fmpz_vec_clear(t, len);
+    _fmpz_vec_clear(s, len);
+    flint_free(idx);
+}
+
+static void
+worker(slong i, void * args)
+{
+    work_t * w = (work_t *) args;
+    slong a = w->start[i], b = w->start[i + 1];
+
+    _fmpz_factor_smooth_vec_chunk(w->res + a, w->vec + a, b - a, w->P);
+}
+
+void
+fmpz_factor_smooth_vec(fmpz * res, const fmpz * vec, slong len, ulong B)
+{
+    fmpz_t P;
+    slong * start;
+    slong i, num;
+    flint_bitcnt_t chunk_bits, bits;
+
+    if (len <= 0)
+        return;
+
+    fmpz_init(P);
+    fmpz_primorial(P, B);
+
+    chunk_bits = FLINT_MAX(fmpz_bits(P), SMOOTH_VEC_MIN_CHUNK_BITS);
+
+    start = flint_malloc((len + 1)*sizeof(slong));
+
+    start[0] = 0;
+    for (i = 0, num = 0, bits = 0; i < len; i++)
+    {
+        bits += fmpz_bits(vec + i);
+
+        if (bits >= chunk_bits || i == len - 1)
+        {
+            start[++num] = i + 1;
+            bits = 0;
+        }
+    }
+
+    if (num > 1 && flint_get_num_threads() > 1)
+    {
+        work_t work[1];
+
+        work->res = res;
+        work->vec = vec;
+        work->start = start;
+        work->P = P;
+
+        flint_parallel_do(worker, work, num, 0, FLINT_PARALLEL_DYNAMIC);
+    }
+    else
+    {
+        for (i = 0; i < num; i++)
+            _fmpz_factor_smooth_vec_chunk(res + start[i], vec + start[i],
+                                              start[i + 1] - start[i], P);
+    }
+
+    flint_free(start);
+    fmpz_clear(P);
+}
@@ -40,6 +40,8 @@ int main(void)
 
             fmpz_mul(primeprod, prime1, prime2);
 
+            flint_set_num_threads(n_randint(state, 4) + 1);
+
             k = fmpz_factor_ecm(fac, i << 2, 2000, 50000, state, primeprod);
 
             if (k == 0)
@@ -69,6 +71,41 @@ int main(void)
         flint_abort();
     }
 
+    /* B2 large enough for stage II by fast polynomial evaluation */
+    fails = 0;
+
+    for (j = 0; j < flint_test_multiplier(); j++)
+    {
+        fmpz_set_ui(prime1, n_randprime(state, 55, 1));
+        fmpz_set_ui(prime2, n_randprime(state, 55, 1));
+
+        fmpz_mul(primeprod, prime1, prime2);
+
+        flint_set_num_threads(n_randint(state, 4) + 1);
+
+        k = fmpz_factor_ecm(fac, 100, 2000, 500000, state, primeprod);
+
+        if (k == 0)
+            fails += 1;
+        else if (!fmpz_equal(fac, prime1) && !fmpz_equal(fac, prime2))
+        {
+            printf("FAIL : Wrong factor calculated\n");
+            printf("n : ");
+            fmpz_print(primeprod);
+            printf(" factor calculated : ");
+            fmpz_print(fac);
+            fflush(stdout);
+            flint_abort();
+        }
+    }
+
+    if (fails > flint_test_multiplier() / 2)
+    {
+        printf("FAIL : ECM with large B2 failed too many times (%d times)\n", fails);
+        fflush(stdout);
+        flint_abort();
+    }
+
     /* Tests for hangs and crashes, don't care about result */
 
 #if FLINT64
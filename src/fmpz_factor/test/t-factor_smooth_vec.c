@@ -0,0 +1,138 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "fmpz_factor.h"
+
+/* B-smooth part of |n| by trial division */
+void smooth_part(fmpz_t s, const fmpz_t n, ulong B)
+{
+    fmpz_t t;
+    n_primes_t iter;
+    ulong p;
+
+    fmpz_init(t);
+    fmpz_abs(t, n);
+    fmpz_one(s);
+
+    if (fmpz_is_zero(t))
+    {
+        fmpz_zero(s);
+        fmpz_clear(t);
+        return;
+    }
+
+    n_primes_init(iter);
+
+    while ((p = n_primes_next(iter)) <= B)
+    {
+        while (fmpz_fdiv_ui(t, p) == 0)
+        {
+            fmpz_divexact_ui(t, t, p);
+            fmpz_mul_ui(s, s, p);
+        }
+    }
+
+    n_primes_clear(iter);
+    fmpz_clear(t);
+}
+
+int main(void)
+{
+    slong iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("factor_smooth_vec....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 200 * flint_test_multiplier(); iter++)
+    {
+        fmpz * vec, * res;
+        fmpz_t s;
+        slong i, j, len, k;
+        ulong B, p;
+
+        len = n_randint(state, 100);
+        B = n_randint(state, 3000);
+
+        flint_set_num_threads(n_randint(state, 4) + 1);
+
+        vec = _fmpz_vec_init(len);
+        res = _fmpz_vec_init(len);
+        fmpz_init(s);
+
+        for (i = 0; i < len; i++)
+        {
+            switch (n_randint(state, 8))
+            {
+                case 0:
+                    fmpz_randtest(vec + i, state, 3);
+                    break;
+                case 1:
+                    fmpz_randtest(vec + i, state, 200);
+                    break;
+                default:
+                    /* a product of small primes, possibly times a cofactor */
+                    fmpz_one(vec + i);
+                    k = n_randint(state, 30);
+                    for (j = 0; j < k; j++)
+                    {
+                        p = n_nextprime(n_randint(state, 2*B + 2), 1);
+                        fmpz_mul_ui(vec + i, vec + i, p);
+                    }
+                    if (n_randint(state, 2))
+                    {
+                        fmpz_randtest_not_zero(s, state, 100);
+                        fmpz_mul(vec + i, vec + i, s);
+                    }
+                    if (n_randint(state, 2))
+                        fmpz_neg(vec + i, vec + i);
+            }
+        }
+
+        if (n_randint(state, 2))
+        {
+            fmpz_factor_smooth_vec(res, vec, len, B);
+        }
+        else
+        {
+            _fmpz_vec_set(res, vec, len);
+            fmpz_factor_smooth_vec(res, res, len, B);
+        }
+
+        for (i = 0; i < len; i++)
+        {
+            smooth_part(s, vec + i, B);
+
+            if (!fmpz_equal(s, res + i))
+            {
+                flint_printf("FAIL:\n");
+                flint_printf("B = %wu, i = %wd\n", B, i);
+                flint_printf("n = "); fmpz_print(vec + i); flint_printf("\n");
+                flint_printf("res = "); fmpz_print(res + i); flint_printf("\n");
+                flint_printf("expected = "); fmpz_print(s); flint_printf("\n");
+                fflush(stdout);
+                flint_abort();
+            }
+        }
+
+        _fmpz_vec_clear(vec, len);
+        _fmpz_vec_clear(res, len);
+        fmpz_clear(s);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
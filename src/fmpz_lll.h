@@ -160,6 +160,14 @@ int fmpz_lll_with_removal(fmpz_mat_t B, fmpz_mat_t U, const fmpz_t gs_B, const f
 
 void fmpz_lll_storjohann_ulll(fmpz_mat_t FM, slong new_size, const fmpz_lll_t fl);
 
+/* BKZ  **********************************************************************/
+
+/* Block size from which BKZ prunes the enumeration */
+#define FMPZ_LLL_BKZ_PRUNE_CUTOFF 30
+
+void fmpz_lll_bkz(fmpz_mat_t B, fmpz_mat_t U, slong block_size,
+                  slong max_tours, const fmpz_lll_t fl);
+
 #ifdef __cplusplus
 }
 #endif
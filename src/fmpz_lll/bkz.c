@@ -0,0 +1,557 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include <math.h>
+#include "double_extras.h"
+#include "d_vec.h"
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "fmpz_mat.h"
+#include "thread_support.h"
+#include "fmpz_lll.h"
+
+/*
+    Plain BKZ: each block is LLL-reduced and searched for a shorter first
+    vector by Schnorr-Euchner enumeration, with a linearly pruned search
+    for blocks of at least FMPZ_LLL_BKZ_PRUNE_CUTOFF rows. Tours end once
+    one of them changes nothing or, as in fplll, once the logarithms of the
+    squared GSO norms stop getting flatter. Of the improvements of BKZ 2.0
+    (Chen and Nguyen) only this early termination is used; there is no
+    recursive preprocessing of the blocks, extreme pruning or
+    rerandomisation.
+
+    The Gram-Schmidt orthogonalisation (GSO) of the basis scaled by
+    2^-expo is kept in doubles. Row i is computed from the products of
+    row i with the previous rows, taken from floating-point approximations
+    of the rows unless there is too much cancellation. The first S->valid
+    rows are LLL-reduced and have an up to date GSO, so that LLL-reducing
+    the first rows only revisits the rows from S->valid on.
+
+    A vector found by enumeration is inserted by a unimodular
+    transformation of its block, so no linear dependency has to be removed.
+    A loss of precision only ends the tours early: the basis is always
+    LLL-reduced by fmpz_lll at the end.
+
+    Only the products in this private LLL are threaded; fmpz_lll itself,
+    which is also used for the final reduction, is not.
+*/
+
+/* number of products from which the products of a row with the previous
+   rows are split between threads */
+#define BKZ_GSO_PARALLEL_CUTOFF 50000
+
+/* tours without progress before stopping */
+#define BKZ_AUTO_ABORT_TOURS 5
+
+/* size reduction passes before giving up */
+#define BKZ_MAX_SIZE_RED 20
+
+typedef struct
+{
+    fmpz_mat_struct * B;
+    fmpz_mat_struct * U;
+    d_mat_t appB;
+    slong * rexp;
+    double * rnorm;
+    slong z;
+    slong valid;
+    slong expo;
+    double delta;
+    double eta;
+    d_mat_t mu;
+    d_mat_t r;
+    double * g;
+    slong row;
+    slong chunk;
+}
+_bkz_struct;
+
+/* row i is approximated by appB[i] 2^rexp[i], of squared norm rnorm[i] */
+static void
+_bkz_approx_row(_bkz_struct * S, slong i)
+{
+    S->rexp[i] = _fmpz_vec_get_d_vec_2exp(S->appB->rows[i], S->B->rows[i],
+                                                                    S->B->c);
+    S->rnorm[i] = _d_vec_norm(S->appB->rows[i], S->B->c);
+}
+
+/*
+    Sets g[j] = <b_i, b_j> 2^(-2 expo) for j in a chunk of rows, from the
+    approximations unless there is too much cancellation
+*/
+static void
+_bkz_dot_worker(slong t, void * arg)
+{
+    _bkz_struct * S = (_bkz_struct *) arg;
+    slong i = S->row, j, j0, j1, e;
+    double s;
+    fmpz_t d;
+
+    j0 = S->z + t * S->chunk;
+    j1 = FLINT_MIN(j0 + S->chunk, i + 1);
+
+    fmpz_init(d);
+
+    for (j = j0; j < j1; j++)
+    {
+        s = _d_vec_dot(S->appB->rows[i], S->appB->rows[j], S->B->c);
+
+        if (s * s <= ldexp(S->rnorm[i] * S->rnorm[j], -70))
+        {
+            _fmpz_vec_dot(d, S->B->rows[i], S->B->rows[j], S->B->c);
+            s = fmpz_get_d_2exp(&e, d);
+            S->g[j] = ldexp(s, e - 2 * S->expo);
+        }
+        else
+        {
+            S->g[j] = ldexp(s, S->rexp[i] + S->rexp[j] - 2 * S->expo);
+        }
+    }
+
+    fmpz_clear(d);
+}
+
+/* computes row i of the GSO, returns 0 if r_ii is not positive */
+static int
+_bkz_gso_row(_bkz_struct * S, slong i)
+{
+    double * ri = S->r->rows[i];
+    double * mui = S->mu->rows[i];
+    slong j, l, len, num;
+    double s;
+
+    len = i - S->z + 1;
+    num = 1;
+
+    if (len * S->B->c >= BKZ_GSO_PARALLEL_CUTOFF)
+        num = FLINT_MIN(flint_get_num_threads(), len / 16);
+
+    S->row = i;
+
+    if (num <= 1)
+    {
+        S->chunk = len;
+        _bkz_dot_worker(0, S);
+    }
+    else
+    {
+        S->chunk = (len + num - 1) / num;
+        num = (len + S->chunk - 1) / S->chunk;
+        flint_parallel_do(_bkz_dot_worker, S, num, 0, FLINT_PARALLEL_UNIFORM);
+    }
+
+    for (j = S->z; j <= i; j++)
+    {
+        s = S->g[j];
+
+        for (l = S->z; l < j; l++)
+            s -= S->mu->rows[j][l] * ri[l];
+
+        ri[j] = s;
+
+        if (j < i)
+            mui[j] = s / S->r->rows[j][j];
+    }
+
+    return ri[i] > 0.0 && ri[i] < D_INF;
+}
+
+/* b_i = b_i - X b_j, without updating the approximation of b_i */
+static void
+_bkz_row_submul(_bkz_struct * S, slong i, slong j, const fmpz_t X)
+{
+    _fmpz_vec_scalar_submul_fmpz(S->B->rows[i], S->B->rows[j], S->B->c, X);
+
+    if (S->U != NULL)
+        _fmpz_vec_scalar_submul_fmpz(S->U->rows[i], S->U->rows[j], S->U->c, X);
+}
+
+static int
+_bkz_size_reduce(_bkz_struct * S, slong i)
+{
+    double * mui = S->mu->rows[i];
+    double m, x;
+    slong j, l, iter;
+    fmpz_t X;
+    int res = 0;
+
+    fmpz_init(X);
+
+    for (iter = 0; iter < BKZ_MAX_SIZE_RED; iter++)
+    {
+        if (!_bkz_gso_row(S, i))
+            break;
+
+        m = 0.0;
+        for (j = S->z; j < i; j++)
+            m = FLINT_MAX(m, fabs(mui[j]));
+
+        if (m <= S->eta)
+        {
+            res = 1;
+            break;
+        }
+
+        if (!(m < D_INF))
+            break;
+
+        for (j = i - 1; j >= S->z; j--)
+        {
+            x = floor(mui[j] + 0.5);
+
+            if (x == 0.0)
+                continue;
+
+            fmpz_set_d(X, x);
+            _bkz_row_submul(S, i, j, X);
+
+            for (l = S->z; l < j; l++)
+                mui[l] -= x * S->mu->rows[j][l];
+            mui[j] -= x;
+        }
+
+        _bkz_approx_row(S, i);
+    }
+
+    fmpz_clear(X);
+
+    return res;
+}
+
+static void
+_bkz_swap_rows(_bkz_struct * S, slong i, slong j)
+{
+    fmpz_mat_swap_rows(S->B, NULL, i, j);
+
+    if (S->U != NULL)
+        fmpz_mat_swap_rows(S->U, NULL, i, j);
+
+    {
+        double * t = S->appB->rows[i];
+        S->appB->rows[i] = S->appB->rows[j];
+        S->appB->rows[j] = t;
+    }
+
+    SLONG_SWAP(S->rexp[i], S->rexp[j]);
+    DOUBLE_SWAP(S->rnorm[i], S->rnorm[j]);
+}
+
+/* LLL-reduces the first end rows, returns 0 on loss of precision */
+static int
+_bkz_lll(_bkz_struct * S, slong end)
+{
+    slong i = S->valid;
+    double a, m;
+
+    while (i < end)
+    {
+        if (!_bkz_size_reduce(S, i))
+        {
+            S->valid = i;
+            return 0;
+        }
+
+        if (i > S->z)
+        {
+            a = S->r->rows[i - 1][i - 1];
+            m = S->mu->rows[i][i - 1];
+
+            if (S->delta * a > S->r->rows[i][i] + m * m * a)
+            {
+                _bkz_swap_rows(S, i - 1, i);
+                i--;
+                continue;
+            }
+        }
+
+        i++;
+    }
+
+    S->valid = FLINT_MAX(S->valid, end);
+
+    return 1;
+}
+
+/*
+    Searches for x with the projection of sum x_i b_(k+i) orthogonally to
+    b_0, ..., b_(k-1) of squared norm less than *R, enumerating the tree
+    of partial sums depth first from the top level. The bound at level i
+    is scaled by prune[i]. Returns 1 and updates *R if such x is found.
+*/
+static int
+_bkz_enum(double * sol, double * R, const _bkz_struct * S, slong k,
+                                    slong bs, const double * prune, double * w)
+{
+    double * x = w;
+    double * c = x + bs;
+    double * l = c + bs;
+    double * dx = l + bs + 1;
+    double * ddx = dx + bs;
+    double s, y, bound = *R;
+    slong i, j, top = 0;
+    int found = 0;
+
+    for (i = 0; i < bs; i++)
+    {
+        x[i] = c[i] = dx[i] = 0.0;
+        ddx[i] = 1.0;
+    }
+
+    for (i = 0; i <= bs; i++)
+        l[i] = 0.0;
+
+    x[0] = 1.0;
+    i = 0;
+
+    for (;;)
+    {
+        y = x[i] - c[i];
+        l[i] = l[i + 1] + y * y * S->r->rows[k + i][k + i];
+
+        if (l[i] < bound * prune[i])
+        {
+            if (i != 0)
+            {
+                i--;
+
+                s = 0.0;
+                for (j = i + 1; j <= top; j++)
+                    s -= x[j] * S->mu->rows[k + j][k + i];
+
+                c[i] = s;
+                x[i] = floor(s + 0.5);
+                dx[i] = ddx[i] = (s >= x[i]) ? 1.0 : -1.0;
+                continue;
+            }
+
+            found = 1;
+            bound = l[0];
+            for (j = 0; j < bs; j++)
+                sol[j] = x[j];
+        }
+        else
+        {
+            i++;
+            if (i == bs)
+                break;
+        }
+
+        /* next candidate at level i; above top only positive ones */
+        if (i >= top)
+        {
+            top = i;
+            x[i] += 1.0;
+        }
+        else
+        {
+            x[i] += dx[i];
+            ddx[i] = -ddx[i];
+            dx[i] = ddx[i] - dx[i];
+        }
+    }
+
+    *R = bound;
+
+    return found;
+}
+
+/* makes b_k = sum x_i b_(k+i) by a unimodular transformation of the block */
+static void
+_bkz_insert(_bkz_struct * S, slong k, slong * x, slong bs)
+{
+    slong j, p;
+    fmpz_t q;
+    int done;
+
+    fmpz_init(q);
+
+    do
+    {
+        p = -1;
+        for (j = 0; j < bs; j++)
+            if (x[j] != 0 && (p < 0 || FLINT_ABS(x[j]) < FLINT_ABS(x[p])))
+                p = j;
+
+        done = 1;
+
+        /* with q = -(x_j / x_p) rounded towards zero,
+           x_p b_p + x_j b_j = x_p (b_p - q b_j) + (x_j + q x_p) b_j */
+        for (j = 0; j < bs; j++)
+        {
+            if (j == p || x[j] == 0)
+                continue;
+
+            fmpz_set_si(q, -(x[j] / x[p]));
+            x[j] += fmpz_get_si(q) * x[p];
+            _bkz_row_submul(S, k + p, k + j, q);
+
+            done = 0;
+        }
+    }
+    while (!done);
+
+    for (j = 0; j < bs; j++)
+        _bkz_approx_row(S, k + j);
+
+    /* now b_p = x_p v with x_p = +-1 */
+    for (j = p; j > 0; j--)
+        _bkz_swap_rows(S, k + j - 1, k + j);
+
+    fmpz_clear(q);
+
+    S->valid = FLINT_MIN(S->valid, k);
+}
+
+/* minus the slope of the least squares fit of log r_ii, which decreases
+   as the basis gets more reduced */
+static double
+_bkz_slope(const _bkz_struct * S, slong n)
+{
+    double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0, y;
+    slong i, len = n - S->z;
+
+    for (i = 0; i < len; i++)
+    {
+        y = log(S->r->rows[S->z + i][S->z + i]);
+        sx += i;
+        sy += y;
+        sxx += (double) i * i;
+        sxy += i * y;
+    }
+
+    return -(len * sxy - sx * sy) / (len * sxx - sx * sx);
+}
+
+void
+fmpz_lll_bkz(fmpz_mat_t B, fmpz_mat_t U, slong block_size, slong max_tours,
+                                                        const fmpz_lll_t fl)
+{
+    _bkz_struct S[1];
+    slong n = B->r, k, bs, kend, i, tour;
+    slong * xi;
+    double * sol, * prune, * w;
+    double R, slope, best_slope = D_INF;
+    slong stuck = 0;
+    ulong g;
+    int clean;
+
+    if (fl->rt != Z_BASIS)
+    {
+        flint_printf("Exception (fmpz_lll_bkz). Input must be a lattice basis.\n");
+        flint_abort();
+    }
+
+    fmpz_lll(B, U, fl);
+
+    if (block_size < 3 || n < 3)
+        return;
+
+    block_size = FLINT_MIN(block_size, n);
+
+    S->B = B;
+    S->U = U;
+    S->delta = fl->delta;
+    S->eta = fl->eta;
+
+    for (S->z = 0; S->z < n && _fmpz_vec_is_zero(B->rows[S->z], B->c); S->z++) ;
+
+    S->valid = S->z;
+    S->expo = FLINT_MAX(0, FLINT_ABS(fmpz_mat_max_bits(B)) - 400);
+
+    d_mat_init(S->mu, n, n);
+    d_mat_init(S->r, n, n);
+    d_mat_init(S->appB, n, B->c);
+    S->rexp = flint_malloc(sizeof(slong) * n);
+    S->rnorm = flint_malloc(sizeof(double) * n);
+    S->g = flint_malloc(sizeof(double) * n);
+
+    for (i = S->z; i < n; i++)
+        _bkz_approx_row(S, i);
+
+    xi = flint_malloc(sizeof(slong) * block_size);
+    sol = flint_malloc(sizeof(double) * block_size);
+    prune = flint_malloc(sizeof(double) * block_size);
+    w = flint_malloc(sizeof(double) * (5 * block_size + 1));
+
+    for (tour = 0; max_tours <= 0 || tour < max_tours; tour++)
+    {
+        clean = 1;
+
+        for (k = S->z; k < n - 1; k++)
+        {
+            kend = FLINT_MIN(k + block_size, n);
+            bs = kend - k;
+
+            if (!_bkz_lll(S, kend))
+                goto cleanup;
+
+            /* the bound falls linearly from R to R/2 over the top half of
+               the levels; plain linear pruning down to R/bs misses most of
+               the improvements, whose top projections are not that short */
+            for (i = 0; i < bs; i++)
+                prune[i] = (block_size >= FMPZ_LLL_BKZ_PRUNE_CUTOFF) ?
+                        FLINT_MIN(1.0, (double) (bs - i) / bs + 0.5) : 1.0;
+
+            R = S->delta * S->r->rows[k][k];
+
+            if (!_bkz_enum(sol, &R, S, k, bs, prune, w))
+                continue;
+
+            g = 0;
+            for (i = 0; i < bs; i++)
+            {
+                xi[i] = (slong) sol[i];
+                g = n_gcd(g, FLINT_ABS(xi[i]));
+            }
+
+            for (i = 0; i < bs; i++)
+                xi[i] /= (slong) g;
+
+            _bkz_insert(S, k, xi, bs);
+            clean = 0;
+        }
+
+        if (clean || !_bkz_lll(S, n))
+            break;
+
+        /* without a limit, stop once the slope has not decreased for
+           BKZ_AUTO_ABORT_TOURS tours */
+        if (max_tours <= 0)
+        {
+            slope = _bkz_slope(S, n);
+
+            if (slope >= best_slope)
+                stuck++;
+            else
+                stuck = 0;
+
+            best_slope = FLINT_MIN(best_slope, slope);
+
+            if (stuck >= BKZ_AUTO_ABORT_TOURS)
+                break;
+        }
+    }
+
+cleanup:
+    d_mat_clear(S->mu);
+    d_mat_clear(S->r);
+    d_mat_clear(S->appB);
+    flint_free(S->rexp);
+    flint_free(S->rnorm);
+    flint_free(S->g);
+    flint_free(xi);
+    flint_free(sol);
+    flint_free(prune);
+    flint_free(w);
+
+    fmpz_lll(B, U, fl);
+}
@@ -0,0 +1,261 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "ulong_extras.h"
+#include "fmpz.h"
+#include "fmpz_vec.h"
+#include "fmpz_mat.h"
+#include "thread_support.h"
+#include "fmpz_lll.h"
+
+int
+main(void)
+{
+    slong i;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("bkz....");
+    fflush(stdout);
+
+    /* rank deficient matrices */
+    {
+        fmpz_mat_t mat;
+        fmpz_lll_t fl;
+
+        fmpz_mat_init(mat, 3, 3);
+        fmpz_lll_context_init_default(fl);
+
+        fmpz_mat_zero(mat);
+        fmpz_set_ui(fmpz_mat_entry(mat, 1, 0), 4);
+        fmpz_set_ui(fmpz_mat_entry(mat, 2, 0), 6);
+        fmpz_lll_bkz(mat, NULL, 3, 0, fl);
+        fmpz_abs(fmpz_mat_entry(mat, 2, 0), fmpz_mat_entry(mat, 2, 0));
+        fmpz_sub_ui(fmpz_mat_entry(mat, 2, 0), fmpz_mat_entry(mat, 2, 0), 2);
+
+        if (!fmpz_mat_is_zero(mat))
+        {
+            flint_printf("FAIL: check gcd(4,6)=2\n");
+            fflush(stdout);
+            flint_abort();
+        }
+
+        fmpz_mat_clear(mat);
+    }
+
+    /* the result is a reduced basis of the same lattice */
+    for (i = 0; i < 10 * flint_test_multiplier(); i++)
+    {
+        fmpz_mat_t A, B, C, U;
+        fmpz_lll_t fl;
+        fmpz_t d;
+        slong r, c, bs, tours;
+
+        fmpz_lll_randtest(fl, state);
+        fl->rt = Z_BASIS;
+
+        switch (n_randint(state, 3))
+        {
+            case 0:
+                r = n_randint(state, 25) + 1;
+                c = r + 1;
+                fmpz_mat_init(A, r, c);
+                fmpz_mat_randintrel(A, state, n_randint(state, 200) + 1);
+                break;
+            case 1:
+                r = 2 * (n_randint(state, 12) + 1);
+                c = r;
+                fmpz_mat_init(A, r, c);
+                fmpz_mat_randntrulike(A, state, n_randint(state, 20) + 1,
+                                                    n_randint(state, 200) + 1);
+                break;
+            default:
+                r = n_randint(state, 25) + 1;
+                c = r;
+                fmpz_mat_init(A, r, c);
+                fmpz_mat_randajtai(A, state, 0.5);
+                break;
+        }
+
+        fmpz_mat_init_set(B, A);
+        fmpz_mat_init(C, r, c);
+        fmpz_mat_init(U, r, r);
+        fmpz_mat_one(U);
+        fmpz_init(d);
+
+        bs = n_randint(state, r + 2);
+        tours = n_randint(state, 4);
+        flint_set_num_threads(n_randint(state, 4) + 1);
+
+        fmpz_lll_bkz(B, U, bs, tours, fl);
+
+        fmpz_mat_mul(C, U, A);
+        fmpz_mat_det(d, U);
+
+        if (!fmpz_mat_equal(B, C) || !fmpz_is_pm1(d))
+        {
+            flint_printf("FAIL: not a unimodular transformation\n");
+            flint_printf("r = %wd, bs = %wd, tours = %wd\n", r, bs, tours);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        if (!fmpz_mat_is_reduced(B, fl->delta, fl->eta))
+        {
+            flint_printf("FAIL: not LLL-reduced\n");
+            flint_printf("r = %wd, bs = %wd, tours = %wd\n", r, bs, tours);
+            flint_printf("delta = %g, eta = %g\n", fl->delta, fl->eta);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        fmpz_mat_clear(A);
+        fmpz_mat_clear(B);
+        fmpz_mat_clear(C);
+        fmpz_mat_clear(U);
+        fmpz_clear(d);
+    }
+
+    /* pruned enumeration, and Gram-Schmidt products split between threads */
+    for (i = 0; i < 2 * flint_test_multiplier(); i++)
+    {
+        fmpz_mat_t A, B, C, U;
+        fmpz_lll_t fl;
+        fmpz_t d;
+        slong r, c, bs;
+
+        fmpz_lll_context_init_default(fl);
+
+        r = FMPZ_LLL_BKZ_PRUNE_CUTOFF + n_randint(state, 6);
+
+        if (i % 2 == 0)
+        {
+            c = r + 1;
+            fmpz_mat_init(A, r, c);
+            fmpz_mat_randintrel(A, state, 4 * r + n_randint(state, 40));
+        }
+        else
+        {
+            /* r c products per row are enough to use several threads */
+            c = 50000 / r + 1 + n_randint(state, 100);
+            fmpz_mat_init(A, r, c);
+            fmpz_mat_randtest(A, state, n_randint(state, 20) + 1);
+        }
+
+        fmpz_mat_init_set(B, A);
+        fmpz_mat_init(C, r, c);
+        fmpz_mat_init(U, r, r);
+        fmpz_mat_one(U);
+        fmpz_init(d);
+
+        bs = FMPZ_LLL_BKZ_PRUNE_CUTOFF
+                    + n_randint(state, r - FMPZ_LLL_BKZ_PRUNE_CUTOFF + 1);
+        flint_set_num_threads(n_randint(state, 3) + 2);
+
+        fmpz_lll_bkz(B, U, bs, 1 + n_randint(state, 2), fl);
+
+        fmpz_mat_mul(C, U, A);
+        fmpz_mat_det(d, U);
+
+        if (!fmpz_mat_equal(B, C) || !fmpz_is_pm1(d))
+        {
+            flint_printf("FAIL: not a unimodular transformation (large)\n");
+            flint_printf("r = %wd, c = %wd, bs = %wd\n", r, c, bs);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        if (!fmpz_mat_is_reduced(B, fl->delta, fl->eta))
+        {
+            flint_printf("FAIL: not LLL-reduced (large)\n");
+            flint_printf("r = %wd, c = %wd, bs = %wd\n", r, c, bs);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        fmpz_mat_clear(A);
+        fmpz_mat_clear(B);
+        fmpz_mat_clear(C);
+        fmpz_mat_clear(U);
+        fmpz_clear(d);
+    }
+
+    flint_set_num_threads(1);
+
+    /* with a single block, no small combination is much shorter than b_0 */
+    for (i = 0; i < 10 * flint_test_multiplier(); i++)
+    {
+        fmpz_mat_t A;
+        fmpz_lll_t fl;
+        fmpz * v;
+        fmpz_t n0, nv;
+        slong r, j, l, e, num;
+        slong x[8];
+
+        r = n_randint(state, 5) + 2;
+
+        fmpz_lll_context_init_default(fl);
+        fmpz_mat_init(A, r, r + 1);
+        fmpz_mat_randintrel(A, state, n_randint(state, 10 * r) + 10);
+
+        fmpz_lll_bkz(A, NULL, r, 0, fl);
+
+        v = _fmpz_vec_init(r + 1);
+        fmpz_init(n0);
+        fmpz_init(nv);
+
+        _fmpz_vec_dot(n0, A->rows[0], A->rows[0], r + 1);
+
+        /* all x in [-2, 2]^r */
+        for (num = 1, j = 0; j < r; j++)
+            num *= 5;
+
+        for (e = 1; e < num; e++)
+        {
+            slong t = e;
+
+            for (j = 0; j < r; j++)
+            {
+                x[j] = t % 5 - 2;
+                t /= 5;
+            }
+
+            _fmpz_vec_zero(v, r + 1);
+            for (j = 0; j < r; j++)
+                _fmpz_vec_scalar_addmul_si(v, A->rows[j], r + 1, x[j]);
+
+            if (_fmpz_vec_is_zero(v, r + 1))
+                continue;
+
+            _fmpz_vec_dot(nv, v, v, r + 1);
+
+            if (fmpz_get_d(nv) < 0.999 * fl->delta * fmpz_get_d(n0))
+            {
+                flint_printf("FAIL: shorter vector\n");
+                fmpz_mat_print_pretty(A);
+                for (l = 0; l < r; l++)
+                    flint_printf("%wd ", x[l]);
+                flint_printf("\n");
+                fflush(stdout);
+                flint_abort();
+            }
+        }
+
+        _fmpz_vec_clear(v, r + 1);
+        fmpz_clear(n0);
+        fmpz_clear(nv);
+        fmpz_mat_clear(A);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -9,21 +9,33 @@
     (at your option) any later version.  See <https://www.gnu.org/licenses/>.
 */
 
+#include "thread_support.h"
 #include "nmod_vec.h"
 #include "nmod_mat.h"
 #include "fmpz.h"
 #include "fmpz_mat.h"
 
-void
-fmpz_mat_multi_mod_ui_precomp(nmod_mat_t * residues, slong nres,
-    const fmpz_mat_t mat, const fmpz_comb_t comb, fmpz_comb_temp_t temp)
+typedef struct
+{
+    nmod_mat_t * residues;
+    slong nres;
+    const fmpz_mat_struct * mat;
+    const fmpz_comb_struct * comb;
+    slong block;
+}
+work_t;
+
+static void
+_fmpz_mat_multi_mod_ui_rows(nmod_mat_t * residues, slong nres,
+    const fmpz_mat_t mat, slong start, slong stop,
+    const fmpz_comb_t comb, fmpz_comb_temp_t temp)
 {
     slong i, j, k;
     mp_ptr r;
 
     r = _nmod_vec_init(nres);
 
-    for (i = 0; i < fmpz_mat_nrows(mat); i++)
+    for (i = start; i < stop; i++)
     {
         for (j = 0; j < fmpz_mat_ncols(mat); j++)
         {
@@ -36,6 +48,53 @@ fmpz_mat_multi_mod_ui_precomp(nmod_mat_t * residues, slong nres,
     _nmod_vec_clear(r);
 }
 
+static void
+worker(slong b, void * args)
+{
+    work_t * w = (work_t *) args;
+    slong start, stop;
+    fmpz_comb_temp_t temp;
+
+    start = b * w->block;
+    stop = FLINT_MIN(fmpz_mat_nrows(w->mat), start + w->block);
+
+    fmpz_comb_temp_init(temp, w->comb);
+    _fmpz_mat_multi_mod_ui_rows(w->residues, w->nres, w->mat, start, stop,
+                                                               w->comb, temp);
+    fmpz_comb_temp_clear(temp);
+}
+
+void
+fmpz_mat_multi_mod_ui_precomp(nmod_mat_t * residues, slong nres,
+    const fmpz_mat_t mat, const fmpz_comb_t comb, fmpz_comb_temp_t temp)
+{
+    slong m = fmpz_mat_nrows(mat);
+    slong n = fmpz_mat_ncols(mat);
+
+    if (m >= 2 && flint_get_num_threads() > 1 &&
+        (double) m * n * nres >= FMPZ_MULTI_MOD_THREAD_CUTOFF)
+    {
+        work_t work[1];
+        slong nthreads = flint_get_num_threads(), nblocks;
+
+        work->residues = residues;
+        work->nres = nres;
+        work->mat = mat;
+        work->comb = comb;
+
+        /* a few blocks of rows per thread so that idle threads can steal
+           work, each with its own temporaries */
+        work->block = (m + 4 * nthreads - 1) / (4 * nthreads);
+        nblocks = (m + work->block - 1) / work->block;
+
+        flint_parallel_do(worker, work, nblocks, 0, FLINT_PARALLEL_DYNAMIC);
+    }
+    else
+    {
+        _fmpz_mat_multi_mod_ui_rows(residues, nres, mat, 0, m, comb, temp);
+    }
+}
+
 void
 fmpz_mat_multi_mod_ui(nmod_mat_t * residues, slong nres, const fmpz_mat_t mat)
 {
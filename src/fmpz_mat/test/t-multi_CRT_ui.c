@@ -34,6 +34,8 @@ main(void)
         nmod_mat_t Amod[1000];
         mp_limb_t primes[1000];
 
+        flint_set_num_threads(1 + n_randint(state, 4));
+
         bits = n_randint(state, 500) + 1;
         rows = n_randint(state, 10);
         cols = n_randint(state, 10);
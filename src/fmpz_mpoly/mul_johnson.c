@@ -36,23 +36,25 @@ slong _fmpz_mpoly_mul_johnson1(fmpz ** poly1, ulong ** exp1, slong * alloc,
    ulong exp, cy;
    ulong c[3], p[2]; /* for accumulating coefficients */
    int first, small;
-   TMP_INIT;
+   mpoly_arena_mark_t arena;
 
-   TMP_START;
+   mpoly_arena_mark(arena);
 
    /* whether input coeffs are small, thus output coeffs fit in three words */
    small = _fmpz_mpoly_fits_small(poly2, len2) &&
                                            _fmpz_mpoly_fits_small(poly3, len3);
 
    next_loc = len2 + 4;   /* something bigger than heap can ever be */
-   heap = (mpoly_heap1_s *) TMP_ALLOC((len2 + 1)*sizeof(mpoly_heap1_s));
+   heap = (mpoly_heap1_s *) mpoly_arena_alloc(arena,
+                                             (len2 + 1)*sizeof(mpoly_heap1_s));
    /* alloc array of heap nodes which can be chained together */
-   chain = (mpoly_heap_t *) TMP_ALLOC(len2*sizeof(mpoly_heap_t));
+   chain = (mpoly_heap_t *) mpoly_arena_alloc(arena,
+                                                    len2*sizeof(mpoly_heap_t));
    /* space for temporary storage of pointers to heap nodes */
-   Q = (slong *) TMP_ALLOC(2*len2*sizeof(slong));
+   Q = (slong *) mpoly_arena_alloc(arena, 2*len2*sizeof(slong));
 
     /* space for heap indices */
-    hind = (slong *) TMP_ALLOC(len2*sizeof(slong));
+    hind = (slong *) mpoly_arena_alloc(arena, len2*sizeof(slong));
     for (i = 0; i < len2; i++)
         hind[i] = 1;
 
@@ -209,7 +211,7 @@ slong _fmpz_mpoly_mul_johnson1(fmpz ** poly1, ulong ** exp1, slong * alloc,
    (*poly1) = p1;
    (*exp1) = e1;
 
-   TMP_END;
+   mpoly_arena_release(arena);
 
    return k;
 }
@@ -240,34 +242,36 @@ slong _fmpz_mpoly_mul_johnson(fmpz ** poly1, ulong ** exp1, slong * alloc,
    slong exp_next;
    slong * hind;
    int first, small;
-   TMP_INIT;
+   mpoly_arena_mark_t arena;
 
    /* if exponent vectors fit in single word, call special version */
    if (N == 1)
       return _fmpz_mpoly_mul_johnson1(poly1, exp1, alloc,
                              poly2, exp2, len2, poly3, exp3, len3, cmpmask[0]);
 
-   TMP_START;
+   mpoly_arena_mark(arena);
 
    /* whether input coeffs are small, thus output coeffs fit in three words */
    small = _fmpz_mpoly_fits_small(poly2, len2) &&
                                            _fmpz_mpoly_fits_small(poly3, len3);
 
    next_loc = len2 + 4;   /* something bigger than heap can ever be */
-   heap = (mpoly_heap_s *) TMP_ALLOC((len2 + 1)*sizeof(mpoly_heap_s));
+   heap = (mpoly_heap_s *) mpoly_arena_alloc(arena,
+                                              (len2 + 1)*sizeof(mpoly_heap_s));
    /* alloc array of heap nodes which can be chained together */
-   chain = (mpoly_heap_t *) TMP_ALLOC(len2*sizeof(mpoly_heap_t));
+   chain = (mpoly_heap_t *) mpoly_arena_alloc(arena,
+                                                    len2*sizeof(mpoly_heap_t));
    /* space for temporary storage of pointers to heap nodes */
-   Q = (slong *) TMP_ALLOC(2*len2*sizeof(slong));
+   Q = (slong *) mpoly_arena_alloc(arena, 2*len2*sizeof(slong));
    /* allocate space for exponent vectors of N words */
-   exps = (ulong *) TMP_ALLOC(len2*N*sizeof(ulong));
+   exps = (ulong *) mpoly_arena_alloc(arena, len2*N*sizeof(ulong));
    /* list of pointers to allocated exponent vectors */
-   exp_list = (ulong **) TMP_ALLOC(len2*sizeof(ulong *));
+   exp_list = (ulong **) mpoly_arena_alloc(arena, len2*sizeof(ulong *));
    for (i = 0; i < len2; i++)
       exp_list[i] = exps + i*N;
 
    /* space for heap indices */
-   hind = (slong *) TMP_ALLOC(len2*sizeof(slong));
+   hind = (slong *) mpoly_arena_alloc(arena, len2*sizeof(slong));
    for (i = 0; i < len2; i++)
        hind[i] = 1;
 
@@ -453,7 +457,7 @@ slong _fmpz_mpoly_mul_johnson(fmpz ** poly1, ulong ** exp1, slong * alloc,
    (*poly1) = p1;
    (*exp1) = e1;
 
-   TMP_END;
+   mpoly_arena_release(arena);
 
    return k;
 }
@@ -469,10 +473,11 @@ void _fmpz_mpoly_mul_johnson_maxfields(
     flint_bitcnt_t Abits;
     ulong * cmpmask;
     ulong * Bexp, * Cexp;
-    int freeBexp, freeCexp;
+    mpoly_arena_mark_t arena;
     TMP_INIT;
 
     TMP_START;
+    mpoly_arena_mark(arena);
 
     _fmpz_vec_add(maxBfields, maxBfields, maxCfields, ctx->minfo->nfields);
 
@@ -487,22 +492,18 @@ void _fmpz_mpoly_mul_johnson_maxfields(
     mpoly_get_cmpmask(cmpmask, N, Abits, ctx->minfo);
 
     /* ensure input exponents are packed into same sized fields as output */
-    freeBexp = 0;
     Bexp = B->exps;
     if (Abits > B->bits)
     {
-        freeBexp = 1;
-        Bexp = (ulong *) flint_malloc(N*B->length*sizeof(ulong));
+        Bexp = (ulong *) mpoly_arena_alloc(arena, N*B->length*sizeof(ulong));
         mpoly_repack_monomials(Bexp, Abits, B->exps, B->bits,
                                                         B->length, ctx->minfo);
     }
 
-    freeCexp = 0;
     Cexp = C->exps;
     if (Abits > C->bits)
     {
-        freeCexp = 1;
-        Cexp = (ulong *) flint_malloc(N*C->length*sizeof(ulong));
+        Cexp = (ulong *) mpoly_arena_alloc(arena, N*C->length*sizeof(ulong));
         mpoly_repack_monomials(Cexp, Abits, C->exps, C->bits,
                                                         C->length, ctx->minfo);
     }
@@ -553,14 +554,9 @@ void _fmpz_mpoly_mul_johnson_maxfields(
         }
     }
 
-    if (freeBexp)
-        flint_free(Bexp);
-
-    if (freeCexp)
-        flint_free(Cexp);
-
     _fmpz_mpoly_set_length(A, Alen, ctx);
 
+    mpoly_arena_release(arena);
     TMP_END;
 }
 
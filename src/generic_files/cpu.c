@@ -0,0 +1,79 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include "flint.h"
+
+/*
+    The level is probed once; concurrent first calls compute the same value,
+    so the race on _flint_cpu_level is harmless.
+*/
+
+static int _flint_cpu_level = -1;
+
+static int _flint_cpu_detect(void)
+{
+#if FLINT_HAVE_CPU_DISPATCH
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq"))
+    {
+        if (__builtin_cpu_supports("avx512ifma"))
+            return FLINT_CPU_AVX512_IFMA;
+
+        return FLINT_CPU_AVX512;
+    }
+
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return FLINT_CPU_AVX2;
+#endif
+
+    return FLINT_CPU_GENERIC;
+}
+
+/* FLINT_CPU_LEVEL may only lower the detected level */
+static int _flint_cpu_env(int level)
+{
+    const char * s = getenv("FLINT_CPU_LEVEL");
+
+    if (s == NULL)
+        return level;
+
+    if (!strcmp(s, "generic") || !strcmp(s, "0"))
+        return FLINT_CPU_GENERIC;
+
+    if (!strcmp(s, "avx2") || !strcmp(s, "1"))
+        return FLINT_MIN(level, FLINT_CPU_AVX2);
+
+    if (!strcmp(s, "avx512") || !strcmp(s, "2"))
+        return FLINT_MIN(level, FLINT_CPU_AVX512);
+
+    return level;
+}
+
+int flint_cpu_level(void)
+{
+    if (_flint_cpu_level < 0)
+        _flint_cpu_level = _flint_cpu_env(_flint_cpu_detect());
+
+    return _flint_cpu_level;
+}
+
+void flint_set_cpu_level(int level)
+{
+    int max = _flint_cpu_detect();
+
+    if (level < FLINT_CPU_GENERIC)
+        level = FLINT_CPU_GENERIC;
+
+    _flint_cpu_level = FLINT_MIN(level, max);
+}
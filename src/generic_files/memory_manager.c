@@ -16,6 +16,7 @@
 #include "flint.h"
 #include "mpfr.h"
 #include "thread_pool.h"
+#include "fmpz.h"
 
 #if FLINT_USES_GC
 #include "gc.h"
@@ -211,7 +212,6 @@ void flint_register_cleanup_function(flint_cleanup_function_t cleanup_function)
 #endif
 }
 
-void _fmpz_cleanup(void);
 
 void _flint_cleanup(void)
 {
@@ -252,4 +252,9 @@ void flint_cleanup_master(void)
         global_thread_pool_initialized = 0;
     }
     _flint_cleanup();
+
+#if FLINT_USES_MPZ_CACHE
+    /* the pool of mpz's shared by all threads outlives their cleanup */
+    _fmpz_mpz_cache_clear_global();
+#endif
 }
@@ -0,0 +1,41 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "gf2_mat.h"
+
+int
+gf2_mat_equal(const gf2_mat_t mat1, const gf2_mat_t mat2)
+{
+    slong i, j;
+
+    if (mat1->r != mat2->r || mat1->c != mat2->c)
+        return 0;
+
+    for (i = 0; i < mat1->r; i++)
+        for (j = 0; j < mat1->stride; j++)
+            if (mat1->rows[i][j] != mat2->rows[i][j])
+                return 0;
+
+    return 1;
+}
+
+int
+gf2_mat_is_zero(const gf2_mat_t mat)
+{
+    slong i, j;
+
+    for (i = 0; i < mat->r; i++)
+        for (j = 0; j < mat->stride; j++)
+            if (mat->rows[i][j] != 0)
+                return 0;
+
+    return 1;
+}
@@ -0,0 +1,43 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "gf2_mat.h"
+
+void
+gf2_mat_init(gf2_mat_t mat, slong rows, slong cols)
+{
+    slong i;
+
+    mat->r = rows;
+    mat->c = cols;
+    mat->stride = (cols + FLINT_BITS - 1) / FLINT_BITS;
+
+    if (rows != 0 && mat->stride != 0)
+    {
+        mat->entries = flint_calloc(rows * mat->stride, sizeof(ulong));
+        mat->rows = flint_malloc(rows * sizeof(ulong *));
+
+        for (i = 0; i < rows; i++)
+            mat->rows[i] = mat->entries + i * mat->stride;
+    }
+    else
+    {
+        mat->entries = NULL;
+        mat->rows = (rows != 0) ? flint_calloc(rows, sizeof(ulong *)) : NULL;
+    }
+}
+
+void
+gf2_mat_clear(gf2_mat_t mat)
+{
+    flint_free(mat->entries);
+    flint_free(mat->rows);
+}
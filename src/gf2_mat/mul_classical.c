@@ -0,0 +1,45 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "gf2_mat.h"
+
+void
+gf2_mat_mul_classical(gf2_mat_t C, const gf2_mat_t A, const gf2_mat_t B)
+{
+    slong i, j, k, w;
+    ulong x;
+
+    if (C == A || C == B)
+    {
+        gf2_mat_t T;
+        gf2_mat_init(T, A->r, B->c);
+        gf2_mat_mul_classical(T, A, B);
+        gf2_mat_swap(C, T);
+        gf2_mat_clear(T);
+        return;
+    }
+
+    gf2_mat_zero(C);
+
+    for (i = 0; i < A->r; i++)
+    {
+        for (w = 0; w < A->stride; w++)
+        {
+            for (x = A->rows[i][w]; x != 0; x &= x - 1)
+            {
+                k = w * FLINT_BITS + flint_ctz(x);
+
+                for (j = 0; j < B->stride; j++)
+                    C->rows[i][j] ^= B->rows[k][j];
+            }
+        }
+    }
+}
@@ -0,0 +1,142 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "thread_support.h"
+#include "gf2_mat.h"
+
+/*
+    Method of Four Russians: for each group of 2 * M4RM_K rows of B, all
+    sums of subsets of the first and second M4RM_K of them are tabulated,
+    after which each row of C takes a single lookup in each table, indexed
+    by the corresponding bits of A. The rows of C are split into blocks
+    handled by separate threads, each with its own tables.
+*/
+
+#define M4RM_K 8
+#define M4RM_MIN_ROWS_PER_THREAD 256
+
+typedef struct
+{
+    gf2_mat_struct * C;
+    const gf2_mat_struct * A;
+    const gf2_mat_struct * B;
+    slong block;
+}
+_m4rm_arg_struct;
+
+/* T[x] = sum of the rows B[g + t] for the bits t of x, 0 <= x < 2^k */
+static void
+_m4rm_table(ulong * T, const gf2_mat_struct * B, slong g, slong k)
+{
+    slong x, j, n = B->stride;
+    const ulong * b;
+    ulong * t, * s;
+
+    for (j = 0; j < n; j++)
+        T[j] = 0;
+
+    for (x = 1; x < (WORD(1) << k); x++)
+    {
+        t = T + x * n;
+        s = T + (x & (x - 1)) * n;
+        b = B->rows[g + flint_ctz(x)];
+
+        for (j = 0; j < n; j++)
+            t[j] = s[j] ^ b[j];
+    }
+}
+
+FLINT_FORCE_INLINE ulong
+_m4rm_bits(const ulong * row, slong g, slong k)
+{
+    return (row[g / FLINT_BITS] >> (g % FLINT_BITS)) & ((UWORD(1) << k) - 1);
+}
+
+static void
+_m4rm_worker(slong b, void * arg_ptr)
+{
+    _m4rm_arg_struct * arg = (_m4rm_arg_struct *) arg_ptr;
+    gf2_mat_struct * C = arg->C;
+    const gf2_mat_struct * A = arg->A;
+    const gf2_mat_struct * B = arg->B;
+    slong i, j, g, k1, k2, n, start, stop;
+    ulong * T1, * T2;
+    const ulong * t1, * t2;
+
+    n = B->stride;
+    start = b * arg->block;
+    stop = FLINT_MIN(A->r, start + arg->block);
+
+    T1 = flint_malloc(2 * (WORD(1) << M4RM_K) * n * sizeof(ulong));
+    T2 = T1 + (WORD(1) << M4RM_K) * n;
+
+    for (g = 0; g < A->c; g += 2 * M4RM_K)
+    {
+        k1 = FLINT_MIN(M4RM_K, A->c - g);
+        k2 = FLINT_MIN(M4RM_K, A->c - g - k1);
+
+        _m4rm_table(T1, B, g, k1);
+        if (k2 > 0)
+            _m4rm_table(T2, B, g + k1, k2);
+
+        for (i = start; i < stop; i++)
+        {
+            ulong * c = C->rows[i];
+
+            t1 = T1 + _m4rm_bits(A->rows[i], g, k1) * n;
+            t2 = (k2 > 0) ? T2 + _m4rm_bits(A->rows[i], g + k1, k2) * n : T2;
+
+            if (k2 > 0)
+                for (j = 0; j < n; j++)
+                    c[j] ^= t1[j] ^ t2[j];
+            else
+                for (j = 0; j < n; j++)
+                    c[j] ^= t1[j];
+        }
+    }
+
+    flint_free(T1);
+}
+
+void
+gf2_mat_mul_m4rm(gf2_mat_t C, const gf2_mat_t A, const gf2_mat_t B)
+{
+    _m4rm_arg_struct arg[1];
+    slong num;
+
+    if (C == A || C == B)
+    {
+        gf2_mat_t T;
+        gf2_mat_init(T, A->r, B->c);
+        gf2_mat_mul_m4rm(T, A, B);
+        gf2_mat_swap(C, T);
+        gf2_mat_clear(T);
+        return;
+    }
+
+    gf2_mat_zero(C);
+
+    if (A->r == 0 || A->c == 0 || B->c == 0)
+        return;
+
+    num = FLINT_MIN(flint_get_num_threads(), A->r / M4RM_MIN_ROWS_PER_THREAD);
+    num = FLINT_MAX(num, 1);
+
+    arg->C = C;
+    arg->A = A;
+    arg->B = B;
+    arg->block = (A->r + num - 1) / num;
+
+    if (num == 1)
+        _m4rm_worker(0, arg);
+    else
+        flint_parallel_do(_m4rm_worker, arg, num, 0, FLINT_PARALLEL_UNIFORM);
+}
@@ -0,0 +1,54 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "gf2_mat.h"
+
+slong
+gf2_mat_nullspace(gf2_mat_t X, const gf2_mat_t A)
+{
+    slong i, j, k, rank, nullity;
+    slong * pivots, * nonpivots;
+    gf2_mat_t tmp;
+
+    gf2_mat_init(tmp, A->r, A->c);
+    gf2_mat_set(tmp, A);
+    rank = gf2_mat_rref(tmp);
+    nullity = A->c - rank;
+
+    pivots = flint_malloc(A->c * sizeof(slong));
+    nonpivots = pivots + rank;
+
+    for (i = j = k = 0; i < rank; i++)
+    {
+        while (!gf2_mat_get_entry(tmp, i, j))
+            nonpivots[k++] = j++;
+        pivots[i] = j++;
+    }
+
+    while (k < nullity)
+        nonpivots[k++] = j++;
+
+    gf2_mat_zero(X);
+
+    for (i = 0; i < nullity; i++)
+    {
+        for (j = 0; j < rank; j++)
+            if (gf2_mat_get_entry(tmp, j, nonpivots[i]))
+                gf2_mat_set_entry(X, pivots[j], i, 1);
+
+        gf2_mat_set_entry(X, nonpivots[i], i, 1);
+    }
+
+    flint_free(pivots);
+    gf2_mat_clear(tmp);
+
+    return nullity;
+}
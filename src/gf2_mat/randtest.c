@@ -0,0 +1,44 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "ulong_extras.h"
+#include "gf2_mat.h"
+
+void
+gf2_mat_randtest(gf2_mat_t mat, flint_rand_t state)
+{
+    slong i, j;
+    ulong density;
+
+    if (n_randint(state, 2))
+    {
+        for (i = 0; i < mat->r; i++)
+        {
+            for (j = 0; j < mat->stride; j++)
+                mat->rows[i][j] = n_randlimb(state);
+
+            if (mat->c % FLINT_BITS != 0)
+                mat->rows[i][mat->stride - 1] &=
+                                    (UWORD(1) << (mat->c % FLINT_BITS)) - 1;
+        }
+    }
+    else
+    {
+        density = n_randint(state, 101);
+
+        gf2_mat_zero(mat);
+
+        for (i = 0; i < mat->r; i++)
+            for (j = 0; j < mat->c; j++)
+                if (n_randint(state, 100) < density)
+                    gf2_mat_set_entry(mat, i, j, 1);
+    }
+}
@@ -0,0 +1,26 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "gf2_mat.h"
+
+slong
+gf2_mat_rank(const gf2_mat_t A)
+{
+    gf2_mat_t T;
+    slong rank;
+
+    gf2_mat_init(T, A->r, A->c);
+    gf2_mat_set(T, A);
+    rank = gf2_mat_rref(T);
+    gf2_mat_clear(T);
+
+    return rank;
+}
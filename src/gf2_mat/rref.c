@@ -0,0 +1,199 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "thread_support.h"
+#include "gf2_mat.h"
+
+/*
+    Method of Four Russians inversion (M4RI). The columns are processed in
+    strips of M4RI_K. Within a strip, up to M4RI_K pivot rows are found
+    and reduced against each other, testing the other rows only virtually;
+    all sums of the pivot rows are then tabulated and every other row is
+    reduced with a single table lookup, indexed by its bits in the strip.
+    The table lookups are split between threads for large matrices.
+
+    The strips start at multiples of M4RI_K, so the bits of a strip lie
+    in a single limb.
+*/
+
+#define M4RI_K 8
+#define M4RI_THREAD_CUTOFF 65536
+#define M4RI_MIN_ROWS_PER_THREAD 256
+
+#define BIT(row, j) (((row)[(j) / FLINT_BITS] >> ((j) % FLINT_BITS)) & 1)
+
+typedef struct
+{
+    ulong ** rows;
+    slong nrows;
+    slong skip_start;
+    slong skip_stop;
+    slong w0;
+    slong n;
+    slong col;
+    ulong mask;
+    const ulong * T;
+    const ulong * map;
+    slong block;
+}
+_m4ri_arg_struct;
+
+static void
+_m4ri_reduce_rows(slong b, void * arg_ptr)
+{
+    _m4ri_arg_struct * arg = (_m4ri_arg_struct *) arg_ptr;
+    slong i, j, start, stop, n = arg->n;
+    ulong x;
+    const ulong * t;
+    ulong * row;
+
+    start = b * arg->block;
+    stop = FLINT_MIN(arg->nrows, start + arg->block);
+
+    for (i = start; i < stop; i++)
+    {
+        if (i >= arg->skip_start && i < arg->skip_stop)
+            continue;
+
+        row = arg->rows[i] + arg->w0;
+        x = arg->map[(row[0] >> (arg->col % FLINT_BITS)) & arg->mask];
+
+        if (x != 0)
+        {
+            t = arg->T + x * n;
+
+            for (j = 0; j < n; j++)
+                row[j] ^= t[j];
+        }
+    }
+}
+
+slong
+gf2_mat_rref(gf2_mat_t A)
+{
+    _m4ri_arg_struct arg[1];
+    slong r, col, cc, i, j, t, k, kk, w0, n, x, num;
+    slong pc[M4RI_K];
+    ulong * T, * map, * p, * s, * q;
+    ulong m;
+    int bit;
+
+    if (A->r == 0 || A->c == 0)
+        return 0;
+
+    T = flint_malloc((WORD(1) << M4RI_K) * A->stride * sizeof(ulong));
+    map = flint_malloc((WORD(1) << M4RI_K) * sizeof(ulong));
+
+    r = 0;
+
+    for (col = 0; col < A->c && r < A->r; col += k)
+    {
+        k = FLINT_MIN(M4RI_K, A->c - col);
+        w0 = col / FLINT_BITS;
+        n = A->stride - w0;
+        kk = 0;
+
+        /* find the pivots of the strip */
+        for (cc = col; cc < col + k && r + kk < A->r; cc++)
+        {
+            for (i = r + kk; i < A->r; i++)
+            {
+                /* bit cc of row i reduced by the pivot rows so far */
+                bit = BIT(A->rows[i], cc);
+                for (t = 0; t < kk; t++)
+                    bit ^= BIT(A->rows[i], pc[t]) & BIT(A->rows[r + t], cc);
+
+                if (bit)
+                    break;
+            }
+
+            if (i == A->r)
+                continue;
+
+            p = A->rows[i];
+            A->rows[i] = A->rows[r + kk];
+            A->rows[r + kk] = p;
+
+            for (t = 0; t < kk; t++)
+                if (BIT(p, pc[t]))
+                    for (j = w0; j < A->stride; j++)
+                        p[j] ^= A->rows[r + t][j];
+
+            for (t = 0; t < kk; t++)
+            {
+                q = A->rows[r + t];
+
+                if (BIT(q, cc))
+                    for (j = w0; j < A->stride; j++)
+                        q[j] ^= p[j];
+            }
+
+            pc[kk++] = cc;
+        }
+
+        if (kk == 0)
+            continue;
+
+        /* sums of the pivot rows, from limb w0 on */
+        for (j = 0; j < n; j++)
+            T[j] = 0;
+
+        for (x = 1; x < (WORD(1) << kk); x++)
+        {
+            p = T + x * n;
+            s = T + (x & (x - 1)) * n;
+            q = A->rows[r + flint_ctz(x)] + w0;
+
+            for (j = 0; j < n; j++)
+                p[j] = s[j] ^ q[j];
+        }
+
+        /* bits of the strip -> index of the sum clearing the pivot columns */
+        for (x = 0; x < (WORD(1) << k); x++)
+        {
+            m = 0;
+            for (t = 0; t < kk; t++)
+                m |= (ulong) ((x >> (pc[t] - col)) & 1) << t;
+            map[x] = m;
+        }
+
+        arg->rows = A->rows;
+        arg->nrows = A->r;
+        arg->skip_start = r;
+        arg->skip_stop = r + kk;
+        arg->w0 = w0;
+        arg->n = n;
+        arg->col = col;
+        arg->mask = (UWORD(1) << k) - 1;
+        arg->T = T;
+        arg->map = map;
+
+        num = 1;
+        if (A->r * n >= M4RI_THREAD_CUTOFF)
+            num = FLINT_MIN(flint_get_num_threads(),
+                                    A->r / M4RI_MIN_ROWS_PER_THREAD);
+        num = FLINT_MAX(num, 1);
+        arg->block = (A->r + num - 1) / num;
+
+        if (num == 1)
+            _m4ri_reduce_rows(0, arg);
+        else
+            flint_parallel_do(_m4ri_reduce_rows, arg, num, 0,
+                                                    FLINT_PARALLEL_UNIFORM);
+
+        r += kk;
+    }
+
+    flint_free(T);
+    flint_free(map);
+
+    return r;
+}
@@ -0,0 +1,45 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include "gf2_mat.h"
+
+void
+gf2_mat_set(gf2_mat_t mat, const gf2_mat_t src)
+{
+    slong i;
+
+    if (mat == src)
+        return;
+
+    for (i = 0; i < src->r; i++)
+        memcpy(mat->rows[i], src->rows[i], src->stride * sizeof(ulong));
+}
+
+void
+gf2_mat_zero(gf2_mat_t mat)
+{
+    slong i;
+
+    for (i = 0; i < mat->r; i++)
+        memset(mat->rows[i], 0, mat->stride * sizeof(ulong));
+}
+
+void
+gf2_mat_one(gf2_mat_t mat)
+{
+    slong i;
+
+    gf2_mat_zero(mat);
+
+    for (i = 0; i < FLINT_MIN(mat->r, mat->c); i++)
+        gf2_mat_set_entry(mat, i, i, 1);
+}
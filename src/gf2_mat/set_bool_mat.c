@@ -0,0 +1,36 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "bool_mat.h"
+#include "gf2_mat.h"
+
+void
+gf2_mat_set_bool_mat(gf2_mat_t A, const bool_mat_t B)
+{
+    slong i, j;
+
+    gf2_mat_zero(A);
+
+    for (i = 0; i < B->r; i++)
+        for (j = 0; j < B->c; j++)
+            if (bool_mat_get_entry(B, i, j))
+                gf2_mat_set_entry(A, i, j, 1);
+}
+
+void
+bool_mat_set_gf2_mat(bool_mat_t A, const gf2_mat_t B)
+{
+    slong i, j;
+
+    for (i = 0; i < B->r; i++)
+        for (j = 0; j < B->c; j++)
+            bool_mat_set_entry(A, i, j, gf2_mat_get_entry(B, i, j));
+}
@@ -0,0 +1,120 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "ulong_extras.h"
+#include "thread_support.h"
+#include "nmod_mat.h"
+#include "gf2_mat.h"
+
+int
+main(void)
+{
+    slong iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("mul....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 200 * flint_test_multiplier(); iter++)
+    {
+        gf2_mat_t A, B, C, D;
+        nmod_mat_t a, b, c, d;
+        slong m, k, n;
+
+        if (n_randint(state, 10) == 0)
+        {
+            m = n_randint(state, 600);
+            k = n_randint(state, 300);
+            n = n_randint(state, 300);
+        }
+        else
+        {
+            m = n_randint(state, 150);
+            k = n_randint(state, 150);
+            n = n_randint(state, 150);
+        }
+
+        flint_set_num_threads(1 + n_randint(state, 4));
+
+        gf2_mat_init(A, m, k);
+        gf2_mat_init(B, k, n);
+        gf2_mat_init(C, m, n);
+        gf2_mat_init(D, m, n);
+        nmod_mat_init(a, m, k, 2);
+        nmod_mat_init(b, k, n, 2);
+        nmod_mat_init(c, m, n, 2);
+        nmod_mat_init(d, m, n, 2);
+
+        gf2_mat_randtest(A, state);
+        gf2_mat_randtest(B, state);
+        gf2_mat_randtest(C, state);
+        gf2_mat_randtest(D, state);
+
+        gf2_mat_mul_m4rm(C, A, B);
+        gf2_mat_mul_classical(D, A, B);
+
+        nmod_mat_set_gf2_mat(a, A);
+        nmod_mat_set_gf2_mat(b, B);
+        nmod_mat_mul(c, a, b);
+        nmod_mat_set_gf2_mat(d, C);
+
+        if (!gf2_mat_equal(C, D) || !nmod_mat_equal(c, d))
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("m = %wd, k = %wd, n = %wd\n", m, k, n);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        gf2_mat_mul(D, A, B);
+
+        if (!gf2_mat_equal(C, D))
+        {
+            flint_printf("FAIL (mul):\n");
+            flint_printf("m = %wd, k = %wd, n = %wd\n", m, k, n);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        /* aliasing */
+        if (m == k && k == n)
+        {
+            gf2_mat_set(D, A);
+            if (n_randint(state, 2))
+                gf2_mat_mul_m4rm(D, D, B);
+            else
+                gf2_mat_mul_classical(D, D, B);
+
+            if (!gf2_mat_equal(C, D))
+            {
+                flint_printf("FAIL (aliasing):\n");
+                flint_printf("n = %wd\n", n);
+                fflush(stdout);
+                flint_abort();
+            }
+        }
+
+        gf2_mat_clear(A);
+        gf2_mat_clear(B);
+        gf2_mat_clear(C);
+        gf2_mat_clear(D);
+        nmod_mat_clear(a);
+        nmod_mat_clear(b);
+        nmod_mat_clear(c);
+        nmod_mat_clear(d);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
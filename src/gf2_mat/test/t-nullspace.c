@@ -0,0 +1,71 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "ulong_extras.h"
+#include "gf2_mat.h"
+
+int
+main(void)
+{
+    slong iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("nullspace....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 500 * flint_test_multiplier(); iter++)
+    {
+        gf2_mat_t A, L, R, X, Z;
+        slong m, n, k, rank, nullity;
+
+        m = n_randint(state, 150);
+        n = n_randint(state, 150);
+        k = n_randint(state, FLINT_MIN(m, n) + 1);
+
+        gf2_mat_init(A, m, n);
+        gf2_mat_init(L, m, k);
+        gf2_mat_init(R, k, n);
+        gf2_mat_init(X, n, n);
+
+        gf2_mat_randtest(L, state);
+        gf2_mat_randtest(R, state);
+        gf2_mat_mul(A, L, R);
+        gf2_mat_randtest(X, state);
+
+        rank = gf2_mat_rank(A);
+        nullity = gf2_mat_nullspace(X, A);
+
+        gf2_mat_init(Z, m, n);
+        gf2_mat_mul(Z, A, X);
+
+        if (nullity != n - rank || !gf2_mat_is_zero(Z)
+                || gf2_mat_rank(X) != nullity)
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("m = %wd, n = %wd, rank = %wd, nullity = %wd\n",
+                m, n, rank, nullity);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        gf2_mat_clear(A);
+        gf2_mat_clear(L);
+        gf2_mat_clear(R);
+        gf2_mat_clear(X);
+        gf2_mat_clear(Z);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,129 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "ulong_extras.h"
+#include "thread_support.h"
+#include "nmod_mat.h"
+#include "gf2_mat.h"
+
+/* Gauss-Jordan elimination mod 2 */
+static slong
+_rref_naive(nmod_mat_t A)
+{
+    slong i, j, k, r;
+    mp_limb_t * t;
+
+    for (j = r = 0; j < A->c && r < A->r; j++)
+    {
+        for (i = r; i < A->r && A->rows[i][j] == 0; i++) ;
+
+        if (i == A->r)
+            continue;
+
+        t = A->rows[i];
+        A->rows[i] = A->rows[r];
+        A->rows[r] = t;
+
+        for (i = 0; i < A->r; i++)
+            if (i != r && A->rows[i][j] != 0)
+                for (k = j; k < A->c; k++)
+                    A->rows[i][k] ^= A->rows[r][k];
+
+        r++;
+    }
+
+    return r;
+}
+
+int
+main(void)
+{
+    slong iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("rref....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 500 * flint_test_multiplier(); iter++)
+    {
+        gf2_mat_t A, L, R;
+        nmod_mat_t a, b;
+        slong m, n, k, rank, rank2;
+
+        if (n_randint(state, 10) == 0)
+        {
+            m = n_randint(state, 700);
+            n = n_randint(state, 300);
+        }
+        else
+        {
+            m = n_randint(state, 100);
+            n = n_randint(state, 100);
+        }
+
+        flint_set_num_threads(1 + n_randint(state, 4));
+
+        gf2_mat_init(A, m, n);
+        nmod_mat_init(a, m, n, 2);
+        nmod_mat_init(b, m, n, 2);
+
+        /* random matrix, or a product of lower rank */
+        if (n_randint(state, 2))
+        {
+            gf2_mat_randtest(A, state);
+        }
+        else
+        {
+            k = n_randint(state, FLINT_MIN(m, n) + 1);
+
+            gf2_mat_init(L, m, k);
+            gf2_mat_init(R, k, n);
+            gf2_mat_randtest(L, state);
+            gf2_mat_randtest(R, state);
+            gf2_mat_mul(A, L, R);
+            gf2_mat_clear(L);
+            gf2_mat_clear(R);
+        }
+
+        nmod_mat_set_gf2_mat(a, A);
+
+        rank = gf2_mat_rref(A);
+        rank2 = _rref_naive(a);
+        nmod_mat_set_gf2_mat(b, A);
+
+        if (rank != rank2 || !nmod_mat_equal(a, b))
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("m = %wd, n = %wd, rank = %wd, rank2 = %wd\n",
+                m, n, rank, rank2);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        if (gf2_mat_rank(A) != rank)
+        {
+            flint_printf("FAIL (rank):\n");
+            flint_printf("m = %wd, n = %wd\n", m, n);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        gf2_mat_clear(A);
+        nmod_mat_clear(a);
+        nmod_mat_clear(b);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,110 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "ulong_extras.h"
+#include "nmod_mat.h"
+#include "gf2_mat.h"
+
+int
+main(void)
+{
+    slong iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("transpose....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 1000 * flint_test_multiplier(); iter++)
+    {
+        gf2_mat_t A, B, C;
+        nmod_mat_t a, b, c;
+        bool_mat_t u;
+        slong m, n;
+
+        m = n_randint(state, 150);
+        n = n_randint(state, 150);
+
+        gf2_mat_init(A, m, n);
+        gf2_mat_init(B, n, m);
+        gf2_mat_init(C, m, n);
+        nmod_mat_init(a, m, n, 2);
+        nmod_mat_init(b, n, m, 2);
+        nmod_mat_init(c, n, m, 2);
+        bool_mat_init(u, m, n);
+
+        gf2_mat_randtest(A, state);
+        gf2_mat_randtest(C, state);
+
+        /* conversions round trip */
+        nmod_mat_set_gf2_mat(a, A);
+        gf2_mat_set_nmod_mat(C, a);
+
+        if (!gf2_mat_equal(A, C))
+        {
+            flint_printf("FAIL (nmod_mat):\n");
+            flint_printf("m = %wd, n = %wd\n", m, n);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        gf2_mat_randtest(C, state);
+        bool_mat_set_gf2_mat(u, A);
+        gf2_mat_set_bool_mat(C, u);
+
+        if (!gf2_mat_equal(A, C))
+        {
+            flint_printf("FAIL (bool_mat):\n");
+            flint_printf("m = %wd, n = %wd\n", m, n);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        gf2_mat_transpose(B, A);
+        nmod_mat_transpose(b, a);
+        nmod_mat_set_gf2_mat(c, B);
+
+        if (!nmod_mat_equal(b, c))
+        {
+            flint_printf("FAIL (transpose):\n");
+            flint_printf("m = %wd, n = %wd\n", m, n);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        /* aliasing */
+        if (m == n)
+        {
+            gf2_mat_transpose(A, A);
+
+            if (!gf2_mat_equal(A, B))
+            {
+                flint_printf("FAIL (aliasing):\n");
+                flint_printf("n = %wd\n", n);
+                fflush(stdout);
+                flint_abort();
+            }
+        }
+
+        gf2_mat_clear(A);
+        gf2_mat_clear(B);
+        gf2_mat_clear(C);
+        nmod_mat_clear(a);
+        nmod_mat_clear(b);
+        nmod_mat_clear(c);
+        bool_mat_clear(u);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,43 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "gf2_mat.h"
+
+void
+gf2_mat_transpose(gf2_mat_t B, const gf2_mat_t A)
+{
+    slong i, k, j;
+    ulong x;
+
+    if (B == A)
+    {
+        gf2_mat_t T;
+        gf2_mat_init(T, A->c, A->r);
+        gf2_mat_transpose(T, A);
+        gf2_mat_swap(B, T);
+        gf2_mat_clear(T);
+        return;
+    }
+
+    gf2_mat_zero(B);
+
+    for (i = 0; i < A->r; i++)
+    {
+        for (k = 0; k < A->stride; k++)
+        {
+            for (x = A->rows[i][k]; x != 0; x &= x - 1)
+            {
+                j = k * FLINT_BITS + flint_ctz(x);
+                B->rows[j][i / FLINT_BITS] |= UWORD(1) << (i % FLINT_BITS);
+            }
+        }
+    }
+}
@@ -40,12 +40,19 @@ extern "C" {
 typedef ulong vec1n;
 typedef __m128i vec2n;
 typedef __m256i vec4n;
-typedef struct {__m256i e1, e2;} vec8n;
 
 typedef double vec1d;
 typedef __m128d vec2d;
 typedef __m256d vec4d;
+
+/* with AVX512 the 8-wide vectors are native zmm registers */
+#if defined(__AVX512F__)
+typedef __m512i vec8n;
+typedef __m512d vec8d;
+#else
+typedef struct {__m256i e1, e2;} vec8n;
 typedef struct {__m256d e1, e2;} vec8d;
+#endif
 
 
 FLINT_FORCE_INLINE void vec4d_print(vec4d a)
@@ -76,10 +83,6 @@ FLINT_FORCE_INLINE vec4n vec4n_load_unaligned(const ulong* a) {
     return _mm256_loadu_si256((__m256i*) a);
 }
 
-FLINT_FORCE_INLINE vec8n vec8n_load_unaligned(const ulong* a) {
-    vec8n z = {vec4n_load_unaligned(a+0), vec4n_load_unaligned(a+4)};
-    return z;
-}
 
 
 FLINT_FORCE_INLINE vec4d vec4n_convert_limited_vec4d(vec4n a) {
@@ -87,18 +90,6 @@ FLINT_FORCE_INLINE vec4d vec4n_convert_limited_vec4d(vec4n a) {
     return _mm256_sub_pd(_mm256_or_pd(_mm256_castsi256_pd(a), t), t);
 }
 
-/* !!! the outputs are also permuted !!! */
-FLINT_FORCE_INLINE vec8d _vec8i32_convert_vec8d(__m256i a)
-{
-    __m256i mask = _mm256_set1_epi32(0x43300000);
-    __m256i ak0 = _mm256_unpacklo_epi32(a, mask);
-    __m256i ak1 = _mm256_unpackhi_epi32(a, mask);
-    __m256d t = _mm256_set1_pd(0x1.0p52);
-    vec8d z;
-    z.e1 = _mm256_sub_pd(_mm256_castsi256_pd(ak0), t);
-    z.e2 = _mm256_sub_pd(_mm256_castsi256_pd(ak1), t);
-    return z;
-}
 
 
 FLINT_FORCE_INLINE ulong vec4n_get_index(vec4n a, const int i)
@@ -473,6 +464,157 @@ FLINT_FORCE_INLINE vec4d vec4d_reduce_2n_to_n(vec4d a, vec4d n) {
 
 /* vec8 **********************************************************************/
 
+#if defined(__AVX512F__)
+
+FLINT_FORCE_INLINE double vec8d_get_index(vec8d a, int i) {
+    return a[i];
+}
+
+FLINT_FORCE_INLINE vec8d vec8d_set_d(double a) {
+    return _mm512_set1_pd(a);
+}
+
+FLINT_FORCE_INLINE vec8d vec8d_set_d8(double a0, double a1, double a2, double a3, double a4, double a5, double a6, double a7) {
+    return _mm512_set_pd(a7, a6, a5, a4, a3, a2, a1, a0);
+}
+
+FLINT_FORCE_INLINE vec8d vec8d_load(const double* a) {
+    return _mm512_loadu_pd(a);
+}
+
+FLINT_FORCE_INLINE vec8d vec8d_load_aligned(const double* a) {
+    return _mm512_load_pd(a);
+}
+
+FLINT_FORCE_INLINE vec8d vec8d_load_unaligned(const double* a) {
+    return _mm512_loadu_pd(a);
+}
+
+FLINT_FORCE_INLINE void vec8d_store(double* z, vec8d a) {
+    _mm512_storeu_pd(z, a);
+}
+
+FLINT_FORCE_INLINE void vec8d_store_aligned(double* z, vec8d a) {
+    _mm512_store_pd(z, a);
+}
+
+FLINT_FORCE_INLINE void vec8d_store_unaligned(double* z, vec8d a) {
+    _mm512_storeu_pd(z, a);
+}
+
+FLINT_FORCE_INLINE int vec8d_same(vec8d a, vec8d b) {
+    return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ) == 0xff;
+}
+
+FLINT_FORCE_INLINE vec8d vec8d_round(vec8d a) {
+    return _mm512_roundscale_pd(a, 4);
+}
+
+FLINT_FORCE_INLINE vec8d vec8d_zero() {
+    return _mm512_setzero_pd();
+}
+
+FLINT_FORCE_INLINE vec8d vec8d_add(vec8d a, vec8d b) {
+    return _mm512_add_pd(a, b);
+}
+
+FLINT_FORCE_INLINE vec8d vec8d_sub(vec8d a, vec8d b) {
+    return _mm512_sub_pd(a, b);
+}
+
+FLINT_FORCE_INLINE vec8d vec8d_neg(vec8d a) {
+    __m512i mask = _mm512_set1_epi64(UWORD(0x8000000000000000));
+    return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a), mask));
+}
+
+FLINT_FORCE_INLINE vec8d vec8d_abs(vec8d a) {
+    return _mm512_abs_pd(a);
+}
+
+FLINT_FORCE_INLINE vec8d vec8d_max(vec8d a, vec8d b) {
+    return _mm512_max_pd(a, b);
+}
+
+FLINT_FORCE_INLINE vec8d vec8d_min(vec8d a, vec8d b) {
+    return _mm512_min_pd(a, b);
+}
+
+FLINT_FORCE_INLINE vec8d vec8d_mul(vec8d a, vec8d b) {
+    return _mm512_mul_pd(a, b);
+}
+
+FLINT_FORCE_INLINE vec8d vec8d_half(vec8d a) {
+    return vec8d_mul(a, vec8d_set_d(0.5));
+}
+
+FLINT_FORCE_INLINE vec8d vec8d_div(vec8d a, vec8d b) {
+    return _mm512_div_pd(a, b);
+}
+
+FLINT_FORCE_INLINE vec8d vec8d_fmadd(vec8d a, vec8d b, vec8d c) {
+    return _mm512_fmadd_pd(a, b, c);
+}
+
+FLINT_FORCE_INLINE vec8d vec8d_fmsub(vec8d a, vec8d b, vec8d c) {
+    return _mm512_fmsub_pd(a, b, c);
+}
+
+FLINT_FORCE_INLINE vec8d vec8d_fnmadd(vec8d a, vec8d b, vec8d c) {
+    return _mm512_fnmadd_pd(a, b, c);
+}
+
+FLINT_FORCE_INLINE vec8d vec8d_fnmsub(vec8d a, vec8d b, vec8d c) {
+    return _mm512_fnmsub_pd(a, b, c);
+}
+
+/* same as vec4d_blendv: take b where the sign bit of c is set */
+FLINT_FORCE_INLINE vec8d vec8d_blendv(vec8d a, vec8d b, vec8d c) {
+    __mmask8 m = _mm512_cmplt_epi64_mask(_mm512_castpd_si512(c),
+                                         _mm512_setzero_si512());
+    return _mm512_mask_blend_pd(m, a, b);
+}
+
+FLINT_FORCE_INLINE vec8d vec8d_reduce_0n_to_pmhn(vec8d a, vec8d n) {
+    vec8d halfn = vec8d_half(n);
+    __mmask8 m = _mm512_cmp_pd_mask(a, halfn, _CMP_GT_OQ);
+    return _mm512_mask_sub_pd(a, m, a, n);
+}
+
+FLINT_FORCE_INLINE vec8d vec8d_reduce_pm1n_to_pmhn(vec8d a, vec8d n) {
+    vec8d halfn = vec8d_half(n);
+    vec8d t = vec8d_blendv(n, vec8d_neg(n), a);
+    __mmask8 m = _mm512_cmp_pd_mask(vec8d_abs(a), halfn, _CMP_GT_OQ);
+    return _mm512_mask_sub_pd(a, m, a, t);
+}
+
+/* [0,2n) to [0,n) */
+FLINT_FORCE_INLINE vec8d vec8d_reduce_2n_to_n(vec8d a, vec8d n) {
+    vec8d s = vec8d_sub(a, n);
+    return vec8d_blendv(s, a, s);
+}
+
+FLINT_FORCE_INLINE vec8n vec8n_load_unaligned(const ulong* a) {
+    return _mm512_loadu_si512((const void*) a);
+}
+
+FLINT_FORCE_INLINE vec8d vec8n_convert_limited_vec8d(vec8n a) {
+    __m512d t = _mm512_set1_pd(0x1.0p52);
+    return _mm512_sub_pd(_mm512_castsi512_pd(_mm512_or_si512(a,
+                                                 _mm512_castpd_si512(t))), t);
+}
+
+/*
+    !!! the outputs are also permuted !!!
+    The order {a0, a1, a4, a5, a2, a3, a6, a7} is that of the AVX2 version.
+*/
+FLINT_FORCE_INLINE vec8d _vec8i32_convert_vec8d(__m256i a)
+{
+    __m256i p = _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7);
+    return _mm512_cvtepu32_pd(_mm256_permutevar8x32_epi32(a, p));
+}
+
+#else
+
 FLINT_FORCE_INLINE double vec8d_get_index(vec8d a, int i) {
     return i < 4 ? vec4d_get_index(a.e1, i) : vec4d_get_index(a.e2, i - 4);
 }
@@ -529,6 +671,26 @@ FLINT_FORCE_INLINE vec8d vec8n_convert_limited_vec8d(vec8n a) {
     return z;
 }
 
+FLINT_FORCE_INLINE vec8n vec8n_load_unaligned(const ulong* a) {
+    vec8n z = {vec4n_load_unaligned(a+0), vec4n_load_unaligned(a+4)};
+    return z;
+}
+
+/* !!! the outputs are also permuted !!! */
+FLINT_FORCE_INLINE vec8d _vec8i32_convert_vec8d(__m256i a)
+{
+    __m256i mask = _mm256_set1_epi32(0x43300000);
+    __m256i ak0 = _mm256_unpacklo_epi32(a, mask);
+    __m256i ak1 = _mm256_unpackhi_epi32(a, mask);
+    __m256d t = _mm256_set1_pd(0x1.0p52);
+    vec8d z;
+    z.e1 = _mm256_sub_pd(_mm256_castsi256_pd(ak0), t);
+    z.e2 = _mm256_sub_pd(_mm256_castsi256_pd(ak1), t);
+    return z;
+}
+
+#endif
+
 
 /* reduce_pm1no_to_0n(a, n): return a mod n in [0,n) assuming a in (-n,n) */
 #define DEFINE_IT(V) \
@@ -537,6 +699,9 @@ FLINT_FORCE_INLINE V V##_reduce_pm1no_to_0n(V a, V n) { \
 }
 DEFINE_IT(vec1d)
 DEFINE_IT(vec4d)
+#if defined(__AVX512F__)
+DEFINE_IT(vec8d)
+#endif
 #undef DEFINE_IT
 
 /* reduce_to_pm1n(a, n, ninv): return a mod n in [-n,n] */
@@ -546,6 +711,9 @@ FLINT_FORCE_INLINE V V##_reduce_to_pm1n(V a, V n, V ninv) { \
 }
 DEFINE_IT(vec1d)
 DEFINE_IT(vec4d)
+#if defined(__AVX512F__)
+DEFINE_IT(vec8d)
+#endif
 #undef DEFINE_IT
 
 /* reduce_to_pm1n(a, n, ninv): return a mod n in (-n,n) */
@@ -555,6 +723,9 @@ FLINT_FORCE_INLINE V V##_reduce_to_pm1no(V a, V n, V ninv) { \
 }
 DEFINE_IT(vec1d)
 DEFINE_IT(vec4d)
+#if defined(__AVX512F__)
+DEFINE_IT(vec8d)
+#endif
 #undef DEFINE_IT
 
 
@@ -565,6 +736,9 @@ FLINT_FORCE_INLINE V V##_reduce_to_0n(V a, V n, V ninv) { \
 }
 DEFINE_IT(vec1d)
 DEFINE_IT(vec4d)
+#if defined(__AVX512F__)
+DEFINE_IT(vec8d)
+#endif
 #undef DEFINE_IT
 
 #define DEFINE_IT(V) \
@@ -573,6 +747,9 @@ FLINT_FORCE_INLINE int V##_same_mod(V a, V b, V n, V ninv) { \
 }
 DEFINE_IT(vec1d)
 DEFINE_IT(vec4d)
+#if defined(__AVX512F__)
+DEFINE_IT(vec8d)
+#endif
 #undef DEFINE_IT
 
 /* mulmod(a, b, n, ninv): return a*b mod n in [-n,n] with assumptions */
@@ -593,6 +770,9 @@ FLINT_FORCE_INLINE V V##_nmulmod(V a, V b, V n, V ninv) { \
 
 DEFINE_IT(vec1d)
 DEFINE_IT(vec4d)
+#if defined(__AVX512F__)
+DEFINE_IT(vec8d)
+#endif
 #undef DEFINE_IT
 
 
@@ -680,6 +860,8 @@ FLINT_FORCE_INLINE vec4n vec4n_addmod(vec4n a, vec4n b, vec4n n)
 #endif
 }
 
+#if !defined(__AVX512F__)
+
 EXTEND_VEC_DEF0(vec4d, vec8d, _zero)
 EXTEND_VEC_DEF1(vec4d, vec8d, _neg)
 EXTEND_VEC_DEF1(vec4d, vec8d, _round)
@@ -705,6 +887,8 @@ EXTEND_VEC_DEF3(vec4n, vec8n, _addmod_limited)
 EXTEND_VEC_DEF4(vec4d, vec8d, _mulmod)
 EXTEND_VEC_DEF4(vec4d, vec8d, _nmulmod)
 
+#endif
+
 #undef EXTEND_VEC_DEF4
 #undef EXTEND_VEC_DEF3
 #undef EXTEND_VEC_DEF2
@@ -714,27 +898,62 @@ EXTEND_VEC_DEF4(vec4d, vec8d, _nmulmod)
 
 
 
+FLINT_FORCE_INLINE vec4n vec4n_bit_shift_right(vec4n a, ulong b) {
+    return _mm256_srl_epi64(a, _mm_set_epi32(0,0,0,b));
+}
+
+FLINT_FORCE_INLINE vec4n vec4n_bit_and(vec4n a, vec4n b) {
+    return _mm256_and_si256(a, b);
+}
+
+#if defined(__AVX512F__)
+
 FLINT_FORCE_INLINE vec8n vec8n_set_n(ulong a) {
-    vec4n x = vec4n_set_n(a);
-    vec8n z = {x, x};
-    return z;
+    return _mm512_set1_epi64(a);
 }
 
-FLINT_FORCE_INLINE vec4n vec4n_bit_shift_right(vec4n a, ulong b) {
-    return _mm256_srl_epi64(a, _mm_set_epi32(0,0,0,b));
+FLINT_FORCE_INLINE vec8n vec8n_add(vec8n a, vec8n b) {
+    return _mm512_add_epi64(a, b);
+}
+
+FLINT_FORCE_INLINE vec8n vec8n_sub(vec8n a, vec8n b) {
+    return _mm512_sub_epi64(a, b);
+}
+
+/* for n < 2^63 */
+FLINT_FORCE_INLINE vec8n vec8n_addmod_limited(vec8n a, vec8n b, vec8n n) {
+    vec8n s = vec8n_add(a, b);
+    vec8n t = vec8n_sub(s, n);
+    __mmask8 m = _mm512_cmplt_epi64_mask(t, _mm512_setzero_si512());
+    return _mm512_mask_blend_epi64(m, t, s);
+}
+
+FLINT_FORCE_INLINE vec8n vec8n_addmod(vec8n a, vec8n b, vec8n n) {
+    vec8n s = vec8n_add(a, b);
+    vec8n t = vec8n_sub(s, n);
+    __mmask8 m = _mm512_cmpgt_epu64_mask(t, a);
+    return _mm512_mask_blend_epi64(m, t, s);
 }
 
 FLINT_FORCE_INLINE vec8n vec8n_bit_shift_right(vec8n a, ulong b) {
-    vec8n z = {vec4n_bit_shift_right(a.e1, b), vec4n_bit_shift_right(a.e2, b)};
-    return z;
+    return _mm512_srl_epi64(a, _mm_set_epi32(0,0,0,b));
 }
 
-#define vec4n_bit_shift_right_32(a) vec4n_bit_shift_right((a), 32)
-#define vec8n_bit_shift_right_32(a) vec8n_bit_shift_right((a), 32)
+FLINT_FORCE_INLINE vec8n vec8n_bit_and(vec8n a, vec8n b) {
+    return _mm512_and_si512(a, b);
+}
 
+#else
 
-FLINT_FORCE_INLINE vec4n vec4n_bit_and(vec4n a, vec4n b) {
-    return _mm256_and_si256(a, b);
+FLINT_FORCE_INLINE vec8n vec8n_set_n(ulong a) {
+    vec4n x = vec4n_set_n(a);
+    vec8n z = {x, x};
+    return z;
+}
+
+FLINT_FORCE_INLINE vec8n vec8n_bit_shift_right(vec8n a, ulong b) {
+    vec8n z = {vec4n_bit_shift_right(a.e1, b), vec4n_bit_shift_right(a.e2, b)};
+    return z;
 }
 
 FLINT_FORCE_INLINE vec8n vec8n_bit_and(vec8n a, vec8n b) {
@@ -742,6 +961,11 @@ FLINT_FORCE_INLINE vec8n vec8n_bit_and(vec8n a, vec8n b) {
     return z;
 }
 
+#endif
+
+#define vec4n_bit_shift_right_32(a) vec4n_bit_shift_right((a), 32)
+#define vec8n_bit_shift_right_32(a) vec8n_bit_shift_right((a), 32)
+
 
 
 #elif defined(__ARM_NEON)
@@ -72,6 +72,15 @@
 
 mp_limb_t flint_mpn_mul_large(mp_ptr r1, mp_srcptr i1, mp_size_t n1, mp_srcptr i2, mp_size_t n2);
 
+size_t flint_mpn_mul_blocked_store_size(mp_size_t xn, mp_size_t yn,
+                                                        mp_size_t max_limbs);
+
+mp_limb_t flint_mpn_mul_blocked(mp_ptr z, mp_srcptr x, mp_size_t xn,
+        mp_srcptr y, mp_size_t yn, mp_size_t max_limbs, void * store);
+
+void flint_mpn_mul_blocked_file(const char * zname, const char * xname,
+                                const char * yname, mp_size_t max_limbs);
+
 MPN_EXTRAS_INLINE mp_limb_t
 flint_mpn_mul(mp_ptr z, mp_srcptr x, mp_size_t xn, mp_srcptr y, mp_size_t yn)
 {
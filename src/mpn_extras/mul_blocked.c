@@ -0,0 +1,550 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include "flint.h"
+#include "mpn_extras.h"
+
+/*
+    Fallback: the operands are cut into blocks of k limbs and the block
+    products are added into the output in order of increasing offset. A k by
+    k product needs 2k limbs for the result plus the scratch space of the
+    underlying FFT, which is roughly another 10k to 12k limbs, so we take
+    k = max_limbs / MUL_BLOCKED_RATIO. Each block is multiplied by every
+    block of the other operand, so this is quadratic in the number of blocks.
+*/
+#define MUL_BLOCKED_RATIO 16
+
+static void
+_flint_mpn_mul_blocked_basecase(mp_ptr z, mp_srcptr x, mp_size_t xn,
+                                mp_srcptr y, mp_size_t yn, mp_size_t k)
+{
+    mp_size_t zn, xb, yb, s, i, j, xl, yl, off;
+    mp_ptr t;
+    int squaring;
+
+    squaring = (x == y && xn == yn);
+
+    zn = xn + yn;
+    xb = (xn + k - 1) / k;
+    yb = (yn + k - 1) / k;
+
+    t = (mp_ptr) flint_malloc(2 * k * sizeof(mp_limb_t));
+
+    flint_mpn_zero(z, zn);
+
+    /* the block x_i*y_j is added at offset (i + j)*k */
+    for (s = 0; s < xb + yb - 1; s++)
+    {
+        off = s * k;
+
+        for (i = FLINT_MAX(0, s - (yb - 1)); i <= FLINT_MIN(s, xb - 1); i++)
+        {
+            j = s - i;
+
+            /* x_i*x_j = x_j*x_i; do it once for i < j and add it twice */
+            if (squaring && j < i)
+                continue;
+
+            xl = FLINT_MIN(k, xn - i * k);
+            yl = FLINT_MIN(k, yn - j * k);
+
+            if (squaring && i == j)
+                flint_mpn_sqr(t, x + i * k, xl);
+            else if (xl >= yl)
+                flint_mpn_mul(t, x + i * k, xl, y + j * k, yl);
+            else
+                flint_mpn_mul(t, y + j * k, yl, x + i * k, xl);
+
+            /* the partial sums are bounded by the full product, so the
+               carry never leaves z; carry propagation stops early */
+            mpn_add(z + off, z + off, zn - off, t, xl + yl);
+
+            if (squaring && i != j)
+                mpn_add(z + off, z + off, zn - off, t, xl + yl);
+        }
+    }
+
+    flint_free(t);
+}
+
+#ifdef FLINT_HAVE_FFT_SMALL
+
+#include "nmod.h"
+#include "fft_small.h"
+#include "machine_vectors.h"
+
+/*
+    Two level number theoretic transform. Every limb is a coefficient and
+    the operands are cut into blocks of m = N/2 limbs, so that the product
+    of two blocks is the cyclic convolution of length N = 2^depth of their
+    zero padded coefficients. Writing x = sum x_i B^(m i), the product is
+    sum_s (sum_(i+j=s) x_i y_j) B^(m s), a convolution of the sequences of
+    blocks. Its coefficients lie below 2^128 yn, so it is computed modulo
+    MUL_BLOCKED_NP primes of fft_small and recovered by the CRT.
+
+    For each prime:
+
+    1. every block is reduced and transformed once by sd_fft (the inner
+       transform) and written to the store, a row of the store per block;
+    2. for each chunk of columns, the rows of x and of y are loaded,
+       transformed along the block index by a plain radix 2 transform of
+       length L >= xb + yb - 1 (the outer transform), multiplied pointwise,
+       transformed back and written over the rows of the store;
+    3. every row s of the result is transformed back by sd_fft and the CRT
+       gives the limbs of the block product sum, which are added into z at
+       limb offset m s.
+
+    Inputs and output are thus read and written once and in order, and the
+    store, which holds about 4 doubles per limb of x and y, is passed over
+    three times, in chunks. The memory in use besides the store is that of
+    a single inner transform for all primes, or of one chunk of columns of
+    all rows, whichever is larger; both are kept below max_limbs words.
+*/
+
+#define MUL_BLOCKED_NP 4
+
+/* below this many limbs of transform, use the basecase */
+#define MUL_BLOCKED_MIN_DEPTH (LG_BLK_SZ + 1)
+
+typedef struct
+{
+    ulong depth;        /* inner transform length N = 2^depth */
+    ulong m;            /* limbs per block, N/2 */
+    ulong stride;       /* doubles per inner transform */
+    ulong xb, yb;       /* number of blocks */
+    ulong ldepth;       /* outer transform length L = 2^ldepth */
+    ulong chunk;        /* columns per chunk of the outer transform */
+    ulong alloc;        /* words of scratch */
+}
+_mul_blocked_param_struct;
+
+/* the product of the primes, in crt_data_prod_primes, has this many limbs */
+static ulong
+_mul_blocked_crt_len(mpn_ctx_struct * R)
+{
+    return R->crts[MUL_BLOCKED_NP - 1].coeff_len;
+}
+
+/* returns 0 if the budget does not allow the transform */
+static int
+_mul_blocked_params(_mul_blocked_param_struct * P, mp_size_t xn,
+                    mp_size_t yn, mp_size_t max_limbs, ulong clen)
+{
+    ulong depth, N, L, inner, outer, stride;
+    slong chunk;
+
+    /* the largest inner transform with all primes and the limbs of a block
+       product in the budget; a single block of x needs no more */
+    depth = MUL_BLOCKED_MIN_DEPTH;
+
+    if (MUL_BLOCKED_NP * sd_fft_ctx_data_size(depth) + n_pow2(depth)
+                                            + 2 * clen + 4 > (ulong) max_limbs)
+        return 0;
+
+    while (n_pow2(depth) < 2 * (ulong) xn &&
+            MUL_BLOCKED_NP * sd_fft_ctx_data_size(depth + 1) + n_pow2(depth + 1)
+                                            + 2 * clen + 4 <= (ulong) max_limbs)
+        depth++;
+
+    N = n_pow2(depth);
+    stride = sd_fft_ctx_data_size(depth);
+    inner = MUL_BLOCKED_NP * stride + N + 2 * clen + 4;
+
+    P->depth = depth;
+    P->m = N / 2;
+    P->stride = stride;
+    P->xb = (xn + P->m - 1) / P->m;
+    P->yb = (yn + P->m - 1) / P->m;
+    P->ldepth = n_clog2(P->xb + P->yb - 1);
+
+    /* the rows of x and y of a chunk and the outer roots of unity */
+    L = n_pow2(P->ldepth);
+    chunk = ((slong) max_limbs - (slong) L) / (slong) (2 * L);
+    chunk = FLINT_MIN(chunk, (slong) stride);
+    chunk -= chunk % 4;
+
+    if (chunk < 4)
+        return 0;
+
+    P->chunk = chunk;
+    outer = 2 * L * chunk + L;
+    P->alloc = FLINT_MAX(inner, outer);
+
+    return 1;
+}
+
+static double *
+_mul_blocked_row(double * store, const _mul_blocked_param_struct * P,
+                                                            ulong r, ulong i)
+{
+    return store + (r * MUL_BLOCKED_NP + i) * P->stride;
+}
+
+/* transform the blocks of (a, an) into rows first, first + 1, ... */
+static void
+_mul_blocked_inner_fft(double * store, const _mul_blocked_param_struct * P,
+                        ulong first, mp_srcptr a, mp_size_t an,
+                        double * buf, mpn_ctx_struct * R)
+{
+    ulong b, i, j, len, nb;
+    sd_fft_lctx_t Q[MUL_BLOCKED_NP];
+
+    nb = (an + P->m - 1) / P->m;
+
+    for (i = 0; i < MUL_BLOCKED_NP; i++)
+        sd_fft_lctx_init(Q[i], R->ffts + i, P->depth);
+
+    for (b = 0; b < nb; b++)
+    {
+        len = FLINT_MIN(P->m, an - b * P->m);
+
+        for (i = 0; i < MUL_BLOCKED_NP; i++)
+        {
+            sd_fft_ctx_struct * F = R->ffts + i;
+
+            memset(buf, 0, P->stride * sizeof(double));
+
+            for (j = 0; j < len; j++)
+            {
+                ulong r;
+                NMOD_RED(r, a[b * P->m + j], F->mod);
+                sd_fft_ctx_set_index(buf, j, vec1d_reduce_0n_to_pmhn(r, F->p));
+            }
+
+            sd_fft_lctx_fft_trunc(Q[i], buf, P->depth, P->m, 2 * P->m);
+
+            memcpy(_mul_blocked_row(store, P, first + b, i), buf,
+                                                P->stride * sizeof(double));
+        }
+    }
+
+    for (i = 0; i < MUL_BLOCKED_NP; i++)
+        sd_fft_lctx_clear(Q[i], R->ffts + i);
+}
+
+/* reduce a in (-4n, 4n) to [-n, n] */
+FLINT_FORCE_INLINE vec4d
+_vec4d_red(vec4d a, vec4d n, vec4d ninv)
+{
+    return vec4d_reduce_to_pm1n(a, n, ninv);
+}
+
+/* forward transform of the L rows of a, natural order in, bit reversed
+   order out; w[j] = w^j for a primitive L-th root of unity w */
+static void
+_mul_blocked_outer_fft(double * a, ulong ldepth, ulong C, const double * w,
+                       double p, double pinv)
+{
+    ulong L = n_pow2(ldepth), h, s, j, k;
+    vec4d n = vec4d_set_d(p), ninv = vec4d_set_d(pinv);
+
+    for (h = L / 2; h >= 1; h /= 2)
+    {
+        for (s = 0; s < L; s += 2 * h)
+        {
+            for (j = 0; j < h; j++)
+            {
+                double * u = a + (s + j) * C;
+                double * v = a + (s + j + h) * C;
+                vec4d t = vec4d_set_d(w[j * (L / (2 * h))]);
+
+                for (k = 0; k < C; k += 4)
+                {
+                    vec4d x = vec4d_load_aligned(u + k);
+                    vec4d y = vec4d_load_aligned(v + k);
+                    vec4d_store_aligned(u + k, _vec4d_red(vec4d_add(x, y), n, ninv));
+                    y = vec4d_mulmod(vec4d_sub(x, y), t, n, ninv);
+                    vec4d_store_aligned(v + k, _vec4d_red(y, n, ninv));
+                }
+            }
+        }
+    }
+}
+
+/* inverse of the above up to a factor L, with w[j] = w^-j */
+static void
+_mul_blocked_outer_ifft(double * a, ulong ldepth, ulong C, const double * w,
+                        double p, double pinv)
+{
+    ulong L = n_pow2(ldepth), h, s, j, k;
+    vec4d n = vec4d_set_d(p), ninv = vec4d_set_d(pinv);
+
+    for (h = 1; h < L; h *= 2)
+    {
+        for (s = 0; s < L; s += 2 * h)
+        {
+            for (j = 0; j < h; j++)
+            {
+                double * u = a + (s + j) * C;
+                double * v = a + (s + j + h) * C;
+                vec4d t = vec4d_set_d(w[j * (L / (2 * h))]);
+
+                for (k = 0; k < C; k += 4)
+                {
+                    vec4d x = vec4d_load_aligned(u + k);
+                    vec4d y = vec4d_load_aligned(v + k);
+                    y = vec4d_mulmod(y, t, n, ninv);
+                    vec4d_store_aligned(u + k, _vec4d_red(vec4d_add(x, y), n, ninv));
+                    vec4d_store_aligned(v + k, _vec4d_red(vec4d_sub(x, y), n, ninv));
+                }
+            }
+        }
+    }
+}
+
+/* multiply along the block index, chunk by chunk, in place in the store */
+static void
+_mul_blocked_outer(double * store, const _mul_blocked_param_struct * P,
+                   int squaring, double * buf, mpn_ctx_struct * R)
+{
+    ulong L = n_pow2(P->ldepth), C = P->chunk, zb = P->xb + P->yb - 1;
+    ulong i, r, c0, c, k;
+    double * a = buf;
+    double * b = buf + L * C;
+    double * w = buf + (squaring ? 1 : 2) * L * C;
+    double * winv = w + L / 2;
+
+    for (i = 0; i < MUL_BLOCKED_NP; i++)
+    {
+        sd_fft_ctx_struct * F = R->ffts + i;
+        ulong g, g_inv, sc;
+        vec4d n = vec4d_set_d(F->p), ninv = vec4d_set_d(F->pinv), s4;
+
+        /* roots of unity of order L */
+        g = nmod_pow_ui(F->primitive_root, (F->mod.n - 1) >> P->ldepth, F->mod);
+        g_inv = nmod_inv(g, F->mod);
+
+        for (k = 0, c = 1, r = 1; k < L / 2; k++)
+        {
+            w[k] = vec1d_reduce_0n_to_pmhn(c, F->p);
+            winv[k] = vec1d_reduce_0n_to_pmhn(r, F->p);
+            c = nmod_mul(c, g, F->mod);
+            r = nmod_mul(r, g_inv, F->mod);
+        }
+
+        /* undo the factors N and L of the transforms and the CRT cofactor */
+        sc = nmod_mul(n_pow2(P->depth) % F->mod.n, L % F->mod.n, F->mod);
+        sc = nmod_mul(sc, *crt_data_co_prime_red(R->crts + MUL_BLOCKED_NP - 1, i), F->mod);
+        sc = nmod_inv(sc, F->mod);
+        s4 = vec4d_set_d(vec1d_reduce_0n_to_pmhn(sc, F->p));
+
+        for (c0 = 0; c0 < P->stride; c0 += C)
+        {
+            c = FLINT_MIN(C, P->stride - c0);
+
+            for (r = 0; r < L; r++)
+            {
+                if (r < P->xb)
+                    memcpy(a + r * C, _mul_blocked_row(store, P, r, i) + c0,
+                                                        c * sizeof(double));
+                else
+                    memset(a + r * C, 0, c * sizeof(double));
+
+                if (squaring)
+                    continue;
+
+                if (r < P->yb)
+                    memcpy(b + r * C,
+                        _mul_blocked_row(store, P, P->xb + r, i) + c0,
+                                                        c * sizeof(double));
+                else
+                    memset(b + r * C, 0, c * sizeof(double));
+            }
+
+            _mul_blocked_outer_fft(a, P->ldepth, C, w, F->p, F->pinv);
+
+            if (!squaring)
+                _mul_blocked_outer_fft(b, P->ldepth, C, w, F->p, F->pinv);
+
+            for (r = 0; r < L; r++)
+            {
+                double * u = a + r * C;
+                double * v = (squaring ? a : b) + r * C;
+
+                for (k = 0; k < c; k += 4)
+                {
+                    vec4d x = vec4d_mulmod(vec4d_load_aligned(u + k),
+                                        vec4d_load_aligned(v + k), n, ninv);
+                    x = vec4d_mulmod(_vec4d_red(x, n, ninv), s4, n, ninv);
+                    vec4d_store_aligned(u + k, _vec4d_red(x, n, ninv));
+                }
+            }
+
+            _mul_blocked_outer_ifft(a, P->ldepth, C, winv, F->p, F->pinv);
+
+            for (r = 0; r < zb; r++)
+                memcpy(_mul_blocked_row(store, P, r, i) + c0, a + r * C,
+                                                        c * sizeof(double));
+        }
+    }
+}
+
+/* transform the rows of the result back and add them into z */
+static void
+_mul_blocked_inner_ifft(mp_ptr z, mp_size_t zn, double * store,
+                        const _mul_blocked_param_struct * P,
+                        double * buf, mpn_ctx_struct * R)
+{
+    const crt_data_struct * crt = R->crts + MUL_BLOCKED_NP - 1;
+    ulong clen = crt->coeff_len, m = P->m, tn = 2 * m + clen + 1;
+    ulong s, i, j, zb = P->xb + P->yb - 1;
+    mp_size_t off, len, hi = 0;
+    mp_ptr t = (mp_ptr) (buf + MUL_BLOCKED_NP * P->stride);
+    mp_ptr v = t + tn;
+    sd_fft_lctx_t Q[MUL_BLOCKED_NP];
+
+    for (i = 0; i < MUL_BLOCKED_NP; i++)
+        sd_fft_lctx_init(Q[i], R->ffts + i, P->depth);
+
+    for (s = 0; s < zb; s++)
+    {
+        for (i = 0; i < MUL_BLOCKED_NP; i++)
+        {
+            memcpy(buf + i * P->stride, _mul_blocked_row(store, P, s, i),
+                                                P->stride * sizeof(double));
+            sd_fft_lctx_ifft_trunc(Q[i], buf + i * P->stride, P->depth, 2 * m);
+        }
+
+        flint_mpn_zero(t, tn);
+
+        /* the block product sum has 2m - 1 coefficients */
+        for (j = 0; j + 1 < 2 * m; j++)
+        {
+            flint_mpn_zero(v, clen + 1);
+
+            for (i = 0; i < MUL_BLOCKED_NP; i++)
+            {
+                sd_fft_ctx_struct * F = R->ffts + i;
+                double d = sd_fft_ctx_get_index(buf + i * P->stride, j);
+                ulong r = vec1d_reduce_to_0n(d, F->p, F->pinv);
+
+                v[clen] += mpn_addmul_1(v, crt_data_co_prime(crt, i), clen, r);
+            }
+
+            while (mpn_cmp(v, crt_data_prod_primes(crt), clen) >= 0 || v[clen])
+                v[clen] -= mpn_sub_n(v, v, crt_data_prod_primes(crt), clen);
+
+            mpn_add(t + j, t + j, tn - j, v, clen);
+        }
+
+        /* add t at limb offset m s, zeroing the limbs not written yet */
+        off = s * m;
+        len = FLINT_MIN((mp_size_t) tn, zn - off);
+
+        if (off + len > hi)
+        {
+            flint_mpn_zero(z + hi, off + len - hi);
+            hi = off + len;
+        }
+
+        mpn_add_n(z + off, z + off, t, len);
+    }
+
+    if (hi < zn)
+        flint_mpn_zero(z + hi, zn - hi);
+
+    for (i = 0; i < MUL_BLOCKED_NP; i++)
+        sd_fft_lctx_clear(Q[i], R->ffts + i);
+}
+
+size_t
+flint_mpn_mul_blocked_store_size(mp_size_t xn, mp_size_t yn,
+                                                        mp_size_t max_limbs)
+{
+    _mul_blocked_param_struct P;
+    mpn_ctx_struct * R;
+
+    if (xn <= max_limbs / MUL_BLOCKED_RATIO)
+        return 0;
+
+    R = get_default_mpn_ctx();
+
+    if (!_mul_blocked_params(&P, xn, yn, max_limbs, _mul_blocked_crt_len(R)))
+        return 0;
+
+    return (P.xb + P.yb) * MUL_BLOCKED_NP * P.stride * sizeof(double);
+}
+
+mp_limb_t
+flint_mpn_mul_blocked(mp_ptr z, mp_srcptr x, mp_size_t xn,
+        mp_srcptr y, mp_size_t yn, mp_size_t max_limbs, void * store)
+{
+    _mul_blocked_param_struct P;
+    mpn_ctx_struct * R;
+    double * buf, * st;
+    int squaring;
+
+    FLINT_ASSERT(xn >= yn);
+    FLINT_ASSERT(yn >= 1);
+
+    if (xn <= max_limbs / MUL_BLOCKED_RATIO)
+        return flint_mpn_mul(z, x, xn, y, yn);
+
+    squaring = (x == y && xn == yn);
+    R = get_default_mpn_ctx();
+
+    if (!_mul_blocked_params(&P, xn, yn, max_limbs, _mul_blocked_crt_len(R)))
+    {
+        _flint_mpn_mul_blocked_basecase(z, x, xn, y, yn,
+                                FLINT_MAX(max_limbs / MUL_BLOCKED_RATIO, 1));
+        return z[xn + yn - 1];
+    }
+
+    buf = (double *) flint_aligned_alloc(64, n_round_up(P.alloc * sizeof(double), 64));
+    st = (store != NULL) ? (double *) store : (double *) flint_malloc(
+                        (P.xb + P.yb) * MUL_BLOCKED_NP * P.stride * sizeof(double));
+
+    _mul_blocked_inner_fft(st, &P, 0, x, xn, buf, R);
+
+    if (!squaring)
+        _mul_blocked_inner_fft(st, &P, P.xb, y, yn, buf, R);
+
+    _mul_blocked_outer(st, &P, squaring, buf, R);
+    _mul_blocked_inner_ifft(z, xn + yn, st, &P, buf, R);
+
+    if (store == NULL)
+        flint_free(st);
+
+    flint_aligned_free(buf);
+
+    return z[xn + yn - 1];
+}
+
+#else
+
+size_t
+flint_mpn_mul_blocked_store_size(mp_size_t xn, mp_size_t yn,
+                                                        mp_size_t max_limbs)
+{
+    return 0;
+}
+
+mp_limb_t
+flint_mpn_mul_blocked(mp_ptr z, mp_srcptr x, mp_size_t xn,
+        mp_srcptr y, mp_size_t yn, mp_size_t max_limbs, void * store)
+{
+    mp_size_t k;
+
+    FLINT_ASSERT(xn >= yn);
+    FLINT_ASSERT(yn >= 1);
+
+    k = FLINT_MAX(max_limbs / MUL_BLOCKED_RATIO, 1);
+
+    if (xn <= k)
+        return flint_mpn_mul(z, x, xn, y, yn);
+
+    _flint_mpn_mul_blocked_basecase(z, x, xn, y, yn, k);
+
+    return z[xn + yn - 1];
+}
+
+#endif
@@ -0,0 +1,153 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include "flint.h"
+#include "mpn_extras.h"
+
+#if !defined(_MSC_VER) && !defined(__MINGW32__)
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+/* map the limbs of an existing file for reading */
+static mp_ptr
+_mul_blocked_map_read(const char * name, mp_size_t * n, size_t * bytes)
+{
+    struct stat st;
+    void * p;
+    int fd;
+
+    fd = open(name, O_RDONLY);
+    if (fd == -1)
+        flint_throw(FLINT_ERROR, "Exception (flint_mpn_mul_blocked_file). "
+                                        "Cannot open %s.\n", name);
+
+    if (fstat(fd, &st) == -1 || st.st_size == 0
+                            || st.st_size % sizeof(mp_limb_t) != 0)
+        flint_throw(FLINT_ERROR, "Exception (flint_mpn_mul_blocked_file). "
+                            "%s is not a nonempty array of limbs.\n", name);
+
+    *bytes = st.st_size;
+    *n = st.st_size / sizeof(mp_limb_t);
+
+    p = mmap(NULL, *bytes, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED)
+        flint_throw(FLINT_ERROR, "Exception (flint_mpn_mul_blocked_file). "
+                                        "Cannot map %s.\n", name);
+
+    close(fd);
+
+    return (mp_ptr) p;
+}
+
+/* create or truncate the file to the given size and map it for writing */
+static void *
+_mul_blocked_map_write(const char * name, size_t bytes)
+{
+    void * p;
+    int fd;
+
+    fd = open(name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1)
+        flint_throw(FLINT_ERROR, "Exception (flint_mpn_mul_blocked_file). "
+                                        "Cannot create %s.\n", name);
+
+    if (ftruncate(fd, bytes) == -1)
+        flint_throw(FLINT_ERROR, "Exception (flint_mpn_mul_blocked_file). "
+                                        "Cannot resize %s.\n", name);
+
+    p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED)
+        flint_throw(FLINT_ERROR, "Exception (flint_mpn_mul_blocked_file). "
+                                        "Cannot map %s.\n", name);
+
+    close(fd);
+
+    return p;
+}
+
+void
+flint_mpn_mul_blocked_file(const char * zname, const char * xname,
+                                const char * yname, mp_size_t max_limbs)
+{
+    mp_ptr x, y, z;
+    mp_size_t xn, yn;
+    size_t xbytes, ybytes, zbytes, store_size;
+    void * store = NULL;
+    char * store_name;
+
+    x = _mul_blocked_map_read(xname, &xn, &xbytes);
+
+    if (strcmp(xname, yname) == 0)
+    {
+        y = x;
+        yn = xn;
+        ybytes = 0;
+    }
+    else
+    {
+        y = _mul_blocked_map_read(yname, &yn, &ybytes);
+    }
+
+    zbytes = (xn + yn) * sizeof(mp_limb_t);
+    z = (mp_ptr) _mul_blocked_map_write(zname, zbytes);
+
+    if (xn < yn)
+    {
+        MP_PTR_SWAP(x, y);
+        SLONG_SWAP(xn, yn);
+        ULONG_SWAP(xbytes, ybytes);
+    }
+
+    /* the store is unlinked at once and disappears when unmapped */
+    store_size = flint_mpn_mul_blocked_store_size(xn, yn, max_limbs);
+
+    if (store_size != 0)
+    {
+        store_name = flint_malloc(strlen(zname) + 7);
+        strcpy(store_name, zname);
+        strcat(store_name, ".store");
+
+        store = _mul_blocked_map_write(store_name, store_size);
+        unlink(store_name);
+
+        flint_free(store_name);
+    }
+
+    flint_mpn_mul_blocked(z, x, xn, y, yn, max_limbs, store);
+
+    if (msync(z, zbytes, MS_SYNC) == -1)
+        flint_throw(FLINT_ERROR, "Exception (flint_mpn_mul_blocked_file). "
+                                        "Cannot write %s.\n", zname);
+
+    munmap(z, zbytes);
+    munmap(x, xbytes);
+    if (ybytes != 0)
+        munmap(y, ybytes);
+    if (store != NULL)
+        munmap(store, store_size);
+}
+
+#else
+
+void
+flint_mpn_mul_blocked_file(const char * zname, const char * xname,
+                                const char * yname, mp_size_t max_limbs)
+{
+    flint_throw(FLINT_ERROR, "Exception (flint_mpn_mul_blocked_file). "
+                    "Memory-mapped files are not supported on this system.\n");
+}
+
+#endif
@@ -0,0 +1,95 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "mpn_extras.h"
+#include "ulong_extras.h"
+
+int main(void)
+{
+    slong iter;
+
+    FLINT_TEST_INIT(state);
+    _flint_rand_init_gmp(state);
+
+    flint_printf("mul_blocked....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 1000 * flint_test_multiplier(); iter++)
+    {
+        mp_size_t xn, yn, max_limbs;
+        mp_ptr x, y, z1, z2;
+        mp_limb_t top;
+        size_t store_size;
+        void * store;
+        int squaring;
+
+        squaring = n_randint(state, 4) == 0;
+
+        if (n_randint(state, 10) == 0)
+            xn = 1 + n_randint(state, 20000);
+        else
+            xn = 1 + n_randint(state, 1000);
+
+        yn = squaring ? xn : 1 + n_randint(state, xn);
+
+        switch (n_randint(state, 3))
+        {
+            case 0:
+                max_limbs = n_randint(state, 16 * 50);
+                break;
+            case 1:
+                max_limbs = n_randint(state, 16 * xn + 100);
+                break;
+            default:
+                /* small enough for several blocks in the transform */
+                max_limbs = 2500 + n_randint(state, 4 * xn);
+                break;
+        }
+
+        store_size = flint_mpn_mul_blocked_store_size(xn, yn, max_limbs);
+        store = (store_size != 0 && n_randint(state, 2)) ?
+                                                flint_malloc(store_size) : NULL;
+
+        x = flint_malloc(sizeof(mp_limb_t) * xn);
+        y = squaring ? x : flint_malloc(sizeof(mp_limb_t) * yn);
+        z1 = flint_malloc(sizeof(mp_limb_t) * (xn + yn));
+        z2 = flint_malloc(sizeof(mp_limb_t) * (xn + yn));
+
+        flint_mpn_rrandom(x, state->gmp_state, xn);
+        if (!squaring)
+            flint_mpn_rrandom(y, state->gmp_state, yn);
+        flint_mpn_rrandom(z2, state->gmp_state, xn + yn);
+
+        mpn_mul(z1, x, xn, y, yn);
+        top = flint_mpn_mul_blocked(z2, x, xn, y, yn, max_limbs, store);
+
+        if (mpn_cmp(z1, z2, xn + yn) != 0 || top != z2[xn + yn - 1])
+        {
+            flint_printf("FAIL\n");
+            flint_printf("xn = %wd, yn = %wd, max_limbs = %wd, squaring = %d\n",
+                                                xn, yn, max_limbs, squaring);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        flint_free(x);
+        if (!squaring)
+            flint_free(y);
+        flint_free(z1);
+        flint_free(z2);
+        flint_free(store);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,164 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+/* try to get mkstemp declared */
+#if defined __STRICT_ANSI__
+#undef __STRICT_ANSI__
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if !defined(_MSC_VER) && !defined(__MINGW32__)
+#include <unistd.h>
+#endif
+#include "mpn_extras.h"
+#include "ulong_extras.h"
+
+#if !defined(_MSC_VER) && !defined(__MINGW32__)
+
+void temp_name(char * name)
+{
+    int fd;
+
+    strcpy(name, FLINT_TMPDIR "/mbtestXXXXXX");
+    fd = mkstemp(name);
+    if (fd == -1)
+    {
+        flint_printf("FAIL: mkstemp\n");
+        fflush(stdout);
+        flint_abort();
+    }
+    close(fd);
+}
+
+void write_limbs(const char * name, mp_srcptr x, mp_size_t n)
+{
+    FILE * f = fopen(name, "wb");
+
+    if (f == NULL || fwrite(x, sizeof(mp_limb_t), n, f) != (size_t) n)
+    {
+        flint_printf("FAIL: write %s\n", name);
+        fflush(stdout);
+        flint_abort();
+    }
+
+    fclose(f);
+}
+
+/* returns the number of limbs read */
+mp_size_t read_limbs(mp_ptr x, mp_size_t n, const char * name)
+{
+    FILE * f = fopen(name, "rb");
+    mp_size_t len;
+
+    if (f == NULL)
+        return -1;
+
+    len = fread(x, sizeof(mp_limb_t), n, f);
+
+    if (fgetc(f) != EOF)
+        len = -1;
+
+    fclose(f);
+
+    return len;
+}
+
+#endif
+
+int main(void)
+{
+    FLINT_TEST_INIT(state);
+    _flint_rand_init_gmp(state);
+
+    flint_printf("mul_blocked_file....");
+    fflush(stdout);
+
+#if !defined(_MSC_VER) && !defined(__MINGW32__)
+    {
+        slong iter;
+        char xname[30], yname[30], zname[30];
+
+        for (iter = 0; iter < 20 * flint_test_multiplier(); iter++)
+        {
+            mp_size_t xn, yn, max_limbs;
+            mp_ptr x, y, z1, z2;
+            int squaring;
+
+            squaring = n_randint(state, 4) == 0;
+
+            xn = 1 + n_randint(state, 5000);
+            yn = squaring ? xn : 1 + n_randint(state, 5000);
+            max_limbs = n_randint(state, 2) ? n_randint(state, 400)
+                                            : 2500 + n_randint(state, 5000);
+
+            x = flint_malloc(sizeof(mp_limb_t) * xn);
+            y = flint_malloc(sizeof(mp_limb_t) * yn);
+            z1 = flint_malloc(sizeof(mp_limb_t) * (xn + yn));
+            z2 = flint_malloc(sizeof(mp_limb_t) * (xn + yn));
+
+            flint_mpn_rrandom(x, state->gmp_state, xn);
+            if (squaring)
+                flint_mpn_copyi(y, x, xn);
+            else
+                flint_mpn_rrandom(y, state->gmp_state, yn);
+
+            temp_name(xname);
+            temp_name(zname);
+            write_limbs(xname, x, xn);
+
+            if (squaring)
+            {
+                strcpy(yname, xname);
+            }
+            else
+            {
+                temp_name(yname);
+                write_limbs(yname, y, yn);
+            }
+
+            /* either operand may be the longer one */
+            if (xn >= yn)
+                mpn_mul(z1, x, xn, y, yn);
+            else
+                mpn_mul(z1, y, yn, x, xn);
+
+            flint_mpn_mul_blocked_file(zname, xname, yname, max_limbs);
+
+            if (read_limbs(z2, xn + yn, zname) != xn + yn
+                                    || mpn_cmp(z1, z2, xn + yn) != 0)
+            {
+                flint_printf("FAIL\n");
+                flint_printf("xn = %wd, yn = %wd, max_limbs = %wd, squaring = %d\n",
+                                                xn, yn, max_limbs, squaring);
+                fflush(stdout);
+                flint_abort();
+            }
+
+            remove(xname);
+            if (!squaring)
+                remove(yname);
+            remove(zname);
+
+            flint_free(x);
+            flint_free(y);
+            flint_free(z1);
+            flint_free(z2);
+        }
+    }
+#endif
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -140,6 +140,40 @@ typedef struct mpoly_heap_s
    void * next;
 } mpoly_heap_s;
 
+/* arena *********************************************************************/
+
+/*
+    Per-thread stack of scratch memory for the heap kernels. Memory obtained
+    from mpoly_arena_alloc is valid until the matching mpoly_arena_release;
+    marks must be released in the reverse order in which they were made.
+*/
+typedef struct mpoly_arena_block_struct
+{
+    struct mpoly_arena_block_struct * prev;
+    size_t size;
+    size_t used;
+} mpoly_arena_block_struct;
+
+typedef struct
+{
+    mpoly_arena_block_struct * block;
+    size_t used;
+} mpoly_arena_mark_struct;
+
+typedef mpoly_arena_mark_struct mpoly_arena_mark_t[1];
+
+void mpoly_arena_mark(mpoly_arena_mark_t m);
+
+void * mpoly_arena_alloc(mpoly_arena_mark_t m, size_t size);
+
+void mpoly_arena_release(mpoly_arena_mark_t m);
+
+void mpoly_arena_clear(void);
+
+size_t mpoly_arena_size(void);
+
+ulong mpoly_arena_num_mallocs(void);
+
 /* trees *********************************************************************/
 
 /* red-black with ui keys */
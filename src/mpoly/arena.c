@@ -0,0 +1,232 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "mpoly.h"
+
+/*
+    Each thread owns a stack of blocks. Allocations are carved from the top
+    block, and a new block is pushed when it is full. When the outermost
+    mark is released, the blocks are replaced by a single block as large as
+    the most memory ever in use (up to ARENA_MAX_KEEP bytes), so that a
+    sequence of similar computations stops calling malloc after the first.
+
+    Without thread local storage a thread safe build cannot share the stack
+    between threads; there every allocation gets its own block, which is
+    chained to the mark and freed on release.
+*/
+
+#define ARENA_ALIGN 16
+
+/* the smallest block allocated */
+#define ARENA_MIN_BLOCK 4096
+
+/* the largest block kept once all marks are released */
+#define ARENA_MAX_KEEP (((size_t) 1) << 26)
+
+#define ARENA_HEADER ((sizeof(mpoly_arena_block_struct) + ARENA_ALIGN - 1) \
+                                               & ~((size_t) ARENA_ALIGN - 1))
+
+#define ARENA_DATA(b) ((char *) (b) + ARENA_HEADER)
+
+#define ARENA_USES_STACK (FLINT_USES_TLS || !FLINT_USES_PTHREAD)
+
+static FLINT_TLS_PREFIX ulong arena_num_mallocs = 0;
+
+static mpoly_arena_block_struct * _arena_block_new(
+                            mpoly_arena_block_struct * prev, size_t size)
+{
+    mpoly_arena_block_struct * b;
+
+    b = (mpoly_arena_block_struct *) flint_malloc(ARENA_HEADER + size);
+    b->prev = prev;
+    b->size = size;
+    b->used = 0;
+
+    arena_num_mallocs++;
+
+    return b;
+}
+
+#if ARENA_USES_STACK
+
+static FLINT_TLS_PREFIX mpoly_arena_block_struct * arena_top = NULL;
+static FLINT_TLS_PREFIX slong arena_depth = 0;     /* number of live marks */
+static FLINT_TLS_PREFIX size_t arena_in_use = 0;   /* bytes handed out */
+static FLINT_TLS_PREFIX size_t arena_peak = 0;     /* max of arena_in_use */
+static FLINT_TLS_PREFIX int arena_have_registered_cleanup = 0;
+
+void mpoly_arena_clear(void)
+{
+    mpoly_arena_block_struct * b;
+
+    FLINT_ASSERT(arena_depth == 0);
+
+    while (arena_top != NULL)
+    {
+        b = arena_top;
+        arena_top = b->prev;
+        flint_free(b);
+    }
+
+    arena_in_use = 0;
+    arena_peak = 0;
+}
+
+/*
+    flint_cleanup forgets the functions it has run, so the next mark of the
+    thread has to register again
+*/
+static void _mpoly_arena_cleanup(void)
+{
+    mpoly_arena_clear();
+    arena_have_registered_cleanup = 0;
+}
+
+void mpoly_arena_mark(mpoly_arena_mark_t m)
+{
+    if (!arena_have_registered_cleanup)
+    {
+        flint_register_cleanup_function(_mpoly_arena_cleanup);
+        arena_have_registered_cleanup = 1;
+    }
+
+    m->block = arena_top;
+    m->used = (arena_top != NULL) ? arena_top->used : 0;
+    arena_depth++;
+}
+
+void * mpoly_arena_alloc(mpoly_arena_mark_t m, size_t size)
+{
+    void * p;
+
+    FLINT_ASSERT(arena_depth > 0);
+
+    size = (size + ARENA_ALIGN - 1) & ~((size_t) ARENA_ALIGN - 1);
+
+    if (arena_top == NULL || arena_top->size - arena_top->used < size)
+    {
+        size_t new_size = FLINT_MAX(size, ARENA_MIN_BLOCK);
+
+        /* grow geometrically */
+        if (arena_top != NULL)
+            new_size = FLINT_MAX(new_size, 2*arena_top->size);
+
+        arena_top = _arena_block_new(arena_top, new_size);
+    }
+
+    p = ARENA_DATA(arena_top) + arena_top->used;
+    arena_top->used += size;
+
+    arena_in_use += size;
+    arena_peak = FLINT_MAX(arena_peak, arena_in_use);
+
+    return p;
+}
+
+void mpoly_arena_release(mpoly_arena_mark_t m)
+{
+    mpoly_arena_block_struct * b;
+    size_t peak;
+
+    FLINT_ASSERT(arena_depth > 0);
+
+    while (arena_top != m->block)
+    {
+        b = arena_top;
+        arena_top = b->prev;
+        arena_in_use -= b->used;
+        flint_free(b);
+    }
+
+    if (arena_top != NULL)
+    {
+        arena_in_use -= arena_top->used - m->used;
+        arena_top->used = m->used;
+    }
+
+    arena_depth--;
+
+    if (arena_depth > 0)
+        return;
+
+    FLINT_ASSERT(arena_in_use == 0);
+
+    /* everything is free: keep one block that fits the peak usage */
+    if (arena_top != NULL && arena_top->size >= arena_peak &&
+                             arena_top->size <= ARENA_MAX_KEEP)
+    {
+        return;
+    }
+
+    peak = arena_peak;
+
+    mpoly_arena_clear();
+
+    if (peak <= ARENA_MAX_KEEP)
+    {
+        arena_top = _arena_block_new(NULL, FLINT_MAX(peak, ARENA_MIN_BLOCK));
+        arena_peak = peak;
+    }
+}
+
+size_t mpoly_arena_size(void)
+{
+    mpoly_arena_block_struct * b;
+    size_t size = 0;
+
+    for (b = arena_top; b != NULL; b = b->prev)
+        size += b->size;
+
+    return size;
+}
+
+#else
+
+void mpoly_arena_clear(void)
+{
+}
+
+void mpoly_arena_mark(mpoly_arena_mark_t m)
+{
+    m->block = NULL;
+    m->used = 0;
+}
+
+void * mpoly_arena_alloc(mpoly_arena_mark_t m, size_t size)
+{
+    m->block = _arena_block_new(m->block, size);
+    m->block->used = size;
+    return ARENA_DATA(m->block);
+}
+
+void mpoly_arena_release(mpoly_arena_mark_t m)
+{
+    mpoly_arena_block_struct * b;
+
+    while (m->block != NULL)
+    {
+        b = m->block;
+        m->block = b->prev;
+        flint_free(b);
+    }
+}
+
+size_t mpoly_arena_size(void)
+{
+    return 0;
+}
+
+#endif
+
+ulong mpoly_arena_num_mallocs(void)
+{
+    return arena_num_mallocs;
+}
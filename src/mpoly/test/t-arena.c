@@ -0,0 +1,150 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "flint.h"
+#include "mpoly.h"
+#include "ulong_extras.h"
+
+#define MAX_DEPTH 6
+#define MAX_ALLOCS 5
+
+/*
+    make nested marks with random allocations filled with a pattern, and
+    check the pattern before releasing; the sizes are drawn from the given
+    state so that the same sequence can be replayed
+*/
+static void
+nested(flint_rand_t state, slong depth, slong max_size)
+{
+    mpoly_arena_mark_t m;
+    ulong * p[MAX_ALLOCS];
+    slong n[MAX_ALLOCS];
+    slong i, j, num;
+
+    mpoly_arena_mark(m);
+
+    num = n_randint(state, MAX_ALLOCS + 1);
+    for (i = 0; i < num; i++)
+    {
+        n[i] = n_randint(state, max_size);
+        p[i] = (ulong *) mpoly_arena_alloc(m, n[i]*sizeof(ulong));
+
+        if (((ulong) p[i]) % 16 != 0)
+        {
+            flint_printf("FAIL: alignment\n");
+            fflush(stdout);
+            flint_abort();
+        }
+
+        for (j = 0; j < n[i]; j++)
+            p[i][j] = depth*1000003 + i*1009 + j;
+    }
+
+    if (depth < MAX_DEPTH && n_randint(state, 3) != 0)
+        nested(state, depth + 1, max_size);
+
+    for (i = 0; i < num; i++)
+    {
+        for (j = 0; j < n[i]; j++)
+        {
+            if (p[i][j] != depth*1000003 + i*1009 + j)
+            {
+                flint_printf("FAIL: check memory\n");
+                flint_printf("depth = %wd, i = %wd, j = %wd\n", depth, i, j);
+                fflush(stdout);
+                flint_abort();
+            }
+        }
+    }
+
+    mpoly_arena_release(m);
+}
+
+int
+main(void)
+{
+    slong iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("arena....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 1000 * flint_test_multiplier(); iter++)
+    {
+        flint_rand_t state2;
+        ulong seed1, seed2, mallocs;
+        slong max_size = 1 + n_randint(state, 10000);
+
+        seed1 = n_randlimb(state);
+        seed2 = n_randlimb(state);
+
+        flint_randinit(state2);
+        flint_randseed(state2, seed1, seed2);
+        nested(state2, 0, max_size);
+
+        if (n_randint(state, 20) == 0)
+            mpoly_arena_clear();
+
+        flint_randseed(state2, seed1, seed2);
+        nested(state2, 0, max_size);
+
+        /* replaying the same sequence must not allocate again */
+        mallocs = mpoly_arena_num_mallocs();
+        flint_randseed(state2, seed1, seed2);
+        nested(state2, 0, max_size);
+
+#if FLINT_USES_TLS || !FLINT_USES_PTHREAD
+        if (mallocs != mpoly_arena_num_mallocs())
+        {
+            flint_printf("FAIL: warm arena allocated\n");
+            flint_printf("iter = %wd\n", iter);
+            fflush(stdout);
+            flint_abort();
+        }
+#endif
+
+        flint_randclear(state2);
+    }
+
+    mpoly_arena_clear();
+
+    if (mpoly_arena_size() != 0)
+    {
+        flint_printf("FAIL: arena not empty after clear\n");
+        fflush(stdout);
+        flint_abort();
+    }
+
+    /* the arena must be registered again after flint_cleanup */
+    for (iter = 0; iter < 2; iter++)
+    {
+        mpoly_arena_mark_t m;
+
+        mpoly_arena_mark(m);
+        mpoly_arena_alloc(m, 100);
+        mpoly_arena_release(m);
+
+        flint_cleanup();
+
+        if (mpoly_arena_size() != 0)
+        {
+            flint_printf("FAIL: arena not empty after flint_cleanup\n");
+            flint_printf("iter = %wd\n", iter);
+            fflush(stdout);
+            flint_abort();
+        }
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -216,6 +216,53 @@ void nmod_init(nmod_t * mod, mp_limb_t n)
    mod->norm = flint_clz(n);
 }
 
+/* Montgomery arithmetic *****************************************************/
+
+void nmod_mont_init(nmod_mont_t * mod, mp_limb_t n);
+
+/* (hi R + lo) / R mod n, assuming hi < n */
+NMOD_INLINE
+mp_limb_t nmod_mont_redc(mp_limb_t hi, mp_limb_t lo, nmod_mont_t mod)
+{
+    mp_limb_t th, tl;
+    umul_ppmm(th, tl, lo * mod.ninv, mod.n);
+    (void) tl;
+    return (hi >= th) ? hi - th : hi - th + mod.n;
+}
+
+NMOD_INLINE
+mp_limb_t nmod_mont_mul(mp_limb_t a, mp_limb_t b, nmod_mont_t mod)
+{
+    mp_limb_t hi, lo;
+    umul_ppmm(hi, lo, a, b);
+    return nmod_mont_redc(hi, lo, mod);
+}
+
+NMOD_INLINE
+mp_limb_t nmod_mont_set_ui(ulong a, nmod_mont_t mod)
+{
+    return nmod_mont_mul(a, mod.r2, mod);
+}
+
+NMOD_INLINE
+ulong nmod_mont_get_ui(mp_limb_t a, nmod_mont_t mod)
+{
+    return nmod_mont_redc(0, a, mod);
+}
+
+NMOD_INLINE
+mp_limb_t nmod_mont_add(mp_limb_t a, mp_limb_t b, nmod_mont_t mod)
+{
+    const mp_limb_t t = mod.n - b;
+    return a - t + ((-(mp_limb_t) (a < t)) & mod.n);
+}
+
+NMOD_INLINE
+mp_limb_t nmod_mont_sub(mp_limb_t a, mp_limb_t b, nmod_mont_t mod)
+{
+    return a - b + ((-(mp_limb_t) (a < b)) & mod.n);
+}
+
 /* discrete logs a la Pohlig - Hellman ***************************************/
 
 typedef struct {
@@ -0,0 +1,39 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "ulong_extras.h"
+#include "nmod.h"
+
+void
+nmod_mont_init(nmod_mont_t * mod, mp_limb_t n)
+{
+    mp_limb_t ninv, pinv;
+
+    if (n % 2 == 0)
+        flint_throw(FLINT_ERROR, "Exception (nmod_mont_init). Even modulus %wu.\n", n);
+
+    /* Newton iteration, starting from 5 correct bits */
+    ninv = (3 * n) ^ 2;
+    ninv *= 2 - n * ninv;
+    ninv *= 2 - n * ninv;
+    ninv *= 2 - n * ninv;
+#if FLINT64
+    ninv *= 2 - n * ninv;
+#endif
+
+    pinv = n_preinvert_limb(n);
+
+    mod->n = n;
+    mod->ninv = ninv;
+    mod->one = n_ll_mod_preinv(1, 0, n, pinv);
+    mod->r2 = n_mulmod2_preinv(mod->one, mod->one, n, pinv);
+    mod->r3 = n_mulmod2_preinv(mod->r2, mod->one, n, pinv);
+}
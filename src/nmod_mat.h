@@ -152,6 +152,11 @@ void nmod_mat_mul(nmod_mat_t C, const nmod_mat_t A, const nmod_mat_t B);
 
 int nmod_mat_mul_blas(nmod_mat_t C, const nmod_mat_t A, const nmod_mat_t B);
 
+int _nmod_mat_mul_double_op(nmod_mat_t D, const nmod_mat_t C,
+                            const nmod_mat_t A, const nmod_mat_t B, int op);
+
+int nmod_mat_mul_double(nmod_mat_t C, const nmod_mat_t A, const nmod_mat_t B);
+
 void nmod_mat_mul_classical(nmod_mat_t C, const nmod_mat_t A, const nmod_mat_t B);
 
 void
@@ -304,10 +309,12 @@ void nmod_mat_permute_rows(nmod_mat_t mat, const slong * perm_act, slong * perm_
 void nmod_mat_solve_tril(nmod_mat_t X, const nmod_mat_t L, const nmod_mat_t B, int unit);
 void nmod_mat_solve_tril_recursive(nmod_mat_t X, const nmod_mat_t L, const nmod_mat_t B, int unit);
 void nmod_mat_solve_tril_classical(nmod_mat_t X, const nmod_mat_t L, const nmod_mat_t B, int unit);
+void nmod_mat_solve_tril_threaded(nmod_mat_t X, const nmod_mat_t L, const nmod_mat_t B, int unit);
 
 void nmod_mat_solve_triu(nmod_mat_t X, const nmod_mat_t U, const nmod_mat_t B, int unit);
 void nmod_mat_solve_triu_recursive(nmod_mat_t X, const nmod_mat_t U, const nmod_mat_t B, int unit);
 void nmod_mat_solve_triu_classical(nmod_mat_t X, const nmod_mat_t U, const nmod_mat_t B, int unit);
+void nmod_mat_solve_triu_threaded(nmod_mat_t X, const nmod_mat_t U, const nmod_mat_t B, int unit);
 
 /* LU decomposition */
 
@@ -315,6 +322,7 @@ slong nmod_mat_lu(slong * P, nmod_mat_t A, int rank_check);
 slong nmod_mat_lu_classical(slong * P, nmod_mat_t A, int rank_check);
 slong nmod_mat_lu_classical_delayed(slong * P, nmod_mat_t A, int rank_check);
 slong nmod_mat_lu_recursive(slong * P, nmod_mat_t A, int rank_check);
+slong nmod_mat_lu_threaded(slong * P, nmod_mat_t A, int rank_check);
 
 /* Nonsingular solving */
 
@@ -372,6 +380,21 @@ void nmod_mat_similarity(nmod_mat_t M, slong r, ulong d);
 #define NMOD_MAT_SOLVE_TRI_ROWS_CUTOFF 64
 #define NMOD_MAT_SOLVE_TRI_COLS_CUTOFF 64
 
+/* Largest modulus size supported by nmod_mat_mul_double */
+#define NMOD_MAT_MUL_DOUBLE_MAX_BITS 26
+
+/* Largest modulus size and smallest dimension for which multiplication
+   uses nmod_mat_mul_double */
+#define NMOD_MAT_MUL_DOUBLE_BITS 22
+#define NMOD_MAT_MUL_DOUBLE_CUTOFF 16
+
+/* Smallest dimension for which single-threaded multiplication with small
+   moduli recurses through Strassen before nmod_mat_mul_double */
+#define NMOD_MAT_MUL_DOUBLE_STRASSEN_CUTOFF 3000
+
+/* Size from which nmod_mat_lu uses nmod_mat_lu_threaded with several threads */
+#define NMOD_MAT_LU_THREADED_CUTOFF 256
+
 /*
    Suggested initial modulus size for multimodular algorithms. This should
    be chosen so that we get the most number of bits per cycle
@@ -0,0 +1,221 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "thread_support.h"
+#include "nmod_mat.h"
+
+/*
+    Right-looking LU decomposition on column tiles of width b. After the
+    panel (tile) k has been factored, tile t > k is updated by solving
+    with the unit lower triangular part of the panel and subtracting a
+    product, U_t = L_kk^-1 A_kt and A'_t = A'_t - L'_k U_t.
+
+    The updates of the tiles t >= k + 2 are spawned as tasks while the
+    current thread updates tile k + 1 and factors it as the next panel,
+    so that the panel factorizations, which are hard to parallelize,
+    overlap with the bulk of the updates. Each task works on its own
+    window and runs single-threaded; the row permutation of a panel is
+    applied to the whole matrix once all tasks have been joined.
+*/
+
+#define LU_THREADED_MIN_BLOCK 64
+#define LU_THREADED_MAX_BLOCK 256
+
+typedef struct
+{
+    nmod_mat_struct * A;
+    slong row;
+    slong rank;
+    slong c0;
+    slong c1;
+}
+_lu_tile_arg_struct;
+
+/* update the columns c0, ..., c1 - 1 with the panel of the given rank at
+   row, whose L factor is stored in the columns row, ..., row + rank - 1 */
+static void
+_lu_tile_update(void * arg_ptr)
+{
+    _lu_tile_arg_struct * arg = (_lu_tile_arg_struct *) arg_ptr;
+    nmod_mat_struct * A = arg->A;
+    slong row = arg->row, r = arg->rank;
+    nmod_mat_t L00, L10, U, T;
+
+    if (r == 0)
+        return;
+
+    nmod_mat_window_init(L00, A, row, row, row + r, row + r);
+    nmod_mat_window_init(U, A, row, arg->c0, row + r, arg->c1);
+    nmod_mat_window_init(L10, A, row + r, row, A->r, row + r);
+    nmod_mat_window_init(T, A, row + r, arg->c0, A->r, arg->c1);
+
+    nmod_mat_solve_tril(U, L00, U, 1);
+
+    if (A->r > row + r)
+        nmod_mat_submul(T, T, L10, U);
+
+    nmod_mat_window_clear(L00);
+    nmod_mat_window_clear(U);
+    nmod_mat_window_clear(L10);
+    nmod_mat_window_clear(T);
+}
+
+/* factor the rows row, ..., of the columns c0, ..., c1 - 1 without
+   touching A->rows; the permutation is returned in P1 */
+static slong
+_lu_panel_factor(slong * P1, nmod_mat_t A, slong row, slong c0, slong c1)
+{
+    nmod_mat_t W;
+    slong r;
+
+    nmod_mat_window_init(W, A, row, c0, A->r, c1);
+    r = nmod_mat_lu(P1, W, 0);
+    nmod_mat_window_clear(W);
+
+    return r;
+}
+
+/* apply the permutation of a panel and move its L factor from the columns
+   starting at c0 to the columns starting at row */
+static void
+_lu_panel_finish(slong * P, nmod_mat_t A, const slong * P1,
+                                            slong row, slong rank, slong c0)
+{
+    slong i, j, m = A->r - row;
+    mp_ptr * Atmp;
+    slong * Ptmp;
+    mp_ptr r;
+
+    if (m == 0)
+        return;
+
+    Atmp = flint_malloc(sizeof(mp_ptr) * m);
+    Ptmp = flint_malloc(sizeof(slong) * m);
+
+    for (i = 0; i < m; i++) Atmp[i] = A->rows[row + P1[i]];
+    for (i = 0; i < m; i++) A->rows[row + i] = Atmp[i];
+    for (i = 0; i < m; i++) Ptmp[i] = P[row + P1[i]];
+    for (i = 0; i < m; i++) P[row + i] = Ptmp[i];
+
+    flint_free(Atmp);
+    flint_free(Ptmp);
+
+    if (row != c0)
+    {
+        for (i = 0; i < m; i++)
+        {
+            r = A->rows[row + i];
+
+            for (j = 0; j < FLINT_MIN(i, rank); j++)
+            {
+                r[row + j] = r[c0 + j];
+                r[c0 + j] = 0;
+            }
+        }
+    }
+}
+
+slong
+nmod_mat_lu_threaded(slong * P, nmod_mat_t A, int rank_check)
+{
+    slong i, m, n, b, k, t, ntiles, row, r, c0, c1, num_threads;
+    slong * P1;
+    _lu_tile_arg_struct * args;
+    thread_pool_task_struct * tasks;
+    int nworkers_save;
+
+    m = A->r;
+    n = A->c;
+
+    for (i = 0; i < m; i++)
+        P[i] = i;
+
+    if (m == 0 || n == 0)
+        return 0;
+
+    num_threads = flint_get_num_threads();
+
+    b = n / (4 * num_threads);
+    b = FLINT_MAX(b, LU_THREADED_MIN_BLOCK);
+    b = FLINT_MIN(b, LU_THREADED_MAX_BLOCK);
+    ntiles = (n + b - 1) / b;
+
+    P1 = flint_malloc(sizeof(slong) * m);
+    args = flint_malloc(sizeof(_lu_tile_arg_struct) * ntiles);
+    tasks = flint_malloc(sizeof(thread_pool_task_struct) * ntiles);
+
+    /* everything on this thread apart from the tasks is single-threaded */
+    nworkers_save = flint_set_num_workers(0);
+
+    row = 0;
+    c1 = FLINT_MIN(b, n);
+    r = _lu_panel_factor(P1, A, 0, 0, c1);
+    _lu_panel_finish(P, A, P1, 0, r, 0);
+
+    for (k = 0; ; k++)
+    {
+        c0 = k * b;
+        c1 = FLINT_MIN(c0 + b, n);
+
+        /* for m < n, a deficient panel does not imply deficient A */
+        if (rank_check && m >= n && r < c1 - c0)
+        {
+            row = 0;
+            break;
+        }
+
+        if (k == ntiles - 1)
+        {
+            row += r;
+            break;
+        }
+
+        for (t = k + 1; t < ntiles; t++)
+        {
+            args[t].A = A;
+            args[t].row = row;
+            args[t].rank = r;
+            args[t].c0 = t * b;
+            args[t].c1 = FLINT_MIN(t * b + b, n);
+        }
+
+        if (num_threads > 1)
+            for (t = ntiles - 1; t >= k + 2; t--)
+                thread_pool_spawn(global_thread_pool, tasks + t, 0,
+                                                _lu_tile_update, args + t);
+
+        /* look ahead: the next panel only depends on this update */
+        _lu_tile_update(args + k + 1);
+        row += r;
+        r = _lu_panel_factor(P1, A, row, c1, args[k + 1].c1);
+
+        if (num_threads > 1)
+            for (t = k + 2; t < ntiles; t++)
+                thread_pool_join(global_thread_pool, tasks + t);
+        else
+            for (t = k + 2; t < ntiles; t++)
+                _lu_tile_update(args + t);
+
+        _lu_panel_finish(P, A, P1, row, r, c1);
+    }
+
+    flint_reset_num_workers(nworkers_save);
+
+    if (rank_check && row < FLINT_MIN(m, n))
+        row = 0;
+
+    flint_free(P1);
+    flint_free(args);
+    flint_free(tasks);
+
+    return row;
+}
@@ -11,6 +11,7 @@
     (at your option) any later version.  See <https://www.gnu.org/licenses/>.
 */
 
+#include "nmod.h"
 #include "nmod_mat.h"
 #include "thread_support.h"
 
@@ -32,6 +33,26 @@ nmod_mat_mul(nmod_mat_t C, const nmod_mat_t A, const nmod_mat_t B)
     FLINT_ASSERT(C->c == B->c);
     FLINT_ASSERT(A->c == B->r);
 
+    /*
+        Small moduli are handled by nmod_mat_mul_double, which is faster
+        than going through blas; on a single thread without aliasing,
+        classical multiplication chooses between it and the packed
+        algorithm for tiny moduli. Large products still save a
+        multiplication per level with Strassen, whose blocks come back
+        here.
+    */
+    if (NMOD_BITS(A->mod) <= NMOD_MAT_MUL_DOUBLE_BITS &&
+        min_dim >= NMOD_MAT_MUL_DOUBLE_CUTOFF)
+    {
+        if (flint_num_threads > 1 || C == A || C == B)
+            nmod_mat_mul_double(C, A, B);
+        else if (min_dim >= NMOD_MAT_MUL_DOUBLE_STRASSEN_CUTOFF)
+            nmod_mat_mul_strassen(C, A, B);
+        else
+            nmod_mat_mul_classical(C, A, B);
+        return;
+    }
+
 #if FLINT_USES_BLAS
     /*
         tuning is based on several assumptions:
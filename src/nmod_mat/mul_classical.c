@@ -121,19 +121,26 @@ _nmod_mat_addmul_packed_op(mp_ptr * D, const mp_ptr * C, const mp_ptr * A,
             Aptr = A[i];
             Tptr = tmp + j * N;
 
-            c = 0;
-
-            /* unroll by 4 */
-            for (k = 0; k + 4 <= N; k += 4)
+            if (N >= NMOD_VEC_DOT1_DISPATCH_CUTOFF)
             {
-                c += Aptr[k + 0] * Tptr[k + 0];
-                c += Aptr[k + 1] * Tptr[k + 1];
-                c += Aptr[k + 2] * Tptr[k + 2];
-                c += Aptr[k + 3] * Tptr[k + 3];
+                c = _nmod_vec_dot1_nored(Aptr, Tptr, N);
+            }
+            else
+            {
+                c = 0;
+
+                /* unroll by 4 */
+                for (k = 0; k + 4 <= N; k += 4)
+                {
+                    c += Aptr[k + 0] * Tptr[k + 0];
+                    c += Aptr[k + 1] * Tptr[k + 1];
+                    c += Aptr[k + 2] * Tptr[k + 2];
+                    c += Aptr[k + 3] * Tptr[k + 3];
+                }
+
+                for ( ; k < N; k++)
+                    c += Aptr[k] * Tptr[k];
             }
-
-            for ( ; k < N; k++)
-                c += Aptr[k] * Tptr[k];
 
             /* unpack and reduce */
             for (k = 0; k < pack && j * pack + k < K; k++)
@@ -180,6 +187,16 @@ _nmod_mat_mul_classical_op(nmod_mat_t D, const nmod_mat_t C,
 
     nlimbs = _nmod_vec_dot_bound_limbs(k, mod);
 
+    /* unless the packed algorithm fits two entries in a limb */
+    if (NMOD_BITS(mod) <= NMOD_MAT_MUL_DOUBLE_BITS &&
+        FLINT_MIN(FLINT_MIN(m, k), n) >= NMOD_MAT_MUL_DOUBLE_CUTOFF &&
+        (2 * NMOD_BITS(mod) + FLINT_BIT_COUNT(k) > FLINT_BITS / 2 ||
+         FLINT_MIN(FLINT_MIN(m, k), n) >= 400) &&
+        _nmod_mat_mul_double_op(D, C, A, B, op))
+    {
+        return;
+    }
+
     if (nlimbs == 1 && m > 10 && k > 10 && n > 10)
     {
         _nmod_mat_addmul_packed_op(D->rows, (op == 0) ? NULL : C->rows,
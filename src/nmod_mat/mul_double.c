@@ -0,0 +1,403 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <math.h>
+#include "thread_support.h"
+#include "nmod.h"
+#include "nmod_mat.h"
+
+#if FLINT_HAVE_CPU_DISPATCH
+# include <immintrin.h>
+#endif
+
+/*
+    Multiplication for moduli n <= 2^26 with entries stored as doubles. A
+    dot product of at most (2^53 - n) / (n - 1)^2 terms of reduced entries
+    is computed exactly in double precision, so the products are
+    accumulated with delayed reduction and only reduced when that many
+    terms have been added since the previous reduction. For n < 2^20 this
+    happens every 8191 terms or less often.
+
+    The accumulation is blocked as in GotoBLAS. The product is computed in
+    tiles of DOUBLE_MC x DOUBLE_NC entries, accumulated in a buffer of
+    doubles. For each block of DOUBLE_KC terms, the DOUBLE_MC x DOUBLE_KC
+    tile of A is packed into panels of DOUBLE_MR rows and the DOUBLE_KC x
+    DOUBLE_NC tile of B into panels of DOUBLE_NR columns, both converted to
+    doubles and padded with zeros, and a micro-kernel updates DOUBLE_MR x
+    DOUBLE_NR blocks of the product kept in registers. The buffers thus
+    stay the same size however large the matrices are. With several
+    threads, each thread handles a block of rows.
+*/
+
+#define DOUBLE_MR 8
+#define DOUBLE_NR 8
+#define DOUBLE_MC 512
+#define DOUBLE_KC 256
+#define DOUBLE_NC 256
+
+static void
+_kernel_generic(double * c, slong ldc, const double * a,
+                                                const double * b, slong kc)
+{
+    double s[4][DOUBLE_NR];
+    slong h, i, j, l;
+
+    for (h = 0; h < DOUBLE_MR; h += 4)
+    {
+        for (i = 0; i < 4; i++)
+            for (j = 0; j < DOUBLE_NR; j++)
+                s[i][j] = 0.0;
+
+        for (l = 0; l < kc; l++)
+            for (i = 0; i < 4; i++)
+                for (j = 0; j < DOUBLE_NR; j++)
+                    s[i][j] += a[l * DOUBLE_MR + h + i] * b[l * DOUBLE_NR + j];
+
+        for (i = 0; i < 4; i++)
+            for (j = 0; j < DOUBLE_NR; j++)
+                c[(h + i) * ldc + j] += s[i][j];
+    }
+}
+
+#if FLINT_HAVE_CPU_DISPATCH
+
+__attribute__((target("avx2,fma")))
+static void
+_kernel_avx2(double * c, slong ldc, const double * a,
+                                                const double * b, slong kc)
+{
+    __m256d s00, s01, s10, s11, s20, s21, s30, s31, b0, b1, x;
+    slong h, l;
+
+    for (h = 0; h < DOUBLE_MR; h += 4)
+    {
+        const double * ah = a + h;
+        double * c0 = c + h * ldc;
+
+        s00 = s01 = s10 = s11 = _mm256_setzero_pd();
+        s20 = s21 = s30 = s31 = _mm256_setzero_pd();
+
+        for (l = 0; l < kc; l++)
+        {
+            b0 = _mm256_loadu_pd(b + l * DOUBLE_NR);
+            b1 = _mm256_loadu_pd(b + l * DOUBLE_NR + 4);
+
+            x = _mm256_broadcast_sd(ah + l * DOUBLE_MR + 0);
+            s00 = _mm256_fmadd_pd(x, b0, s00);
+            s01 = _mm256_fmadd_pd(x, b1, s01);
+            x = _mm256_broadcast_sd(ah + l * DOUBLE_MR + 1);
+            s10 = _mm256_fmadd_pd(x, b0, s10);
+            s11 = _mm256_fmadd_pd(x, b1, s11);
+            x = _mm256_broadcast_sd(ah + l * DOUBLE_MR + 2);
+            s20 = _mm256_fmadd_pd(x, b0, s20);
+            s21 = _mm256_fmadd_pd(x, b1, s21);
+            x = _mm256_broadcast_sd(ah + l * DOUBLE_MR + 3);
+            s30 = _mm256_fmadd_pd(x, b0, s30);
+            s31 = _mm256_fmadd_pd(x, b1, s31);
+        }
+
+#define ACC(cc, s) _mm256_storeu_pd((cc), _mm256_add_pd(_mm256_loadu_pd(cc), (s)))
+        ACC(c0 + 0 * ldc, s00); ACC(c0 + 0 * ldc + 4, s01);
+        ACC(c0 + 1 * ldc, s10); ACC(c0 + 1 * ldc + 4, s11);
+        ACC(c0 + 2 * ldc, s20); ACC(c0 + 2 * ldc + 4, s21);
+        ACC(c0 + 3 * ldc, s30); ACC(c0 + 3 * ldc + 4, s31);
+#undef ACC
+    }
+}
+
+__attribute__((target("avx512f")))
+static void
+_kernel_avx512(double * c, slong ldc, const double * a,
+                                                const double * b, slong kc)
+{
+    __m512d s0, s1, s2, s3, s4, s5, s6, s7, y;
+    slong l;
+
+    s0 = s1 = s2 = s3 = _mm512_setzero_pd();
+    s4 = s5 = s6 = s7 = _mm512_setzero_pd();
+
+    for (l = 0; l < kc; l++)
+    {
+        y = _mm512_loadu_pd(b + l * DOUBLE_NR);
+
+        s0 = _mm512_fmadd_pd(_mm512_set1_pd(a[l * DOUBLE_MR + 0]), y, s0);
+        s1 = _mm512_fmadd_pd(_mm512_set1_pd(a[l * DOUBLE_MR + 1]), y, s1);
+        s2 = _mm512_fmadd_pd(_mm512_set1_pd(a[l * DOUBLE_MR + 2]), y, s2);
+        s3 = _mm512_fmadd_pd(_mm512_set1_pd(a[l * DOUBLE_MR + 3]), y, s3);
+        s4 = _mm512_fmadd_pd(_mm512_set1_pd(a[l * DOUBLE_MR + 4]), y, s4);
+        s5 = _mm512_fmadd_pd(_mm512_set1_pd(a[l * DOUBLE_MR + 5]), y, s5);
+        s6 = _mm512_fmadd_pd(_mm512_set1_pd(a[l * DOUBLE_MR + 6]), y, s6);
+        s7 = _mm512_fmadd_pd(_mm512_set1_pd(a[l * DOUBLE_MR + 7]), y, s7);
+    }
+
+#define ACC(cc, s) _mm512_storeu_pd((cc), _mm512_add_pd(_mm512_loadu_pd(cc), (s)))
+    ACC(c + 0 * ldc, s0); ACC(c + 1 * ldc, s1);
+    ACC(c + 2 * ldc, s2); ACC(c + 3 * ldc, s3);
+    ACC(c + 4 * ldc, s4); ACC(c + 5 * ldc, s5);
+    ACC(c + 6 * ldc, s6); ACC(c + 7 * ldc, s7);
+#undef ACC
+}
+
+#endif
+
+typedef void (* _kernel_func)(double *, slong, const double *,
+                                                    const double *, slong);
+
+/* x mod n for 0 <= x < 2^53; fma makes x - q n exact */
+static void
+_reduce_rows(double * c, slong len, double n, double ninv)
+{
+    slong i;
+    double q, r;
+
+    for (i = 0; i < len; i++)
+    {
+        q = floor(c[i] * ninv);
+        r = fma(-q, n, c[i]);
+        r = (r < 0.0) ? r + n : r;
+        r = (r >= n) ? r - n : r;
+        c[i] = r;
+    }
+}
+
+typedef struct
+{
+    mp_ptr * D;
+    const mp_ptr * C;
+    const mp_ptr * A;
+    const mp_ptr * B;
+    slong m;
+    slong k;
+    slong n;
+    slong block;
+    slong kb;
+    int op;
+    nmod_t mod;
+    _kernel_func kernel;
+}
+_mul_double_arg_struct;
+
+/* pack rows i0, ..., i0 + mc - 1 of A, columns kk, ..., kk + kc - 1 */
+static void
+_pack_a(double * a, const mp_ptr * A, slong i0, slong mc, slong kk, slong kc)
+{
+    slong i, h, l;
+
+    for (i = 0; i < mc; i += DOUBLE_MR)
+    {
+        double * ap = a + i * kc;
+
+        for (h = 0; h < DOUBLE_MR; h++)
+        {
+            if (i + h < mc)
+            {
+                mp_srcptr Ai = A[i0 + i + h] + kk;
+
+                for (l = 0; l < kc; l++)
+                    ap[l * DOUBLE_MR + h] = (double) Ai[l];
+            }
+            else
+            {
+                for (l = 0; l < kc; l++)
+                    ap[l * DOUBLE_MR + h] = 0.0;
+            }
+        }
+    }
+}
+
+/* pack rows kk, ..., kk + kc - 1 of B, columns j0, ..., j0 + nc - 1 */
+static void
+_pack_b(double * b, const mp_ptr * B, slong kk, slong kc, slong j0, slong nc)
+{
+    slong j, h, l;
+
+    for (j = 0; j < nc; j += DOUBLE_NR)
+    {
+        double * bp = b + j * kc;
+        slong w = FLINT_MIN(DOUBLE_NR, nc - j);
+
+        for (l = 0; l < kc; l++)
+        {
+            mp_srcptr Bl = B[kk + l] + j0 + j;
+
+            for (h = 0; h < w; h++)
+                bp[l * DOUBLE_NR + h] = (double) Bl[h];
+            for ( ; h < DOUBLE_NR; h++)
+                bp[l * DOUBLE_NR + h] = 0.0;
+        }
+    }
+}
+
+static void
+_mul_double_worker(slong t, void * arg_ptr)
+{
+    _mul_double_arg_struct * arg = (_mul_double_arg_struct *) arg_ptr;
+    slong i, j, i0, i1, ii, jj, kk, mc, nc, kc, mcp, ncp, terms;
+    slong k = arg->k, n = arg->n;
+    double * a, * b, * c;
+    double dn, dninv;
+    mp_limb_t d;
+
+    i0 = t * arg->block;
+    i1 = FLINT_MIN(arg->m, i0 + arg->block);
+
+    if (i0 >= i1)
+        return;
+
+    a = flint_malloc(sizeof(double) * DOUBLE_MC * DOUBLE_KC);
+    b = flint_malloc(sizeof(double) * DOUBLE_KC * DOUBLE_NC);
+    c = flint_malloc(sizeof(double) * DOUBLE_MC * DOUBLE_NC);
+
+    dn = (double) arg->mod.n;
+    dninv = 1.0 / dn;
+
+    for (jj = 0; jj < n; jj += DOUBLE_NC)
+    {
+        nc = FLINT_MIN(DOUBLE_NC, n - jj);
+        ncp = ((nc + DOUBLE_NR - 1) / DOUBLE_NR) * DOUBLE_NR;
+
+        for (ii = i0; ii < i1; ii += DOUBLE_MC)
+        {
+            mc = FLINT_MIN(DOUBLE_MC, i1 - ii);
+            mcp = ((mc + DOUBLE_MR - 1) / DOUBLE_MR) * DOUBLE_MR;
+
+            for (i = 0; i < mcp * ncp; i++)
+                c[i] = 0.0;
+
+            terms = 0;
+
+            for (kk = 0; kk < k; kk += kc)
+            {
+                kc = FLINT_MIN(FLINT_MIN(DOUBLE_KC, arg->kb), k - kk);
+
+                if (terms + kc > arg->kb)
+                {
+                    _reduce_rows(c, mcp * ncp, dn, dninv);
+                    terms = 0;
+                }
+
+                _pack_a(a, arg->A, ii, mc, kk, kc);
+                _pack_b(b, arg->B, kk, kc, jj, nc);
+
+                for (i = 0; i < mcp; i += DOUBLE_MR)
+                    for (j = 0; j < ncp; j += DOUBLE_NR)
+                        arg->kernel(c + i * ncp + j, ncp,
+                                                a + i * kc, b + j * kc, kc);
+
+                terms += kc;
+            }
+
+            _reduce_rows(c, mcp * ncp, dn, dninv);
+
+            for (i = 0; i < mc; i++)
+            {
+                for (j = 0; j < nc; j++)
+                {
+                    d = (mp_limb_t) c[i * ncp + j];
+
+                    if (arg->op == 1)
+                        d = nmod_add(arg->C[ii + i][jj + j], d, arg->mod);
+                    else if (arg->op == -1)
+                        d = nmod_sub(arg->C[ii + i][jj + j], d, arg->mod);
+
+                    arg->D[ii + i][jj + j] = d;
+                }
+            }
+        }
+    }
+
+    flint_free(a);
+    flint_free(b);
+    flint_free(c);
+}
+
+int
+_nmod_mat_mul_double_op(nmod_mat_t D, const nmod_mat_t C,
+                                const nmod_mat_t A, const nmod_mat_t B, int op)
+{
+    _mul_double_arg_struct arg[1];
+    slong m = A->r, k = A->c, n = B->c, num;
+    double t;
+
+    if (NMOD_BITS(A->mod) > NMOD_MAT_MUL_DOUBLE_MAX_BITS)
+        return 0;
+
+    if (m == 0 || n == 0)
+        return 1;
+
+    if (k == 0)
+    {
+        if (op == 0)
+            nmod_mat_zero(D);
+        else
+            nmod_mat_set(D, C);
+        return 1;
+    }
+
+    /* a sum of kb products plus a reduced entry stays below 2^53 */
+    t = (double) (A->mod.n - 1);
+    t = t * t;
+    arg->kb = (t == 0.0) ? k : (slong) ((9007199254740992.0 - A->mod.n) / t);
+    arg->kb = FLINT_MAX(arg->kb, 1);
+
+    arg->D = D->rows;
+    arg->C = (op == 0) ? NULL : C->rows;
+    arg->A = A->rows;
+    arg->B = B->rows;
+    arg->m = m;
+    arg->k = k;
+    arg->n = n;
+    arg->op = op;
+    arg->mod = A->mod;
+    arg->kernel = _kernel_generic;
+
+#if FLINT_HAVE_CPU_DISPATCH
+    if (flint_cpu_level() >= FLINT_CPU_AVX512)
+        arg->kernel = _kernel_avx512;
+    else if (flint_cpu_level() >= FLINT_CPU_AVX2)
+        arg->kernel = _kernel_avx2;
+#endif
+
+    /* blocks of rows of at least 64 per thread */
+    num = FLINT_MIN(flint_get_num_threads(), (m + 63) / 64);
+    num = FLINT_MAX(num, 1);
+    arg->block = (m + num - 1) / num;
+    arg->block = ((arg->block + DOUBLE_MR - 1) / DOUBLE_MR) * DOUBLE_MR;
+    num = (m + arg->block - 1) / arg->block;
+
+    if (num == 1)
+        _mul_double_worker(0, arg);
+    else
+        flint_parallel_do(_mul_double_worker, arg, num, 0,
+                                                    FLINT_PARALLEL_UNIFORM);
+
+    return 1;
+}
+
+int
+nmod_mat_mul_double(nmod_mat_t C, const nmod_mat_t A, const nmod_mat_t B)
+{
+    int res;
+
+    if (C == A || C == B)
+    {
+        nmod_mat_t T;
+        nmod_mat_init(T, A->r, B->c, A->mod.n);
+        res = _nmod_mat_mul_double_op(T, NULL, A, B, 0);
+        if (res)
+            nmod_mat_swap_entrywise(C, T);
+        nmod_mat_clear(T);
+        return res;
+    }
+
+    return _nmod_mat_mul_double_op(C, NULL, A, B, 0);
+}
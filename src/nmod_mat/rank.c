@@ -10,6 +10,7 @@
 */
 
 #include "nmod_mat.h"
+#include "gf2_mat.h"
 
 slong
 nmod_mat_rank(const nmod_mat_t A)
@@ -24,6 +25,18 @@ nmod_mat_rank(const nmod_mat_t A)
     if (m == 0 || n == 0)
         return 0;
 
+    if (A->mod.n == 2)
+    {
+        gf2_mat_t B;
+
+        gf2_mat_init(B, m, n);
+        gf2_mat_set_nmod_mat(B, A);
+        rank = gf2_mat_rref(B);
+        gf2_mat_clear(B);
+
+        return rank;
+    }
+
     nmod_mat_init_set(tmp, A);
     perm = flint_malloc(sizeof(slong) * m);
 
@@ -0,0 +1,90 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "thread_support.h"
+#include "nmod_mat.h"
+
+/*
+    The columns of X are independent, so they are split into one block
+    per thread and each block is solved single-threaded.
+*/
+
+typedef struct
+{
+    nmod_mat_struct * X;
+    const nmod_mat_struct * T;
+    const nmod_mat_struct * B;
+    slong num;
+    int unit;
+    int upper;
+}
+_solve_tri_arg_struct;
+
+static void
+_solve_tri_worker(slong i, void * arg_ptr)
+{
+    _solve_tri_arg_struct * arg = (_solve_tri_arg_struct *) arg_ptr;
+    slong c0, c1, n = arg->B->c;
+    nmod_mat_t XX, BB;
+    int nworkers_save;
+
+    c0 = i * n / arg->num;
+    c1 = (i + 1) * n / arg->num;
+
+    nmod_mat_window_init(XX, arg->X, 0, c0, arg->X->r, c1);
+    nmod_mat_window_init(BB, arg->B, 0, c0, arg->B->r, c1);
+
+    nworkers_save = flint_set_num_workers(0);
+
+    if (arg->upper)
+        nmod_mat_solve_triu(XX, arg->T, BB, arg->unit);
+    else
+        nmod_mat_solve_tril(XX, arg->T, BB, arg->unit);
+
+    flint_reset_num_workers(nworkers_save);
+
+    nmod_mat_window_clear(XX);
+    nmod_mat_window_clear(BB);
+}
+
+static void
+_nmod_mat_solve_tri_threaded(nmod_mat_t X, const nmod_mat_t T,
+                                    const nmod_mat_t B, int unit, int upper)
+{
+    _solve_tri_arg_struct arg[1];
+
+    arg->X = X;
+    arg->T = T;
+    arg->B = B;
+    arg->unit = unit;
+    arg->upper = upper;
+    arg->num = FLINT_MIN(flint_get_num_threads(),
+                                    B->c / NMOD_MAT_SOLVE_TRI_COLS_CUTOFF);
+    arg->num = FLINT_MAX(arg->num, 1);
+
+    flint_parallel_do(_solve_tri_worker, arg, arg->num, 0,
+                                                    FLINT_PARALLEL_UNIFORM);
+}
+
+void
+nmod_mat_solve_tril_threaded(nmod_mat_t X, const nmod_mat_t L,
+                                                const nmod_mat_t B, int unit)
+{
+    _nmod_mat_solve_tri_threaded(X, L, B, unit, 0);
+}
+
+void
+nmod_mat_solve_triu_threaded(nmod_mat_t X, const nmod_mat_t U,
+                                                const nmod_mat_t B, int unit)
+{
+    _nmod_mat_solve_tri_threaded(X, U, B, unit, 1);
+}
@@ -9,6 +9,7 @@
     (at your option) any later version.  See <https://www.gnu.org/licenses/>.
 */
 
+#include "thread_support.h"
 #include "nmod_mat.h"
 
 void
@@ -20,6 +21,11 @@ nmod_mat_solve_triu(nmod_mat_t X, const nmod_mat_t U,
     {
         nmod_mat_solve_triu_classical(X, U, B, unit);
     }
+    else if (flint_get_num_threads() > 1 &&
+        B->c >= 2 * NMOD_MAT_SOLVE_TRI_COLS_CUTOFF)
+    {
+        nmod_mat_solve_triu_threaded(X, U, B, unit);
+    }
     else
     {
         nmod_mat_solve_triu_recursive(X, U, B, unit);
@@ -0,0 +1,171 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "ulong_extras.h"
+#include "thread_support.h"
+#include "nmod.h"
+#include "nmod_mat.h"
+
+/* D = C + op A B entry by entry, independently of the dispatch in mul */
+void
+mul_naive_op(nmod_mat_t D, const nmod_mat_t C,
+                            const nmod_mat_t A, const nmod_mat_t B, int op)
+{
+    slong i, j, l;
+    mp_limb_t s;
+
+    for (i = 0; i < A->r; i++)
+    {
+        for (j = 0; j < B->c; j++)
+        {
+            s = 0;
+            for (l = 0; l < A->c; l++)
+                s = nmod_addmul(s, A->rows[i][l], B->rows[l][j], A->mod);
+
+            if (op == 1)
+                s = nmod_add(C->rows[i][j], s, A->mod);
+            else if (op == -1)
+                s = nmod_sub(C->rows[i][j], s, A->mod);
+
+            D->rows[i][j] = s;
+        }
+    }
+}
+
+int
+main(void)
+{
+    slong i, max_threads = 5;
+    int max_level, level;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("mul_double....");
+    fflush(stdout);
+
+    max_level = flint_cpu_level();
+
+    for (i = 0; i < 100 * flint_test_multiplier(); i++)
+    {
+        nmod_mat_t A, B, C, D, E;
+        mp_limb_t modulus;
+        slong m, k, n;
+        int op;
+
+        m = n_randint(state, 50) + 1;
+        k = n_randint(state, 50) + 1;
+        n = n_randint(state, 50) + 1;
+
+        /* large k exercises the delayed reduction */
+        if (n_randint(state, 10) == 0)
+            k = n_randint(state, 1000) + 1;
+
+        if (n_randint(state, 8) == 0)
+            m = n = k = FLINT_MIN(k, 100);
+
+        switch (n_randint(state, 3))
+        {
+            case 0:
+                modulus = n_randint(state, UWORD(1) << 26) + 1;
+                break;
+            case 1:
+                modulus = (UWORD(1) << 26) - 1 - n_randint(state, 16);
+                break;
+            default:
+                modulus = n_randtest_bits(state,
+                                n_randint(state, NMOD_MAT_MUL_DOUBLE_MAX_BITS) + 1);
+                break;
+        }
+
+        flint_set_num_threads(n_randint(state, max_threads) + 1);
+
+        nmod_mat_init(A, m, k, modulus);
+        nmod_mat_init(B, k, n, modulus);
+        nmod_mat_init(C, m, n, modulus);
+        nmod_mat_init(D, m, n, modulus);
+        nmod_mat_init(E, m, n, modulus);
+
+        if (n_randint(state, 2))
+        {
+            nmod_mat_randfull(A, state);
+            nmod_mat_randfull(B, state);
+        }
+        else
+        {
+            nmod_mat_randtest(A, state);
+            nmod_mat_randtest(B, state);
+        }
+
+        nmod_mat_randtest(C, state);
+
+        op = (int) n_randint(state, 3) - 1;
+        mul_naive_op(E, C, A, B, op);
+
+        for (level = FLINT_CPU_GENERIC; level <= max_level; level++)
+        {
+            flint_set_cpu_level(level);
+            nmod_mat_randtest(D, state);
+
+            if (!_nmod_mat_mul_double_op(D, C, A, B, op) ||
+                !nmod_mat_equal(D, E))
+            {
+                flint_printf("FAIL: results not equal\n");
+                flint_printf("m = %wd, k = %wd, n = %wd, modulus = %wu\n",
+                                                            m, k, n, modulus);
+                flint_printf("op = %d, level = %d\n", op, level);
+                fflush(stdout);
+                flint_abort();
+            }
+        }
+
+        flint_set_cpu_level(max_level);
+
+        /* aliasing */
+        if (m == k && k == n)
+        {
+            mul_naive_op(E, NULL, A, B, 0);
+            nmod_mat_set(D, A);
+
+            if (!nmod_mat_mul_double(D, D, B) || !nmod_mat_equal(D, E))
+            {
+                flint_printf("FAIL: aliasing failed\n");
+                fflush(stdout);
+                flint_abort();
+            }
+        }
+
+        nmod_mat_clear(A);
+        nmod_mat_clear(B);
+        nmod_mat_clear(C);
+        nmod_mat_clear(D);
+        nmod_mat_clear(E);
+    }
+
+    /* larger moduli are refused */
+    {
+        nmod_mat_t A;
+
+        nmod_mat_init(A, 2, 2, (UWORD(1) << NMOD_MAT_MUL_DOUBLE_MAX_BITS) + 1);
+
+        if (nmod_mat_mul_double(A, A, A))
+        {
+            flint_printf("FAIL: large modulus accepted\n");
+            fflush(stdout);
+            flint_abort();
+        }
+
+        nmod_mat_clear(A);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
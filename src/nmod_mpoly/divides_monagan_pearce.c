@@ -32,18 +32,21 @@ static int _nmod_mpoly_divides_monagan_pearce1(
     slong * hind;
     ulong mask, exp, maxexp = exp2[len2 - 1];
     mp_limb_t lc_minus_inv, acc0, acc1, acc2, pp1, pp0;
-    TMP_INIT;
+    mpoly_arena_mark_t arena;
 
-    TMP_START;
+    mpoly_arena_mark(arena);
 
     /* alloc array of heap nodes which can be chained together */
     next_loc = len3 + 4;   /* something bigger than heap can ever be */
-    heap = (mpoly_heap1_s *) TMP_ALLOC((len3 + 1)*sizeof(mpoly_heap1_s));
-    chain = (mpoly_heap_t *) TMP_ALLOC(len3*sizeof(mpoly_heap_t));
-    store = store_base = (slong *) TMP_ALLOC(2*len3*sizeof(slong));
+    heap = (mpoly_heap1_s *) mpoly_arena_alloc(arena,
+                                             (len3 + 1)*sizeof(mpoly_heap1_s));
+    chain = (mpoly_heap_t *) mpoly_arena_alloc(arena,
+                                                    len3*sizeof(mpoly_heap_t));
+    store = store_base = (slong *) mpoly_arena_alloc(arena,
+                                                         2*len3*sizeof(slong));
 
     /* space for flagged heap indices */
-    hind = (slong *) TMP_ALLOC(len3*sizeof(slong));
+    hind = (slong *) mpoly_arena_alloc(arena, len3*sizeof(slong));
     for (i = 0; i < len3; i++)
         hind[i] = 1;
 
@@ -183,7 +186,7 @@ static int _nmod_mpoly_divides_monagan_pearce1(
     Q->exps = q_exp;
     Q->length = q_len;
 
-    TMP_END;
+    mpoly_arena_release(arena);
 
     return 1;
 
@@ -193,7 +196,7 @@ not_exact_division:
     Q->exps = q_exp;
     Q->length = 0;
 
-    TMP_END;
+    mpoly_arena_release(arena);
 
     return 0;
 }
@@ -223,33 +226,36 @@ int _nmod_mpoly_divides_monagan_pearce(
     mp_limb_t lc_minus_inv, acc0, acc1, acc2, pp1, pp0;
     ulong mask;
     slong * hind;
-    TMP_INIT;
+    mpoly_arena_mark_t arena;
 
     if (N == 1)
         return _nmod_mpoly_divides_monagan_pearce1(Q, coeff2, exp2, len2,
                                    coeff3, exp3, len3, bits, cmpmask[0], fctx);
 
-    TMP_START;
+    mpoly_arena_mark(arena);
 
     /* alloc array of heap nodes which can be chained together */
     next_loc = len3 + 4;   /* something bigger than heap can ever be */
-    heap = (mpoly_heap_s *) TMP_ALLOC((len3 + 1)*sizeof(mpoly_heap_s));
-    chain = (mpoly_heap_t *) TMP_ALLOC(len3*sizeof(mpoly_heap_t));
-    store = store_base = (slong *) TMP_ALLOC(2*len3*sizeof(slong));
+    heap = (mpoly_heap_s *) mpoly_arena_alloc(arena,
+                                              (len3 + 1)*sizeof(mpoly_heap_s));
+    chain = (mpoly_heap_t *) mpoly_arena_alloc(arena,
+                                                    len3*sizeof(mpoly_heap_t));
+    store = store_base = (slong *) mpoly_arena_alloc(arena,
+                                                         2*len3*sizeof(slong));
 
     /* array of exponent vectors, each of "N" words */
-    exps = (ulong *) TMP_ALLOC(len3*N*sizeof(ulong));
+    exps = (ulong *) mpoly_arena_alloc(arena, len3*N*sizeof(ulong));
     /* list of pointers to available exponent vectors */
-    exp_list = (ulong **) TMP_ALLOC(len3*sizeof(ulong *));
+    exp_list = (ulong **) mpoly_arena_alloc(arena, len3*sizeof(ulong *));
     /* space to save copy of current exponent vector */
-    exp = (ulong *) TMP_ALLOC(N*sizeof(ulong));
+    exp = (ulong *) mpoly_arena_alloc(arena, N*sizeof(ulong));
     /* set up list of available exponent vectors */
     exp_next = 0;
     for (i = 0; i < len3; i++)
         exp_list[i] = exps + i*N;
 
     /* space for flagged heap indices */
-    hind = (slong *) TMP_ALLOC(len3*sizeof(slong));
+    hind = (slong *) mpoly_arena_alloc(arena, len3*sizeof(slong));
     for (i = 0; i < len3; i++)
         hind[i] = 1;
 
@@ -425,7 +431,7 @@ int _nmod_mpoly_divides_monagan_pearce(
     Q->exps = q_exp;
     Q->length = q_len;
 
-    TMP_END;
+    mpoly_arena_release(arena);
 
     return 1;
 
@@ -435,7 +441,7 @@ not_exact_division:
     Q->exps = q_exp;
     Q->length = 0;
 
-    TMP_END;
+    mpoly_arena_release(arena);
 
     return 0;
 }
@@ -452,8 +458,9 @@ int nmod_mpoly_divides_monagan_pearce(
     fmpz * Amaxfields, * Bmaxfields;
     ulong * cmpmask;
     ulong * exp2 = A->exps, * exp3 = B->exps, * expq;
-    int divides, easy_exit, free2 = 0, free3 = 0;
+    int divides, easy_exit;
     ulong mask = 0;
+    mpoly_arena_mark_t arena;
     TMP_INIT;
 
     if (B->length == 0)
@@ -476,6 +483,7 @@ int nmod_mpoly_divides_monagan_pearce(
     }
 
     TMP_START;
+    mpoly_arena_mark(arena);
 
     Amaxfields = (fmpz *) TMP_ALLOC(ctx->minfo->nfields*sizeof(fmpz));
     Bmaxfields = (fmpz *) TMP_ALLOC(ctx->minfo->nfields*sizeof(fmpz));
@@ -536,16 +544,14 @@ int nmod_mpoly_divides_monagan_pearce(
     /* ensure input exponents packed to same size as output exponents */
     if (Qbits > A->bits)
     {
-        free2 = 1;
-        exp2 = (ulong *) flint_malloc(N*A->length*sizeof(ulong));
+        exp2 = (ulong *) mpoly_arena_alloc(arena, N*A->length*sizeof(ulong));
         mpoly_repack_monomials(exp2, Qbits, A->exps, A->bits,
                                                     A->length, ctx->minfo);
     }
 
     if (Qbits > B->bits)
     {
-        free3 = 1;
-        exp3 = (ulong *) flint_malloc(N*B->length*sizeof(ulong));
+        exp3 = (ulong *) mpoly_arena_alloc(arena, N*B->length*sizeof(ulong));
         mpoly_repack_monomials(exp3, Qbits, B->exps, B->bits,
                                                     B->length, ctx->minfo);
     }
@@ -598,12 +604,7 @@ int nmod_mpoly_divides_monagan_pearce(
 
 cleanup:
 
-    if (free2)
-        flint_free(exp2);
-
-    if (free3)
-        flint_free(exp3);
-
+    mpoly_arena_release(arena);
     TMP_END;
 
     return divides;
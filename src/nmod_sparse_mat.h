@@ -0,0 +1,167 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef NMOD_SPARSE_MAT_H
+#define NMOD_SPARSE_MAT_H
+
+#ifdef NMOD_SPARSE_MAT_INLINES_C
+#define NMOD_SPARSE_MAT_INLINE
+#else
+#define NMOD_SPARSE_MAT_INLINE static __inline__
+#endif
+
+#include "nmod_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+    Compressed sparse row layout: the nonzero entries of row i are
+    entries[rows[i]], ..., entries[rows[i + 1] - 1], in increasing order
+    of their column indices cols[rows[i]], ..., cols[rows[i + 1] - 1].
+    max_row is the largest number of entries in a row.
+*/
+typedef struct
+{
+    mp_limb_t * entries;
+    slong * cols;
+    slong * rows;
+    slong r;
+    slong c;
+    slong nnz;
+    slong max_row;
+    slong alloc;
+    nmod_t mod;
+}
+nmod_sparse_mat_struct;
+
+typedef nmod_sparse_mat_struct nmod_sparse_mat_t[1];
+
+NMOD_SPARSE_MAT_INLINE
+slong nmod_sparse_mat_nrows(const nmod_sparse_mat_t A)
+{
+    return A->r;
+}
+
+NMOD_SPARSE_MAT_INLINE
+slong nmod_sparse_mat_ncols(const nmod_sparse_mat_t A)
+{
+    return A->c;
+}
+
+NMOD_SPARSE_MAT_INLINE
+slong nmod_sparse_mat_nnz(const nmod_sparse_mat_t A)
+{
+    return A->nnz;
+}
+
+/* Memory management */
+void nmod_sparse_mat_init(nmod_sparse_mat_t A, slong rows, slong cols,
+                                                                mp_limb_t n);
+
+void nmod_sparse_mat_clear(nmod_sparse_mat_t A);
+
+void nmod_sparse_mat_fit_nnz(nmod_sparse_mat_t A, slong nnz);
+
+void nmod_sparse_mat_swap(nmod_sparse_mat_t A, nmod_sparse_mat_t B);
+
+/* Basic assignment */
+void nmod_sparse_mat_set(nmod_sparse_mat_t A, const nmod_sparse_mat_t B);
+
+void nmod_sparse_mat_zero(nmod_sparse_mat_t A);
+
+void nmod_sparse_mat_set_entries(nmod_sparse_mat_t A, const slong * rows,
+                const slong * cols, const mp_limb_t * entries, slong len);
+
+void nmod_sparse_mat_set_nmod_mat(nmod_sparse_mat_t A, const nmod_mat_t B);
+
+void nmod_mat_set_nmod_sparse_mat(nmod_mat_t A, const nmod_sparse_mat_t B);
+
+void nmod_sparse_mat_transpose(nmod_sparse_mat_t B, const nmod_sparse_mat_t A);
+
+/* Random generation */
+void nmod_sparse_mat_randtest(nmod_sparse_mat_t A, flint_rand_t state,
+                                                      slong min, slong max);
+
+/* Comparison */
+int nmod_sparse_mat_equal(const nmod_sparse_mat_t A, const nmod_sparse_mat_t B);
+
+/* Matrix-vector multiplication */
+void nmod_sparse_mat_mul_vec(mp_ptr y, const nmod_sparse_mat_t A, mp_srcptr x);
+
+/* Structured Gaussian elimination */
+typedef struct
+{
+    slong * cols;
+    mp_limb_t * entries;
+    slong len;
+    slong alloc;
+}
+_nmod_sparse_row_struct;
+
+typedef struct
+{
+    _nmod_sparse_row_struct * rows;
+    slong r;
+    slong c;
+    slong cpiv;
+    char * active;
+    slong * weight;
+    slong ** crows;
+    slong * clen;
+    slong * calloc;
+    slong * piv_row;
+    slong * piv_col;
+    slong * col_piv;
+    slong npiv;
+    slong nnz;
+    nmod_t mod;
+}
+_nmod_sparse_elim_struct;
+
+typedef _nmod_sparse_elim_struct _nmod_sparse_elim_t[1];
+
+void _nmod_sparse_elim_init(_nmod_sparse_elim_t E, const nmod_sparse_mat_t A,
+                                                                mp_srcptr b);
+
+void _nmod_sparse_elim_clear(_nmod_sparse_elim_t E);
+
+void _nmod_sparse_elim_run(_nmod_sparse_elim_t E);
+
+slong _nmod_sparse_elim_remaining(nmod_mat_t D, slong * cmap,
+                                                const _nmod_sparse_elim_t E);
+
+/* Rank, nullspace and solving */
+slong nmod_sparse_mat_rank(const nmod_sparse_mat_t A);
+
+slong nmod_sparse_mat_nullspace(nmod_mat_t X, const nmod_sparse_mat_t A);
+
+int nmod_sparse_mat_solve(mp_ptr x, const nmod_sparse_mat_t A, mp_srcptr b);
+
+/* Wiedemann's algorithm */
+void _nmod_sparse_mat_evaluate_vec(mp_ptr y, const nmod_sparse_mat_t A,
+                                        mp_srcptr g, slong len, mp_srcptr v);
+
+void _nmod_sparse_mat_wiedemann_minpoly(nmod_poly_t f,
+        const nmod_sparse_mat_t A, mp_srcptr v, int early, flint_rand_t state);
+
+int nmod_sparse_mat_solve_wiedemann(mp_ptr x, const nmod_sparse_mat_t A,
+                                        mp_srcptr b, flint_rand_t state);
+
+int nmod_sparse_mat_nullvector_wiedemann(mp_ptr x,
+                            const nmod_sparse_mat_t A, flint_rand_t state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
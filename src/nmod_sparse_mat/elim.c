@@ -0,0 +1,501 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "ulong_extras.h"
+#include "nmod.h"
+#include "nmod_mat.h"
+#include "nmod_sparse_mat.h"
+
+/*
+    Structured Gaussian elimination. Pivots are taken greedily by the
+    Markowitz criterion: rows with a single entry and columns with a single
+    entry first, as they cause no fill-in, then entries (i, j) with j a
+    column of smallest weight and i the lightest row meeting it, as long as
+    the fill-in (r_i - 1)(c_j - 1) stays below SGE_MAX_FILL and the total
+    number of entries below SGE_MAX_GROWTH times the original one. The
+    rows which are left can then be handled by dense linear algebra.
+
+    The column weights count the active rows containing the column. For
+    each column, crows holds the rows which may contain it: entries are
+    only appended, so the list must be checked against the rows.
+
+    A right hand side, if given, is kept as the column cpiv = A->c, which is
+    never chosen as a pivot.
+*/
+
+#define SGE_MAX_FILL 64
+#define SGE_MAX_GROWTH 4
+
+typedef struct
+{
+    slong * weight;
+    slong * col;
+    slong len;
+    slong alloc;
+}
+_col_heap_struct;
+
+static void
+_col_heap_push(_col_heap_struct * H, slong w, slong c)
+{
+    slong i, p;
+
+    if (H->len == H->alloc)
+    {
+        H->alloc = FLINT_MAX(16, 2 * H->alloc);
+        H->weight = flint_realloc(H->weight, H->alloc * sizeof(slong));
+        H->col = flint_realloc(H->col, H->alloc * sizeof(slong));
+    }
+
+    for (i = H->len++; i > 0; i = p)
+    {
+        p = (i - 1) / 2;
+
+        if (H->weight[p] <= w)
+            break;
+
+        H->weight[i] = H->weight[p];
+        H->col[i] = H->col[p];
+    }
+
+    H->weight[i] = w;
+    H->col[i] = c;
+}
+
+static void
+_col_heap_pop(slong * w, slong * c, _col_heap_struct * H)
+{
+    slong i, k, lw, lc;
+
+    *w = H->weight[0];
+    *c = H->col[0];
+
+    H->len--;
+    lw = H->weight[H->len];
+    lc = H->col[H->len];
+
+    for (i = 0; (k = 2 * i + 1) < H->len; i = k)
+    {
+        if (k + 1 < H->len && H->weight[k + 1] < H->weight[k])
+            k++;
+
+        if (lw <= H->weight[k])
+            break;
+
+        H->weight[i] = H->weight[k];
+        H->col[i] = H->col[k];
+    }
+
+    H->weight[i] = lw;
+    H->col[i] = lc;
+}
+
+static void
+_crows_append(_nmod_sparse_elim_t E, slong j, slong i)
+{
+    if (E->clen[j] == E->calloc[j])
+    {
+        E->calloc[j] = FLINT_MAX(4, 2 * E->calloc[j]);
+        E->crows[j] = flint_realloc(E->crows[j], E->calloc[j] * sizeof(slong));
+    }
+
+    E->crows[j][E->clen[j]++] = i;
+}
+
+/* number of entries of row i in pivot columns */
+static slong
+_row_weight(const _nmod_sparse_elim_t E, slong i)
+{
+    const _nmod_sparse_row_struct * R = E->rows + i;
+
+    return R->len - (R->len > 0 && R->cols[R->len - 1] >= E->cpiv);
+}
+
+/* position of column j in row i, or -1 */
+static slong
+_row_find(const _nmod_sparse_elim_t E, slong i, slong j)
+{
+    const _nmod_sparse_row_struct * R = E->rows + i;
+    slong lo = 0, hi = R->len - 1, mid;
+
+    while (lo <= hi)
+    {
+        mid = lo + (hi - lo) / 2;
+
+        if (R->cols[mid] == j)
+            return mid;
+        else if (R->cols[mid] < j)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+
+    return -1;
+}
+
+void
+_nmod_sparse_elim_init(_nmod_sparse_elim_t E, const nmod_sparse_mat_t A,
+                                                                mp_srcptr b)
+{
+    slong i, k, len;
+
+    E->r = A->r;
+    E->cpiv = A->c;
+    E->c = A->c + (b != NULL);
+    E->mod = A->mod;
+    E->nnz = 0;
+    E->npiv = 0;
+
+    E->rows = flint_malloc(A->r * sizeof(_nmod_sparse_row_struct));
+    E->active = flint_malloc(A->r);
+    E->weight = flint_calloc(A->c, sizeof(slong));
+    E->crows = flint_calloc(A->c, sizeof(slong *));
+    E->clen = flint_calloc(A->c, sizeof(slong));
+    E->calloc = flint_calloc(A->c, sizeof(slong));
+    E->piv_row = flint_malloc(FLINT_MIN(A->r, A->c) * sizeof(slong));
+    E->piv_col = flint_malloc(FLINT_MIN(A->r, A->c) * sizeof(slong));
+    E->col_piv = flint_malloc(A->c * sizeof(slong));
+
+    for (i = 0; i < A->c; i++)
+        E->col_piv[i] = -1;
+
+    for (i = 0; i < A->r; i++)
+    {
+        _nmod_sparse_row_struct * R = E->rows + i;
+
+        len = A->rows[i + 1] - A->rows[i];
+        R->alloc = len + (b != NULL);
+        R->cols = flint_malloc(R->alloc * sizeof(slong));
+        R->entries = flint_malloc(R->alloc * sizeof(mp_limb_t));
+        R->len = 0;
+
+        for (k = A->rows[i]; k < A->rows[i + 1]; k++)
+        {
+            R->cols[R->len] = A->cols[k];
+            R->entries[R->len] = A->entries[k];
+            R->len++;
+
+            E->weight[A->cols[k]]++;
+            _crows_append(E, A->cols[k], i);
+        }
+
+        if (b != NULL && b[i] != 0)
+        {
+            R->cols[R->len] = E->cpiv;
+            R->entries[R->len] = b[i];
+            R->len++;
+        }
+
+        E->nnz += R->len;
+        E->active[i] = (R->len != 0);
+    }
+}
+
+void
+_nmod_sparse_elim_clear(_nmod_sparse_elim_t E)
+{
+    slong i;
+
+    for (i = 0; i < E->r; i++)
+    {
+        flint_free(E->rows[i].cols);
+        flint_free(E->rows[i].entries);
+    }
+
+    for (i = 0; i < E->cpiv; i++)
+        flint_free(E->crows[i]);
+
+    flint_free(E->rows);
+    flint_free(E->active);
+    flint_free(E->weight);
+    flint_free(E->crows);
+    flint_free(E->clen);
+    flint_free(E->calloc);
+    flint_free(E->piv_row);
+    flint_free(E->piv_col);
+    flint_free(E->col_piv);
+}
+
+/* row k -= c * row i, eliminating column j from row k */
+static void
+_row_submul(_nmod_sparse_elim_t E, slong k, slong i, mp_limb_t c, slong j,
+                                _col_heap_struct * H, slong ** stack,
+                                slong * slen, slong * salloc)
+{
+    _nmod_sparse_row_struct * Rk = E->rows + k;
+    const _nmod_sparse_row_struct * Ri = E->rows + i;
+    slong * cols;
+    mp_limb_t * entries;
+    slong p, q, len, l, alloc;
+    mp_limb_t x;
+
+    alloc = Rk->len + Ri->len;
+    cols = flint_malloc(alloc * sizeof(slong));
+    entries = flint_malloc(alloc * sizeof(mp_limb_t));
+
+    p = q = len = 0;
+
+    while (p < Rk->len || q < Ri->len)
+    {
+        if (q == Ri->len || (p < Rk->len && Rk->cols[p] < Ri->cols[q]))
+        {
+            cols[len] = Rk->cols[p];
+            entries[len] = Rk->entries[p];
+            len++;
+            p++;
+            continue;
+        }
+
+        l = Ri->cols[q];
+        x = nmod_mul(c, Ri->entries[q], E->mod);
+
+        if (p == Rk->len || Rk->cols[p] > l)
+        {
+            /* fill-in */
+            x = nmod_neg(x, E->mod);
+
+            if (x != 0)
+            {
+                cols[len] = l;
+                entries[len] = x;
+                len++;
+
+                if (l < E->cpiv)
+                {
+                    E->weight[l]++;
+                    _crows_append(E, l, k);
+                    _col_heap_push(H, E->weight[l], l);
+                }
+            }
+        }
+        else
+        {
+            x = (l == j) ? 0 : nmod_sub(Rk->entries[p], x, E->mod);
+
+            if (x != 0)
+            {
+                cols[len] = l;
+                entries[len] = x;
+                len++;
+            }
+            else if (l < E->cpiv)
+            {
+                E->weight[l]--;
+
+                if (l != j && E->weight[l] > 0)
+                    _col_heap_push(H, E->weight[l], l);
+            }
+
+            p++;
+        }
+
+        q++;
+    }
+
+    E->nnz += len - Rk->len;
+
+    flint_free(Rk->cols);
+    flint_free(Rk->entries);
+    Rk->cols = cols;
+    Rk->entries = entries;
+    Rk->len = len;
+    Rk->alloc = alloc;
+
+    if (len == 0)
+    {
+        E->active[k] = 0;
+    }
+    else if (_row_weight(E, k) == 1)
+    {
+        if (*slen == *salloc)
+        {
+            *salloc = FLINT_MAX(16, 2 * *salloc);
+            *stack = flint_realloc(*stack, *salloc * sizeof(slong));
+        }
+
+        (*stack)[(*slen)++] = k;
+    }
+}
+
+void
+_nmod_sparse_elim_run(_nmod_sparse_elim_t E)
+{
+    _col_heap_struct H[1];
+    slong * stack = NULL;
+    slong slen = 0, salloc = 0;
+    slong i, j, k, t, w, r, best, max_nnz;
+    mp_limb_t c, inv;
+
+    H->weight = H->col = NULL;
+    H->len = H->alloc = 0;
+
+    max_nnz = SGE_MAX_GROWTH * E->nnz + E->r;
+
+    for (j = 0; j < E->cpiv; j++)
+        if (E->weight[j] > 0)
+            _col_heap_push(H, E->weight[j], j);
+
+    for (i = 0; i < E->r; i++)
+    {
+        if (E->active[i] && _row_weight(E, i) == 1)
+        {
+            if (slen == salloc)
+            {
+                salloc = FLINT_MAX(16, 2 * salloc);
+                stack = flint_realloc(stack, salloc * sizeof(slong));
+            }
+
+            stack[slen++] = i;
+        }
+    }
+
+    while (1)
+    {
+        if (slen > 0)
+        {
+            i = stack[--slen];
+
+            if (!E->active[i] || _row_weight(E, i) != 1)
+                continue;
+
+            j = E->rows[i].cols[0];
+        }
+        else
+        {
+            if (H->len == 0)
+                break;
+
+            _col_heap_pop(&w, &j, H);
+
+            if (E->col_piv[j] != -1 || E->weight[j] != w)
+                continue;
+
+            /* lightest row containing j */
+            best = -1;
+            r = WORD_MAX;
+
+            for (t = 0; t < E->clen[j]; t++)
+            {
+                k = E->crows[j][t];
+
+                if (E->active[k] && _row_weight(E, k) < r
+                                 && _row_find(E, k, j) != -1)
+                {
+                    best = k;
+                    r = _row_weight(E, k);
+                }
+            }
+
+            if (best == -1)
+                continue;
+
+            if ((r - 1) * (w - 1) > SGE_MAX_FILL || E->nnz > max_nnz)
+                break;
+
+            i = best;
+        }
+
+        /* pivot on (i, j) */
+        inv = n_invmod(E->rows[i].entries[_row_find(E, i, j)], E->mod.n);
+
+        E->piv_row[E->npiv] = i;
+        E->piv_col[E->npiv] = j;
+        E->col_piv[j] = E->npiv;
+        E->npiv++;
+        E->active[i] = 0;
+
+        for (t = 0; t < E->clen[j]; t++)
+        {
+            k = E->crows[j][t];
+
+            if (k == i || !E->active[k])
+                continue;
+
+            r = _row_find(E, k, j);
+            if (r == -1)
+                continue;
+
+            c = nmod_mul(E->rows[k].entries[r], inv, E->mod);
+            _row_submul(E, k, i, c, j, H, &stack, &slen, &salloc);
+        }
+
+        flint_free(E->crows[j]);
+        E->crows[j] = NULL;
+        E->clen[j] = E->calloc[j] = 0;
+
+        /* the pivot row leaves the active rows */
+        for (t = 0; t < E->rows[i].len; t++)
+        {
+            k = E->rows[i].cols[t];
+
+            if (k < E->cpiv)
+            {
+                E->weight[k]--;
+
+                if (E->col_piv[k] == -1 && E->weight[k] > 0)
+                    _col_heap_push(H, E->weight[k], k);
+            }
+        }
+    }
+
+    flint_free(H->weight);
+    flint_free(H->col);
+    flint_free(stack);
+}
+
+slong
+_nmod_sparse_elim_remaining(nmod_mat_t D, slong * cmap,
+                                                const _nmod_sparse_elim_t E)
+{
+    slong i, j, k, m, nrows;
+    slong * pos;
+
+    pos = flint_malloc(E->c * sizeof(slong));
+
+    m = 0;
+    for (j = 0; j < E->cpiv; j++)
+    {
+        if (E->col_piv[j] == -1 && E->weight[j] > 0)
+        {
+            cmap[m] = j;
+            pos[j] = m++;
+        }
+        else
+        {
+            pos[j] = -1;
+        }
+    }
+
+    if (E->c > E->cpiv)
+        pos[E->cpiv] = m;
+
+    nrows = 0;
+    for (i = 0; i < E->r; i++)
+        nrows += E->active[i];
+
+    nmod_mat_init(D, nrows, m + (E->c - E->cpiv), E->mod.n);
+
+    for (i = k = 0; i < E->r; i++)
+    {
+        if (!E->active[i])
+            continue;
+
+        for (j = 0; j < E->rows[i].len; j++)
+            nmod_mat_entry(D, k, pos[E->rows[i].cols[j]]) = E->rows[i].entries[j];
+
+        k++;
+    }
+
+    flint_free(pos);
+
+    return m;
+}
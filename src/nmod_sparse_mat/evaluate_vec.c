@@ -0,0 +1,42 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "nmod_vec.h"
+#include "nmod_sparse_mat.h"
+
+/* y = g(A) v, by Horner's rule */
+void
+_nmod_sparse_mat_evaluate_vec(mp_ptr y, const nmod_sparse_mat_t A,
+                                        mp_srcptr g, slong len, mp_srcptr v)
+{
+    mp_ptr t;
+    slong i;
+
+    if (len == 0)
+    {
+        _nmod_vec_zero(y, A->r);
+        return;
+    }
+
+    t = _nmod_vec_init(A->r);
+
+    _nmod_vec_scalar_mul_nmod(y, v, A->r, g[len - 1], A->mod);
+
+    for (i = len - 2; i >= 0; i--)
+    {
+        nmod_sparse_mat_mul_vec(t, A, y);
+        _nmod_vec_set(y, t, A->r);
+        _nmod_vec_scalar_addmul_nmod(y, v, A->r, g[i], A->mod);
+    }
+
+    _nmod_vec_clear(t);
+}
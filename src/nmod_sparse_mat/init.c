@@ -0,0 +1,57 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "nmod.h"
+#include "nmod_sparse_mat.h"
+
+void
+nmod_sparse_mat_init(nmod_sparse_mat_t A, slong rows, slong cols, mp_limb_t n)
+{
+    A->rows = flint_calloc(rows + 1, sizeof(slong));
+    A->cols = NULL;
+    A->entries = NULL;
+    A->r = rows;
+    A->c = cols;
+    A->nnz = 0;
+    A->max_row = 0;
+    A->alloc = 0;
+    nmod_init(&A->mod, n);
+}
+
+void
+nmod_sparse_mat_clear(nmod_sparse_mat_t A)
+{
+    flint_free(A->rows);
+    flint_free(A->cols);
+    flint_free(A->entries);
+}
+
+void
+nmod_sparse_mat_fit_nnz(nmod_sparse_mat_t A, slong nnz)
+{
+    if (nnz > A->alloc)
+    {
+        nnz = FLINT_MAX(nnz, 2 * A->alloc);
+        A->cols = flint_realloc(A->cols, nnz * sizeof(slong));
+        A->entries = flint_realloc(A->entries, nnz * sizeof(mp_limb_t));
+        A->alloc = nnz;
+    }
+}
+
+void
+nmod_sparse_mat_swap(nmod_sparse_mat_t A, nmod_sparse_mat_t B)
+{
+    nmod_sparse_mat_t T;
+    *T = *A;
+    *A = *B;
+    *B = *T;
+}
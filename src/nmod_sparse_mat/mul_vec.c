@@ -0,0 +1,84 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "nmod.h"
+#include "nmod_vec.h"
+#include "thread_support.h"
+#include "nmod_sparse_mat.h"
+
+/* below this number of nonzero entries a product is not split */
+#define MUL_VEC_THREAD_CUTOFF 32768
+
+typedef struct
+{
+    const nmod_sparse_mat_struct * A;
+    mp_srcptr x;
+    mp_ptr y;
+    const slong * start;
+    int nlimbs;
+}
+_mul_vec_arg_struct;
+
+static void
+_mul_vec_worker(slong k, void * arg_ptr)
+{
+    _mul_vec_arg_struct * arg = (_mul_vec_arg_struct *) arg_ptr;
+    const nmod_sparse_mat_struct * A = arg->A;
+    mp_srcptr x = arg->x;
+    mp_ptr y = arg->y;
+    slong i, j, off, len;
+
+    for (i = arg->start[k]; i < arg->start[k + 1]; i++)
+    {
+        off = A->rows[i];
+        len = A->rows[i + 1] - off;
+
+        NMOD_VEC_DOT(y[i], j, len, A->entries[off + j], x[A->cols[off + j]],
+                                                        A->mod, arg->nlimbs);
+    }
+}
+
+void
+nmod_sparse_mat_mul_vec(mp_ptr y, const nmod_sparse_mat_t A, mp_srcptr x)
+{
+    _mul_vec_arg_struct arg[1];
+    slong i, k, num, nthreads;
+    slong * start;
+
+    nthreads = flint_get_num_threads();
+    num = (A->nnz < MUL_VEC_THREAD_CUTOFF) ? 1 : FLINT_MIN(nthreads, A->r);
+    num = FLINT_MAX(num, 1);
+
+    /* split the rows into blocks with about the same number of entries */
+    start = flint_malloc((num + 1) * sizeof(slong));
+    start[0] = 0;
+    for (k = 1, i = 0; k < num; k++)
+    {
+        while (i < A->r && A->rows[i] < (k * A->nnz) / num)
+            i++;
+        start[k] = i;
+    }
+    start[num] = A->r;
+
+    arg->A = A;
+    arg->x = x;
+    arg->y = y;
+    arg->start = start;
+    arg->nlimbs = _nmod_vec_dot_bound_limbs(A->max_row, A->mod);
+
+    if (num == 1)
+        _mul_vec_worker(0, arg);
+    else
+        flint_parallel_do(_mul_vec_worker, arg, num, 0, FLINT_PARALLEL_UNIFORM);
+
+    flint_free(start);
+}
@@ -0,0 +1,101 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "nmod.h"
+#include "nmod_mat.h"
+#include "nmod_sparse_mat.h"
+
+/*
+    The kernel vectors are first found on the columns which were not
+    eliminated: those of the remaining dense matrix and the empty ones.
+    The pivot columns then follow by back substitution, in the reverse
+    order of elimination.
+*/
+slong
+nmod_sparse_mat_nullspace(nmod_mat_t X, const nmod_sparse_mat_t A)
+{
+    _nmod_sparse_elim_t E;
+    nmod_mat_t D, Y;
+    slong * cmap;
+    mp_ptr s;
+    slong i, j, k, l, m, p, t, nullity, dnullity;
+    mp_limb_t inv;
+
+    _nmod_sparse_elim_init(E, A, NULL);
+    _nmod_sparse_elim_run(E);
+
+    cmap = flint_malloc(A->c * sizeof(slong));
+    m = _nmod_sparse_elim_remaining(D, cmap, E);
+
+    nmod_mat_init(Y, m, m, A->mod.n);
+
+    if (D->r == 0)
+    {
+        nmod_mat_one(Y);
+        dnullity = m;
+    }
+    else
+    {
+        dnullity = nmod_mat_nullspace(Y, D);
+    }
+
+    nullity = dnullity + (A->c - m - E->npiv);
+
+    nmod_mat_clear(X);
+    nmod_mat_init(X, A->c, nullity, A->mod.n);
+
+    for (l = 0; l < m; l++)
+        for (t = 0; t < dnullity; t++)
+            nmod_mat_entry(X, cmap[l], t) = nmod_mat_entry(Y, l, t);
+
+    for (j = 0, t = dnullity; j < A->c; j++)
+        if (E->col_piv[j] == -1 && E->weight[j] == 0)
+            nmod_mat_entry(X, j, t++) = 1;
+
+    s = flint_malloc(nullity * sizeof(mp_limb_t));
+
+    for (p = E->npiv - 1; p >= 0; p--)
+    {
+        const _nmod_sparse_row_struct * R = E->rows + E->piv_row[p];
+
+        j = E->piv_col[p];
+
+        for (t = 0; t < nullity; t++)
+            s[t] = 0;
+
+        inv = 0;
+        for (k = 0; k < R->len; k++)
+        {
+            i = R->cols[k];
+
+            if (i == j)
+                inv = R->entries[k];
+            else
+                for (t = 0; t < nullity; t++)
+                    s[t] = nmod_addmul(s[t], R->entries[k],
+                                        nmod_mat_entry(X, i, t), A->mod);
+        }
+
+        inv = nmod_neg(nmod_inv(inv, A->mod), A->mod);
+
+        for (t = 0; t < nullity; t++)
+            nmod_mat_entry(X, j, t) = nmod_mul(s[t], inv, A->mod);
+    }
+
+    flint_free(s);
+    nmod_mat_clear(D);
+    nmod_mat_clear(Y);
+    flint_free(cmap);
+    _nmod_sparse_elim_clear(E);
+
+    return nullity;
+}
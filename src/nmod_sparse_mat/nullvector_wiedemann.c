@@ -0,0 +1,92 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "nmod_vec.h"
+#include "nmod_poly.h"
+#include "nmod_sparse_mat.h"
+
+#define WIEDEMANN_ROUNDS 32
+
+/*
+    If f = x^e g is the minimal polynomial of A with respect to v, with
+    g(0) != 0 and e > 0, then w = g(A) v is nonzero and A^e w = 0, so that
+    the last nonzero vector among w, A w, ..., A^e w lies in the kernel.
+    For singular A, e > 0 holds unless v misses the generalised kernel,
+    which happens with probability about 1/p; each round takes a new v.
+    A generator of degree n with f(0) != 0 proves that A is nonsingular.
+*/
+int
+nmod_sparse_mat_nullvector_wiedemann(mp_ptr x, const nmod_sparse_mat_t A,
+                                                        flint_rand_t state)
+{
+    nmod_poly_t f;
+    mp_ptr v, w;
+    slong i, e, n, round;
+    int success = 0;
+
+    if (A->r != A->c)
+        flint_throw(FLINT_ERROR, "Exception (nmod_sparse_mat_nullvector_wiedemann). "
+                                                    "Non-square matrix.\n");
+
+    n = A->r;
+
+    if (n == 0)
+        return 0;
+
+    v = _nmod_vec_init(n);
+    w = _nmod_vec_init(n);
+    nmod_poly_init_mod(f, A->mod);
+
+    for (round = 0; round < WIEDEMANN_ROUNDS && !success; round++)
+    {
+        for (i = 0; i < n; i++)
+            v[i] = n_randint(state, A->mod.n);
+
+        nmod_poly_one(f);
+        _nmod_sparse_mat_wiedemann_minpoly(f, A, v, round == 0, state);
+
+        for (e = 0; e < f->length && f->coeffs[e] == 0; e++)
+            ;
+
+        if (e == 0)
+        {
+            if (round != 0 && f->length == n + 1)
+                break;
+
+            continue;
+        }
+
+        _nmod_sparse_mat_evaluate_vec(x, A, f->coeffs + e, f->length - e, v);
+
+        if (_nmod_vec_is_zero(x, n))
+            continue;
+
+        for (i = 0; i < e && !success; i++)
+        {
+            nmod_sparse_mat_mul_vec(w, A, x);
+
+            if (_nmod_vec_is_zero(w, n))
+                success = 1;
+            else
+                _nmod_vec_set(x, w, n);
+        }
+    }
+
+    if (!success)
+        _nmod_vec_zero(x, n);
+
+    nmod_poly_clear(f);
+    _nmod_vec_clear(v);
+    _nmod_vec_clear(w);
+
+    return success;
+}
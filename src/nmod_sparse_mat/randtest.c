@@ -0,0 +1,73 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <string.h>
+#include "ulong_extras.h"
+#include "nmod_sparse_mat.h"
+
+void
+nmod_sparse_mat_randtest(nmod_sparse_mat_t A, flint_rand_t state,
+                                                        slong min, slong max)
+{
+    slong i, j, k, w, nnz;
+    slong * cols;
+    mp_limb_t x;
+
+    min = FLINT_MIN(min, A->c);
+    max = FLINT_MAX(min, FLINT_MIN(max, A->c));
+
+    if (A->mod.n == 1)
+        min = max = 0;
+
+    nmod_sparse_mat_fit_nnz(A, A->r * max);
+
+    nnz = 0;
+    A->max_row = 0;
+    for (i = 0; i < A->r; i++)
+    {
+        A->rows[i] = nnz;
+        cols = A->cols + nnz;
+
+        /* distinct columns, kept sorted by insertion */
+        w = min + n_randint(state, max - min + 1);
+
+        for (j = 0; j < w; )
+        {
+            slong c = n_randint(state, A->c);
+
+            for (k = j; k > 0 && cols[k - 1] > c; k--)
+                ;
+
+            if (k > 0 && cols[k - 1] == c)
+                continue;
+
+            memmove(cols + k + 1, cols + k, (j - k) * sizeof(slong));
+            cols[k] = c;
+            j++;
+        }
+
+        for (j = 0; j < w; j++)
+        {
+            do {
+                x = n_randtest(state) % A->mod.n;
+            } while (x == 0);
+
+            A->entries[nnz + j] = x;
+        }
+
+        nnz += w;
+        A->max_row = FLINT_MAX(A->max_row, w);
+    }
+
+    A->rows[A->r] = nnz;
+    A->nnz = nnz;
+}
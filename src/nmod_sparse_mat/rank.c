@@ -0,0 +1,37 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "nmod_mat.h"
+#include "nmod_sparse_mat.h"
+
+slong
+nmod_sparse_mat_rank(const nmod_sparse_mat_t A)
+{
+    _nmod_sparse_elim_t E;
+    nmod_mat_t D;
+    slong * cmap;
+    slong rank;
+
+    _nmod_sparse_elim_init(E, A, NULL);
+    _nmod_sparse_elim_run(E);
+
+    cmap = flint_malloc(A->c * sizeof(slong));
+    _nmod_sparse_elim_remaining(D, cmap, E);
+
+    rank = E->npiv + nmod_mat_rank(D);
+
+    nmod_mat_clear(D);
+    flint_free(cmap);
+    _nmod_sparse_elim_clear(E);
+
+    return rank;
+}
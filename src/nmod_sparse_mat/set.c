@@ -0,0 +1,48 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "nmod_sparse_mat.h"
+
+void
+nmod_sparse_mat_set(nmod_sparse_mat_t A, const nmod_sparse_mat_t B)
+{
+    slong i;
+
+    if (A == B)
+        return;
+
+    nmod_sparse_mat_fit_nnz(A, B->nnz);
+
+    for (i = 0; i <= B->r; i++)
+        A->rows[i] = B->rows[i];
+
+    for (i = 0; i < B->nnz; i++)
+    {
+        A->cols[i] = B->cols[i];
+        A->entries[i] = B->entries[i];
+    }
+
+    A->nnz = B->nnz;
+    A->max_row = B->max_row;
+}
+
+void
+nmod_sparse_mat_zero(nmod_sparse_mat_t A)
+{
+    slong i;
+
+    for (i = 0; i <= A->r; i++)
+        A->rows[i] = 0;
+
+    A->nnz = 0;
+    A->max_row = 0;
+}
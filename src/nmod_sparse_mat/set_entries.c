@@ -0,0 +1,105 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <stdlib.h>
+#include "nmod.h"
+#include "nmod_sparse_mat.h"
+
+typedef struct
+{
+    slong col;
+    mp_limb_t entry;
+}
+_col_entry_struct;
+
+static int
+_col_entry_cmp(const void * a, const void * b)
+{
+    slong x = ((const _col_entry_struct *) a)->col;
+    slong y = ((const _col_entry_struct *) b)->col;
+
+    return (x > y) - (x < y);
+}
+
+void
+nmod_sparse_mat_set_entries(nmod_sparse_mat_t A, const slong * rows,
+                    const slong * cols, const mp_limb_t * entries, slong len)
+{
+    _col_entry_struct * T;
+    slong * start;
+    slong i, j, k, nnz;
+    mp_limb_t x;
+
+    for (i = 0; i < len; i++)
+    {
+        if (rows[i] < 0 || rows[i] >= A->r || cols[i] < 0 || cols[i] >= A->c)
+            flint_throw(FLINT_ERROR, "Exception (nmod_sparse_mat_set_entries). "
+                                              "Index out of range.\n");
+    }
+
+    /* bucket the entries by row, then sort each row by column */
+    start = flint_calloc(A->r + 1, sizeof(slong));
+    T = flint_malloc(len * sizeof(_col_entry_struct));
+
+    for (i = 0; i < len; i++)
+        start[rows[i] + 1]++;
+
+    for (i = 0; i < A->r; i++)
+        start[i + 1] += start[i];
+
+    for (i = 0; i < len; i++)
+    {
+        k = start[rows[i]]++;
+        T[k].col = cols[i];
+        NMOD_RED(T[k].entry, entries[i], A->mod);
+    }
+
+    for (i = A->r; i > 0; i--)
+        start[i] = start[i - 1];
+    start[0] = 0;
+
+    /* combine duplicates and drop zeros */
+    nmod_sparse_mat_fit_nnz(A, len);
+    nnz = 0;
+    A->max_row = 0;
+
+    for (i = 0; i < A->r; i++)
+    {
+        qsort(T + start[i], start[i + 1] - start[i],
+                                sizeof(_col_entry_struct), _col_entry_cmp);
+
+        A->rows[i] = nnz;
+
+        for (j = start[i]; j < start[i + 1]; j = k)
+        {
+            x = T[j].entry;
+
+            for (k = j + 1; k < start[i + 1] && T[k].col == T[j].col; k++)
+                x = nmod_add(x, T[k].entry, A->mod);
+
+            if (x != 0)
+            {
+                A->cols[nnz] = T[j].col;
+                A->entries[nnz] = x;
+                nnz++;
+            }
+        }
+
+        A->max_row = FLINT_MAX(A->max_row, nnz - A->rows[i]);
+    }
+
+    A->rows[A->r] = nnz;
+    A->nnz = nnz;
+
+    flint_free(start);
+    flint_free(T);
+}
@@ -0,0 +1,100 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "nmod.h"
+#include "nmod_vec.h"
+#include "nmod_mat.h"
+#include "nmod_sparse_mat.h"
+
+int
+nmod_sparse_mat_solve(mp_ptr x, const nmod_sparse_mat_t A, mp_srcptr b)
+{
+    _nmod_sparse_elim_t E;
+    nmod_mat_t D, DA, Db, Y;
+    slong * cmap;
+    slong i, j, k, l, m, p;
+    mp_limb_t s, inv;
+    int success;
+
+    _nmod_sparse_elim_init(E, A, b);
+    _nmod_sparse_elim_run(E);
+
+    cmap = flint_malloc(A->c * sizeof(slong));
+    m = _nmod_sparse_elim_remaining(D, cmap, E);
+
+    _nmod_vec_zero(x, A->c);
+
+    /* the remaining system, on the columns which were not eliminated */
+    if (D->r == 0)
+    {
+        success = 1;
+    }
+    else if (m == 0)
+    {
+        success = 1;
+        for (i = 0; i < D->r; i++)
+            success = success && (nmod_mat_entry(D, i, 0) == 0);
+    }
+    else
+    {
+        nmod_mat_window_init(DA, D, 0, 0, D->r, m);
+        nmod_mat_window_init(Db, D, 0, m, D->r, m + 1);
+        nmod_mat_init(Y, m, 1, A->mod.n);
+
+        success = nmod_mat_can_solve(Y, DA, Db);
+
+        for (l = 0; l < m; l++)
+            x[cmap[l]] = nmod_mat_entry(Y, l, 0);
+
+        nmod_mat_clear(Y);
+        nmod_mat_window_clear(Db);
+        nmod_mat_window_clear(DA);
+    }
+
+    /* back substitution for the pivot columns */
+    if (success)
+    {
+        for (p = E->npiv - 1; p >= 0; p--)
+        {
+            const _nmod_sparse_row_struct * R = E->rows + E->piv_row[p];
+
+            j = E->piv_col[p];
+            s = 0;
+            inv = 0;
+
+            for (k = 0; k < R->len; k++)
+            {
+                i = R->cols[k];
+
+                if (i == j)
+                    inv = R->entries[k];
+                else if (i == E->cpiv)
+                    s = nmod_add(s, R->entries[k], A->mod);
+                else
+                    s = nmod_sub(s, nmod_mul(R->entries[k], x[i], A->mod),
+                                                                    A->mod);
+            }
+
+            x[j] = nmod_mul(s, nmod_inv(inv, A->mod), A->mod);
+        }
+    }
+    else
+    {
+        _nmod_vec_zero(x, A->c);
+    }
+
+    nmod_mat_clear(D);
+    flint_free(cmap);
+    _nmod_sparse_elim_clear(E);
+
+    return success;
+}
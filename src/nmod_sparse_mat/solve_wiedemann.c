@@ -0,0 +1,85 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "nmod.h"
+#include "nmod_vec.h"
+#include "nmod_poly.h"
+#include "nmod_sparse_mat.h"
+
+#define WIEDEMANN_ROUNDS 8
+
+/*
+    If f = f_0 + f_1 x + ... + f_d x^d annihilates b, i.e. f(A) b = 0, and
+    f_0 != 0, then x = -(f_1 b + f_2 A b + ... + f_d A^(d-1) b) / f_0.
+    The first attempt uses an early terminated sequence; after that f is
+    rebuilt from full sequences, each round multiplying in the generators
+    of new projections, so f divides the minimal polynomial of A with
+    respect to b and f_0 = 0 proves that A is singular.
+*/
+int
+nmod_sparse_mat_solve_wiedemann(mp_ptr x, const nmod_sparse_mat_t A,
+                                        mp_srcptr b, flint_rand_t state)
+{
+    nmod_poly_t f;
+    mp_ptr t;
+    slong n, round;
+    int success = 0;
+
+    if (A->r != A->c)
+        flint_throw(FLINT_ERROR, "Exception (nmod_sparse_mat_solve_wiedemann). "
+                                                    "Non-square matrix.\n");
+
+    n = A->r;
+
+    if (_nmod_vec_is_zero(b, n))
+    {
+        _nmod_vec_zero(x, n);
+        return 1;
+    }
+
+    t = _nmod_vec_init(n);
+    nmod_poly_init_mod(f, A->mod);
+
+    for (round = 0; round < WIEDEMANN_ROUNDS && !success; round++)
+    {
+        if (round <= 1)
+            nmod_poly_one(f);
+
+        _nmod_sparse_mat_wiedemann_minpoly(f, A, b, round == 0, state);
+
+        if (f->length <= 1)
+            continue;
+
+        if (f->coeffs[0] == 0)
+        {
+            if (round == 0)
+                continue;
+            else
+                break;
+        }
+
+        _nmod_sparse_mat_evaluate_vec(x, A, f->coeffs + 1, f->length - 1, b);
+        _nmod_vec_scalar_mul_nmod(x, x, n,
+                nmod_neg(nmod_inv(f->coeffs[0], A->mod), A->mod), A->mod);
+
+        nmod_sparse_mat_mul_vec(t, A, x);
+        success = _nmod_vec_equal(t, b, n);
+    }
+
+    if (!success)
+        _nmod_vec_zero(x, n);
+
+    nmod_poly_clear(f);
+    _nmod_vec_clear(t);
+
+    return success;
+}
@@ -0,0 +1,90 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "ulong_extras.h"
+#include "nmod_vec.h"
+#include "nmod_mat.h"
+#include "nmod_sparse_mat.h"
+
+int
+main(void)
+{
+    slong iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("mul_vec....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 200 * flint_test_multiplier(); iter++)
+    {
+        nmod_sparse_mat_t A;
+        nmod_mat_t D, X, Y;
+        mp_ptr x, y;
+        slong r, c, i;
+        mp_limb_t n;
+
+        flint_set_num_threads(n_randint(state, 4) + 1);
+
+        if (n_randint(state, 10) == 0)
+        {
+            r = n_randint(state, 2000);
+            c = n_randint(state, 2000) + 1;
+        }
+        else
+        {
+            r = n_randint(state, 50);
+            c = n_randint(state, 50) + 1;
+        }
+
+        n = n_randtest_not_zero(state);
+
+        nmod_sparse_mat_init(A, r, c, n);
+        nmod_mat_init(D, r, c, n);
+        nmod_mat_init(X, c, 1, n);
+        nmod_mat_init(Y, r, 1, n);
+        x = _nmod_vec_init(c);
+        y = _nmod_vec_init(r);
+
+        nmod_sparse_mat_randtest(A, state, 0, 1 + n_randint(state, 40));
+        nmod_mat_set_nmod_sparse_mat(D, A);
+        _nmod_vec_randtest(x, state, c, A->mod);
+
+        for (i = 0; i < c; i++)
+            nmod_mat_entry(X, i, 0) = x[i];
+
+        nmod_sparse_mat_mul_vec(y, A, x);
+        nmod_mat_mul(Y, D, X);
+
+        for (i = 0; i < r; i++)
+        {
+            if (y[i] != nmod_mat_entry(Y, i, 0))
+            {
+                flint_printf("FAIL:\n");
+                flint_printf("r = %wd, c = %wd, n = %wu, i = %wd\n", r, c, n, i);
+                fflush(stdout);
+                flint_abort();
+            }
+        }
+
+        nmod_sparse_mat_clear(A);
+        nmod_mat_clear(D);
+        nmod_mat_clear(X);
+        nmod_mat_clear(Y);
+        _nmod_vec_clear(x);
+        _nmod_vec_clear(y);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
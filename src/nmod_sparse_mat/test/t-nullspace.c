@@ -0,0 +1,70 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "ulong_extras.h"
+#include "nmod_mat.h"
+#include "nmod_sparse_mat.h"
+
+int
+main(void)
+{
+    slong iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("nullspace....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 1000 * flint_test_multiplier(); iter++)
+    {
+        nmod_sparse_mat_t A;
+        nmod_mat_t D, X, Z;
+        slong r, c, nullity, rank;
+        mp_limb_t p;
+
+        r = n_randint(state, 60);
+        c = n_randint(state, 60);
+        p = n_randtest_prime(state, 0);
+
+        nmod_sparse_mat_init(A, r, c, p);
+        nmod_mat_init(D, r, c, p);
+        nmod_mat_init(X, 0, 0, p);
+
+        nmod_sparse_mat_randtest(A, state, 0, 1 + n_randint(state, 6));
+        nmod_mat_set_nmod_sparse_mat(D, A);
+
+        nullity = nmod_sparse_mat_nullspace(X, A);
+        rank = nmod_mat_rank(D);
+
+        nmod_mat_init(Z, r, nullity, p);
+        nmod_mat_mul(Z, D, X);
+
+        if (nullity != c - rank || X->r != c || X->c != nullity
+                || !nmod_mat_is_zero(Z) || nmod_mat_rank(X) != nullity)
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("r = %wd, c = %wd, p = %wu\n", r, c, p);
+            flint_printf("rank = %wd, nullity = %wd\n", rank, nullity);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        nmod_sparse_mat_clear(A);
+        nmod_mat_clear(D);
+        nmod_mat_clear(X);
+        nmod_mat_clear(Z);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,66 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "ulong_extras.h"
+#include "nmod_vec.h"
+#include "nmod_sparse_mat.h"
+
+int
+main(void)
+{
+    slong iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("nullvector_wiedemann....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 200 * flint_test_multiplier(); iter++)
+    {
+        nmod_sparse_mat_t A;
+        mp_ptr x, y;
+        slong n, rank;
+        mp_limb_t p;
+        int res;
+
+        n = n_randint(state, 80) + 1;
+        p = n_randtest_prime(state, 0);
+
+        nmod_sparse_mat_init(A, n, n, p);
+        x = _nmod_vec_init(n);
+        y = _nmod_vec_init(n);
+
+        nmod_sparse_mat_randtest(A, state, 0, 1 + n_randint(state, 4));
+
+        rank = nmod_sparse_mat_rank(A);
+        res = nmod_sparse_mat_nullvector_wiedemann(x, A, state);
+        nmod_sparse_mat_mul_vec(y, A, x);
+
+        if (res != (rank < n) || (res && (_nmod_vec_is_zero(x, n)
+                                            || !_nmod_vec_is_zero(y, n))))
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("n = %wd, p = %wu, rank = %wd, res = %d\n",
+                                                            n, p, rank, res);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        nmod_sparse_mat_clear(A);
+        _nmod_vec_clear(x);
+        _nmod_vec_clear(y);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,142 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "ulong_extras.h"
+#include "nmod.h"
+#include "nmod_mat.h"
+#include "nmod_sparse_mat.h"
+
+static slong
+_max_row(const nmod_sparse_mat_t A)
+{
+    slong i, len = 0;
+
+    for (i = 0; i < A->r; i++)
+        len = FLINT_MAX(len, A->rows[i + 1] - A->rows[i]);
+
+    return len;
+}
+
+int
+main(void)
+{
+    slong iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("set_entries....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 1000 * flint_test_multiplier(); iter++)
+    {
+        nmod_sparse_mat_t A, B, C;
+        nmod_mat_t D, E, F;
+        slong r, c, i, len;
+        slong * rows, * cols;
+        mp_ptr entries;
+        mp_limb_t n;
+
+        r = n_randint(state, 20);
+        c = n_randint(state, 20);
+        n = n_randtest_not_zero(state);
+        len = (r == 0 || c == 0) ? 0 : n_randint(state, 3 * r * c + 1);
+
+        nmod_sparse_mat_init(A, r, c, n);
+        nmod_sparse_mat_init(B, r, c, n);
+        nmod_sparse_mat_init(C, c, r, n);
+        nmod_mat_init(D, r, c, n);
+        nmod_mat_init(E, r, c, n);
+        nmod_mat_init(F, c, r, n);
+
+        rows = flint_malloc(len * sizeof(slong));
+        cols = flint_malloc(len * sizeof(slong));
+        entries = flint_malloc(len * sizeof(mp_limb_t));
+
+        /* duplicate positions are summed */
+        for (i = 0; i < len; i++)
+        {
+            rows[i] = n_randint(state, r);
+            cols[i] = n_randint(state, c);
+            entries[i] = n_randtest(state);
+
+            nmod_mat_entry(D, rows[i], cols[i]) = nmod_add(
+                nmod_mat_entry(D, rows[i], cols[i]),
+                n_mod2_preinv(entries[i], D->mod.n, D->mod.ninv), D->mod);
+        }
+
+        nmod_sparse_mat_set_entries(A, rows, cols, entries, len);
+        nmod_mat_set_nmod_sparse_mat(E, A);
+
+        if (!nmod_mat_equal(D, E))
+        {
+            flint_printf("FAIL (set_entries):\n");
+            nmod_mat_print_pretty(D);
+            nmod_mat_print_pretty(E);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        for (i = 0; i < A->nnz; i++)
+        {
+            if (A->entries[i] == 0)
+            {
+                flint_printf("FAIL (zero entry)\n");
+                fflush(stdout);
+                flint_abort();
+            }
+        }
+
+        nmod_sparse_mat_set_nmod_mat(B, D);
+
+        if (!nmod_sparse_mat_equal(A, B))
+        {
+            flint_printf("FAIL (set_nmod_mat)\n");
+            fflush(stdout);
+            flint_abort();
+        }
+
+        nmod_sparse_mat_transpose(C, A);
+        nmod_mat_transpose(F, D);
+        nmod_mat_clear(E);
+        nmod_mat_init(E, c, r, n);
+        nmod_mat_set_nmod_sparse_mat(E, C);
+
+        if (!nmod_mat_equal(E, F))
+        {
+            flint_printf("FAIL (transpose)\n");
+            fflush(stdout);
+            flint_abort();
+        }
+
+        if (A->max_row != _max_row(A) || B->max_row != _max_row(B)
+                                      || C->max_row != _max_row(C))
+        {
+            flint_printf("FAIL (max_row)\n");
+            fflush(stdout);
+            flint_abort();
+        }
+
+        nmod_sparse_mat_clear(A);
+        nmod_sparse_mat_clear(B);
+        nmod_sparse_mat_clear(C);
+        nmod_mat_clear(D);
+        nmod_mat_clear(E);
+        nmod_mat_clear(F);
+        flint_free(rows);
+        flint_free(cols);
+        flint_free(entries);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,92 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "ulong_extras.h"
+#include "nmod_vec.h"
+#include "nmod_mat.h"
+#include "nmod_sparse_mat.h"
+
+int
+main(void)
+{
+    slong iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("solve....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 1000 * flint_test_multiplier(); iter++)
+    {
+        nmod_sparse_mat_t A;
+        nmod_mat_t D, X, B;
+        mp_ptr x, b, y;
+        slong r, c, i;
+        mp_limb_t p;
+        int res1, res2;
+
+        r = n_randint(state, 60);
+        c = n_randint(state, 60);
+        p = n_randtest_prime(state, 0);
+
+        nmod_sparse_mat_init(A, r, c, p);
+        nmod_mat_init(D, r, c, p);
+        nmod_mat_init(X, c, 1, p);
+        nmod_mat_init(B, r, 1, p);
+        x = _nmod_vec_init(c);
+        b = _nmod_vec_init(r);
+        y = _nmod_vec_init(r);
+
+        nmod_sparse_mat_randtest(A, state, 0, 1 + n_randint(state, 6));
+        nmod_mat_set_nmod_sparse_mat(D, A);
+
+        /* a consistent system half of the time */
+        if (n_randint(state, 2))
+        {
+            _nmod_vec_randtest(x, state, c, A->mod);
+            nmod_sparse_mat_mul_vec(b, A, x);
+        }
+        else
+        {
+            _nmod_vec_randtest(b, state, r, A->mod);
+        }
+
+        for (i = 0; i < r; i++)
+            nmod_mat_entry(B, i, 0) = b[i];
+
+        res1 = nmod_sparse_mat_solve(x, A, b);
+        res2 = nmod_mat_can_solve(X, D, B);
+
+        nmod_sparse_mat_mul_vec(y, A, x);
+
+        if (res1 != res2 || (res1 && !_nmod_vec_equal(y, b, r)))
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("r = %wd, c = %wd, p = %wu\n", r, c, p);
+            flint_printf("res1 = %d, res2 = %d\n", res1, res2);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        nmod_sparse_mat_clear(A);
+        nmod_mat_clear(D);
+        nmod_mat_clear(X);
+        nmod_mat_clear(B);
+        _nmod_vec_clear(x);
+        _nmod_vec_clear(b);
+        _nmod_vec_clear(y);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,116 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "nmod_vec.h"
+#include "nmod_poly.h"
+#include "nmod_sparse_mat.h"
+
+/*
+    The minimal generator of u^T A^i v for random u divides the minimal
+    polynomial of A with respect to v and equals it with probability about
+    1 - deg/p for a prime modulus p. Over small fields several projections
+    of the same Krylov sequence are used, which costs a dot product per
+    projection and step but no further products by A, and their generators
+    are combined by their least common multiple.
+
+    With early termination the sequence is cut off once every generator
+    has stayed the same for WIEDEMANN_MARGIN terms. This is a heuristic
+    and the result then need not divide the minimal polynomial, so that
+    callers must check what they compute from it.
+*/
+
+#define WIEDEMANN_SMALL_MODULUS (UWORD(1) << 16)
+#define WIEDEMANN_NUM_PROJ 4
+#define WIEDEMANN_MARGIN 16
+#define WIEDEMANN_CHECK 32
+
+void
+_nmod_sparse_mat_wiedemann_minpoly(nmod_poly_t f, const nmod_sparse_mat_t A,
+                                mp_srcptr v, int early, flint_rand_t state)
+{
+    nmod_berlekamp_massey_struct * B;
+    nmod_poly_t g, h;
+    mp_ptr U, x, y;
+    slong i, k, n, nproj;
+    int nlimbs, done;
+
+    n = A->r;
+    nproj = (A->mod.n < WIEDEMANN_SMALL_MODULUS) ? WIEDEMANN_NUM_PROJ : 1;
+
+    U = _nmod_vec_init(nproj * n);
+    x = _nmod_vec_init(n);
+    y = _nmod_vec_init(n);
+    B = flint_malloc(nproj * sizeof(nmod_berlekamp_massey_struct));
+
+    for (i = 0; i < nproj * n; i++)
+        U[i] = n_randint(state, A->mod.n);
+
+    for (k = 0; k < nproj; k++)
+        nmod_berlekamp_massey_init(B + k, A->mod.n);
+
+    nlimbs = _nmod_vec_dot_bound_limbs(n, A->mod);
+    _nmod_vec_set(x, v, n);
+
+    for (i = 0; i < 2 * n; i++)
+    {
+        for (k = 0; k < nproj; k++)
+            nmod_berlekamp_massey_add_point(B + k,
+                            _nmod_vec_dot(U + k * n, x, n, A->mod, nlimbs));
+
+        if (early && (i + 1) % WIEDEMANN_CHECK == 0)
+        {
+            done = 1;
+
+            for (k = 0; k < nproj; k++)
+            {
+                nmod_berlekamp_massey_reduce(B + k);
+
+                if (2 * nmod_poly_degree(nmod_berlekamp_massey_V_poly(B + k))
+                                                + WIEDEMANN_MARGIN > i + 1)
+                    done = 0;
+            }
+
+            if (done)
+                break;
+        }
+
+        if (i + 1 < 2 * n)
+        {
+            nmod_sparse_mat_mul_vec(y, A, x);
+            MP_PTR_SWAP(x, y);
+        }
+    }
+
+    nmod_poly_init_mod(g, A->mod);
+    nmod_poly_init_mod(h, A->mod);
+
+    /* f = lcm(f, V_1, ..., V_k) */
+    for (k = 0; k < nproj; k++)
+    {
+        nmod_berlekamp_massey_reduce(B + k);
+        nmod_poly_make_monic(g, nmod_berlekamp_massey_V_poly(B + k));
+        nmod_poly_gcd(h, f, g);
+        nmod_poly_div(g, g, h);
+        nmod_poly_mul(f, f, g);
+
+        nmod_berlekamp_massey_clear(B + k);
+    }
+
+    nmod_poly_make_monic(f, f);
+
+    nmod_poly_clear(g);
+    nmod_poly_clear(h);
+    flint_free(B);
+    _nmod_vec_clear(U);
+    _nmod_vec_clear(x);
+    _nmod_vec_clear(y);
+}
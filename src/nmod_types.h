@@ -18,6 +18,17 @@
 extern "C" {
 #endif
 
+/* Montgomery representation modulo an odd n, with R = 2^FLINT_BITS */
+typedef struct
+{
+    mp_limb_t n;
+    mp_limb_t ninv;     /* n^(-1) mod R */
+    mp_limb_t one;      /* R mod n */
+    mp_limb_t r2;       /* R^2 mod n */
+    mp_limb_t r3;       /* R^3 mod n */
+}
+nmod_mont_t;
+
 typedef struct
 {
     mp_limb_t * entries;
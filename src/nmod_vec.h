@@ -20,6 +20,7 @@
 #endif
 
 #include "flint.h"
+#include "nmod_types.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -116,6 +117,25 @@ void _nmod_vec_scalar_addmul_nmod(mp_ptr res, mp_srcptr vec,
 
 int _nmod_vec_dot_bound_limbs(slong len, nmod_t mod);
 
+/* Montgomery kernels ********************************************************/
+
+/* from this length on, the kernels use AVX2 lanes for n < 2^32 and
+   AVX512 IFMA lanes for n < 2^50 when flint_cpu_level allows */
+#define NMOD_VEC_MONT_DISPATCH_CUTOFF 8
+
+void _nmod_vec_to_mont(mp_ptr res, mp_srcptr vec, slong len, nmod_mont_t mod);
+
+void _nmod_vec_from_mont(mp_ptr res, mp_srcptr vec, slong len, nmod_mont_t mod);
+
+void _nmod_vec_scalar_mul_nmod_mont(mp_ptr res, mp_srcptr vec,
+                            slong len, mp_limb_t c, nmod_mont_t mod);
+
+mp_limb_t _nmod_vec_dot_mont(mp_srcptr vec1, mp_srcptr vec2,
+                            slong len, nmod_mont_t mod);
+
+void _nmod_vec_butterfly_mont(mp_ptr a, mp_ptr b, slong len,
+                            mp_limb_t w, nmod_mont_t mod);
+
 
 #define NMOD_VEC_DOT(res, i, len, expr1, expr2, mod, nlimbs)                \
     do                                                                      \
@@ -184,6 +204,11 @@ int _nmod_vec_dot_bound_limbs(slong len, nmod_t mod);
 mp_limb_t _nmod_vec_dot(mp_srcptr vec1, mp_srcptr vec2,
     slong len, nmod_t mod, int nlimbs);
 
+/* below this length the dispatch costs more than the vector kernels gain */
+#define NMOD_VEC_DOT1_DISPATCH_CUTOFF 64
+
+mp_limb_t _nmod_vec_dot1_nored(mp_srcptr vec1, mp_srcptr vec2, slong len);
+
 mp_limb_t _nmod_vec_dot_rev(mp_srcptr vec1, mp_srcptr vec2,
     slong len, nmod_t mod, int nlimbs);
 
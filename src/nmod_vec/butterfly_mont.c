@@ -0,0 +1,150 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "ulong_extras.h"
+#include "nmod.h"
+#include "nmod_vec.h"
+
+#if FLINT_HAVE_CPU_DISPATCH && FLINT_BITS == 64
+# include <immintrin.h>
+#endif
+
+/* (a, b) = (a + w b, a - w b), as in a step of a number theoretic transform */
+static void
+_nmod_vec_butterfly_mont_generic(mp_ptr a, mp_ptr b, slong len, mp_limb_t w,
+                                                           nmod_mont_t mod)
+{
+    slong i;
+    mp_limb_t wr = nmod_mont_mul(w, mod.r2, mod);
+
+    for (i = 0; i + 2 <= len; i += 2)
+    {
+        mp_limb_t t0, t1, x0, x1;
+
+        t0 = nmod_mont_mul(b[i], wr, mod);
+        t1 = nmod_mont_mul(b[i + 1], wr, mod);
+        x0 = a[i];
+        x1 = a[i + 1];
+
+        a[i] = nmod_mont_add(x0, t0, mod);
+        a[i + 1] = nmod_mont_add(x1, t1, mod);
+        b[i] = nmod_mont_sub(x0, t0, mod);
+        b[i + 1] = nmod_mont_sub(x1, t1, mod);
+    }
+
+    if (i < len)
+    {
+        mp_limb_t t0 = nmod_mont_mul(b[i], wr, mod), x0 = a[i];
+
+        a[i] = nmod_mont_add(x0, t0, mod);
+        b[i] = nmod_mont_sub(x0, t0, mod);
+    }
+}
+
+#if FLINT_HAVE_CPU_DISPATCH && FLINT_BITS == 64
+
+/* w b by REDC with 2^32 as in _nmod_vec_scalar_mul_nmod_mont, for n < 2^32 */
+__attribute__((target("avx2")))
+static void
+_nmod_vec_butterfly_mont_avx2(mp_ptr a, mp_ptr b, slong len, mp_limb_t w,
+                                                           nmod_mont_t mod)
+{
+    __m256i n = _mm256_set1_epi64x(mod.n);
+    __m256i ninv = _mm256_set1_epi64x(mod.ninv);
+    __m256i v = _mm256_set1_epi64x((w << 32) % mod.n);
+    __m256i zero = _mm256_setzero_si256();
+    __m256i x, t, q, s, d;
+    slong i;
+
+    for (i = 0; i + 4 <= len; i += 4)
+    {
+        t = _mm256_mul_epu32(_mm256_loadu_si256((const __m256i *) (b + i)), v);
+        q = _mm256_mul_epu32(_mm256_mul_epu32(t, ninv), n);
+        t = _mm256_sub_epi64(_mm256_srli_epi64(t, 32), _mm256_srli_epi64(q, 32));
+        t = _mm256_add_epi64(t, _mm256_and_si256(_mm256_cmpgt_epi64(zero, t), n));
+
+        x = _mm256_loadu_si256((const __m256i *) (a + i));
+        s = _mm256_add_epi64(x, t);
+        s = _mm256_sub_epi64(s, _mm256_andnot_si256(_mm256_cmpgt_epi64(n, s), n));
+        d = _mm256_sub_epi64(x, t);
+        d = _mm256_add_epi64(d, _mm256_and_si256(_mm256_cmpgt_epi64(zero, d), n));
+
+        _mm256_storeu_si256((__m256i *) (a + i), s);
+        _mm256_storeu_si256((__m256i *) (b + i), d);
+    }
+
+    _nmod_vec_butterfly_mont_generic(a + i, b + i, len - i, w, mod);
+}
+
+/* w b by REDC with 2^52 as in _nmod_vec_scalar_mul_nmod_mont, for n < 2^50 */
+__attribute__((target("avx512f,avx512ifma")))
+static void
+_nmod_vec_butterfly_mont_ifma(mp_ptr a, mp_ptr b, slong len, mp_limb_t w,
+                                                           nmod_mont_t mod)
+{
+    mp_limb_t pinv = n_preinvert_limb(mod.n);
+    __m512i n = _mm512_set1_epi64(mod.n);
+    __m512i ninv = _mm512_set1_epi64(mod.ninv);
+    __m512i v = _mm512_set1_epi64(n_mulmod2_preinv(w,
+                                (UWORD(1) << 52) % mod.n, mod.n, pinv));
+    __m512i zero = _mm512_setzero_si512();
+    __m512i x, lo, hi, q, t, s, d;
+    slong i;
+
+    for (i = 0; i + 8 <= len; i += 8)
+    {
+        x = _mm512_loadu_si512((const void *) (b + i));
+        lo = _mm512_madd52lo_epu64(zero, x, v);
+        hi = _mm512_madd52hi_epu64(zero, x, v);
+        q = _mm512_madd52lo_epu64(zero, lo, ninv);
+        t = _mm512_sub_epi64(hi, _mm512_madd52hi_epu64(zero, q, n));
+        t = _mm512_min_epu64(t, _mm512_add_epi64(t, n));
+
+        x = _mm512_loadu_si512((const void *) (a + i));
+        s = _mm512_add_epi64(x, t);
+        s = _mm512_min_epu64(s, _mm512_sub_epi64(s, n));
+        d = _mm512_sub_epi64(x, t);
+        d = _mm512_min_epu64(d, _mm512_add_epi64(d, n));
+
+        _mm512_storeu_si512((void *) (a + i), s);
+        _mm512_storeu_si512((void *) (b + i), d);
+    }
+
+    _nmod_vec_butterfly_mont_generic(a + i, b + i, len - i, w, mod);
+}
+
+#endif
+
+void
+_nmod_vec_butterfly_mont(mp_ptr a, mp_ptr b, slong len, mp_limb_t w,
+                                                           nmod_mont_t mod)
+{
+#if FLINT_HAVE_CPU_DISPATCH && FLINT_BITS == 64
+    if (len >= NMOD_VEC_MONT_DISPATCH_CUTOFF)
+    {
+        int level = flint_cpu_level();
+
+        if (level >= FLINT_CPU_AVX512_IFMA && mod.n < (UWORD(1) << 50))
+        {
+            _nmod_vec_butterfly_mont_ifma(a, b, len, w, mod);
+            return;
+        }
+
+        if (level >= FLINT_CPU_AVX2 && mod.n < (UWORD(1) << 32))
+        {
+            _nmod_vec_butterfly_mont_avx2(a, b, len, w, mod);
+            return;
+        }
+    }
+#endif
+
+    _nmod_vec_butterfly_mont_generic(a, b, len, w, mod);
+}
@@ -17,6 +17,14 @@ _nmod_vec_dot(mp_srcptr vec1, mp_srcptr vec2, slong len, nmod_t mod, int nlimbs)
 {
     mp_limb_t res;
     slong i;
+
+    if (nlimbs == 1 && len >= NMOD_VEC_DOT1_DISPATCH_CUTOFF)
+    {
+        res = _nmod_vec_dot1_nored(vec1, vec2, len);
+        NMOD_RED(res, res, mod);
+        return res;
+    }
+
     NMOD_VEC_DOT(res, i, len, vec1[i], vec2[i], mod, nlimbs);
     return res;
 }
@@ -0,0 +1,125 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "nmod_vec.h"
+
+#if FLINT_HAVE_CPU_DISPATCH && FLINT_BITS == 64
+# include <immintrin.h>
+#endif
+
+static mp_limb_t
+_nmod_vec_dot1_nored_generic(mp_srcptr vec1, mp_srcptr vec2, slong len)
+{
+    mp_limb_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    slong i;
+
+    for (i = 0; i + 4 <= len; i += 4)
+    {
+        s0 += vec1[i + 0] * vec2[i + 0];
+        s1 += vec1[i + 1] * vec2[i + 1];
+        s2 += vec1[i + 2] * vec2[i + 2];
+        s3 += vec1[i + 3] * vec2[i + 3];
+    }
+
+    for ( ; i < len; i++)
+        s0 += vec1[i] * vec2[i];
+
+    return s0 + s1 + s2 + s3;
+}
+
+#if FLINT_HAVE_CPU_DISPATCH && FLINT_BITS == 64
+
+/* the low word of x*y is xlo*ylo + ((xhi*ylo + xlo*yhi) << 32) */
+__attribute__((target("avx2")))
+static mp_limb_t
+_nmod_vec_dot1_nored_avx2(mp_srcptr vec1, mp_srcptr vec2, slong len)
+{
+    __m256i s = _mm256_setzero_si256();
+    __m256i x, y, lo, mid;
+    mp_limb_t t[4], res;
+    slong i;
+
+    for (i = 0; i + 4 <= len; i += 4)
+    {
+        x = _mm256_loadu_si256((const __m256i *) (vec1 + i));
+        y = _mm256_loadu_si256((const __m256i *) (vec2 + i));
+        lo = _mm256_mul_epu32(x, y);
+        mid = _mm256_add_epi64(
+                    _mm256_mul_epu32(_mm256_srli_epi64(x, 32), y),
+                    _mm256_mul_epu32(x, _mm256_srli_epi64(y, 32)));
+        s = _mm256_add_epi64(s, _mm256_add_epi64(lo,
+                                             _mm256_slli_epi64(mid, 32)));
+    }
+
+    _mm256_storeu_si256((__m256i *) t, s);
+    res = t[0] + t[1] + t[2] + t[3];
+
+    for ( ; i < len; i++)
+        res += vec1[i] * vec2[i];
+
+    return res;
+}
+
+__attribute__((target("avx512f,avx512dq")))
+static mp_limb_t
+_nmod_vec_dot1_nored_avx512(mp_srcptr vec1, mp_srcptr vec2, slong len)
+{
+    __m512i s0 = _mm512_setzero_si512();
+    __m512i s1 = _mm512_setzero_si512();
+    mp_limb_t res;
+    slong i;
+
+    for (i = 0; i + 16 <= len; i += 16)
+    {
+        s0 = _mm512_add_epi64(s0, _mm512_mullo_epi64(
+                            _mm512_loadu_si512((const void *) (vec1 + i)),
+                            _mm512_loadu_si512((const void *) (vec2 + i))));
+        s1 = _mm512_add_epi64(s1, _mm512_mullo_epi64(
+                            _mm512_loadu_si512((const void *) (vec1 + i + 8)),
+                            _mm512_loadu_si512((const void *) (vec2 + i + 8))));
+    }
+
+    if (i + 8 <= len)
+    {
+        s0 = _mm512_add_epi64(s0, _mm512_mullo_epi64(
+                            _mm512_loadu_si512((const void *) (vec1 + i)),
+                            _mm512_loadu_si512((const void *) (vec2 + i))));
+        i += 8;
+    }
+
+    res = _mm512_reduce_add_epi64(_mm512_add_epi64(s0, s1));
+
+    for ( ; i < len; i++)
+        res += vec1[i] * vec2[i];
+
+    return res;
+}
+
+#endif
+
+mp_limb_t
+_nmod_vec_dot1_nored(mp_srcptr vec1, mp_srcptr vec2, slong len)
+{
+#if FLINT_HAVE_CPU_DISPATCH && FLINT_BITS == 64
+    if (len >= 8)
+    {
+        int level = flint_cpu_level();
+
+        if (level >= FLINT_CPU_AVX512)
+            return _nmod_vec_dot1_nored_avx512(vec1, vec2, len);
+
+        if (level >= FLINT_CPU_AVX2)
+            return _nmod_vec_dot1_nored_avx2(vec1, vec2, len);
+    }
+#endif
+
+    return _nmod_vec_dot1_nored_generic(vec1, vec2, len);
+}
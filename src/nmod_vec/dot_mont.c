@@ -0,0 +1,186 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "nmod.h"
+#include "nmod_vec.h"
+
+#if FLINT_HAVE_CPU_DISPATCH && FLINT_BITS == 64
+# include <immintrin.h>
+#endif
+
+/*
+    The sum T = s2 R^2 + s1 R + s0 is reduced by two Montgomery steps,
+    giving T / R^2 mod n, and a Montgomery multiplication by R^3 mod n.
+*/
+static mp_limb_t
+_nmod_vec_dot_mont_reduce(mp_limb_t s2, mp_limb_t s1, mp_limb_t s0,
+                                                           nmod_mont_t mod)
+{
+    mp_limb_t th, tl;
+
+    if (s2 >= mod.n)
+        s2 %= mod.n;
+
+    /* (s2 R + s1 - th) with s2 < n, reduced to a value below n R */
+    umul_ppmm(th, tl, s0 * mod.ninv, mod.n);
+    (void) tl;
+    if (s1 < th)
+        s2 = (s2 == 0) ? mod.n - 1 : s2 - 1;
+    s1 -= th;
+
+    return nmod_mont_mul(nmod_mont_redc(s2, s1, mod), mod.r3, mod);
+}
+
+/* The products are summed in two independent three limb accumulators. */
+static mp_limb_t
+_nmod_vec_dot_mont_generic(mp_srcptr vec1, mp_srcptr vec2, slong len,
+                                                           nmod_mont_t mod)
+{
+    mp_limb_t s0, s1, s2, u0, u1, u2, t0, t1;
+    slong i;
+
+    s0 = s1 = s2 = u0 = u1 = u2 = 0;
+
+    for (i = 0; i + 2 <= len; i += 2)
+    {
+        umul_ppmm(t1, t0, vec1[i], vec2[i]);
+        add_sssaaaaaa(s2, s1, s0, s2, s1, s0, 0, t1, t0);
+        umul_ppmm(t1, t0, vec1[i + 1], vec2[i + 1]);
+        add_sssaaaaaa(u2, u1, u0, u2, u1, u0, 0, t1, t0);
+    }
+
+    if (i < len)
+    {
+        umul_ppmm(t1, t0, vec1[i], vec2[i]);
+        add_sssaaaaaa(s2, s1, s0, s2, s1, s0, 0, t1, t0);
+    }
+
+    add_sssaaaaaa(s2, s1, s0, s2, s1, s0, u2, u1, u0);
+
+    return _nmod_vec_dot_mont_reduce(s2, s1, s0, mod);
+}
+
+#if FLINT_HAVE_CPU_DISPATCH && FLINT_BITS == 64
+
+/*
+    For n < 2^32 the products fit in a word. Their low and high halves are
+    summed separately, and a lane is added to the three limb sum after at
+    most 2^31 products.
+*/
+__attribute__((target("avx2")))
+static mp_limb_t
+_nmod_vec_dot_mont_avx2(mp_srcptr vec1, mp_srcptr vec2, slong len,
+                                                           nmod_mont_t mod)
+{
+    __m256i mask = _mm256_set1_epi64x(0xffffffff);
+    __m256i lo, hi, p;
+    mp_limb_t s0, s1, s2, l[4], h[4];
+    slong i, j, stop;
+
+    s0 = s1 = s2 = 0;
+
+    for (i = 0; i + 4 <= len; )
+    {
+        lo = hi = _mm256_setzero_si256();
+        stop = FLINT_MIN(len, i + (WORD(1) << 33));
+
+        for ( ; i + 4 <= stop; i += 4)
+        {
+            p = _mm256_mul_epu32(_mm256_loadu_si256((const __m256i *) (vec1 + i)),
+                                 _mm256_loadu_si256((const __m256i *) (vec2 + i)));
+            lo = _mm256_add_epi64(lo, _mm256_and_si256(p, mask));
+            hi = _mm256_add_epi64(hi, _mm256_srli_epi64(p, 32));
+        }
+
+        _mm256_storeu_si256((__m256i *) l, lo);
+        _mm256_storeu_si256((__m256i *) h, hi);
+
+        for (j = 0; j < 4; j++)
+        {
+            add_sssaaaaaa(s2, s1, s0, s2, s1, s0, 0, h[j] >> 32, h[j] << 32);
+            add_sssaaaaaa(s2, s1, s0, s2, s1, s0, 0, 0, l[j]);
+        }
+    }
+
+    for ( ; i < len; i++)
+        add_sssaaaaaa(s2, s1, s0, s2, s1, s0, 0, 0, vec1[i] * vec2[i]);
+
+    return _nmod_vec_dot_mont_reduce(s2, s1, s0, mod);
+}
+
+/*
+    For n < 2^50 the 52-bit multiply-add instructions sum the low and high
+    52 bits of the products, and a lane is added to the three limb sum after
+    at most 2^11 products.
+*/
+__attribute__((target("avx512f,avx512ifma")))
+static mp_limb_t
+_nmod_vec_dot_mont_ifma(mp_srcptr vec1, mp_srcptr vec2, slong len,
+                                                           nmod_mont_t mod)
+{
+    __m512i lo, hi, x, y;
+    mp_limb_t s0, s1, s2, t0, t1, l[8], h[8];
+    slong i, j, stop;
+
+    s0 = s1 = s2 = 0;
+
+    for (i = 0; i + 8 <= len; )
+    {
+        lo = hi = _mm512_setzero_si512();
+        stop = FLINT_MIN(len, i + (WORD(1) << 14));
+
+        for ( ; i + 8 <= stop; i += 8)
+        {
+            x = _mm512_loadu_si512((const void *) (vec1 + i));
+            y = _mm512_loadu_si512((const void *) (vec2 + i));
+            lo = _mm512_madd52lo_epu64(lo, x, y);
+            hi = _mm512_madd52hi_epu64(hi, x, y);
+        }
+
+        _mm512_storeu_si512((void *) l, lo);
+        _mm512_storeu_si512((void *) h, hi);
+
+        for (j = 0; j < 8; j++)
+        {
+            add_sssaaaaaa(s2, s1, s0, s2, s1, s0, 0, h[j] >> 12, h[j] << 52);
+            add_sssaaaaaa(s2, s1, s0, s2, s1, s0, 0, 0, l[j]);
+        }
+    }
+
+    for ( ; i < len; i++)
+    {
+        umul_ppmm(t1, t0, vec1[i], vec2[i]);
+        add_sssaaaaaa(s2, s1, s0, s2, s1, s0, 0, t1, t0);
+    }
+
+    return _nmod_vec_dot_mont_reduce(s2, s1, s0, mod);
+}
+
+#endif
+
+mp_limb_t
+_nmod_vec_dot_mont(mp_srcptr vec1, mp_srcptr vec2, slong len, nmod_mont_t mod)
+{
+#if FLINT_HAVE_CPU_DISPATCH && FLINT_BITS == 64
+    if (len >= NMOD_VEC_MONT_DISPATCH_CUTOFF)
+    {
+        int level = flint_cpu_level();
+
+        if (level >= FLINT_CPU_AVX512_IFMA && mod.n < (UWORD(1) << 50))
+            return _nmod_vec_dot_mont_ifma(vec1, vec2, len, mod);
+
+        if (level >= FLINT_CPU_AVX2 && mod.n < (UWORD(1) << 32))
+            return _nmod_vec_dot_mont_avx2(vec1, vec2, len, mod);
+    }
+#endif
+
+    return _nmod_vec_dot_mont_generic(vec1, vec2, len, mod);
+}
@@ -0,0 +1,31 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "nmod.h"
+#include "nmod_vec.h"
+
+void
+_nmod_vec_to_mont(mp_ptr res, mp_srcptr vec, slong len, nmod_mont_t mod)
+{
+    slong i;
+
+    for (i = 0; i < len; i++)
+        res[i] = nmod_mont_mul(vec[i], mod.r2, mod);
+}
+
+void
+_nmod_vec_from_mont(mp_ptr res, mp_srcptr vec, slong len, nmod_mont_t mod)
+{
+    slong i;
+
+    for (i = 0; i < len; i++)
+        res[i] = nmod_mont_redc(0, vec[i], mod);
+}
@@ -0,0 +1,128 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "profiler.h"
+#include "flint.h"
+#include "ulong_extras.h"
+#include "nmod.h"
+#include "nmod_vec.h"
+
+#define LENGTH 1024
+
+typedef struct
+{
+   flint_bitcnt_t bits;
+   int algo;
+} info_t;
+
+void sample(void * arg, ulong count)
+{
+   mp_limb_t n, c;
+   nmod_t mod;
+   nmod_mont_t mmod;
+   info_t * info = (info_t *) arg;
+   flint_bitcnt_t bits = info->bits;
+   slong i, j;
+   mp_ptr vec = _nmod_vec_init(LENGTH);
+   mp_ptr vec2 = _nmod_vec_init(LENGTH);
+   mp_ptr vec3 = _nmod_vec_init(LENGTH);
+   int limbs;
+   volatile mp_limb_t r;
+   FLINT_TEST_INIT(state);
+
+   for (i = 0; i < count; i++)
+   {
+      n = n_randbits(state, bits) | 1;
+      c = n_randint(state, n);
+      for (j = 0; j < LENGTH; j++)
+      {
+         vec[j] = n_randint(state, n);
+         vec2[j] = n_randint(state, n);
+      }
+
+      nmod_init(&mod, n);
+      nmod_mont_init(&mmod, n);
+      limbs = _nmod_vec_dot_bound_limbs(LENGTH, mod);
+
+      prof_start();
+      switch (info->algo)
+      {
+         case 0:
+            for (j = 0; j < 30; j++)
+               _nmod_vec_scalar_mul_nmod(vec3, vec, LENGTH, c, mod);
+            break;
+         case 1:
+            for (j = 0; j < 30; j++)
+               _nmod_vec_scalar_mul_nmod_shoup(vec3, vec, LENGTH, c, mod);
+            break;
+         case 2:
+            for (j = 0; j < 30; j++)
+               _nmod_vec_scalar_mul_nmod_mont(vec3, vec, LENGTH, c, mmod);
+            break;
+         case 3:
+            for (j = 0; j < 30; j++)
+               r = _nmod_vec_dot(vec, vec2, LENGTH, mod, limbs);
+            break;
+         case 4:
+            for (j = 0; j < 30; j++)
+               r = _nmod_vec_dot_mont(vec, vec2, LENGTH, mmod);
+            break;
+         case 5:
+            for (j = 0; j < 30; j++)
+            {
+               _nmod_vec_scalar_mul_nmod(vec3, vec2, LENGTH, c, mod);
+               _nmod_vec_sub(vec2, vec, vec3, LENGTH, mod);
+               _nmod_vec_add(vec, vec, vec3, LENGTH, mod);
+            }
+            break;
+         default:
+            for (j = 0; j < 30; j++)
+               _nmod_vec_butterfly_mont(vec, vec2, LENGTH, c, mmod);
+      }
+      prof_stop();
+   }
+
+   (void) r;
+
+   flint_randclear(state);
+   _nmod_vec_clear(vec);
+   _nmod_vec_clear(vec2);
+   _nmod_vec_clear(vec3);
+}
+
+int main(void)
+{
+   double min[7], max;
+   info_t info;
+   flint_bitcnt_t i;
+   int k;
+
+   flint_printf("cycles per entry, length %d, odd moduli\n", LENGTH);
+   flint_printf("bits  scalar_mul: nmod  shoup  mont   dot: nmod  mont"
+                "   butterfly: nmod  mont\n");
+
+   for (i = 2; i <= FLINT_BITS; i++)
+   {
+      info.bits = i;
+
+      for (k = 0; k < 7; k++)
+      {
+         info.algo = k;
+         prof_repeat(min + k, &max, sample, (void *) &info);
+         min[k] = (min[k]/(double)FLINT_CLOCK_SCALE_FACTOR)/(LENGTH*30);
+      }
+
+      flint_printf("%4wd  %16.1lf %6.1lf %5.1lf  %10.1lf %5.1lf  %16.1lf %5.1lf\n",
+         i, min[0], min[1], min[2], min[3], min[4], min[5], min[6]);
+   }
+
+   return 0;
+}
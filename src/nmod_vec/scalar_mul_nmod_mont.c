@@ -0,0 +1,141 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "ulong_extras.h"
+#include "nmod.h"
+#include "nmod_vec.h"
+
+#if FLINT_HAVE_CPU_DISPATCH && FLINT_BITS == 64
+# include <immintrin.h>
+#endif
+
+/*
+    With c' = c R mod n, the Montgomery product of x and c' is x c mod n,
+    so the entries need no conversion. The loop is unrolled so that the
+    multiplications of neighbouring entries overlap.
+*/
+static void
+_nmod_vec_scalar_mul_nmod_mont_generic(mp_ptr res, mp_srcptr vec, slong len,
+                                             mp_limb_t c, nmod_mont_t mod)
+{
+    slong i;
+    mp_limb_t w = nmod_mont_mul(c, mod.r2, mod);
+
+    for (i = 0; i + 4 <= len; i += 4)
+    {
+        mp_limb_t r0, r1, r2, r3;
+
+        r0 = nmod_mont_mul(vec[i + 0], w, mod);
+        r1 = nmod_mont_mul(vec[i + 1], w, mod);
+        r2 = nmod_mont_mul(vec[i + 2], w, mod);
+        r3 = nmod_mont_mul(vec[i + 3], w, mod);
+
+        res[i + 0] = r0;
+        res[i + 1] = r1;
+        res[i + 2] = r2;
+        res[i + 3] = r3;
+    }
+
+    for ( ; i < len; i++)
+        res[i] = nmod_mont_mul(vec[i], w, mod);
+}
+
+#if FLINT_HAVE_CPU_DISPATCH && FLINT_BITS == 64
+
+/*
+    For n < 2^32 the lanes use REDC with 2^32: x c = (x v) / 2^32 mod n with
+    v = c 2^32 mod n. With q = x v n^-1 mod 2^32, the low halves of x v and
+    q n agree, so (x v - q n) / 2^32 is the difference of the high halves.
+*/
+__attribute__((target("avx2")))
+static void
+_nmod_vec_scalar_mul_nmod_mont_avx2(mp_ptr res, mp_srcptr vec, slong len,
+                                             mp_limb_t c, nmod_mont_t mod)
+{
+    __m256i n = _mm256_set1_epi64x(mod.n);
+    __m256i ninv = _mm256_set1_epi64x(mod.ninv);
+    __m256i v = _mm256_set1_epi64x((c << 32) % mod.n);
+    __m256i zero = _mm256_setzero_si256();
+    __m256i t, q, r;
+    mp_limb_t w = nmod_mont_mul(c, mod.r2, mod);
+    slong i;
+
+    for (i = 0; i + 4 <= len; i += 4)
+    {
+        t = _mm256_mul_epu32(_mm256_loadu_si256((const __m256i *) (vec + i)), v);
+        q = _mm256_mul_epu32(_mm256_mul_epu32(t, ninv), n);
+        r = _mm256_sub_epi64(_mm256_srli_epi64(t, 32), _mm256_srli_epi64(q, 32));
+        r = _mm256_add_epi64(r, _mm256_and_si256(_mm256_cmpgt_epi64(zero, r), n));
+        _mm256_storeu_si256((__m256i *) (res + i), r);
+    }
+
+    for ( ; i < len; i++)
+        res[i] = nmod_mont_mul(vec[i], w, mod);
+}
+
+/* the same with REDC by 2^52 using the 52-bit multiply-add instructions */
+__attribute__((target("avx512f,avx512ifma")))
+static void
+_nmod_vec_scalar_mul_nmod_mont_ifma(mp_ptr res, mp_srcptr vec, slong len,
+                                             mp_limb_t c, nmod_mont_t mod)
+{
+    mp_limb_t pinv = n_preinvert_limb(mod.n);
+    __m512i n = _mm512_set1_epi64(mod.n);
+    __m512i ninv = _mm512_set1_epi64(mod.ninv);
+    __m512i v = _mm512_set1_epi64(n_mulmod2_preinv(c,
+                                (UWORD(1) << 52) % mod.n, mod.n, pinv));
+    __m512i zero = _mm512_setzero_si512();
+    __m512i x, lo, hi, q, r;
+    mp_limb_t w = nmod_mont_mul(c, mod.r2, mod);
+    slong i;
+
+    for (i = 0; i + 8 <= len; i += 8)
+    {
+        x = _mm512_loadu_si512((const void *) (vec + i));
+        lo = _mm512_madd52lo_epu64(zero, x, v);
+        hi = _mm512_madd52hi_epu64(zero, x, v);
+        q = _mm512_madd52lo_epu64(zero, lo, ninv);
+        r = _mm512_sub_epi64(hi, _mm512_madd52hi_epu64(zero, q, n));
+        r = _mm512_min_epu64(r, _mm512_add_epi64(r, n));
+        _mm512_storeu_si512((void *) (res + i), r);
+    }
+
+    for ( ; i < len; i++)
+        res[i] = nmod_mont_mul(vec[i], w, mod);
+}
+
+#endif
+
+void
+_nmod_vec_scalar_mul_nmod_mont(mp_ptr res, mp_srcptr vec, slong len,
+                                             mp_limb_t c, nmod_mont_t mod)
+{
+#if FLINT_HAVE_CPU_DISPATCH && FLINT_BITS == 64
+    if (len >= NMOD_VEC_MONT_DISPATCH_CUTOFF)
+    {
+        int level = flint_cpu_level();
+
+        if (level >= FLINT_CPU_AVX512_IFMA && mod.n < (UWORD(1) << 50))
+        {
+            _nmod_vec_scalar_mul_nmod_mont_ifma(res, vec, len, c, mod);
+            return;
+        }
+
+        if (level >= FLINT_CPU_AVX2 && mod.n < (UWORD(1) << 32))
+        {
+            _nmod_vec_scalar_mul_nmod_mont_avx2(res, vec, len, c, mod);
+            return;
+        }
+    }
+#endif
+
+    _nmod_vec_scalar_mul_nmod_mont_generic(res, vec, len, c, mod);
+}
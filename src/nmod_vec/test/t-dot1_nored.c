@@ -0,0 +1,90 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "flint.h"
+#include "nmod_vec.h"
+#include "ulong_extras.h"
+
+int
+main(void)
+{
+    int i, level, max_level;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("dot1_nored....");
+    fflush(stdout);
+
+    max_level = flint_cpu_level();
+
+    /* every implementation agrees with the generic one */
+    for (i = 0; i < 10000 * flint_test_multiplier(); i++)
+    {
+        slong j, len;
+        mp_ptr x, y;
+        mp_limb_t r0, r1, s;
+
+        len = n_randint(state, 100);
+        x = _nmod_vec_init(len);
+        y = _nmod_vec_init(len);
+
+        for (j = 0; j < len; j++)
+        {
+            x[j] = n_randtest(state);
+            y[j] = n_randtest(state);
+        }
+
+        flint_set_cpu_level(FLINT_CPU_GENERIC);
+        r0 = _nmod_vec_dot1_nored(x, y, len);
+
+        s = 0;
+        for (j = 0; j < len; j++)
+            s += x[j] * y[j];
+
+        if (r0 != s)
+        {
+            flint_printf("FAIL (generic):\n");
+            flint_printf("len = %wd\n", len);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        for (level = FLINT_CPU_AVX2; level <= max_level; level++)
+        {
+            flint_set_cpu_level(level);
+            r1 = _nmod_vec_dot1_nored(x, y, len);
+
+            if (r0 != r1)
+            {
+                flint_printf("FAIL:\n");
+                flint_printf("len = %wd, level = %d\n", len, level);
+                fflush(stdout);
+                flint_abort();
+            }
+        }
+
+        flint_set_cpu_level(max_level);
+
+        _nmod_vec_clear(x);
+        _nmod_vec_clear(y);
+    }
+
+    if (flint_cpu_level() != max_level)
+    {
+        flint_printf("FAIL (level not restored)\n");
+        fflush(stdout);
+        flint_abort();
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
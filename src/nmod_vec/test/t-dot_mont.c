@@ -0,0 +1,86 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "nmod.h"
+#include "nmod_vec.h"
+
+int
+main(void)
+{
+    int i, max_level;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("dot_mont....");
+    fflush(stdout);
+
+    max_level = flint_cpu_level();
+
+    for (i = 0; i < 1000 * flint_test_multiplier(); i++)
+    {
+        slong len;
+        nmod_t mod;
+        nmod_mont_t mmod;
+        mp_limb_t m, res1, res2;
+        mp_ptr x, y;
+
+        /* exercise the vector kernels of every supported level */
+        flint_set_cpu_level(n_randint(state, max_level + 1));
+
+        len = n_randint(state, 1000);
+
+        if (n_randint(state, 4) == 0)
+            m = UWORD_MAX - 2 * n_randint(state, 100);
+        else
+            m = n_randtest_not_zero(state) | 1;
+
+        nmod_init(&mod, m);
+        nmod_mont_init(&mmod, m);
+
+        x = _nmod_vec_init(len);
+        y = _nmod_vec_init(len);
+
+        if (n_randint(state, 2))
+        {
+            _nmod_vec_randtest(x, state, len, mod);
+            _nmod_vec_randtest(y, state, len, mod);
+        }
+        else
+        {
+            slong j;
+
+            for (j = 0; j < len; j++)
+                x[j] = y[j] = m - 1;
+        }
+
+        res1 = _nmod_vec_dot(x, y, len, mod, _nmod_vec_dot_bound_limbs(len, mod));
+        res2 = _nmod_vec_dot_mont(x, y, len, mmod);
+
+        if (res1 != res2)
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("m = %wu\n", m);
+            flint_printf("len = %wd\n", len);
+            flint_printf("res1 = %wu, res2 = %wu\n", res1, res2);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        _nmod_vec_clear(x);
+        _nmod_vec_clear(y);
+    }
+
+    flint_set_cpu_level(max_level);
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
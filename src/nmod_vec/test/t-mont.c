@@ -0,0 +1,137 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "nmod.h"
+#include "nmod_vec.h"
+
+static mp_limb_t
+randtest_odd_modulus(flint_rand_t state)
+{
+    mp_limb_t n;
+
+    switch (n_randint(state, 4))
+    {
+        case 0:
+            n = 1;
+            break;
+        case 1:
+            n = UWORD_MAX - 2 * n_randint(state, 100);
+            break;
+        default:
+            n = n_randtest_not_zero(state) | 1;
+    }
+
+    return n;
+}
+
+int
+main(void)
+{
+    int i, max_level;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("mont....");
+    fflush(stdout);
+
+    max_level = flint_cpu_level();
+
+    for (i = 0; i < 10000 * flint_test_multiplier(); i++)
+    {
+        slong j, len = n_randint(state, 100);
+        mp_limb_t n = randtest_odd_modulus(state);
+        mp_limb_t c = n_randint(state, n);
+        nmod_t mod;
+        nmod_mont_t mmod;
+
+        mp_ptr a = _nmod_vec_init(len);
+        mp_ptr b = _nmod_vec_init(len);
+        mp_ptr r = _nmod_vec_init(len);
+        mp_ptr s = _nmod_vec_init(len);
+
+        /* exercise the vector kernels of every supported level */
+        flint_set_cpu_level(n_randint(state, max_level + 1));
+
+        nmod_init(&mod, n);
+        nmod_mont_init(&mmod, n);
+
+        _nmod_vec_randtest(a, state, len, mod);
+        _nmod_vec_randtest(b, state, len, mod);
+
+        /* conversion */
+        _nmod_vec_to_mont(r, a, len, mmod);
+        _nmod_vec_from_mont(r, r, len, mmod);
+
+        if (!_nmod_vec_equal(r, a, len))
+        {
+            flint_printf("FAIL (conversion):\n");
+            flint_printf("len = %wd, n = %wu\n", len, n);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        for (j = 0; j < len; j++)
+        {
+            if (nmod_mont_get_ui(nmod_mont_mul(nmod_mont_set_ui(a[j], mmod),
+                    nmod_mont_set_ui(b[j], mmod), mmod), mmod)
+                        != nmod_mul(a[j], b[j], mod))
+            {
+                flint_printf("FAIL (nmod_mont_mul):\n");
+                flint_printf("n = %wu, a = %wu, b = %wu\n", n, a[j], b[j]);
+                fflush(stdout);
+                flint_abort();
+            }
+        }
+
+        /* scalar multiplication, aliased */
+        _nmod_vec_scalar_mul_nmod(r, a, len, c, mod);
+        _nmod_vec_set(s, a, len);
+        _nmod_vec_scalar_mul_nmod_mont(s, s, len, c, mmod);
+
+        if (!_nmod_vec_equal(r, s, len))
+        {
+            flint_printf("FAIL (scalar_mul_nmod_mont):\n");
+            flint_printf("len = %wd, n = %wu, c = %wu\n", len, n, c);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        /* butterfly */
+        _nmod_vec_set(r, a, len);
+        _nmod_vec_set(s, b, len);
+        _nmod_vec_butterfly_mont(r, s, len, c, mmod);
+
+        for (j = 0; j < len; j++)
+        {
+            mp_limb_t t = nmod_mul(b[j], c, mod);
+
+            if (r[j] != nmod_add(a[j], t, mod) || s[j] != nmod_sub(a[j], t, mod))
+            {
+                flint_printf("FAIL (butterfly_mont):\n");
+                flint_printf("n = %wu, a = %wu, b = %wu, w = %wu\n",
+                                                              n, a[j], b[j], c);
+                fflush(stdout);
+                flint_abort();
+            }
+        }
+
+        _nmod_vec_clear(a);
+        _nmod_vec_clear(b);
+        _nmod_vec_clear(r);
+        _nmod_vec_clear(s);
+    }
+
+    flint_set_cpu_level(max_level);
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -53,11 +53,13 @@ typedef struct          /* entry in hash table */
    mp_limb_t prime;    /* value of prime */
    mp_limb_t next;     /* next prime which have same hash value as 'prime' */
    mp_limb_t count;    /* number of occurrence of 'prime' */
+   mp_limb_t parent;   /* union-find parent, 0 for the vertex 1 */
 } hash_t;
 
 typedef struct             /* format for relation */
 {
    mp_limb_t lp;          /* large prime, is 1, if relation is full */
+   mp_limb_t lp2;         /* second large prime, is 1 unless a double partial */
    slong num_factors;     /* number of factors, excluding small factor */
    slong small_primes;   /* number of small factors */
    slong * small;         /* exponent of small factors */
@@ -170,6 +172,15 @@ typedef struct
    FLINT_FILE * siqs;           /* pointer to file for storing relations */
    char * fname;          /* name of file used for relations */
 
+   int lp_mode;           /* large prime variation requested, QS_LP_TUNED,
+                             QS_LP_SINGLE or QS_LP_DOUBLE */
+   slong dlp_bits;        /* max bits of a cofactor split into two large
+                             primes, 0 for the single large prime variation */
+
+   slong part;            /* only sieve the A with index = part mod num_parts */
+   slong num_parts;       /* number of processes sieving for the same n */
+   slong A_count;         /* index of the current A */
+
    slong full_relation;   /* number of full relations */
    slong num_cycles;      /* number of possible full relations from partials */
 
@@ -187,6 +198,7 @@ typedef struct
    fmpz * Y_arr;          /* array of Y's corresponding to relations */
    slong * curr_rel;      /* current relation in array of relations */
    slong * relation;      /* relation array */
+   slong * rel_offset;    /* offset of each relation in relation array */
 
    slong buffer_size;     /* size of buffer of relations */
    slong num_relations;   /* number of relations so far */
@@ -297,6 +309,18 @@ static const mp_limb_t qsieve_tune[][6] =
 /* number of entries in the tuning table */
 #define QS_TUNE_SIZE (sizeof(qsieve_tune)/(6*sizeof(mp_limb_t)))
 
+/* iterations of SQUFOF used to split a double large prime cofactor */
+#define QS_DLP_SQUFOF_ITERS 50000
+
+/*
+   large prime variations for qsieve_factor_lp; the double large prime
+   variation has not been found to pay off at the tuned sizes, so it is
+   only used on request
+*/
+#define QS_LP_TUNED 0  /* the default of qsieve_factor, currently single */
+#define QS_LP_SINGLE 1
+#define QS_LP_DOUBLE 2
+
 void qsieve_init(qs_t qs_inf, const fmpz_t n);
 
 mp_limb_t qsieve_knuth_schroeppel(qs_t qs_inf);
@@ -305,6 +329,11 @@ void qsieve_clear(qs_t qs_inf);
 
 void qsieve_factor(fmpz_factor_t factors, const fmpz_t n);
 
+void qsieve_factor_checkpoint(fmpz_factor_t factors, const fmpz_t n,
+                          const char * fname, slong part, slong num_parts);
+
+void qsieve_factor_lp(fmpz_factor_t factors, const fmpz_t n, int lp_mode);
+
 prime_t * compute_factor_base(mp_limb_t * small_factor, qs_t qs_inf,
                                                              slong num_primes);
 
@@ -353,10 +382,16 @@ slong qsieve_merge_relations(qs_t qs_inf);
 void qsieve_write_to_file(qs_t qs_inf, mp_limb_t prime,
                                                      fmpz_t Y, qs_poly_t poly);
 
+void qsieve_write_to_file_dlp(qs_t qs_inf, mp_limb_t prime1,
+                              mp_limb_t prime2, fmpz_t Y, qs_poly_t poly);
+
 hash_t * qsieve_get_table_entry(qs_t qs_inf, mp_limb_t prime);
 
 void qsieve_add_to_hashtable(qs_t qs_inf, mp_limb_t prime);
 
+void qsieve_add_pair_to_hashtable(qs_t qs_inf, mp_limb_t prime1,
+                                                          mp_limb_t prime2);
+
 relation_t qsieve_parse_relation(qs_t qs_inf, char * str);
 
 relation_t qsieve_merge_relation(qs_t qs_inf, relation_t  a, relation_t  b);
@@ -370,6 +405,14 @@ void qsieve_insert_relation(qs_t qs_inf, relation_t * rel_list,
 
 int qsieve_process_relation(qs_t qs_inf);
 
+int qsieve_process_relation_dlp(qs_t qs_inf);
+
+void qsieve_write_file_header(qs_t qs_inf);
+
+slong qsieve_file_num_primes(qs_t qs_inf);
+
+void qsieve_load_relations(qs_t qs_inf);
+
 static __inline__ void insert_col_entry(la_col_t * col, slong entry)
 {
    if (((col->weight >> 4) << 4) == col->weight) /* need more space */
@@ -417,6 +460,10 @@ void reduce_matrix(qs_t qs_inf, slong *nrows, slong *ncols, la_col_t *cols);
 uint64_t * block_lanczos(flint_rand_t state, slong nrows,
 			slong dense_rows, slong ncols, la_col_t *B);
 
+uint64_t * block_lanczos_threaded(flint_rand_t state, slong nrows,
+			slong dense_rows, slong ncols, la_col_t *B,
+			const thread_pool_handle *handles, slong num_handles);
+
 void qsieve_square_root(fmpz_t X, fmpz_t Y, qs_t qs_inf,
    uint64_t * nullrows, slong ncols, slong l, fmpz_t N);
 
@@ -21,6 +21,8 @@ benefit from your work.
 --------------------------------------------------------------------*/
 
 
+#include <stdlib.h>
+#include "thread_support.h"
 #include "ulong_extras.h"
 #include "qsieve.h"
 
@@ -31,6 +33,9 @@ benefit from your work.
 # include <string.h>
 #endif
 
+/* minimum number of columns per thread in the sparse products */
+#define LANCZOS_THREAD_COLS 1000
+
 #define BIT(x) (((uint64_t)(1)) << (x))
 
 static const uint64_t bitmask[64] = {
@@ -54,14 +59,130 @@ uint64_t get_null_entry(uint64_t * nullrows, slong i, slong l) {
     return nullrows[i]&bitmask[l];
 }
 
+/*--------------------------------------------------------------------*/
+static slong clique_find(slong *parent, slong i) {
+
+	while (parent[i] != i) {
+		parent[i] = parent[parent[i]];
+		i = parent[i];
+	}
+
+	return i;
+}
+
+static int clique_cmp(const void *a, const void *b) {
+
+	/* pairs (weight, column), heaviest first */
+
+	slong x = ((const slong *)a)[0];
+	slong y = ((const slong *)b)[0];
+
+	return (x < y) - (x > y);
+}
+
+/*--------------------------------------------------------------------*/
+static void delete_cliques(slong *counts, slong nrows, slong *ncols,
+				la_col_t *cols, slong budget) {
+
+	/* A row with exactly two entries ties its columns
+	   together: once one of them is deleted the other
+	   contains a singleton and goes on the next pass,
+	   taking the row with it. The columns joined by such
+	   rows form the connected components (cliques) of a
+	   graph, and deleting a whole clique removes nearly as
+	   many rows as columns. Delete up to budget of the
+	   cliques of two or more columns, heaviest first */
+
+	slong i, j, k, r, a, b, num;
+	slong *other, *parent, *size, *weight, *comp;
+
+	other = (slong *)flint_malloc(nrows * sizeof(slong));
+	parent = (slong *)flint_malloc(*ncols * sizeof(slong));
+	size = (slong *)flint_calloc(*ncols, sizeof(slong));
+	weight = (slong *)flint_calloc(*ncols, sizeof(slong));
+
+	for (i = 0; i < nrows; i++)
+		other[i] = -1;
+
+	for (i = 0; i < *ncols; i++)
+		parent[i] = i;
+
+	for (i = 0; i < *ncols; i++) {
+		la_col_t *col = cols + i;
+		for (k = 0; k < col->weight; k++) {
+			r = col->data[k];
+			if (counts[r] != 2)
+				continue;
+
+			if (other[r] < 0) {
+				other[r] = i;
+			}
+			else {
+				a = clique_find(parent, other[r]);
+				b = clique_find(parent, i);
+				if (a != b)
+					parent[a] = b;
+			}
+		}
+	}
+
+	for (i = 0; i < *ncols; i++) {
+		a = clique_find(parent, i);
+		size[a]++;
+		weight[a] += cols[i].weight;
+	}
+
+	comp = (slong *)flint_malloc(2 * (*ncols) * sizeof(slong));
+	for (i = num = 0; i < *ncols; i++) {
+		if (parent[i] == i && size[i] > 1) {
+			comp[2*num] = weight[i];
+			comp[2*num + 1] = i;
+			num++;
+		}
+	}
+
+	qsort(comp, num, 2 * sizeof(slong), clique_cmp);
+
+	/* reuse size[] to mark the cliques to delete */
+
+	for (i = 0; i < *ncols; i++)
+		size[i] = 0;
+
+	for (i = 0; i < FLINT_MIN(num, budget); i++)
+		size[comp[2*i + 1]] = 1;
+
+	for (i = j = 0; i < *ncols; i++) {
+		la_col_t *col = cols + i;
+
+		if (size[clique_find(parent, i)]) {
+			for (k = 0; k < col->weight; k++)
+				counts[col->data[k]]--;
+			free_col(col);
+			clear_col(col);
+			continue;
+		}
+
+		cols[j++] = cols[i];
+		if (j-1 != i) clear_col(col);
+	}
+	*ncols = j;
+
+	flint_free(other);
+	flint_free(parent);
+	flint_free(size);
+	flint_free(weight);
+	flint_free(comp);
+}
+
 /*--------------------------------------------------------------------*/
 void reduce_matrix(qs_t qs_inf, slong *nrows, slong *ncols, la_col_t *cols) {
 
 	/* Perform light filtering on the nrows x ncols
 	   matrix specified by cols[]. The processing here is
 	   limited to deleting columns that contain a singleton
-	   row, then resizing the matrix to have a few more
-	   columns than rows. Because deleting a column reduces
+	   row, deleting the heaviest cliques of columns joined
+	   by rows of weight two, then resizing the matrix to have a few
+	   more columns than rows. Because deleting a column reduces
 	   the counts in several different rows, the process
 	   must iterate to convergence.
 
@@ -138,6 +259,18 @@ void reduce_matrix(qs_t qs_inf, slong *nrows, slong *ncols, la_col_t *cols) {
 		   the heaviest, so delete those (and update the
 		   row counts again) */
 
+		/* Spend up to half of the surplus columns on deleting
+		   cliques, which shrinks the matrix in both dimensions,
+		   and the rest on the heavy columns below */
+
+		if (reduced_cols > reduced_rows + qs_inf->extra_rels + 1) {
+			slong budget = (reduced_cols - reduced_rows
+						- qs_inf->extra_rels) / 2;
+
+			delete_cliques(counts, *nrows, &reduced_cols,
+							cols, budget);
+		}
+
 		if (reduced_cols > reduced_rows + qs_inf->extra_rels) {
 			for (i = reduced_rows + qs_inf->extra_rels;
 					i < reduced_cols; i++) {
@@ -485,20 +618,15 @@ static slong find_nonsingular_sub(uint64_t *t, slong *s,
 }
 
 /*-------------------------------------------------------------------*/
-void mul_MxN_Nx64(slong vsize, slong dense_rows,
-		slong ncols, la_col_t *A,
-		uint64_t *x, uint64_t *b) {
+static void mul_MxN_Nx64_cols(slong start, slong stop, slong dense_rows,
+		la_col_t *A, uint64_t *x, uint64_t *b) {
 
-	/* Multiply the vector x[] by the matrix A (stored
-	   columnwise) and put the result in b[]. vsize
-	   refers to the number of uint64_t's allocated for
-	   x[] and b[]; vsize is probably different from ncols */
+	/* Add the contribution of columns start to stop - 1
+	   of A to the product of A by x[], in b[] */
 
 	slong i, j;
 
-	memset(b, 0, vsize * sizeof(uint64_t));
-
-	for (i = 0; i < ncols; i++) {
+	for (i = start; i < stop; i++) {
 		la_col_t *col = A + i;
 		slong *row_entries = col->data;
 		uint64_t tmp = x[i];
@@ -509,7 +637,7 @@ void mul_MxN_Nx64(slong vsize, slong dense_rows,
 	}
 
 	if (dense_rows) {
-		for (i = 0; i < ncols; i++) {
+		for (i = start; i < stop; i++) {
 			la_col_t *col = A + i;
 			slong *row_entries = col->data + col->weight;
 			uint64_t tmp = x[i];
@@ -525,16 +653,15 @@ void mul_MxN_Nx64(slong vsize, slong dense_rows,
 }
 
 /*-------------------------------------------------------------------*/
-void mul_trans_MxN_Nx64(slong dense_rows, slong ncols,
-			la_col_t *A, uint64_t *x, uint64_t *b) {
+static void mul_trans_MxN_Nx64_cols(slong start, slong stop,
+		slong dense_rows, la_col_t *A, uint64_t *x, uint64_t *b) {
 
-	/* Multiply the vector x[] by the transpose of the
-	   matrix A and put the result in b[]. Since A is stored
-	   by columns, this is just a matrix-vector product */
+	/* Compute entries start to stop - 1 of the product of
+	   the transpose of A by x[], in b[] */
 
 	slong i, j;
 
-	for (i = 0; i < ncols; i++) {
+	for (i = start; i < stop; i++) {
 		la_col_t *col = A + i;
 		slong *row_entries = col->data;
 		uint64_t accum = 0;
@@ -546,7 +673,7 @@ void mul_trans_MxN_Nx64(slong dense_rows, slong ncols,
 	}
 
 	if (dense_rows) {
-		for (i = 0; i < ncols; i++) {
+		for (i = start; i < stop; i++) {
 			la_col_t *col = A + i;
 			slong *row_entries = col->data + col->weight;
 			uint64_t accum = b[i];
@@ -562,6 +689,162 @@ void mul_trans_MxN_Nx64(slong dense_rows, slong ncols,
 	}
 }
 
+/*-------------------------------------------------------------------*/
+void mul_MxN_Nx64(slong vsize, slong dense_rows,
+		slong ncols, la_col_t *A,
+		uint64_t *x, uint64_t *b) {
+
+	/* Multiply the vector x[] by the matrix A (stored
+	   columnwise) and put the result in b[]. vsize
+	   refers to the number of uint64_t's allocated for
+	   x[] and b[]; vsize is probably different from ncols */
+
+	memset(b, 0, vsize * sizeof(uint64_t));
+
+	mul_MxN_Nx64_cols(0, ncols, dense_rows, A, x, b);
+}
+
+/*-------------------------------------------------------------------*/
+void mul_trans_MxN_Nx64(slong dense_rows, slong ncols,
+			la_col_t *A, uint64_t *x, uint64_t *b) {
+
+	/* Multiply the vector x[] by the transpose of the
+	   matrix A and put the result in b[]. Since A is stored
+	   by columns, this is just a matrix-vector product */
+
+	mul_trans_MxN_Nx64_cols(0, ncols, dense_rows, A, x, b);
+}
+
+/*-------------------------------------------------------------------*/
+
+/* Threaded versions of the two products above. Each thread
+   takes a contiguous range of columns. For the transpose
+   product the ranges write disjoint parts of the output;
+   for the product by A each thread scatters into its own
+   vector of length vsize and the vectors are then xored
+   together, again split over the threads by rows */
+
+typedef struct {
+	slong start;
+	slong stop;
+	slong vsize;
+	slong dense_rows;
+	la_col_t *A;
+	uint64_t *x;
+	uint64_t *b;
+	uint64_t *partial;	/* num_partial vectors of length vsize */
+	slong num_partial;
+} _lanczos_worker_arg_struct;
+
+typedef struct {
+	const thread_pool_handle *handles;
+	slong num_handles;
+	_lanczos_worker_arg_struct *args;
+	uint64_t *partial;	/* num_handles vectors of length vsize */
+} lanczos_threads_t;
+
+static void _mul_MxN_Nx64_worker(void *varg) {
+
+	_lanczos_worker_arg_struct *arg = (_lanczos_worker_arg_struct *) varg;
+
+	memset(arg->b, 0, arg->vsize * sizeof(uint64_t));
+	mul_MxN_Nx64_cols(arg->start, arg->stop, arg->dense_rows,
+				arg->A, arg->x, arg->b);
+}
+
+static void _xor_partial_worker(void *varg) {
+
+	_lanczos_worker_arg_struct *arg = (_lanczos_worker_arg_struct *) varg;
+	slong i, k;
+
+	for (k = 0; k < arg->num_partial; k++) {
+		uint64_t *p = arg->partial + k * arg->vsize;
+
+		for (i = arg->start; i < arg->stop; i++)
+			arg->b[i] ^= p[i];
+	}
+}
+
+static void _mul_trans_MxN_Nx64_worker(void *varg) {
+
+	_lanczos_worker_arg_struct *arg = (_lanczos_worker_arg_struct *) varg;
+
+	mul_trans_MxN_Nx64_cols(arg->start, arg->stop, arg->dense_rows,
+				arg->A, arg->x, arg->b);
+}
+
+static void _lanczos_run(lanczos_threads_t *T, void (*f)(void *)) {
+
+	slong i;
+
+	for (i = 0; i < T->num_handles; i++)
+		thread_pool_wake(global_thread_pool, T->handles[i], 0,
+							f, T->args + i);
+
+	f(T->args + T->num_handles);
+
+	for (i = 0; i < T->num_handles; i++)
+		thread_pool_wait(global_thread_pool, T->handles[i]);
+}
+
+static void mul_MxN_Nx64_threaded(slong vsize, slong dense_rows,
+		slong ncols, la_col_t *A, uint64_t *x, uint64_t *b,
+		lanczos_threads_t *T) {
+
+	slong i, n = T->num_handles + 1;
+
+	if (T->num_handles == 0) {
+		mul_MxN_Nx64(vsize, dense_rows, ncols, A, x, b);
+		return;
+	}
+
+	for (i = 0; i < n; i++) {
+		T->args[i].start = i * ncols / n;
+		T->args[i].stop = (i + 1) * ncols / n;
+		T->args[i].vsize = vsize;
+		T->args[i].dense_rows = dense_rows;
+		T->args[i].A = A;
+		T->args[i].x = x;
+		T->args[i].b = (i < T->num_handles) ?
+					T->partial + i * vsize : b;
+	}
+
+	_lanczos_run(T, _mul_MxN_Nx64_worker);
+
+	for (i = 0; i < n; i++) {
+		T->args[i].start = i * vsize / n;
+		T->args[i].stop = (i + 1) * vsize / n;
+		T->args[i].b = b;
+		T->args[i].partial = T->partial;
+		T->args[i].num_partial = T->num_handles;
+	}
+
+	_lanczos_run(T, _xor_partial_worker);
+}
+
+static void mul_trans_MxN_Nx64_threaded(slong dense_rows, slong ncols,
+		la_col_t *A, uint64_t *x, uint64_t *b,
+		lanczos_threads_t *T) {
+
+	slong i, n = T->num_handles + 1;
+
+	if (T->num_handles == 0) {
+		mul_trans_MxN_Nx64(dense_rows, ncols, A, x, b);
+		return;
+	}
+
+	for (i = 0; i < n; i++) {
+		T->args[i].start = i * ncols / n;
+		T->args[i].stop = (i + 1) * ncols / n;
+		T->args[i].dense_rows = dense_rows;
+		T->args[i].A = A;
+		T->args[i].x = x;
+		T->args[i].b = b;
+	}
+
+	_lanczos_run(T, _mul_trans_MxN_Nx64_worker);
+}
+
 /*-----------------------------------------------------------------------*/
 static void transpose_vector(slong ncols, uint64_t *v, uint64_t **trans) {
 
@@ -708,9 +991,29 @@ void combine_cols(slong ncols,
 uint64_t * block_lanczos(flint_rand_t state, slong nrows,
 			slong dense_rows, slong ncols, la_col_t *B) {
 
+	thread_pool_handle *handles;
+	slong num_handles;
+	uint64_t *x;
+
+	num_handles = flint_request_threads(&handles, flint_get_num_threads());
+
+	x = block_lanczos_threaded(state, nrows, dense_rows, ncols, B,
+						handles, num_handles);
+
+	flint_give_back_threads(handles, num_handles);
+
+	return x;
+}
+
+/*-----------------------------------------------------------------------*/
+uint64_t * block_lanczos_threaded(flint_rand_t state, slong nrows,
+			slong dense_rows, slong ncols, la_col_t *B,
+			const thread_pool_handle *handles, slong num_handles) {
+
 	/* Solve Bx = 0 for some nonzero x; the computed
 	   solution, containing up to 64 of these nullspace
-	   vectors, is returned */
+	   vectors, is returned. The products by B and its
+	   transpose are split over the given threads */
 
 	uint64_t *vnext, *v[3], *x, *v0;
 	uint64_t *winv[3];
@@ -724,6 +1027,7 @@ uint64_t * block_lanczos(flint_rand_t state, slong nrows,
 	slong dim0, dim1;
 	uint64_t mask0, mask1;
 	slong vsize;
+	lanczos_threads_t T;
 
 	/* allocate all of the size-n variables. Note that because
 	   B has been preprocessed to ignore singleton rows, the
@@ -754,6 +1058,17 @@ uint64_t * block_lanczos(flint_rand_t state, slong nrows,
 	f = (uint64_t *)flint_malloc(64 * sizeof(uint64_t));
 	f2 = (uint64_t *)flint_malloc(64 * sizeof(uint64_t));
 
+	/* only use as many threads as there are blocks of
+	   LANCZOS_THREAD_COLS columns */
+
+	T.handles = handles;
+	T.num_handles = FLINT_MIN(num_handles, ncols / LANCZOS_THREAD_COLS - 1);
+	T.num_handles = FLINT_MAX(T.num_handles, 0);
+	T.args = (_lanczos_worker_arg_struct *) flint_malloc(
+		(T.num_handles + 1) * sizeof(_lanczos_worker_arg_struct));
+	T.partial = (uint64_t *)flint_malloc(
+		T.num_handles * vsize * sizeof(uint64_t));
+
 	/* The iterations computes v[0], vt_a_v[0],
 	   vt_a2_v[0], s[0] and winv[0]. Subscripts larger
 	   than zero represent past versions of these
@@ -805,8 +1120,8 @@ uint64_t * block_lanczos(flint_rand_t state, slong nrows,
 		   version of B, or B'B (apostrophe means
 		   transpose). Use "A" to refer to B'B  */
 
-		mul_MxN_Nx64(vsize, dense_rows, ncols, B, v[0], scratch);
-		mul_trans_MxN_Nx64(dense_rows, ncols, B, scratch, vnext);
+		mul_MxN_Nx64_threaded(vsize, dense_rows, ncols, B, v[0], scratch, &T);
+		mul_trans_MxN_Nx64_threaded(dense_rows, ncols, B, scratch, vnext, &T);
 
 		/* compute v0'*A*v0 and (A*v0)'(A*v0) */
 
@@ -930,6 +1245,8 @@ uint64_t * block_lanczos(flint_rand_t state, slong nrows,
 	flint_free(e);
 	flint_free(f);
 	flint_free(f2);
+	flint_free(T.args);
+	flint_free(T.partial);
 
 	/* if a recoverable failure occurred, start everything
 	   over again */
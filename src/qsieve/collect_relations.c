@@ -251,6 +251,8 @@ slong qsieve_evaluate_candidate(qs_t qs_inf, ulong i, unsigned char * sieve, qs_
    sieve[i] -= qs_inf->sieve_fill; /* adjust sieve entry to number of bits */
    bits = FLINT_ABS(fmpz_bits(res)); /* compute bits of poly value */
    bits -= BITS_ADJUST; /* adjust for log approximations */
+   if (qs_inf->dlp_bits > 30) /* allow for a second large prime */
+      bits -= qs_inf->dlp_bits - 30;
    extra_bits = 0; /* bits for mult. and small primes we didn't sieve with */
 
    if (factor_base[0].p != 1) /* divide out powers of the multiplier */
@@ -435,6 +437,60 @@ slong qsieve_evaluate_candidate(qs_t qs_inf, ulong i, unsigned char * sieve, qs_
 #endif
 
               }
+          } else if (fmpz_bits(res) <= qs_inf->dlp_bits) /* two large primes? */
+          {
+              mp_limb_t lp_bound = 60*factor_base[qs_inf->num_primes - 1].p;
+              mp_limb_t cofactor = fmpz_get_ui(res), prime2;
+
+              /*
+                 both primes must be below the large prime bound and coprime
+                 to the multiplier; the cofactor is split with SQUFOF, which
+                 is fast for cofactors of this size
+              */
+              if (cofactor / lp_bound < lp_bound && !n_is_prime(cofactor))
+              {
+                  prime = n_factor_SQUFOF(cofactor, QS_DLP_SQUFOF_ITERS);
+
+                  if (prime > 1 && prime < cofactor)
+                  {
+                      prime2 = cofactor / prime;
+
+                      if (prime > prime2)
+                      {
+                          prime = prime2;
+                          prime2 = cofactor / prime;
+                      }
+
+                      if (prime != prime2 && prime2 < lp_bound
+                          && n_is_prime(prime) && n_is_prime(prime2)
+                          && n_gcd(cofactor, qs_inf->k) == 1)
+                      {
+                          for (k = 0; k < qs_inf->s; k++)  /* commit any outstanding A factors */
+                          {
+                              if (A_ind[k] >= j) /* check beyond where loop above ended */
+                              {
+                                  factor[num_factors].ind = A_ind[k];
+                                  factor[num_factors++].exp = 1;
+                              }
+                          }
+
+                          poly->num_factors = num_factors;
+
+#if FLINT_USES_PTHREAD
+                          pthread_mutex_lock(&qs_inf->mutex);
+#endif
+                          qsieve_write_to_file_dlp(qs_inf, prime, prime2, Y, poly);
+
+                          qs_inf->edges++;
+
+                          qsieve_add_pair_to_hashtable(qs_inf, prime, prime2);
+
+#if FLINT_USES_PTHREAD
+                          pthread_mutex_unlock(&qs_inf->mutex);
+#endif
+                      }
+                  }
+              }
           }
       }
 
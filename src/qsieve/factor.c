@@ -26,6 +26,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "thread_support.h"
 #include "fmpz.h"
 #include "fmpz_factor.h"
@@ -40,12 +41,41 @@ int compare_facs(const void * a, const void * b)
    return fmpz_cmp(x, y);
 }
 
+static void _qsieve_factor(fmpz_factor_t factors, const fmpz_t n,
+             const char * fname, slong part, slong num_parts, int lp_mode);
+
 /*
    Finds at least one nontrivial factor of n using the self initialising
-   multiple polynomial quadratic sieve with single large prime variation.
-   Assumes n is not prime and not a perfect power.
+   multiple polynomial quadratic sieve with the single large prime
+   variation. Assumes n is not prime and not a perfect power.
 */
 void qsieve_factor(fmpz_factor_t factors, const fmpz_t n)
+{
+    _qsieve_factor(factors, n, NULL, 0, 1, QS_LP_TUNED);
+}
+
+/*
+   As above, but if fname is not NULL the relations are kept in that file,
+   which is not removed, and any relations already in it are used. Only the
+   polynomials A with index congruent to part modulo num_parts are sieved.
+*/
+void qsieve_factor_checkpoint(fmpz_factor_t factors, const fmpz_t n,
+                           const char * fname, slong part, slong num_parts)
+{
+    _qsieve_factor(factors, n, fname, part, num_parts, QS_LP_TUNED);
+}
+
+/*
+   As qsieve_factor, but with the large prime variation given by lp_mode;
+   the double one (QS_LP_DOUBLE) is only available this way
+*/
+void qsieve_factor_lp(fmpz_factor_t factors, const fmpz_t n, int lp_mode)
+{
+    _qsieve_factor(factors, n, NULL, 0, 1, lp_mode);
+}
+
+static void _qsieve_factor(fmpz_factor_t factors, const fmpz_t n,
+             const char * fname, slong part, slong num_parts, int lp_mode)
 {
     qs_t qs_inf;
     mp_limb_t small_factor, delta;
@@ -73,7 +103,7 @@ void qsieve_factor(fmpz_factor_t factors, const fmpz_t n)
 
        factors->sign *= -1;
 
-       qsieve_factor(factors, n2);
+       _qsieve_factor(factors, n2, fname, part, num_parts, lp_mode);
 
        fmpz_clear(n2);
 
@@ -91,6 +121,16 @@ void qsieve_factor(fmpz_factor_t factors, const fmpz_t n)
 
     qsieve_init(qs_inf, n);
 
+    qs_inf->part = part;
+    qs_inf->num_parts = num_parts;
+    qs_inf->lp_mode = lp_mode;
+
+    if (fname != NULL)
+    {
+        qs_inf->fname = flint_realloc(qs_inf->fname, strlen(fname) + 1);
+        strcpy(qs_inf->fname, fname);
+    }
+
 #if QS_DEBUG
     flint_printf("factoring ");
     fmpz_print(qs_inf->n);
@@ -174,6 +214,37 @@ void qsieve_factor(fmpz_factor_t factors, const fmpz_t n)
         return;
     }
 
+    /* relations in the file may use a larger factor base */
+    if (fname != NULL)
+    {
+        slong file_primes = qsieve_file_num_primes(qs_inf);
+
+        if (file_primes > qs_inf->num_primes)
+        {
+            fmpz_clear(qs_inf->target_A);
+
+            small_factor = qsieve_primes_increment(qs_inf,
+                                         file_primes - qs_inf->num_primes);
+
+            if (small_factor)
+            {
+                fmpz_init_set_ui(temp, small_factor);
+
+                expt += fmpz_remove(temp, qs_inf->n, temp);
+
+                _fmpz_factor_append_ui(factors, small_factor, expt);
+
+                qsieve_clear(qs_inf);
+
+                fmpz_factor_no_trial(factors, temp);
+
+                fmpz_clear(temp);
+
+                return;
+            }
+        }
+    }
+
     fmpz_init(temp);
     fmpz_init(temp2);
     fmpz_init(X);
@@ -209,25 +280,30 @@ void qsieve_factor(fmpz_factor_t factors, const fmpz_t n)
     pthread_mutex_init(&qs_inf->mutex, NULL);
 #endif
 
+    if (fname != NULL)
+        qsieve_load_relations(qs_inf);
+    else
+    {
 #if (defined(__WIN32) && !defined(__CYGWIN__) && !defined(__MINGW32__) && !defined(__MINGW64__)) || defined(_MSC_VER)
-    tmpnam_ret = tmpnam(NULL);
-    if (tmpnam_ret == NULL)
-        flint_throw(FLINT_ERROR, "tmpnam failed\n");
-
-    strcpy(qs_inf->fname, tmpnam_ret);
-    qs_inf->siqs = fopen(qs_inf->fname, "w");
-    if (qs_inf->siqs == NULL)
-        flint_throw(FLINT_ERROR, "fopen failed\n");
+        tmpnam_ret = tmpnam(NULL);
+        if (tmpnam_ret == NULL)
+            flint_throw(FLINT_ERROR, "tmpnam failed\n");
+
+        strcpy(qs_inf->fname, tmpnam_ret);
+        qs_inf->siqs = fopen(qs_inf->fname, "w");
+        if (qs_inf->siqs == NULL)
+            flint_throw(FLINT_ERROR, "fopen failed\n");
 #else
-    strcpy(qs_inf->fname, FLINT_TMPDIR "/siqsXXXXXX");
-    fd = mkstemp(qs_inf->fname);
-    if (fd == -1)
-        flint_throw(FLINT_ERROR, "mkstemp failed\n");
-
-    qs_inf->siqs = (FLINT_FILE *) fdopen(fd, "w");
-    if (qs_inf->siqs == NULL)
-        flint_throw(FLINT_ERROR, "fdopen failed\n");
+        strcpy(qs_inf->fname, FLINT_TMPDIR "/siqsXXXXXX");
+        fd = mkstemp(qs_inf->fname);
+        if (fd == -1)
+            flint_throw(FLINT_ERROR, "mkstemp failed\n");
+
+        qs_inf->siqs = (FLINT_FILE *) fdopen(fd, "w");
+        if (qs_inf->siqs == NULL)
+            flint_throw(FLINT_ERROR, "fdopen failed\n");
 #endif
+    }
 
     for (j = qs_inf->small_primes; j < qs_inf->num_primes; j++)
     {
@@ -253,7 +329,9 @@ void qsieve_factor(fmpz_factor_t factors, const fmpz_t n)
 
         do
         {
-            qsieve_collect_relations(qs_inf, sieve);
+            /* other processes may be sieving the remaining A */
+            if (qs_inf->A_count++ % qs_inf->num_parts == qs_inf->part)
+                qsieve_collect_relations(qs_inf, sieve);
 
             qs_inf->num_cycles = qs_inf->edges + qs_inf->components - qs_inf->vertices;
 
@@ -314,7 +392,8 @@ void qsieve_factor(fmpz_factor_t factors, const fmpz_t n)
 
                     do /* repeat block lanczos until it succeeds */
                     {
-                        nullrows = block_lanczos(state, nrows, 0, ncols, qs_inf->matrix);
+                        nullrows = block_lanczos_threaded(state, nrows, 0, ncols,
+                                    qs_inf->matrix, qs_inf->handles, qs_inf->num_handles);
                     } while (nullrows == NULL);
 
                     for (i = 0, mask = 0; i < ncols; i++) /* create mask of nullspace vectors */
@@ -385,7 +464,9 @@ void qsieve_factor(fmpz_factor_t factors, const fmpz_t n)
 
                     _fmpz_vec_clear(facs, 100);
 
-                    qs_inf->siqs = (FLINT_FILE *) fopen(qs_inf->fname, "w");
+                    /* a relation file given by the user is reloaded below */
+                    qs_inf->siqs = (FLINT_FILE *) fopen(qs_inf->fname,
+                                                    fname != NULL ? "a" : "w");
                     if (qs_inf->siqs == NULL)
                         flint_throw(FLINT_ERROR, "fopen fail\n");
                     qs_inf->num_primes = num_primes; /* linear algebra adjusts this */
@@ -419,6 +500,7 @@ more_primes: /* ran out of A's in init/sieving of linalg failed, increase FB */
         qs_inf->second_prime = j;
 
         qs_inf->s = 0; /* indicate polynomials need setting up again */
+        qs_inf->A_count = 0;
 
 #if QS_DEBUG
         printf("Now %ld primes\n", qs_inf->num_primes);
@@ -445,6 +527,15 @@ found_small_factor:
         }
 
         qsieve_linalg_realloc(qs_inf);
+
+        /* count the relations in the file again for the new factor base */
+        if (fname != NULL)
+        {
+            if (fclose((FILE *) qs_inf->siqs))
+                flint_throw(FLINT_ERROR, "fclose fail\n");
+
+            qsieve_load_relations(qs_inf);
+        }
     }
 
     /**************************************************************************
@@ -465,7 +556,7 @@ cleanup:
     flint_give_back_threads(qs_inf->handles, qs_inf->num_handles);
 
     flint_free(sieve);
-    if (remove(qs_inf->fname))
+    if (fname == NULL && remove(qs_inf->fname))
         flint_throw(FLINT_ERROR, "remove fail\n");
     qsieve_clear(qs_inf);
     qsieve_linalg_clear(qs_inf);
@@ -54,6 +54,11 @@ void qsieve_init(qs_t qs_inf, const fmpz_t n)
     qs_inf->vertices = 0;
     qs_inf->components = 0;
     qs_inf->edges = 0;
+    qs_inf->lp_mode = QS_LP_TUNED;
+    qs_inf->dlp_bits = 0;
+    qs_inf->part = 0;
+    qs_inf->num_parts = 1;
+    qs_inf->A_count = 0;
 #if QS_DEBUG
     qs_inf->poly_count = 0;
 #endif
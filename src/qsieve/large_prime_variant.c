@@ -13,6 +13,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <ctype.h>
+#include <string.h>
 #include "fmpz.h"
 #include "qsieve.h"
 
@@ -71,6 +72,8 @@ int qsieve_is_relation(qs_t qs_inf, relation_t a)
 
     if (a.num_factors > qs_inf->max_factors)
     {
+        fmpz_clear(temp);
+        fmpz_clear(temp2);
         return 0;
     }
 
@@ -82,12 +85,15 @@ int qsieve_is_relation(qs_t qs_inf, relation_t a)
     }
 
     fmpz_mul_ui(temp2, temp2, a.lp);
+    fmpz_mul_ui(temp2, temp2, a.lp2);
     fmpz_pow_ui(temp, a.Y, UWORD(2));
     fmpz_mod(temp, temp, qs_inf->kn);
     fmpz_mod(temp2, temp2, qs_inf->kn);
 
     if (fmpz_cmp(temp, temp2) != 0)
     {
+        fmpz_clear(temp);
+        fmpz_clear(temp2);
         return 0;
     }
 
@@ -101,6 +107,16 @@ int qsieve_is_relation(qs_t qs_inf, relation_t a)
     Write partial or full relation to file
 */
 void qsieve_write_to_file(qs_t qs_inf, mp_limb_t prime, fmpz_t Y, qs_poly_t poly)
+{
+    qsieve_write_to_file_dlp(qs_inf, prime, 1, Y, poly);
+}
+
+/*
+    As above, but for a partial with two large primes, which are written
+    separated by a comma
+*/
+void qsieve_write_to_file_dlp(qs_t qs_inf, mp_limb_t prime1,
+                               mp_limb_t prime2, fmpz_t Y, qs_poly_t poly)
 {
     slong i;
     char * str = NULL;
@@ -108,7 +124,11 @@ void qsieve_write_to_file(qs_t qs_inf, mp_limb_t prime, fmpz_t Y, qs_poly_t poly
     slong * small = poly->small;
     fac_t * factor = poly->factor;
 
-    flint_fprintf((FILE *) qs_inf->siqs, "%X ", prime); /* write large prime */
+    /* write large primes */
+    if (prime2 != 1)
+        flint_fprintf((FILE *) qs_inf->siqs, "%X,%X ", prime1, prime2);
+    else
+        flint_fprintf((FILE *) qs_inf->siqs, "%X ", prime1);
 
     for (i = 0; i < qs_inf->small_primes; i++) /* write small primes */
         flint_fprintf((FILE *) qs_inf->siqs, "%X ", small[i]);
@@ -124,6 +144,365 @@ void qsieve_write_to_file(qs_t qs_inf, mp_limb_t prime, fmpz_t Y, qs_poly_t poly
     flint_free(str);
 }
 
+/*
+   Write a header line to the relation file, recording n and the size of
+   the factor base. A new header is written whenever the factor base grows,
+   so that relations found after it can be read back by a later run.
+*/
+void qsieve_write_file_header(qs_t qs_inf)
+{
+    char * str = fmpz_get_str(NULL, 16, qs_inf->n);
+
+    flint_fprintf((FILE *) qs_inf->siqs, "# %s %wx\n", str, qs_inf->num_primes);
+    flint_free(str);
+}
+
+/*
+   Read the large primes at the start of a line of the relation file, which
+   are "p" for a full relation (p = 1) or a partial and "p1,p2" for a partial
+   with two large primes. Return a pointer to the rest of the line.
+*/
+static char * _qsieve_read_large_primes(mp_limb_t * prime1,
+                                                mp_limb_t * prime2, char * buf)
+{
+    char * str;
+
+    *prime1 = strtoul(buf, &str, 16);
+    *prime2 = 1;
+
+    if (*str == ',')
+        *prime2 = strtoul(str + 1, &str, 16);
+
+    return str;
+}
+
+/*
+   Read a line of at most size - 1 characters into buf. Return 0 at the end
+   of the file, 1 for a complete line and -1 for a line which is too long or
+   has no newline, as happens when a run is stopped while writing to the file.
+*/
+static int _qsieve_read_line(FILE * file, char * buf, slong size)
+{
+    slong len;
+
+    if (fgets(buf, size, file) == NULL)
+        return 0;
+
+    len = strlen(buf);
+
+    if (len > 0 && buf[len - 1] == '\n')
+        return 1;
+
+    /* skip the rest of a long line */
+    while (len == size - 1 && buf[len - 1] != '\n')
+    {
+        if (fgets(buf, size, file) == NULL)
+            break;
+
+        len = strlen(buf);
+    }
+
+    return -1;
+}
+
+/*
+   Return the largest factor base size recorded in the relation file, or
+   zero if there is no file. An exception is raised if the file contains
+   relations for a different n.
+*/
+slong qsieve_file_num_primes(qs_t qs_inf)
+{
+    FILE * file;
+    char buf[1024];
+    char * str, * next;
+    slong num_primes = 0, np;
+    fmpz_t m;
+    int status;
+
+    file = fopen(qs_inf->fname, "r");
+    if (file == NULL)
+        return 0;
+
+    fmpz_init(m);
+
+    while ((status = _qsieve_read_line(file, buf, sizeof(buf))) != 0)
+    {
+        if (status != 1 || buf[0] != '#')
+            continue;
+
+        str = buf + 1;
+        while (isspace(*str))
+            str++;
+
+        next = str;
+        while (isxdigit(*next))
+            next++;
+
+        if (next == str || !isspace(*next))
+            continue;
+
+        *next = '\0';
+
+        if (fmpz_set_str(m, str, 16) != 0)
+            continue;
+
+        if (!fmpz_equal(m, qs_inf->n))
+        {
+            fclose(file);
+            fmpz_clear(m);
+            flint_throw(FLINT_ERROR, "relation file %s is for a different n\n",
+                                                               qs_inf->fname);
+        }
+
+        np = strtol(next + 1, NULL, 16);
+        num_primes = FLINT_MAX(num_primes, np);
+    }
+
+    fclose(file);
+    fmpz_clear(m);
+
+    return num_primes;
+}
+
+/*
+   Check that a line read from the relation file is a complete relation for
+   the current factor base. The fields are checked before the line is parsed
+   so that a damaged line cannot overrun the relation.
+*/
+static int _qsieve_relation_is_valid(qs_t qs_inf, char * buf)
+{
+    relation_t rel;
+    char * rest, * str, * next;
+    slong i, num_factors;
+    mp_limb_t prime, prime2 = 1, ind;
+    int valid;
+
+    prime = strtoul(buf, &rest, 16);
+    if (rest == buf || prime == 0)
+        return 0;
+
+    /* two large primes are only used by the double large prime variation */
+    if (*rest == ',')
+    {
+        prime2 = strtoul(rest + 1, &next, 16);
+        if (next == rest + 1 || prime2 <= 1 || qs_inf->dlp_bits == 0)
+            return 0;
+        rest = next;
+    }
+
+    str = rest;
+
+    for (i = 0; i < qs_inf->small_primes; i++)
+    {
+        strtoul(str, &next, 16);
+        if (next == str)
+            return 0;
+        str = next;
+    }
+
+    num_factors = strtoul(str, &next, 16);
+    if (next == str || num_factors > qs_inf->max_factors)
+        return 0;
+    str = next;
+
+    for (i = 0; i < 2*num_factors; i++)
+    {
+        ind = strtoul(str, &next, 16);
+        if (next == str || (i % 2 == 0 && ind >= qs_inf->num_primes))
+            return 0;
+        str = next;
+    }
+
+    rel = qsieve_parse_relation(qs_inf, rest);
+    rel.lp = prime;
+    rel.lp2 = prime2;
+
+    valid = qsieve_is_relation(qs_inf, rel);
+
+    flint_free(rel.small);
+    flint_free(rel.factor);
+    fmpz_clear(rel.Y);
+
+    return valid;
+}
+
+/* FNV-1a, used to spot repeated lines in the relation file */
+static ulong _qsieve_line_hash(const char * str)
+{
+    ulong h = UWORD(2166136261);
+
+    while (*str != '\0')
+    {
+        h ^= (unsigned char) *str++;
+        h *= UWORD(16777619);
+    }
+
+    return h;
+}
+
+typedef struct
+{
+    ulong hash;     /* hash of the line, zero for an empty slot */
+    long offset;    /* offset of the line in the output file */
+} _qsieve_line_entry;
+
+/*
+   Insert the line, found at the given offset of out, into the open
+   addressing table of lines, returning 0 if it is already there. The table
+   has a power of two size and is grown when half full. The hashes only
+   locate candidates; on a match the earlier line is read back from out,
+   which must be open for update, and compared in full.
+*/
+static int _qsieve_line_set_insert(_qsieve_line_entry ** table,
+                   slong * alloc, slong * num, FILE * out, const char * line,
+                                                                  long offset)
+{
+    char buf[1024];
+    slong i, mask;
+    ulong h = _qsieve_line_hash(line);
+    long pos;
+    int equal;
+
+    h += (h == 0);
+
+    if (2*(*num + 1) > *alloc)
+    {
+        _qsieve_line_entry * old = *table;
+        slong j, old_alloc = *alloc;
+
+        *alloc = FLINT_MAX(2*old_alloc, 1024);
+        *table = flint_calloc(*alloc, sizeof(_qsieve_line_entry));
+        mask = *alloc - 1;
+
+        for (j = 0; j < old_alloc; j++)
+        {
+            if (old[j].hash != 0)
+            {
+                for (i = old[j].hash & mask; (*table)[i].hash != 0;
+                                                         i = (i + 1) & mask) ;
+
+                (*table)[i] = old[j];
+            }
+        }
+
+        flint_free(old);
+    }
+
+    mask = *alloc - 1;
+
+    for (i = h & mask; (*table)[i].hash != 0; i = (i + 1) & mask)
+    {
+        if ((*table)[i].hash != h)
+            continue;
+
+        pos = ftell(out);
+
+        if (pos < 0 || fseek(out, (*table)[i].offset, SEEK_SET))
+            flint_throw(FLINT_ERROR, "fseek fail\n");
+
+        equal = (_qsieve_read_line(out, buf, sizeof(buf)) == 1
+                                                     && strcmp(buf, line) == 0);
+
+        if (fseek(out, pos, SEEK_SET))
+            flint_throw(FLINT_ERROR, "fseek fail\n");
+
+        if (equal)
+            return 0;
+    }
+
+    (*table)[i].hash = h;
+    (*table)[i].offset = offset;
+    (*num)++;
+
+    return 1;
+}
+
+/*
+   Open the relation file for appending, keeping the relations left by
+   earlier runs. Complete relations for the current n and factor base are
+   counted as if they had just been found, which includes adding the large
+   primes of partials to the hash table. Repeated lines, as arise when the
+   files of several processes are concatenated, and damaged lines are
+   dropped. The cleaned relations are written to a new file which then
+   replaces the old one, so that an interruption never loses relations.
+*/
+void qsieve_load_relations(qs_t qs_inf)
+{
+    FILE * in, * out;
+    char buf[1024];
+    char * tmp_name;
+    mp_limb_t prime, prime2;
+    _qsieve_line_entry * table = NULL;
+    slong alloc = 0, num = 0;
+    long offset;
+    int status;
+
+    tmp_name = flint_malloc(strlen(qs_inf->fname) + 5);
+    strcpy(tmp_name, qs_inf->fname);
+    strcat(tmp_name, ".tmp");
+
+    out = fopen(tmp_name, "w+");
+    if (out == NULL)
+        flint_throw(FLINT_ERROR, "fopen fail\n");
+
+    qs_inf->siqs = (FLINT_FILE *) out;
+    qsieve_write_file_header(qs_inf);
+
+    in = fopen(qs_inf->fname, "r");
+
+    if (in != NULL)
+    {
+        while ((status = _qsieve_read_line(in, buf, sizeof(buf))) != 0)
+        {
+            if (status != 1 || buf[0] == '#')
+                continue;
+
+            if (!_qsieve_relation_is_valid(qs_inf, buf))
+                continue;
+
+            offset = ftell(out);
+            if (offset < 0)
+                flint_throw(FLINT_ERROR, "ftell fail\n");
+
+            if (!_qsieve_line_set_insert(&table, &alloc, &num,
+                                                         out, buf, offset))
+                continue;
+
+            fputs(buf, out);
+
+            _qsieve_read_large_primes(&prime, &prime2, buf);
+
+            if (prime == 1)
+                qs_inf->full_relation++;
+            else
+            {
+                qs_inf->edges++;
+
+                if (prime2 == 1)
+                    qsieve_add_to_hashtable(qs_inf, prime);
+                else
+                    qsieve_add_pair_to_hashtable(qs_inf, prime, prime2);
+            }
+        }
+
+        fclose(in);
+    }
+
+    flint_free(table);
+
+    if (fclose(out))
+        flint_throw(FLINT_ERROR, "fclose fail\n");
+
+    if (rename(tmp_name, qs_inf->fname))
+        flint_throw(FLINT_ERROR, "rename fail\n");
+
+    flint_free(tmp_name);
+
+    qs_inf->siqs = (FLINT_FILE *) fopen(qs_inf->fname, "a");
+    if (qs_inf->siqs == NULL)
+        flint_throw(FLINT_ERROR, "fopen fail\n");
+}
+
 /******************************************************************************
  *
  *  Hash table
@@ -178,12 +557,50 @@ hash_t * qsieve_get_table_entry(qs_t qs_inf, mp_limb_t prime)
         entry->prime = prime;
         entry->next = hash_table[first_offset];
         entry->count = 0;
+        entry->parent = qs_inf->vertices;
         hash_table[first_offset] = qs_inf->vertices;
     }
 
     return entry;
 }
 
+/*
+   Union-find on the entries of the table, used with the double large prime
+   variation to count the components of the graph whose vertices are 1 and
+   the large primes and whose edges are the partials. Offset 0 stands for
+   the vertex 1.
+*/
+static slong _qsieve_find(hash_t * table, slong i)
+{
+    while (i != 0 && table[i].parent != i)
+    {
+        slong p = table[i].parent;
+
+        if (p != 0)
+            table[i].parent = table[p].parent; /* path halving */
+
+        i = p;
+    }
+
+    return i;
+}
+
+static void _qsieve_union(qs_t qs_inf, slong i, slong j)
+{
+    i = _qsieve_find(qs_inf->table, i);
+    j = _qsieve_find(qs_inf->table, j);
+
+    if (i == j)
+        return;
+
+    if (i == 0)
+        qs_inf->table[j].parent = 0;
+    else
+        qs_inf->table[i].parent = j;
+
+    qs_inf->components--;
+}
+
 /*
    add prime to hashtable, increase size of table if necessary
    and increment count for the added prime
@@ -191,9 +608,46 @@ hash_t * qsieve_get_table_entry(qs_t qs_inf, mp_limb_t prime)
 void qsieve_add_to_hashtable(qs_t qs_inf, mp_limb_t prime)
 {
     hash_t * entry;
+    slong vertices = qs_inf->vertices;
 
     entry = qsieve_get_table_entry(qs_inf, prime);
     entry->count++;
+
+    /* the single large prime variation never needs the components */
+    if (qs_inf->dlp_bits != 0)
+    {
+        if (qs_inf->vertices != vertices)
+            qs_inf->components++;
+
+        _qsieve_union(qs_inf, 0, entry - qs_inf->table);
+    }
+}
+
+/*
+   add the edge between two large primes of a partial to the graph
+*/
+void qsieve_add_pair_to_hashtable(qs_t qs_inf, mp_limb_t prime1,
+                                                           mp_limb_t prime2)
+{
+    hash_t * entry;
+    slong i, vertices = qs_inf->vertices;
+
+    entry = qsieve_get_table_entry(qs_inf, prime1);
+    entry->count++;
+    i = entry - qs_inf->table;
+
+    if (qs_inf->vertices != vertices)
+        qs_inf->components++;
+
+    vertices = qs_inf->vertices;
+
+    entry = qsieve_get_table_entry(qs_inf, prime2);
+    entry->count++;
+
+    if (qs_inf->vertices != vertices)
+        qs_inf->components++;
+
+    _qsieve_union(qs_inf, i, entry - qs_inf->table);
 }
 
 /******************************************************************************
@@ -213,6 +667,7 @@ relation_t qsieve_parse_relation(qs_t qs_inf, char * str)
     relation_t rel;
 
     rel.lp = UWORD(1);
+    rel.lp2 = UWORD(1);
     rel.small = flint_malloc(qs_inf->small_primes * sizeof(slong));
     rel.factor = flint_malloc(qs_inf->max_factors * sizeof(fac_t));
 
@@ -267,6 +722,7 @@ relation_t qsieve_merge_relation(qs_t qs_inf, relation_t a, relation_t b)
     fmpz_t temp;
 
     c.lp = UWORD(1);
+    c.lp2 = UWORD(1);
     c.small = flint_malloc(qs_inf->small_primes * sizeof(slong));
     c.factor = flint_malloc(qs_inf->max_factors * sizeof(fac_t));
     fmpz_init(c.Y);
@@ -361,6 +817,12 @@ int qsieve_compare_relation(const void * a, const void * b)
     if (r1->lp < r2->lp)
         return -1;
 
+    if (r1->lp2 > r2->lp2)
+        return 1;
+
+    if (r1->lp2 < r2->lp2)
+        return -1;
+
     if (r1->num_factors > r2->num_factors)
         return 1;
 
@@ -434,7 +896,7 @@ int qsieve_remove_duplicates(relation_t * rel_list, slong num_relations)
 */
 void qsieve_insert_relation(qs_t qs_inf, relation_t * rel_list, slong num_relations)
 {
-    slong i, j, num_factors, fac_num;
+    slong i, j, num_factors, fac_num, size;
     slong * small;
     slong * curr_rel;
     fac_t * factor;
@@ -442,6 +904,19 @@ void qsieve_insert_relation(qs_t qs_inf, relation_t * rel_list, slong num_relati
 
     qs_inf->num_relations = 0;
 
+    /* relations combined from cycles may be long, so store them packed */
+    size = 0;
+    for (j = 0; j < num_relations; j++)
+    {
+        size += 2*rel_list[j].num_factors + 1;
+
+        for (i = 0; i < qs_inf->small_primes; i++)
+            size += 2*(rel_list[j].small[i] != 0);
+    }
+
+    qs_inf->curr_rel = qs_inf->relation
+                     = flint_realloc(qs_inf->relation, size*sizeof(slong));
+
     for (j = 0; j < num_relations; j++)
     {
         small = rel_list[j].small;
@@ -478,7 +953,8 @@ void qsieve_insert_relation(qs_t qs_inf, relation_t * rel_list, slong num_relati
 
         fmpz_set(qs_inf->Y_arr + qs_inf->num_relations, rel_list[j].Y);
 
-        qs_inf->curr_rel += qs_inf->max_factors*2;
+        qs_inf->rel_offset[qs_inf->num_relations] = qs_inf->curr_rel - qs_inf->relation;
+        qs_inf->curr_rel += 2*fac_num + 1;
         qs_inf->num_relations++;
     }
 
@@ -499,10 +975,15 @@ int qsieve_process_relation(qs_t qs_inf)
     hash_t * entry;
     mp_limb_t * hash_table = qs_inf->hash_table;
     slong rel_size = 50000;
-    relation_t * rel_list = (relation_t *) flint_malloc(rel_size * sizeof(relation_t));
+    relation_t * rel_list;
     relation_t * rlist;
     int done = 0;
 
+    if (qs_inf->dlp_bits != 0)
+        return qsieve_process_relation_dlp(qs_inf);
+
+    rel_list = (relation_t *) flint_malloc(rel_size * sizeof(relation_t));
+
     qs_inf->siqs = (FLINT_FILE *) fopen(qs_inf->fname, "r");
 
 #if QS_DEBUG & 64
@@ -511,6 +992,9 @@ int qsieve_process_relation(qs_t qs_inf)
 
     while (fgets(buf, sizeof(buf), (FILE *) qs_inf->siqs) != NULL)
     {
+        if (buf[0] == '#') /* header */
+            continue;
+
         prime = strtoul(buf, &str, 16);
         entry = qsieve_get_table_entry(qs_inf, prime);
 
@@ -573,10 +1057,6 @@ int qsieve_process_relation(qs_t qs_inf)
 
     num_relations = rlist_length;
 
-#if QS_DEBUG & 64
-    printf("Sorting relations\n");
-#endif
-
     if (rlist_length < qs_inf->num_primes + qs_inf->ks_primes + qs_inf->extra_rels)
     {
        qs_inf->edges -= 100;
@@ -615,3 +1095,487 @@ cleanup:
     return done;
 }
 
+
+/*
+   Double large prime variation
+
+   The partials with two large primes p1 < p2 are the edges between p1 and p2
+   of a graph whose other edges join 1 to the large prime of the partials with
+   one large prime. Every cycle in this graph gives a full relation, as each
+   large prime on it divides exactly two of the partials on the cycle.
+*/
+
+/* the vertex of the graph for the given prime, 0 for the prime 1 */
+static slong _qsieve_vertex(qs_t qs_inf, mp_limb_t prime)
+{
+    if (prime == 1)
+        return 0;
+
+    return qsieve_get_table_entry(qs_inf, prime) - qs_inf->table;
+}
+
+static slong _qsieve_uf_find(slong * uf, slong i)
+{
+    while (uf[i] != i)
+    {
+        uf[i] = uf[uf[i]];
+        i = uf[i];
+    }
+
+    return i;
+}
+
+/*
+   Combine the relations rels[idx[0]], ..., rels[idx[len - 1]] on a cycle into
+   a full relation c, where primes[0], ..., primes[num - 1] are the large
+   primes on the cycle, each of which divides Y^2 exactly twice. The result
+   may have more than max_factors factors.
+*/
+static void _qsieve_combine_cycle(relation_t * c, qs_t qs_inf, relation_t * rels,
+                   const slong * idx, slong len, const mp_limb_t * primes,
+                                                                   slong num)
+{
+    slong i, j, k, l, max = 0;
+    fac_t * tmp;
+    fmpz_t inv;
+
+    for (l = 0; l < len; l++)
+        max += rels[idx[l]].num_factors;
+
+    c->lp = UWORD(1);
+    c->lp2 = UWORD(1);
+    c->small = flint_calloc(qs_inf->small_primes, sizeof(slong));
+    c->factor = flint_malloc(FLINT_MAX(max, 1) * sizeof(fac_t));
+    c->small_primes = qs_inf->small_primes;
+    c->num_factors = 0;
+    fmpz_init_set_ui(c->Y, 1);
+
+    tmp = flint_malloc(FLINT_MAX(max, 1) * sizeof(fac_t));
+
+    for (l = 0; l < len; l++)
+    {
+        relation_t * a = rels + idx[l];
+
+        for (i = 0; i < qs_inf->small_primes; i++)
+            c->small[i] += a->small[i];
+
+        i = j = k = 0;
+
+        while (i < c->num_factors || j < a->num_factors)
+        {
+            if (j == a->num_factors || (i < c->num_factors
+                                 && c->factor[i].ind < a->factor[j].ind))
+                tmp[k++] = c->factor[i++];
+            else if (i == c->num_factors
+                                 || c->factor[i].ind > a->factor[j].ind)
+                tmp[k++] = a->factor[j++];
+            else
+            {
+                tmp[k].ind = c->factor[i].ind;
+                tmp[k++].exp = c->factor[i++].exp + a->factor[j++].exp;
+            }
+        }
+
+        memcpy(c->factor, tmp, k * sizeof(fac_t));
+        c->num_factors = k;
+
+        fmpz_mul(c->Y, c->Y, a->Y);
+        fmpz_mod(c->Y, c->Y, qs_inf->kn);
+    }
+
+    fmpz_init_set_ui(inv, 1);
+
+    for (i = 0; i < num; i++)
+    {
+        fmpz_mul_ui(inv, inv, primes[i]);
+        fmpz_mod(inv, inv, qs_inf->kn);
+    }
+
+    fmpz_invmod(inv, inv, qs_inf->kn);
+    fmpz_mul(c->Y, c->Y, inv);
+    fmpz_mod(c->Y, c->Y, qs_inf->kn);
+
+    fmpz_clear(inv);
+    flint_free(tmp);
+}
+
+/*
+   process relations from the file, combining the partials along the cycles
+   of the graph of large primes
+*/
+int qsieve_process_relation_dlp(qs_t qs_inf)
+{
+    char buf[1024];
+    char * str;
+    slong i, j, k, u, v, w, e, num_lines, num_vertices, num_relations;
+    slong num_relations2, rel_size, lines_size, rlist_length = 0;
+    slong head, tail, len, num;
+    mp_limb_t prime, prime2;
+    slong * ends, * deg, * off, * adj, * queue, * uf;
+    slong * par_v, * par_e, * depth, * idx;
+    mp_limb_t * primes;
+    char * alive;
+    relation_t * rel_list, * rlist;
+    int done = 0;
+
+    /* pass 1: rebuild the graph from the file and record its edges */
+    qs_inf->siqs = (FLINT_FILE *) fopen(qs_inf->fname, "r");
+
+    memset(qs_inf->hash_table, 0, (1 << 20) * sizeof(mp_limb_t));
+    qs_inf->vertices = 0;
+    qs_inf->components = 1;
+    qs_inf->edges = 0;
+
+    lines_size = 50000;
+    ends = flint_malloc(2 * lines_size * sizeof(slong));
+    num_lines = 0;
+
+    while (fgets(buf, sizeof(buf), (FILE *) qs_inf->siqs) != NULL)
+    {
+        if (buf[0] == '#') /* header */
+            continue;
+
+        _qsieve_read_large_primes(&prime, &prime2, buf);
+
+        if (num_lines == lines_size)
+        {
+            ends = flint_realloc(ends, 4 * lines_size * sizeof(slong));
+            lines_size *= 2;
+        }
+
+        if (prime == 1)
+        {
+            ends[2*num_lines] = ends[2*num_lines + 1] = -1;
+        } else
+        {
+            num = qs_inf->vertices;
+
+            qs_inf->edges++;
+            if (prime2 == 1)
+                qsieve_add_to_hashtable(qs_inf, prime);
+            else
+                qsieve_add_pair_to_hashtable(qs_inf, prime, prime2);
+
+            /* a large prime may divide kn if it is not too small */
+            for (i = num + 1; i <= qs_inf->vertices; i++)
+            {
+                if (fmpz_fdiv_ui(qs_inf->kn, qs_inf->table[i].prime) == 0)
+                   qs_inf->small_factor = qs_inf->table[i].prime;
+            }
+
+            ends[2*num_lines] = _qsieve_vertex(qs_inf, prime2 == 1 ? 1 : prime);
+            ends[2*num_lines + 1] = _qsieve_vertex(qs_inf, prime2 == 1 ? prime : prime2);
+        }
+
+        num_lines++;
+    }
+
+    fclose((FILE *) qs_inf->siqs);
+
+    if (qs_inf->small_factor != 0)
+    {
+        flint_free(ends);
+        return -1;
+    }
+
+    /* remove the partials which cannot be on a cycle */
+    num_vertices = qs_inf->vertices + 1;
+
+    deg = flint_calloc(num_vertices, sizeof(slong));
+    off = flint_calloc(num_vertices + 1, sizeof(slong));
+    alive = flint_malloc(num_lines);
+
+    for (i = 0; i < num_lines; i++)
+    {
+        alive[i] = (ends[2*i] >= 0);
+
+        if (alive[i])
+        {
+            deg[ends[2*i]]++;
+            deg[ends[2*i + 1]]++;
+        }
+    }
+
+    for (i = 0; i < num_vertices; i++)
+        off[i + 1] = off[i] + deg[i];
+
+    adj = flint_malloc((off[num_vertices] + 1) * sizeof(slong));
+    queue = flint_malloc(num_vertices * sizeof(slong));
+    par_v = flint_malloc(num_vertices * sizeof(slong)); /* fill pointers */
+
+    for (i = 0; i < num_vertices; i++)
+        par_v[i] = off[i];
+
+    for (i = 0; i < num_lines; i++)
+    {
+        if (alive[i])
+        {
+            adj[par_v[ends[2*i]]++] = i;
+            adj[par_v[ends[2*i + 1]]++] = i;
+        }
+    }
+
+    head = tail = 0;
+    for (i = 1; i < num_vertices; i++)
+    {
+        if (deg[i] == 1)
+            queue[tail++] = i;
+    }
+
+    while (head < tail)
+    {
+        w = queue[head++];
+
+        if (deg[w] != 1)
+            continue;
+
+        for (j = off[w]; !alive[adj[j]]; j++) ;
+
+        e = adj[j];
+        alive[e] = 0;
+        u = ends[2*e];
+        v = ends[2*e + 1];
+        deg[u]--;
+        deg[v]--;
+
+        u = (u == w) ? v : u;
+        if (u != 0 && deg[u] == 1)
+            queue[tail++] = u;
+    }
+
+    flint_free(adj);
+    flint_free(deg);
+
+#if QS_DEBUG & 64
+    printf("Getting relations\n");
+#endif
+
+    /* pass 2: read the full relations and the partials left */
+    qs_inf->siqs = (FLINT_FILE *) fopen(qs_inf->fname, "r");
+
+    rel_size = 50000;
+    rel_list = flint_malloc(rel_size * sizeof(relation_t));
+    num_relations = 0;
+    i = 0;
+
+    while (fgets(buf, sizeof(buf), (FILE *) qs_inf->siqs) != NULL)
+    {
+        if (buf[0] == '#') /* header */
+            continue;
+
+        if (i < num_lines && (ends[2*i] < 0 || alive[i]))
+        {
+            str = _qsieve_read_large_primes(&prime, &prime2, buf);
+
+            if (num_relations == rel_size)
+            {
+                rel_list = flint_realloc(rel_list, 2*rel_size * sizeof(relation_t));
+                rel_size *= 2;
+            }
+
+            rel_list[num_relations] = qsieve_parse_relation(qs_inf, str);
+            rel_list[num_relations].lp = prime;
+            rel_list[num_relations].lp2 = prime2;
+            num_relations++;
+        }
+
+        i++;
+    }
+
+    fclose((FILE *) qs_inf->siqs);
+
+    flint_free(alive);
+    flint_free(ends);
+
+#if QS_DEBUG & 64
+    printf("Removing duplicates\n");
+#endif
+
+    if (num_relations >= 2)
+        num_relations = qsieve_remove_duplicates(rel_list, num_relations);
+
+#if QS_DEBUG & 64
+    printf("Finding cycles\n");
+#endif
+
+    /* split the partials into a spanning forest and the other edges */
+    ends = flint_malloc(2 * (num_relations + 1) * sizeof(slong));
+    alive = flint_calloc(num_relations + 1, 1); /* 1 for forest edges */
+    uf = flint_malloc(num_vertices * sizeof(slong));
+    deg = flint_calloc(num_vertices, sizeof(slong));
+    off = flint_realloc(off, (num_vertices + 1) * sizeof(slong));
+
+    for (i = 0; i < num_vertices; i++)
+        uf[i] = i;
+
+    for (i = 0; i < num_relations; i++)
+    {
+        if (rel_list[i].lp == UWORD(1))
+            continue;
+
+        u = _qsieve_vertex(qs_inf, rel_list[i].lp2 == 1 ? 1 : rel_list[i].lp);
+        v = _qsieve_vertex(qs_inf, rel_list[i].lp2 == 1 ? rel_list[i].lp : rel_list[i].lp2);
+        ends[2*i] = u;
+        ends[2*i + 1] = v;
+
+        u = _qsieve_uf_find(uf, u);
+        v = _qsieve_uf_find(uf, v);
+
+        if (u != v)
+        {
+            uf[u] = v;
+            alive[i] = 1;
+            deg[ends[2*i]]++;
+            deg[ends[2*i + 1]]++;
+        }
+    }
+
+    off[0] = 0;
+    for (i = 0; i < num_vertices; i++)
+        off[i + 1] = off[i] + deg[i];
+
+    adj = flint_malloc((off[num_vertices] + 1) * sizeof(slong));
+
+    for (i = 0; i < num_vertices; i++)
+        par_v[i] = off[i];
+
+    for (i = 0; i < num_relations; i++)
+    {
+        if (alive[i])
+        {
+            adj[par_v[ends[2*i]]++] = i;
+            adj[par_v[ends[2*i + 1]]++] = i;
+        }
+    }
+
+    /* root each tree of the forest, the vertex 1 first */
+    depth = flint_malloc(num_vertices * sizeof(slong));
+    par_e = flint_malloc(num_vertices * sizeof(slong));
+
+    for (i = 0; i < num_vertices; i++)
+        depth[i] = -1;
+
+    for (k = 0; k < num_vertices; k++)
+    {
+        if (depth[k] >= 0)
+            continue;
+
+        depth[k] = 0;
+        par_v[k] = -1;
+        par_e[k] = -1;
+        head = tail = 0;
+        queue[tail++] = k;
+
+        while (head < tail)
+        {
+            w = queue[head++];
+
+            for (j = off[w]; j < off[w + 1]; j++)
+            {
+                e = adj[j];
+                u = (ends[2*e] == w) ? ends[2*e + 1] : ends[2*e];
+
+                if (depth[u] < 0)
+                {
+                    depth[u] = depth[w] + 1;
+                    par_v[u] = w;
+                    par_e[u] = e;
+                    queue[tail++] = u;
+                }
+            }
+        }
+    }
+
+    /* every other partial closes a cycle with the forest */
+    rlist = flint_malloc((num_relations + 1) * sizeof(relation_t));
+    idx = flint_malloc((num_vertices + 1) * sizeof(slong));
+    primes = flint_malloc((num_vertices + 1) * sizeof(mp_limb_t));
+
+    for (i = 0; i < num_relations; i++)
+    {
+        if (rel_list[i].lp == UWORD(1))
+        {
+            rlist[rlist_length++] = rel_list[i];
+            continue;
+        }
+
+        if (alive[i])
+            continue;
+
+        u = ends[2*i];
+        v = ends[2*i + 1];
+        len = num = 0;
+        idx[len++] = i;
+
+        while (u != v)
+        {
+            if (depth[u] < depth[v])
+            {
+                w = u;
+                u = v;
+                v = w;
+            }
+
+            if (u != 0)
+                primes[num++] = qs_inf->table[u].prime;
+
+            idx[len++] = par_e[u];
+            u = par_v[u];
+        }
+
+        if (u != 0)
+            primes[num++] = qs_inf->table[u].prime;
+
+        _qsieve_combine_cycle(rlist + rlist_length, qs_inf, rel_list,
+                                                        idx, len, primes, num);
+        rlist_length++;
+    }
+
+    flint_free(primes);
+    flint_free(idx);
+    flint_free(par_e);
+    flint_free(depth);
+    flint_free(adj);
+    flint_free(off);
+    flint_free(deg);
+    flint_free(uf);
+    flint_free(queue);
+    flint_free(par_v);
+    flint_free(alive);
+    flint_free(ends);
+
+    if (rlist_length < qs_inf->num_primes + qs_inf->ks_primes + qs_inf->extra_rels)
+    {
+       qs_inf->edges -= 100;
+       done = 0;
+       qs_inf->siqs = (FLINT_FILE *) fopen(qs_inf->fname, "a");
+    } else
+    {
+       done = 1;
+       num_relations2 = qs_inf->num_primes + qs_inf->ks_primes + qs_inf->extra_rels;
+       qsort(rlist, (size_t) num_relations2, sizeof(relation_t), qsieve_compare_relation);
+       qsieve_insert_relation(qs_inf, rlist, num_relations2);
+    }
+
+    for (i = 0; i < num_relations; i++)
+    {
+        /* rlist took the full relations */
+        if (rel_list[i].lp != UWORD(1))
+        {
+            flint_free(rel_list[i].small);
+            flint_free(rel_list[i].factor);
+            fmpz_clear(rel_list[i].Y);
+        }
+    }
+    flint_free(rel_list);
+
+    for (i = 0; i < rlist_length; i++)
+    {
+       flint_free(rlist[i].small);
+       flint_free(rlist[i].factor);
+       fmpz_clear(rlist[i].Y);
+    }
+    flint_free(rlist);
+
+    return done;
+}
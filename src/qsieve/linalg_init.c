@@ -37,6 +37,7 @@ void qsieve_linalg_init(qs_t qs_inf)
     qs_inf->Y_arr = flint_malloc(qs_inf->buffer_size*sizeof(fmpz));
     qs_inf->curr_rel = qs_inf->relation
                      = flint_malloc(2*qs_inf->buffer_size*qs_inf->max_factors*sizeof(slong));
+    qs_inf->rel_offset = flint_malloc(qs_inf->buffer_size*sizeof(slong));
 
     for (i = 0; i < qs_inf->buffer_size; i++)
     {
@@ -78,6 +79,7 @@ void qsieve_linalg_realloc(qs_t qs_inf)
     qs_inf->Y_arr = flint_realloc(qs_inf->Y_arr, qs_inf->buffer_size*sizeof(fmpz));
     qs_inf->curr_rel = qs_inf->relation
                      = flint_realloc(qs_inf->relation, 2*qs_inf->buffer_size*qs_inf->max_factors*sizeof(slong));
+    qs_inf->rel_offset = flint_realloc(qs_inf->rel_offset, qs_inf->buffer_size*sizeof(slong));
 
     qs_inf->prime_count = flint_realloc(qs_inf->prime_count, qs_inf->num_primes*sizeof(slong));
     qs_inf->num_primes = num_primes;
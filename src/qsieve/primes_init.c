@@ -122,17 +122,6 @@ mp_limb_t qsieve_primes_init(qs_t qs_inf)
     qs_inf->sieve_size = qsieve_tune[i][4]; /* size of sieve to use */
     qs_inf->small_primes = qsieve_tune[i][3]; /* number of primes to not sieve with */
 
-    bits = qsieve_tune[i][5];
-    if (bits >= 64)
-    {
-       qs_inf->sieve_bits = bits;
-       qs_inf->sieve_fill = 0;
-    } else
-    {
-       qs_inf->sieve_bits = 64;
-       qs_inf->sieve_fill = 64 - bits;
-    }
-
     if (qs_inf->small_primes > num_primes)
     {
        flint_printf("Too few factor base primes\n");
@@ -146,6 +135,33 @@ mp_limb_t qsieve_primes_init(qs_t qs_inf)
 
     qs_inf->num_primes = num_primes;
 
+    /*
+       the double large prime variation is only used on request; it allows
+       cofactors up to the square of the large prime bound, as long as they
+       fit in a limb so that they can be split
+    */
+    if (qs_inf->lp_mode == QS_LP_DOUBLE)
+        qs_inf->dlp_bits = FLINT_MIN(2*FLINT_BIT_COUNT(60*factor_base[num_primes - 1].p),
+                                                               FLINT_BITS - 2);
+    else
+        qs_inf->dlp_bits = 0;
+
+    bits = qsieve_tune[i][5];
+
+    /* with two large primes candidates have a larger unsieved part */
+    if (qs_inf->dlp_bits > 30)
+        bits -= FLINT_MIN((qs_inf->dlp_bits - 30)/4, bits/2);
+
+    if (bits >= 64)
+    {
+       qs_inf->sieve_bits = bits;
+       qs_inf->sieve_fill = 0;
+    } else
+    {
+       qs_inf->sieve_bits = 64;
+       qs_inf->sieve_fill = 64 - bits;
+    }
+
     /* calculating optimal A coefficient size for hypercube */
     fmpz_init(qs_inf->target_A);
     fmpz_mul_2exp(qs_inf->target_A, qs_inf->kn, 1);
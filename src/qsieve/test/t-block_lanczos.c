@@ -0,0 +1,140 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "ulong_extras.h"
+#include "qsieve.h"
+
+/*
+   random sparse matrix with columns sorted by increasing weight; as for
+   the factor base, low numbered rows are much denser than the others
+*/
+void random_matrix(la_col_t * cols, slong nrows, slong ncols,
+                                                      flint_rand_t state)
+{
+    slong i, j, k, weight;
+
+    for (i = 0; i < ncols; i++)
+    {
+        cols[i].weight = 0;
+        cols[i].orig = i;
+
+        weight = 3 + (i * 20) / ncols;
+
+        for (j = 0; j < weight; j++)
+        {
+            slong r = n_randint(state, n_randint(state, nrows) + 1);
+
+            for (k = 0; k < cols[i].weight; k++)
+                if (cols[i].data[k] == r)
+                    break;
+
+            if (k == cols[i].weight)
+                insert_col_entry(cols + i, r);
+        }
+    }
+}
+
+int main(void)
+{
+    slong iter;
+
+    FLINT_TEST_INIT(state);
+
+    flint_printf("block_lanczos....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 10 * flint_test_multiplier(); iter++)
+    {
+        slong i, j, nrows, ncols, rows, cols;
+        la_col_t * A;
+        uint64_t * x, * y, * b;
+        flint_rand_t state1, state2;
+        qs_t qs_inf;
+
+        nrows = 100 + n_randint(state, 3000);
+        ncols = nrows + 64 + n_randint(state, 500);
+
+        A = flint_malloc(ncols * sizeof(la_col_t));
+        random_matrix(A, nrows, ncols, state);
+
+        qs_inf->extra_rels = 64;
+        rows = nrows;
+        cols = ncols;
+        reduce_matrix(qs_inf, &rows, &cols, A);
+
+        if (cols <= rows)
+        {
+            flint_printf("FAIL (reduce_matrix):\n");
+            flint_printf("rows = %wd, cols = %wd\n", rows, cols);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        /* the threaded products must give exactly the serial answer */
+        flint_randinit(state1);
+        flint_randinit(state2);
+
+        flint_set_num_threads(1);
+        do {
+            x = block_lanczos(state1, rows, 0, cols, A);
+        } while (x == NULL);
+
+        flint_set_num_threads(2 + n_randint(state, 4));
+        do {
+            y = block_lanczos(state2, rows, 0, cols, A);
+        } while (y == NULL);
+
+        for (i = 0; i < cols; i++)
+        {
+            if (x[i] != y[i])
+            {
+                flint_printf("FAIL (threaded result differs):\n");
+                flint_printf("rows = %wd, cols = %wd, i = %wd\n", rows, cols, i);
+                fflush(stdout);
+                flint_abort();
+            }
+        }
+
+        /* check A*x = 0 */
+        b = flint_calloc(rows, sizeof(uint64_t));
+
+        for (i = 0; i < cols; i++)
+            for (j = 0; j < A[i].weight; j++)
+                b[A[i].data[j]] ^= x[i];
+
+        for (i = 0; i < rows; i++)
+        {
+            if (b[i] != 0)
+            {
+                flint_printf("FAIL (not in nullspace):\n");
+                flint_printf("rows = %wd, cols = %wd, i = %wd\n", rows, cols, i);
+                fflush(stdout);
+                flint_abort();
+            }
+        }
+
+        flint_free(b);
+        flint_free(x);
+        flint_free(y);
+
+        flint_randclear(state1);
+        flint_randclear(state2);
+
+        for (i = 0; i < cols; i++)
+            free_col(A + i);
+        flint_free(A);
+    }
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,221 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+/* try to get fdopen, mkstemp declared */
+#if defined __STRICT_ANSI__
+#undef __STRICT_ANSI__
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if !defined(_MSC_VER) && !defined(__MINGW32__)
+#include <unistd.h>
+#endif
+#include "fmpz.h"
+#include "fmpz_factor.h"
+#include "qsieve.h"
+
+#if !defined(_MSC_VER) && !defined(__MINGW32__)
+
+void randprime(fmpz_t p, flint_rand_t state, slong bits)
+{
+    fmpz_randbits(p, state, bits);
+
+    if (fmpz_sgn(p) < 0)
+       fmpz_neg(p, p);
+
+    if (fmpz_is_even(p))
+       fmpz_add_ui(p, p, 1);
+
+    while (!fmpz_is_probabprime(p))
+       fmpz_add_ui(p, p, 2);
+}
+
+void temp_name(char * name)
+{
+    int fd;
+
+    strcpy(name, FLINT_TMPDIR "/qstestXXXXXX");
+    fd = mkstemp(name);
+    if (fd == -1)
+    {
+        flint_printf("FAIL: mkstemp\n");
+        fflush(stdout);
+        flint_abort();
+    }
+    close(fd);
+}
+
+/* append the first len bytes of file src (all of it if len < 0) to dst */
+void append_file(const char * dst, const char * src, slong len)
+{
+    FILE * in, * out;
+    int c;
+
+    in = fopen(src, "r");
+    out = fopen(dst, "a");
+
+    while (len-- != 0 && (c = fgetc(in)) != EOF)
+        fputc(c, out);
+
+    fclose(in);
+    fclose(out);
+}
+
+slong file_size(const char * name)
+{
+    FILE * f = fopen(name, "r");
+    slong len = 0;
+
+    while (fgetc(f) != EOF)
+        len++;
+
+    fclose(f);
+    return len;
+}
+
+/* number of complete relation lines in a file */
+slong count_relations(const char * name)
+{
+    FILE * f = fopen(name, "r");
+    slong count = 0;
+    int c, first = 1, header = 0;
+
+    while ((c = fgetc(f)) != EOF)
+    {
+        if (first)
+            header = (c == '#');
+
+        first = (c == '\n');
+
+        if (first && !header)
+            count++;
+    }
+
+    fclose(f);
+    return count;
+}
+
+void check_factors(fmpz_factor_t factors, slong num, const char * test, slong i)
+{
+    if (factors->num < num)
+    {
+        flint_printf("FAIL:\n");
+        flint_printf("%s\ni = %wd\n", test, i);
+        flint_printf("%ld factors found\n", factors->num);
+        fflush(stdout);
+        flint_abort();
+    }
+}
+
+#endif
+
+int main(void)
+{
+#if !defined(_MSC_VER) && !defined(__MINGW32__)
+   slong i;
+   fmpz_t n, x, y;
+   fmpz_factor_t factors;
+   char name1[64], name2[64], name3[64];
+#endif
+   FLINT_TEST_INIT(state);
+
+   flint_printf("factor_checkpoint....");
+   fflush(stdout);
+
+/* mkstemp is not available on windows */
+#if !defined(_MSC_VER) && !defined(__MINGW32__)
+
+   fmpz_init(x);
+   fmpz_init(y);
+   fmpz_init(n);
+
+   for (i = 0; i < flint_test_multiplier(); i++)
+   {
+      slong len, rels;
+
+      randprime(x, state, 50);
+      do {
+         randprime(y, state, 50);
+      } while (fmpz_equal(x, y));
+
+      fmpz_mul(n, x, y);
+
+      flint_set_num_threads(n_randint(state, 3) + 1);
+
+      temp_name(name1);
+      temp_name(name2);
+      temp_name(name3);
+
+      /* two processes sieving different polynomials */
+      fmpz_factor_init(factors);
+      qsieve_factor_checkpoint(factors, n, name1, 0, 2);
+      check_factors(factors, 2, "part 0 of 2", i);
+      fmpz_factor_clear(factors);
+
+      fmpz_factor_init(factors);
+      qsieve_factor_checkpoint(factors, n, name2, 1, 2);
+      check_factors(factors, 2, "part 1 of 2", i);
+      fmpz_factor_clear(factors);
+
+      if (count_relations(name1) == 0 || count_relations(name2) == 0)
+      {
+         flint_printf("FAIL:\n");
+         flint_printf("relation file empty\ni = %wd\n", i);
+         fflush(stdout);
+         flint_abort();
+      }
+
+      /*
+         merge both files, the first twice, and cut the end off as if the
+         run had been stopped while writing a relation
+      */
+      remove(name3);
+      append_file(name3, name1, -1);
+      append_file(name3, name1, -1);
+      len = file_size(name2);
+      append_file(name3, name2, len - 10);
+
+      rels = count_relations(name1) + count_relations(name2) - 1;
+
+      fmpz_factor_init(factors);
+      qsieve_factor_checkpoint(factors, n, name3, 0, 1);
+      check_factors(factors, 2, "merged relations", i);
+      fmpz_factor_clear(factors);
+
+      /* all complete relations are kept, repeated ones only once */
+      if (count_relations(name3) < rels)
+      {
+         flint_printf("FAIL:\n");
+         flint_printf("relations lost on resume\ni = %wd\n", i);
+         flint_printf("%wd relations, expected at least %wd\n",
+                                                 count_relations(name3), rels);
+         fflush(stdout);
+         flint_abort();
+      }
+
+      remove(name1);
+      remove(name2);
+      remove(name3);
+   }
+
+   fmpz_clear(n);
+   fmpz_clear(x);
+   fmpz_clear(y);
+
+#endif
+
+   FLINT_TEST_CLEANUP(state);
+
+   flint_printf("PASS\n");
+   return 0;
+}
@@ -0,0 +1,95 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "fmpz.h"
+#include "fmpz_factor.h"
+#include "qsieve.h"
+
+static void randprime(fmpz_t p, flint_rand_t state, slong bits)
+{
+    fmpz_randbits(p, state, bits);
+
+    if (fmpz_sgn(p) < 0)
+       fmpz_neg(p, p);
+
+    if (fmpz_is_even(p))
+       fmpz_add_ui(p, p, 1);
+
+    while (!fmpz_is_probabprime(p))
+       fmpz_add_ui(p, p, 2);
+}
+
+int main(void)
+{
+    slong i;
+    fmpz_t n, x, y, prod;
+    fmpz_factor_t factors;
+    FLINT_TEST_INIT(state);
+
+    fmpz_init(n);
+    fmpz_init(x);
+    fmpz_init(y);
+    fmpz_init(prod);
+
+    flint_printf("factor_lp....");
+    fflush(stdout);
+
+    for (i = 0; i < 2 * flint_test_multiplier(); i++)
+    {
+        slong j, bits = 45 + n_randint(state, 20);
+        int lp_mode = (i % 2 == 0) ? QS_LP_DOUBLE : QS_LP_SINGLE;
+
+        randprime(x, state, bits);
+        do {
+            randprime(y, state, bits);
+        } while (fmpz_equal(x, y));
+
+        fmpz_mul(n, x, y);
+
+        if (n_randint(state, 4) == 0)
+            fmpz_neg(n, n);
+
+        fmpz_factor_init(factors);
+
+        flint_set_num_threads(n_randint(state, 4) + 1);
+
+        qsieve_factor_lp(factors, n, lp_mode);
+
+        fmpz_set_si(prod, factors->sign);
+        for (j = 0; j < factors->num; j++)
+        {
+            fmpz_pow_ui(x, factors->p + j, factors->exp[j]);
+            fmpz_mul(prod, prod, x);
+        }
+
+        if (factors->num < 2 || !fmpz_equal(prod, n))
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("i = %wd, lp_mode = %d\n", i, lp_mode);
+            flint_printf("n = "); fmpz_print(n); flint_printf("\n");
+            flint_printf("%wd factors found\n", factors->num);
+            fflush(stdout);
+            flint_abort();
+        }
+
+        fmpz_factor_clear(factors);
+    }
+
+    fmpz_clear(n);
+    fmpz_clear(x);
+    fmpz_clear(y);
+    fmpz_clear(prod);
+
+    FLINT_TEST_CLEANUP(state);
+
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -22,12 +22,42 @@
  extern "C" {
 #endif
 
+/*
+    A task that can be spawned into a thread pool and later joined. The
+    struct is owned by the spawning thread and must stay alive until the
+    matching call to thread_pool_join has returned.
+*/
+typedef struct
+{
+    void (* fxn)(void *);
+    void * fxnarg;
+    int max_workers;
+    volatile int done;
+} thread_pool_task_struct;
+
+typedef thread_pool_task_struct thread_pool_task_t[1];
+
+/* double ended queue of spawned tasks; owner works at the back, thieves at the front */
+typedef struct
+{
+#if FLINT_USES_PTHREAD
+    pthread_mutex_t mutex;
+#endif
+    thread_pool_task_struct ** tasks;
+    slong start;
+    slong length;
+    slong alloc;
+} thread_pool_deque_struct;
+
+typedef thread_pool_deque_struct thread_pool_deque_t[1];
+
+struct thread_pool_struct_s;
+
 typedef struct
 {
 #if FLINT_USES_PTHREAD
     pthread_t pth;
     pthread_mutex_t mutex;
-    pthread_cond_t sleep1;
     pthread_cond_t sleep2;
 #endif
     volatile int idx;
@@ -37,20 +67,28 @@ typedef struct
     void * fxnarg;
     volatile int working;
     volatile int exit;
+    volatile int busy;
+    thread_pool_deque_struct deque;
+    struct thread_pool_struct_s * pool;
 } thread_pool_entry_struct;
 
 typedef thread_pool_entry_struct thread_pool_entry_t[1];
 
-typedef struct
+typedef struct thread_pool_struct_s
 {
 #if FLINT_USES_CPUSET && FLINT_USES_PTHREAD
     void * original_affinity;
 #endif
 #if FLINT_USES_PTHREAD
     pthread_mutex_t mutex;
+    pthread_mutex_t sched_mutex;
+    pthread_cond_t sched_cond;
 #endif
     thread_pool_entry_struct * tdata;
     slong length;
+    thread_pool_deque_struct external;  /* tasks spawned by threads outside the pool */
+    volatile slong num_queued;
+    volatile slong num_waiting;
 } thread_pool_struct;
 
 typedef thread_pool_struct thread_pool_t[1];
@@ -85,6 +123,13 @@ void thread_pool_give_back(thread_pool_t T, thread_pool_handle i);
 
 void thread_pool_clear(thread_pool_t T);
 
+/* fork/join tasks ***********************************************************/
+
+void thread_pool_spawn(thread_pool_t T, thread_pool_task_t task,
+                                  int max_workers, void (*f)(void*), void * a);
+
+void thread_pool_join(thread_pool_t T, thread_pool_task_t task);
+
 /* misc internal helpers *****************************************************/
 
 void _thread_pool_distribute_work_2(slong start, slong stop,
@@ -94,6 +139,27 @@ void _thread_pool_distribute_work_2(slong start, slong stop,
 ulong _thread_pool_find_work_2(ulong a, ulong alpha,
                                       ulong b, ulong beta, ulong yn, ulong yd);
 
+extern FLINT_TLS_PREFIX thread_pool_entry_struct * _thread_pool_current_entry;
+
+void _thread_pool_deque_init(thread_pool_deque_t Q);
+
+void _thread_pool_deque_clear(thread_pool_deque_t Q);
+
+void _thread_pool_entry_init(thread_pool_struct * T,
+                                   thread_pool_entry_struct * D, slong idx);
+
+void _thread_pool_entry_stop(thread_pool_struct * T,
+                                                 thread_pool_entry_struct * D);
+
+int _thread_pool_run_pending_task(thread_pool_struct * T);
+
+int _thread_pool_sleep(thread_pool_struct * T, thread_pool_entry_struct * D);
+
+void _thread_pool_steal_loop(thread_pool_struct * T,
+                                                 thread_pool_entry_struct * D);
+
+void _thread_pool_notify(thread_pool_struct * T);
+
 #ifdef __cplusplus
 }
 #endif
@@ -9,6 +9,8 @@
     (at your option) any later version.  See <https://www.gnu.org/licenses/>.
 */
 
+#include <sched.h>
+
 #include "thread_pool.h"
 
 
@@ -25,21 +27,28 @@ void thread_pool_clear(thread_pool_t T)
 
     for (i = 0; i < size; i++)
     {
+        /* let threads that are only running spawned tasks finish them */
+        while (D[i].busy)
+        {
 #if FLINT_USES_PTHREAD
-        pthread_mutex_lock(&D[i].mutex);
+            pthread_mutex_unlock(&T->mutex);
+            sched_yield();
+            pthread_mutex_lock(&T->mutex);
 #endif
+        }
+
 	/* all threads should be given back */
         FLINT_ASSERT(D[i].available == 1);
-        D[i].exit = 1;
+        D[i].available = 0;
+    }
+
 #if FLINT_USES_PTHREAD
-	pthread_cond_signal(&D[i].sleep1);
-        pthread_mutex_unlock(&D[i].mutex);
-        pthread_join(D[i].pth, NULL);
-        pthread_cond_destroy(&D[i].sleep2);
-        pthread_cond_destroy(&D[i].sleep1);
-        pthread_mutex_destroy(&D[i].mutex);
+    pthread_mutex_unlock(&T->mutex);
 #endif
-    }
+
+    for (i = 0; i < size; i++)
+        _thread_pool_entry_stop(T, D + i);
+
     if (D != NULL)
     {
         flint_free(D);
@@ -50,8 +59,10 @@ void thread_pool_clear(thread_pool_t T)
         T->original_affinity = NULL;
     }
 #endif
+    _thread_pool_deque_clear(&T->external);
 #if FLINT_USES_PTHREAD
-    pthread_mutex_unlock(&T->mutex);
+    pthread_cond_destroy(&T->sched_cond);
+    pthread_mutex_destroy(&T->sched_mutex);
     pthread_mutex_destroy(&T->mutex);
 #endif
     T->length = -1;
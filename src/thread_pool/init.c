@@ -17,52 +17,106 @@
 thread_pool_t global_thread_pool;
 int global_thread_pool_initialized = 0;
 
+/* the pool entry of the current thread, or NULL for outside threads */
+FLINT_TLS_PREFIX thread_pool_entry_struct * _thread_pool_current_entry = NULL;
 
 void * thread_pool_idle_loop(void * varg)
 {
     thread_pool_entry_struct * arg = (thread_pool_entry_struct *) varg;
+    thread_pool_struct * T = arg->pool;
+    int status;
 
-    goto thread_pool_Lock;
-
-thread_pool_DoWork:
-
-    _flint_set_num_workers(arg->max_workers);
-    arg->fxn(arg->fxnarg);
-
-thread_pool_Lock:
+    _thread_pool_current_entry = arg;
 
 #if FLINT_USES_PTHREAD
     pthread_mutex_lock(&arg->mutex);
 #endif
     arg->working = 0;
-
-thread_pool_CheckExit:
-
-    if (arg->exit != 0)
-        goto thread_pool_Unlock;
-
 #if FLINT_USES_PTHREAD
     pthread_cond_signal(&arg->sleep2);
-    pthread_cond_wait(&arg->sleep1, &arg->mutex);
+    pthread_mutex_unlock(&arg->mutex);
 #endif
 
-    if (arg->working == 0)
-        goto thread_pool_CheckExit;
-
-thread_pool_Unlock:
+    /*
+        status 1: we have been woken by thread_pool_wake
+        status 2: we are available and there are spawned tasks to steal
+    */
+    while ((status = _thread_pool_sleep(T, arg)) != 0)
+    {
+        if (status == 1)
+        {
+            _flint_set_num_workers(arg->max_workers);
+            arg->fxn(arg->fxnarg);
 
 #if FLINT_USES_PTHREAD
-    pthread_mutex_unlock(&arg->mutex);
+            pthread_mutex_lock(&arg->mutex);
+#endif
+            arg->working = 0;
+#if FLINT_USES_PTHREAD
+            pthread_cond_signal(&arg->sleep2);
+            pthread_mutex_unlock(&arg->mutex);
 #endif
+        }
+        else
+        {
+            _thread_pool_steal_loop(T, arg);
+        }
+    }
 
-    if (arg->exit == 0)
-        goto thread_pool_DoWork;
+    _thread_pool_current_entry = NULL;
 
     flint_cleanup();
 
     return NULL;
 }
 
+void _thread_pool_entry_init(thread_pool_struct * T,
+                                    thread_pool_entry_struct * D, slong idx)
+{
+#if FLINT_USES_PTHREAD
+    pthread_mutex_init(&D->mutex, NULL);
+    pthread_cond_init(&D->sleep2, NULL);
+#endif
+    D->idx = idx;
+    D->available = 1;
+    D->fxn = NULL;
+    D->fxnarg = NULL;
+    D->working = -1;
+    D->max_workers = 0;
+    D->exit = 0;
+    D->busy = 0;
+    D->pool = T;
+    _thread_pool_deque_init(&D->deque);
+#if FLINT_USES_PTHREAD
+    pthread_mutex_lock(&D->mutex);
+    pthread_create(&D->pth, NULL, thread_pool_idle_loop, D);
+    while (D->working != 0)
+        pthread_cond_wait(&D->sleep2, &D->mutex);
+    pthread_mutex_unlock(&D->mutex);
+#endif
+}
+
+void _thread_pool_entry_stop(thread_pool_struct * T,
+                                                 thread_pool_entry_struct * D)
+{
+#if FLINT_USES_PTHREAD
+    pthread_mutex_lock(&D->mutex);
+#endif
+    D->exit = 1;
+#if FLINT_USES_PTHREAD
+    pthread_mutex_unlock(&D->mutex);
+
+    /* idle threads sleep on the scheduler condition */
+    pthread_mutex_lock(&T->sched_mutex);
+    pthread_cond_broadcast(&T->sched_cond);
+    pthread_mutex_unlock(&T->sched_mutex);
+
+    pthread_join(D->pth, NULL);
+    pthread_cond_destroy(&D->sleep2);
+    pthread_mutex_destroy(&D->mutex);
+#endif
+    _thread_pool_deque_clear(&D->deque);
+}
 
 void thread_pool_init(thread_pool_t T, slong size)
 {
@@ -72,8 +126,13 @@ void thread_pool_init(thread_pool_t T, slong size)
 
 #if FLINT_USES_PTHREAD
     pthread_mutex_init(&T->mutex, NULL);
+    pthread_mutex_init(&T->sched_mutex, NULL);
+    pthread_cond_init(&T->sched_cond, NULL);
 #endif
     T->length = size;
+    T->num_queued = 0;
+    T->num_waiting = 0;
+    _thread_pool_deque_init(&T->external);
 
 #if FLINT_USES_CPUSET && FLINT_USES_PTHREAD
     T->original_affinity = flint_malloc(sizeof(cpu_set_t));
@@ -95,25 +154,5 @@ void thread_pool_init(thread_pool_t T, slong size)
     T->tdata = D;
 
     for (i = 0; i < size; i++)
-    {
-#if FLINT_USES_PTHREAD
-        pthread_mutex_init(&D[i].mutex, NULL);
-        pthread_cond_init(&D[i].sleep1, NULL);
-        pthread_cond_init(&D[i].sleep2, NULL);
-#endif
-	D[i].idx = i;
-        D[i].available = 1;
-        D[i].fxn = NULL;
-        D[i].fxnarg = NULL;
-        D[i].working = -1;
-	D[i].max_workers = 0;
-        D[i].exit = 0;
-#if FLINT_USES_PTHREAD
-        pthread_mutex_lock(&D[i].mutex);
-        pthread_create(&D[i].pth, NULL, thread_pool_idle_loop, &D[i]);
-	while (D[i].working != 0)
-            pthread_cond_wait(&D[i].sleep2, &D[i].mutex);
-        pthread_mutex_unlock(&D[i].mutex);
-#endif
-    }
+        _thread_pool_entry_init(T, D + i, i);
 }
@@ -9,6 +9,8 @@
     (at your option) any later version.  See <https://www.gnu.org/licenses/>.
 */
 
+#include <sched.h>
+
 #include "thread_pool.h"
 
 int thread_pool_set_size(thread_pool_t T, slong new_size)
@@ -19,12 +21,32 @@ int thread_pool_set_size(thread_pool_t T, slong new_size)
 
     new_size = FLINT_MAX(new_size, WORD(0));
 
+    /* a thread of T is certainly using T */
+    if (_thread_pool_current_entry != NULL &&
+        _thread_pool_current_entry->pool == T)
+    {
+        return 0;
+    }
+
 #if FLINT_USES_PTHREAD
     pthread_mutex_lock(&T->mutex);
 #endif
     D = T->tdata;
     old_size = T->length;
 
+    /* let threads that are only running spawned tasks finish them */
+    for (i = 0; i < old_size; i++)
+    {
+        while (D[i].busy)
+        {
+#if FLINT_USES_PTHREAD
+            pthread_mutex_unlock(&T->mutex);
+            sched_yield();
+            pthread_mutex_lock(&T->mutex);
+#endif
+        }
+    }
+
     /* check if T is in use */
     for (i = 0; i < old_size; i++)
     {
@@ -37,22 +59,22 @@ int thread_pool_set_size(thread_pool_t T, slong new_size)
         }
     }
 
-    /* destroy all old data */
+    /* claim all threads so that nobody starts working while we destroy them */
     for (i = 0; i < old_size; i++)
-    {
+        D[i].available = 0;
+
 #if FLINT_USES_PTHREAD
-        pthread_mutex_lock(&D[i].mutex);
+    pthread_mutex_unlock(&T->mutex);
 #endif
-        D[i].exit = 1;
+
+    /* destroy all old data */
+    for (i = 0; i < old_size; i++)
+        _thread_pool_entry_stop(T, D + i);
+
 #if FLINT_USES_PTHREAD
-	pthread_cond_signal(&D[i].sleep1);
-        pthread_mutex_unlock(&D[i].mutex);
-        pthread_join(D[i].pth, NULL);
-        pthread_cond_destroy(&D[i].sleep2);
-        pthread_cond_destroy(&D[i].sleep1);
-        pthread_mutex_destroy(&D[i].mutex);
+    pthread_mutex_lock(&T->mutex);
 #endif
-    }
+
     if (D != NULL)
     {
         flint_free(D);
@@ -67,26 +89,7 @@ int thread_pool_set_size(thread_pool_t T, slong new_size)
                                            * sizeof(thread_pool_entry_struct));
 
         for (i = 0; i < new_size; i++)
-        {
-#if FLINT_USES_PTHREAD
-            pthread_mutex_init(&D[i].mutex, NULL);
-            pthread_cond_init(&D[i].sleep1, NULL);
-            pthread_cond_init(&D[i].sleep2, NULL);
-#endif
-            D[i].idx = i;
-            D[i].available = 1;
-            D[i].fxn = NULL;
-            D[i].fxnarg = NULL;
-            D[i].working = -1;
-            D[i].exit = 0;
-#if FLINT_USES_PTHREAD
-            pthread_mutex_lock(&D[i].mutex);
-            pthread_create(&D[i].pth, NULL, thread_pool_idle_loop, &D[i]);
-            while (D[i].working != 0)
-                pthread_cond_wait(&D[i].sleep2, &D[i].mutex);
-            pthread_mutex_unlock(&D[i].mutex);
-#endif
-	}
+            _thread_pool_entry_init(T, D + i, i);
     }
 
     T->length = new_size;
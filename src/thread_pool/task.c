@@ -0,0 +1,322 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "thread_pool.h"
+
+/*
+    Fork/join tasks with work stealing.
+
+    Every thread of the pool owns a deque of spawned tasks, and threads
+    outside the pool share the deque T->external. A thread pushes and pops
+    its own tasks at the back of its deque, while other threads steal from
+    the front. A thread joining a task that has not finished runs other
+    pending tasks in the meantime, so that nested parallel calls never
+    leave a thread idle while there is work.
+
+    Threads without anything to do sleep on T->sched_cond. Any event that
+    can end a sleep (a task being queued or finished, a thread being woken
+    or asked to exit) is followed by a broadcast on T->sched_cond. The
+    counters num_queued and num_waiting are only used to avoid the
+    broadcast when nobody is sleeping, which requires sequentially
+    consistent atomics; without these we always broadcast.
+*/
+
+#if FLINT_USES_PTHREAD && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 8))
+# define TP_HAVE_ATOMICS 1
+# define TP_LOAD(x) __atomic_load_n(&(x), __ATOMIC_SEQ_CST)
+# define TP_STORE(x, v) __atomic_store_n(&(x), (v), __ATOMIC_SEQ_CST)
+# define TP_ADD(x, v) __atomic_add_fetch(&(x), (v), __ATOMIC_SEQ_CST)
+#else
+# define TP_HAVE_ATOMICS 0
+# define TP_LOAD(x) (x)
+# define TP_STORE(x, v) ((x) = (v))
+# define TP_ADD(x, v) ((x) += (v))
+#endif
+
+/* num_queued is also changed outside of sched_mutex */
+static void _add_num_queued(thread_pool_struct * T, slong v)
+{
+#if TP_HAVE_ATOMICS || !FLINT_USES_PTHREAD
+    TP_ADD(T->num_queued, v);
+#else
+    pthread_mutex_lock(&T->sched_mutex);
+    T->num_queued += v;
+    pthread_mutex_unlock(&T->sched_mutex);
+#endif
+}
+
+void _thread_pool_deque_init(thread_pool_deque_t Q)
+{
+#if FLINT_USES_PTHREAD
+    pthread_mutex_init(&Q->mutex, NULL);
+#endif
+    Q->tasks = NULL;
+    Q->start = 0;
+    Q->length = 0;
+    Q->alloc = 0;
+}
+
+void _thread_pool_deque_clear(thread_pool_deque_t Q)
+{
+    /* all spawned tasks should have been joined */
+    FLINT_ASSERT(Q->length == 0);
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_destroy(&Q->mutex);
+#endif
+    flint_free(Q->tasks);
+}
+
+static void _deque_push_back(thread_pool_deque_t Q,
+                                                 thread_pool_task_struct * t)
+{
+#if FLINT_USES_PTHREAD
+    pthread_mutex_lock(&Q->mutex);
+#endif
+
+    if (Q->length >= Q->alloc)
+    {
+        slong i, new_alloc = FLINT_MAX(8, 2*Q->alloc);
+        thread_pool_task_struct ** new_tasks = (thread_pool_task_struct **)
+                  flint_malloc(new_alloc*sizeof(thread_pool_task_struct *));
+
+        /* unwrap the ring buffer */
+        for (i = 0; i < Q->length; i++)
+            new_tasks[i] = Q->tasks[(Q->start + i) % Q->alloc];
+
+        flint_free(Q->tasks);
+        Q->tasks = new_tasks;
+        Q->start = 0;
+        Q->alloc = new_alloc;
+    }
+
+    Q->tasks[(Q->start + Q->length) % Q->alloc] = t;
+    Q->length++;
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_unlock(&Q->mutex);
+#endif
+}
+
+static thread_pool_task_struct * _deque_pop_back(thread_pool_deque_t Q)
+{
+    thread_pool_task_struct * t = NULL;
+
+    if (Q->length == 0)     /* racy peek */
+        return NULL;
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_lock(&Q->mutex);
+#endif
+
+    if (Q->length > 0)
+    {
+        Q->length--;
+        t = Q->tasks[(Q->start + Q->length) % Q->alloc];
+    }
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_unlock(&Q->mutex);
+#endif
+
+    return t;
+}
+
+static thread_pool_task_struct * _deque_pop_front(thread_pool_deque_t Q)
+{
+    thread_pool_task_struct * t = NULL;
+
+    if (Q->length == 0)     /* racy peek */
+        return NULL;
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_lock(&Q->mutex);
+#endif
+
+    if (Q->length > 0)
+    {
+        t = Q->tasks[Q->start];
+        Q->start = (Q->start + 1) % Q->alloc;
+        Q->length--;
+    }
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_unlock(&Q->mutex);
+#endif
+
+    return t;
+}
+
+void _thread_pool_notify(thread_pool_struct * T)
+{
+#if FLINT_USES_PTHREAD
+    if (!TP_HAVE_ATOMICS || TP_LOAD(T->num_waiting) > 0)
+    {
+        pthread_mutex_lock(&T->sched_mutex);
+        pthread_cond_broadcast(&T->sched_cond);
+        pthread_mutex_unlock(&T->sched_mutex);
+    }
+#endif
+}
+
+static thread_pool_deque_struct * _own_deque(thread_pool_struct * T)
+{
+    thread_pool_entry_struct * E = _thread_pool_current_entry;
+
+    return (E != NULL && E->pool == T) ? &E->deque : &T->external;
+}
+
+/*
+    Run one pending task of T if there is one: our own newest task first,
+    otherwise the oldest task of some other thread. Return 1 if a task was
+    run and 0 otherwise.
+*/
+int _thread_pool_run_pending_task(thread_pool_struct * T)
+{
+    thread_pool_entry_struct * E = _thread_pool_current_entry;
+    thread_pool_deque_struct * own = _own_deque(T);
+    thread_pool_task_struct * t;
+    slong i, j, n = T->length;
+    int save_workers;
+
+    t = _deque_pop_back(own);
+
+    if (t == NULL)
+    {
+        /* start at our right neighbour so that thieves spread out */
+        j = (own == &T->external) ? 0 : E->idx + 1;
+        for (i = 0; i < n && t == NULL; i++)
+            t = _deque_pop_front(&T->tdata[(i + j) % n].deque);
+
+        if (t == NULL && own != &T->external)
+            t = _deque_pop_front(&T->external);
+
+        if (t == NULL)
+            return 0;
+    }
+
+    _add_num_queued(T, -1);
+
+    save_workers = flint_get_num_threads() - 1;
+    _flint_set_num_workers(t->max_workers);
+    t->fxn(t->fxnarg);
+    _flint_set_num_workers(save_workers);
+
+    /* t may not be touched once done is set */
+    TP_STORE(t->done, 1);
+    _thread_pool_notify(T);
+
+    return 1;
+}
+
+void thread_pool_spawn(thread_pool_t T, thread_pool_task_t task,
+                                   int max_workers, void (*f)(void*), void * a)
+{
+    task->fxn = f;
+    task->fxnarg = a;
+    task->max_workers = max_workers;
+    task->done = 0;
+
+    _deque_push_back(_own_deque(T), task);
+    _add_num_queued(T, 1);
+    _thread_pool_notify(T);
+}
+
+void thread_pool_join(thread_pool_t T, thread_pool_task_t task)
+{
+    while (!TP_LOAD(task->done))
+    {
+        if (_thread_pool_run_pending_task(T))
+            continue;
+
+        /* the task is running elsewhere and there is nothing to help with */
+#if FLINT_USES_PTHREAD
+        pthread_mutex_lock(&T->sched_mutex);
+        TP_ADD(T->num_waiting, 1);
+        while (!TP_LOAD(task->done) && TP_LOAD(T->num_queued) <= 0)
+            pthread_cond_wait(&T->sched_cond, &T->sched_mutex);
+        TP_ADD(T->num_waiting, -1);
+        pthread_mutex_unlock(&T->sched_mutex);
+#endif
+    }
+}
+
+/*
+    Put the pool thread D to sleep until there is something for it to do.
+    Return 0 if D should exit, 1 if D has been woken by thread_pool_wake
+    and 2 if D is available and there are pending tasks to steal.
+*/
+int _thread_pool_sleep(thread_pool_struct * T, thread_pool_entry_struct * D)
+{
+    int status;
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_lock(&T->sched_mutex);
+    TP_ADD(T->num_waiting, 1);
+    while (1)
+    {
+        if (D->exit != 0)
+            status = 0;
+        else if (D->working == 1)
+            status = 1;
+        else if (D->available == 1 && TP_LOAD(T->num_queued) > 0)
+            status = 2;
+        else
+        {
+            pthread_cond_wait(&T->sched_cond, &T->sched_mutex);
+            continue;
+        }
+        break;
+    }
+    TP_ADD(T->num_waiting, -1);
+    pthread_mutex_unlock(&T->sched_mutex);
+#else
+    status = 0;
+#endif
+
+    return status;
+}
+
+/*
+    Run pending tasks with the pool thread D until there are none left.
+    While doing so D is not available to thread_pool_request.
+*/
+void _thread_pool_steal_loop(thread_pool_struct * T,
+                                                 thread_pool_entry_struct * D)
+{
+#if FLINT_USES_PTHREAD
+    pthread_mutex_lock(&T->mutex);
+#endif
+    if (D->available != 1)
+    {
+#if FLINT_USES_PTHREAD
+        pthread_mutex_unlock(&T->mutex);
+#endif
+        return;
+    }
+    D->available = 0;
+    D->busy = 1;
+#if FLINT_USES_PTHREAD
+    pthread_mutex_unlock(&T->mutex);
+#endif
+
+    while (_thread_pool_run_pending_task(T))
+        ;
+
+#if FLINT_USES_PTHREAD
+    pthread_mutex_lock(&T->mutex);
+#endif
+    D->busy = 0;
+    D->available = 1;
+#if FLINT_USES_PTHREAD
+    pthread_mutex_unlock(&T->mutex);
+#endif
+}
@@ -158,6 +158,62 @@ void test2(fmpz_t x, ulong n)
 }
 
 
+/******************************************************************************
+    test3 - calculate x = n! by recursively spawning tasks
+*******************************************************************************/
+
+void test3_helper(fmpz_t x, ulong min, ulong max);
+
+void worker3(void * varg)
+{
+    worker2_arg_struct * arg = (worker2_arg_struct *) varg;
+
+    test3_helper(arg->ans, arg->min, arg->max);
+}
+
+/* set x = product of numbers in (min, max] */
+void test3_helper(fmpz_t x, ulong min, ulong max)
+{
+    ulong i, mid;
+    thread_pool_task_t task;
+    worker2_arg_struct args[1];
+
+    FLINT_ASSERT(max >= min);
+
+    if (max - min > UWORD(20))
+    {
+        mid = min + ((max - min)/UWORD(2));
+
+        /* let any idle thread pick up the lower half */
+        args[0].min = min;
+        args[0].max = mid;
+        fmpz_init(args[0].ans);
+        thread_pool_spawn(global_thread_pool, task, 0, worker3, &args[0]);
+
+        /* do the upper half ourselves */
+        test3_helper(x, mid, max);
+
+        /* join the task and combine its answer */
+        thread_pool_join(global_thread_pool, task);
+        fmpz_mul(x, x, args[0].ans);
+        fmpz_clear(args[0].ans);
+    }
+    else
+    {
+        fmpz_one(x);
+        for (i = max; i > min; i--)
+        {
+            fmpz_mul_ui(x, x, i);
+        }
+    }
+}
+
+void test3(fmpz_t x, ulong n)
+{
+    test3_helper(x, 0, n);
+}
+
+
 int
 main(void)
 {
@@ -202,6 +258,17 @@ main(void)
                 fflush(stdout);
                 flint_abort();
             }
+
+            test3(x, n);
+            if (!fmpz_equal(x, y))
+            {
+                flint_printf("n: %wu\n", n);
+                printf("x: "); fmpz_print(x); printf("\n");
+                printf("y: "); fmpz_print(y); printf("\n");
+                printf("test3 failed\n");
+                fflush(stdout);
+                flint_abort();
+            }
         }
 
         fmpz_clear(y);
@@ -37,10 +37,13 @@ void thread_pool_wake(thread_pool_t T, thread_pool_handle i,
     D[i].fxn = f;
     D[i].fxnarg = a;
 #if FLINT_USES_PTHREAD
-    pthread_cond_signal(&D[i].sleep1);
-
     pthread_mutex_unlock(&D[i].mutex);
 
+    /* idle threads sleep on the scheduler condition */
+    pthread_mutex_lock(&T->sched_mutex);
+    pthread_cond_broadcast(&T->sched_cond);
+    pthread_mutex_unlock(&T->sched_mutex);
+
     pthread_mutex_unlock(&T->mutex);
 #endif
 }
@@ -26,6 +26,24 @@ f(slong i, void * param)
     p->res[i] = i * i;
 }
 
+typedef struct
+{
+    int * res;
+    slong n;
+}
+g_param_t;
+
+/* nested parallel call */
+void
+g(slong i, void * param)
+{
+    g_param_t * p = (g_param_t *) param;
+    f_param_t inner;
+
+    inner.res = p->res + i * p->n;
+    flint_parallel_do(f, &inner, p->n, 0, FLINT_PARALLEL_DYNAMIC);
+}
+
 int
 main(void)
 {
@@ -69,6 +87,42 @@ main(void)
         flint_free(resy);
     }
 
+    for (iter = 0; iter < 10 * flint_test_multiplier(); iter++)
+    {
+        int * res;
+        slong i, j, m, n;
+        g_param_t work;
+
+        m = n_randint(state, 20);
+        n = n_randint(state, 100);
+
+        flint_set_num_threads(n_randint(state, 10) + 1);
+
+        res = flint_malloc(m * n * sizeof(int));
+
+        work.res = res;
+        work.n = n;
+
+        flint_parallel_do(g, &work, m, n_randint(state, 5), n_randint(state, 2) ?
+                                   FLINT_PARALLEL_DYNAMIC : FLINT_PARALLEL_UNIFORM);
+
+        for (i = 0; i < m; i++)
+        {
+            for (j = 0; j < n; j++)
+            {
+                if (res[i * n + j] != j * j)
+                {
+                    flint_printf("FAIL (nested)\n");
+                    flint_printf("num_threads = %wd, i = %wd/%wd, j = %wd/%wd\n",
+                                       flint_get_num_threads(), i, m, j, n);
+                    flint_abort();
+                }
+            }
+        }
+
+        flint_free(res);
+    }
+
     FLINT_TEST_CLEANUP(state);
 
     flint_printf("PASS\n");
@@ -152,82 +152,86 @@ void flint_parallel_do(do_func_t f, void * args, slong n, int thread_limit, int
 
     thread_limit = FLINT_MIN(thread_limit, n);
 
-    if (thread_limit <= 1)
+    if (thread_limit <= 1 || !global_thread_pool_initialized ||
+        global_thread_pool->length <= 0)
     {
+        if (flags & FLINT_PARALLEL_VERBOSE)
+            flint_printf("parallel_do with num_threads = 1\n");
+
         for (i = 0; i < n; i++)
             f(i, args);
     }
     else
     {
-        slong i, num_threads, num_workers;
-        thread_pool_handle * handles;
+        slong num_chunks, chunk_size;
+        int num_workers = flint_get_num_threads() - 1;
+        work_chunk_t * work;
+        thread_pool_task_struct * tasks;
+        TMP_INIT;
+        TMP_START;
 
-        num_workers = flint_request_threads(&handles, thread_limit);
-        num_threads = num_workers + 1;
+        /*
+            One chunk per thread, except with dynamic scheduling where
+            idle threads steal small chunks from busy ones.
+        */
+        num_chunks = thread_limit;
+        if (flags & FLINT_PARALLEL_DYNAMIC)
+            num_chunks = FLINT_MIN(n, 8 * num_chunks);
 
         if (flags & FLINT_PARALLEL_VERBOSE)
-            flint_printf("parallel_do with num_threads = %wd\n", num_threads);
+            flint_printf("parallel_do with num_threads = %wd, num_chunks = %wd\n",
+                                                (slong) thread_limit, num_chunks);
 
-        if (num_workers < 1)
-        {
-            flint_give_back_threads(handles, num_workers);
+        work = TMP_ALLOC(num_chunks * sizeof(work_chunk_t));
+        tasks = TMP_ALLOC(num_chunks * sizeof(thread_pool_task_struct));
 
-            for (i = 0; i < n; i++)
-                f(i, args);
+        if (flags & FLINT_PARALLEL_STRIDED)
+        {
+            for (i = 0; i < num_chunks; i++)
+            {
+                work[i].f = f;
+                work[i].args = args;
+                work[i].a = i;
+                work[i].b = n;
+                work[i].step = num_chunks;
+            }
         }
         else
         {
-            work_chunk_t * work;
-            slong chunk_size;
-            TMP_INIT;
-            TMP_START;
-
-            work = TMP_ALLOC(num_threads * sizeof(work_chunk_t));
+            chunk_size = (n + num_chunks - 1) / num_chunks;
 
-            if (flags & FLINT_PARALLEL_STRIDED)
-            {
-                for (i = 0; i < num_threads; i++)
-                {
-                    work[i].f = f;
-                    work[i].args = args;
-                    work[i].a = i;
-                    work[i].b = n;
-                    work[i].step = num_threads;
-                }
-            }
-            else
+            for (i = 0; i < num_chunks; i++)
             {
-                chunk_size = (n + num_threads - 1) / num_threads;
-
-                for (i = 0; i < num_threads; i++)
-                {
-                    work[i].f = f;
-                    work[i].args = args;
-                    work[i].a = i * chunk_size;
-                    work[i].b = FLINT_MIN((i + 1) * chunk_size, n);
-                    work[i].step = 1;
-                }
+                work[i].f = f;
+                work[i].args = args;
+                work[i].a = i * chunk_size;
+                work[i].b = FLINT_MIN((i + 1) * chunk_size, n);
+                work[i].step = 1;
             }
+        }
 
-            if (flags & FLINT_PARALLEL_VERBOSE)
+        if (flags & FLINT_PARALLEL_VERBOSE)
+        {
+            for (i = 0; i < num_chunks; i++)
             {
-                for (i = 0; i < num_threads; i++)
-                {
-                    flint_printf("thread #%wd allocated a = %wd, b = %wd, step = %wd\n", i, work[i].a, work[i].b, work[i].step);
-                }
+                flint_printf("chunk #%wd allocated a = %wd, b = %wd, step = %wd\n", i, work[i].a, work[i].b, work[i].step);
             }
+        }
 
-            for (i = 0; i < num_workers; i++)
-                thread_pool_wake(global_thread_pool, handles[i], 0, worker, &work[i]);
+        /*
+            Nested parallel calls made by f compose: the chunks run with
+            the thread limit of the caller, and their own spawned tasks
+            are picked up by whichever threads are idle.
+        */
+        for (i = 1; i < num_chunks; i++)
+            thread_pool_spawn(global_thread_pool, tasks + i, num_workers, worker, work + i);
 
-            worker(&work[num_workers]);
+        worker(work + 0);
 
-            for (i = 0; i < num_workers; i++)
-                thread_pool_wait(global_thread_pool, handles[i]);
+        for (i = num_chunks - 1; i >= 1; i--)
+            thread_pool_join(global_thread_pool, tasks + i);
 
-            flint_give_back_threads(handles, num_workers);
-            TMP_END;
-        }
+        TMP_END;
     }
 }
 
@@ -243,111 +247,120 @@ typedef struct
     slong a;
     slong b;
     slong basecase_cutoff;
-    slong thread_limit;
+    slong num_threads;
     int flags;
 }
 flint_parallel_binary_splitting_t;
 
+static void _parallel_binary_splitting(flint_parallel_binary_splitting_t * x);
+
 static void
 _bsplit_worker(void * _args)
 {
-    flint_parallel_binary_splitting_t * args = (flint_parallel_binary_splitting_t *) _args;
-
-    flint_parallel_binary_splitting(args->res, args->basecase, args->merge, args->sizeof_res, args->init, args->clear, args->args, args->a, args->b, args->basecase_cutoff, args->thread_limit, args->flags);
+    _parallel_binary_splitting((flint_parallel_binary_splitting_t *) _args);
 }
 
-void
-flint_parallel_binary_splitting(void * res, bsplit_basecase_func_t basecase, bsplit_merge_func_t merge,
-    size_t sizeof_res, bsplit_init_func_t init, bsplit_clear_func_t clear, void * args, slong a, slong b, slong basecase_cutoff, int thread_limit, int flags)
+/*
+    The range [x->a, x->b) is split in halves until x->num_threads is
+    exhausted; the right half is spawned as a task and the left half is
+    computed by the current thread.
+*/
+static void
+_parallel_binary_splitting(flint_parallel_binary_splitting_t * x)
 {
-    basecase_cutoff = FLINT_MAX(basecase_cutoff, 1);
-
-    if (b - a <= basecase_cutoff)
+    if (x->b - x->a <= x->basecase_cutoff)
     {
-        basecase(res, a, b, args);
+        x->basecase(x->res, x->a, x->b, x->args);
     }
     else
     {
-        void * left, * right;
-        slong m = a + (b - a) / 2;
-        slong nw;
-        slong nw_save;
-        slong nt;
-        thread_pool_handle * threads;
+        flint_parallel_binary_splitting_t left, right;
+        thread_pool_task_t task;
+        slong m = x->a + (x->b - x->a) / 2;
         TMP_INIT;
 
         TMP_START;
 
-        if (flags & FLINT_PARALLEL_BSPLIT_LEFT_INPLACE)
+        left = *x;
+        right = *x;
+
+        if (x->flags & FLINT_PARALLEL_BSPLIT_LEFT_INPLACE)
         {
-            left = res;
-            right = TMP_ALLOC(sizeof_res);
+            left.res = x->res;
+            right.res = TMP_ALLOC(x->sizeof_res);
 
-            init(right, args);
+            x->init(right.res, x->args);
         }
         else
         {
-            left = TMP_ALLOC(2 * sizeof_res);
-            right = (void *) (((char *) left) + sizeof_res);
+            left.res = TMP_ALLOC(2 * x->sizeof_res);
+            right.res = (void *) (((char *) left.res) + x->sizeof_res);
 
-            init(left, args);
-            init(right, args);
+            x->init(left.res, x->args);
+            x->init(right.res, x->args);
         }
 
-        if (thread_limit <= 0)
-            thread_limit = flint_get_num_threads();
+        left.b = m;
+        right.a = m;
 
-        nt = thread_limit;
-        nw = flint_request_threads(&threads, FLINT_MIN(nt, 2)); /* request one extra worker */
-
-        if (nw == 0)
+        if (x->num_threads <= 1)
         {
-            flint_parallel_binary_splitting(left, basecase, merge, sizeof_res, init, clear, args, a, m, basecase_cutoff, thread_limit, flags);
-            flint_parallel_binary_splitting(right, basecase, merge, sizeof_res, init, clear, args, m, b, basecase_cutoff, thread_limit, flags);
+            _parallel_binary_splitting(&left);
+            _parallel_binary_splitting(&right);
         }
         else
         {
-            flint_parallel_binary_splitting_t right_args;
-
-            FLINT_ASSERT(nt >= 2);
-
-            nw_save = flint_set_num_workers(nt - nt / 2 - 1);
+            left.num_threads = x->num_threads - x->num_threads / 2;
+            right.num_threads = x->num_threads / 2;
 
-            right_args.res = right;
-            right_args.basecase = basecase;
-            right_args.merge = merge;
-            right_args.sizeof_res = sizeof_res;
-            right_args.init = init;
-            right_args.clear = clear;
-            right_args.args = args;
-            right_args.a = m;
-            right_args.b = b;
-            right_args.basecase_cutoff = basecase_cutoff;
-            right_args.thread_limit = thread_limit;
-            right_args.flags = flags;
+            thread_pool_spawn(global_thread_pool, task,
+                flint_get_num_threads() - 1, _bsplit_worker, &right);
 
-            thread_pool_wake(global_thread_pool, threads[0], nt / 2 - 1, _bsplit_worker, &right_args);
+            _parallel_binary_splitting(&left);
 
-            flint_parallel_binary_splitting(left, basecase, merge, sizeof_res, init, clear, args, a, m, basecase_cutoff, thread_limit, flags);
-
-            flint_reset_num_workers(nw_save);
-            thread_pool_wait(global_thread_pool, threads[0]);
+            thread_pool_join(global_thread_pool, task);
         }
 
-        flint_give_back_threads(threads, nw);
-
-        merge(res, left, right, args);
+        x->merge(x->res, left.res, right.res, x->args);
 
-        if (flags & FLINT_PARALLEL_BSPLIT_LEFT_INPLACE)
+        if (x->flags & FLINT_PARALLEL_BSPLIT_LEFT_INPLACE)
         {
-            clear(right, args);
+            x->clear(right.res, x->args);
         }
         else
         {
-            clear(left, args);
-            clear(right, args);
+            x->clear(left.res, x->args);
+            x->clear(right.res, x->args);
         }
 
         TMP_END;
     }
 }
+
+void
+flint_parallel_binary_splitting(void * res, bsplit_basecase_func_t basecase, bsplit_merge_func_t merge,
+    size_t sizeof_res, bsplit_init_func_t init, bsplit_clear_func_t clear, void * args, slong a, slong b, slong basecase_cutoff, int thread_limit, int flags)
+{
+    flint_parallel_binary_splitting_t x;
+
+    if (thread_limit <= 0)
+        thread_limit = flint_get_num_threads();
+
+    if (!global_thread_pool_initialized || global_thread_pool->length <= 0)
+        thread_limit = 1;
+
+    x.res = res;
+    x.basecase = basecase;
+    x.merge = merge;
+    x.sizeof_res = sizeof_res;
+    x.init = init;
+    x.clear = clear;
+    x.args = args;
+    x.a = a;
+    x.b = b;
+    x.basecase_cutoff = FLINT_MAX(basecase_cutoff, 1);
+    x.num_threads = thread_limit;
+    x.flags = flags;
+
+    _parallel_binary_splitting(&x);
+}
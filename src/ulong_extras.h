@@ -320,6 +320,38 @@ void n_cleanup_primes(void);
 const ulong * n_primes_arr_readonly(ulong n);
 const double * n_prime_inverses_arr_readonly(ulong n);
 
+/* Segmented sieve */
+
+typedef struct
+{
+    unsigned int * primes;
+    slong num;
+    ulong bound;
+    ulong * pattern;
+}
+n_sieve_struct;
+
+typedef n_sieve_struct n_sieve_t[1];
+
+void n_sieve_init(n_sieve_t S, ulong bound);
+void n_sieve_clear(n_sieve_t S);
+
+void n_sieve_segment(ulong * bits, ulong low, slong nbits, const n_sieve_t S);
+ulong n_sieve_count(const ulong * bits, slong nbits);
+
+/* sieving primes used on a range stay below this, larger factors are found
+   by n_is_prime */
+#if FLINT64
+#define N_PRIMES_RANGE_MAX_SIEVE_BOUND (UWORD(1) << 30)
+#else
+#define N_PRIMES_RANGE_MAX_SIEVE_BOUND UWORD(65535)
+#endif
+
+void n_primes_range(ulong a, ulong b,
+        int (* func)(const ulong * primes, slong len, void * arg), void * arg);
+
+ulong n_primes_count_range(ulong a, ulong b);
+
 int n_is_oddprime_small(ulong n);
 int n_is_oddprime_binary(ulong n);
 
@@ -333,6 +365,7 @@ int n_is_strong_probabprime_precomp(ulong n, double npre, ulong a, ulong d);
 int n_is_strong_probabprime2_preinv(ulong n, ulong ninv, ulong a, ulong d);
 
 int n_is_prime(ulong n);
+void n_is_prime_vec(int * res, const ulong * vec, slong len);
 int n_is_prime_pseudosquare(ulong n);
 int n_is_prime_pocklington(ulong n, ulong iterations);
 
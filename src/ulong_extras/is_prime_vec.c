@@ -0,0 +1,781 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "flint.h"
+#include "ulong_extras.h"
+
+#if FLINT_HAVE_CPU_DISPATCH && FLINT_BITS == 64
+# include <immintrin.h>
+#endif
+
+/*
+    Entries are first trial divided by the odd primes 3, ..., 233 at once:
+    for odd p, x is divisible by p if and only if x * p^(-1) mod 2^FLINT_BITS
+    is at most (2^FLINT_BITS - 1) / p, which needs no division and runs as
+    a plain loop over a block of entries for each p, or-ing the results
+    into a flag per entry.
+
+    The survivors go through the strong BPSW test: a strong base 2 test
+    and a strong Lucas test with Selfridge's parameters P = 1, Q = (1 - D)/4,
+    which is known to have no pseudoprimes below 2^64. Both are computed in
+    Montgomery form for IS_PRIME_LANES entries at a time so that their
+    independent multiplications overlap.
+
+    When flint_cpu_level allows, entries below 2^32 instead go through AVX2
+    lanes doing REDC with 2^32, and entries below 2^50 through AVX512 IFMA
+    lanes doing REDC with 2^52, each lane holding one entry; the parameter
+    search of the Lucas test stays scalar.
+*/
+
+#define IS_PRIME_BLOCK 256
+#define IS_PRIME_NUM_TRIAL 50
+#define IS_PRIME_LANES 4
+#define IS_PRIME_MAX_LANES 8
+
+typedef void (* _is_prime_lanes_func)(int * res, const ulong * n);
+
+/* x^(-1) mod 2^FLINT_BITS for odd x */
+static ulong
+_inv_2exp(ulong x)
+{
+    ulong y = (3 * x) ^ 2;
+
+    y *= 2 - x * y;
+    y *= 2 - x * y;
+    y *= 2 - x * y;
+#if FLINT64
+    y *= 2 - x * y;
+#endif
+
+    return y;
+}
+
+/* a * b / 2^FLINT_BITS mod n, with ninv = n^(-1) mod 2^FLINT_BITS */
+FLINT_FORCE_INLINE ulong
+_mulredc(ulong a, ulong b, ulong n, ulong ninv)
+{
+    ulong hi, lo, th, tl;
+
+    umul_ppmm(hi, lo, a, b);
+    umul_ppmm(th, tl, lo * ninv, n);
+    (void) tl;
+
+    return (hi >= th) ? hi - th : hi - th + n;
+}
+
+FLINT_FORCE_INLINE ulong
+_dblmod(ulong a, ulong n)
+{
+    return (a >= n - a) ? a - (n - a) : a + a;
+}
+
+/* strong base 2 test for IS_PRIME_LANES odd n > 2 */
+static void
+_is_strong_probabprime2_lanes(int * res, const ulong * n)
+{
+    ulong ninv[IS_PRIME_LANES], one[IS_PRIME_LANES], d[IS_PRIME_LANES];
+    ulong x[IS_PRIME_LANES];
+    flint_bitcnt_t s[IS_PRIME_LANES];
+    slong i, j, bits;
+
+    bits = 0;
+
+    for (j = 0; j < IS_PRIME_LANES; j++)
+    {
+        ninv[j] = _inv_2exp(n[j]);
+        one[j] = (-n[j]) % n[j];
+        s[j] = flint_ctz(n[j] - 1);
+        d[j] = (n[j] - 1) >> s[j];
+        x[j] = one[j];
+        bits = FLINT_MAX(bits, FLINT_BIT_COUNT(d[j]));
+    }
+
+    /* x = 2^d, left to right; leading zero bits square one to itself */
+    for (i = bits - 1; i >= 0; i--)
+    {
+        for (j = 0; j < IS_PRIME_LANES; j++)
+        {
+            ulong t = _mulredc(x[j], x[j], n[j], ninv[j]);
+            ulong u = _dblmod(t, n[j]);
+
+            x[j] = ((d[j] >> i) & 1) ? u : t;
+        }
+    }
+
+    for (j = 0; j < IS_PRIME_LANES; j++)
+    {
+        ulong minus_one = n[j] - one[j];
+        flint_bitcnt_t k;
+
+        if (x[j] == one[j] || x[j] == minus_one)
+        {
+            res[j] = 1;
+            continue;
+        }
+
+        res[j] = 0;
+
+        for (k = 1; k < s[j]; k++)
+        {
+            x[j] = _mulredc(x[j], x[j], n[j], ninv[j]);
+
+            if (x[j] == minus_one)
+            {
+                res[j] = 1;
+                break;
+            }
+
+            if (x[j] == one[j])
+                break;
+        }
+    }
+}
+
+FLINT_FORCE_INLINE ulong
+_submod(ulong a, ulong b, ulong n)
+{
+    return (a >= b) ? a - b : a - b + n;
+}
+
+/* x * 2^FLINT_BITS mod n */
+static ulong
+_to_mont(ulong x, ulong n)
+{
+    return n_ll_mod_preinv(x % n, 0, n, n_preinvert_limb(n));
+}
+
+/* (D/n) for small odd D, by reciprocity */
+static int
+_jacobi_small(slong D, ulong n)
+{
+    ulong m = FLINT_ABS(D);
+    int c;
+
+    c = n_jacobi_unsigned(n % m, m);
+
+    if (m % 4 == 3 && n % 4 == 3)
+        c = -c;
+
+    if (D < 0 && n % 4 == 3)
+        c = -c;
+
+    return c;
+}
+
+/* sets D to the first of 5, -7, 9, -11, ... with (D/n) = -1 and returns 0,
+   or returns 1 if n is found to be composite on the way */
+static int
+_lucas_D(slong * D, ulong n)
+{
+    slong E;
+    int c, tries;
+
+    for (E = 5, tries = 0; ; E = (E > 0) ? -E - 2 : -E + 2, tries++)
+    {
+        c = _jacobi_small(E, n);
+
+        if (c == -1)
+            break;
+
+        if (c == 0 && (ulong) FLINT_ABS(E) != n)
+            break;
+
+        if (tries == 10 && n_is_square(n))
+            break;
+    }
+
+    *D = E;
+    return (c != -1);
+}
+
+/*
+    Strong Lucas test for IS_PRIME_LANES odd n > 2 which are not squares,
+    with D the first of 5, -7, 9, -11, ... with (D/n) = -1. Only V_k and
+    Q^k are computed; U_d = 0 is equivalent to 2 V_(d+1) = V_d as D is
+    invertible.
+*/
+static void
+_is_strong_lucas_lanes(int * res, const ulong * n)
+{
+    ulong ninv[IS_PRIME_LANES], d[IS_PRIME_LANES], Q[IS_PRIME_LANES];
+    ulong V[IS_PRIME_LANES], W[IS_PRIME_LANES], Qk[IS_PRIME_LANES];
+    ulong two[IS_PRIME_LANES];
+    flint_bitcnt_t s[IS_PRIME_LANES];
+    slong i, j, bits, D;
+    int done[IS_PRIME_LANES];
+
+    bits = 0;
+
+    for (j = 0; j < IS_PRIME_LANES; j++)
+    {
+        ulong one, q;
+
+        res[j] = 0;
+        done[j] = _lucas_D(&D, n[j]);
+
+        ninv[j] = _inv_2exp(n[j]);
+        one = (-n[j]) % n[j];
+        two[j] = _dblmod(one, n[j]);
+
+        /* Q = (1 - D)/4 */
+        q = _to_mont(FLINT_ABS(1 - D) / 4, n[j]);
+        Q[j] = (D > 0) ? _submod(0, q, n[j]) : q;
+
+        s[j] = flint_ctz(n[j] + 1);
+        d[j] = (n[j] + 1) >> s[j];
+
+        /* (V_0, V_1, Q^0) */
+        V[j] = two[j];
+        W[j] = one;
+        Qk[j] = one;
+
+        bits = FLINT_MAX(bits, FLINT_BIT_COUNT(d[j]));
+    }
+
+    /*
+        (V_k, V_(k+1), Q^k) -> (V_2k, V_(2k+1), Q^2k) or
+        (V_(2k+1), V_(2k+2), Q^(2k+1)), using
+        V_2k = V_k^2 - 2 Q^k and V_(2k+1) = V_k V_(k+1) - Q^k.
+        Leading zero bits leave (V_0, V_1, Q^0) unchanged.
+    */
+    for (i = bits - 1; i >= 0; i--)
+    {
+        for (j = 0; j < IS_PRIME_LANES; j++)
+        {
+            ulong nj = n[j], ni = ninv[j];
+            ulong Qk1, mid, x, y, z;
+            int b = (d[j] >> i) & 1;
+
+            Qk1 = _mulredc(Qk[j], Q[j], nj, ni);
+            mid = _submod(_mulredc(V[j], W[j], nj, ni), Qk[j], nj);
+
+            x = b ? W[j] : V[j];
+            y = b ? Qk1 : Qk[j];
+            z = _submod(_mulredc(x, x, nj, ni), _dblmod(y, nj), nj);
+
+            Qk[j] = _mulredc(Qk[j], y, nj, ni);
+            V[j] = b ? mid : z;
+            W[j] = b ? z : mid;
+        }
+    }
+
+    for (j = 0; j < IS_PRIME_LANES; j++)
+    {
+        flint_bitcnt_t k;
+
+        if (done[j])
+            continue;
+
+        /* U_d = 0 */
+        if (_dblmod(W[j], n[j]) == V[j])
+        {
+            res[j] = 1;
+            continue;
+        }
+
+        /* V_(d 2^k) = 0 for some 0 <= k < s */
+        for (k = 0; k < s[j]; k++)
+        {
+            if (V[j] == 0)
+            {
+                res[j] = 1;
+                break;
+            }
+
+            V[j] = _submod(_mulredc(V[j], V[j], n[j], ninv[j]),
+                                                _dblmod(Qk[j], n[j]), n[j]);
+            Qk[j] = _mulredc(Qk[j], Qk[j], n[j], ninv[j]);
+        }
+    }
+}
+
+#if FLINT_HAVE_CPU_DISPATCH && FLINT_BITS == 64
+
+/*
+    AVX2 lanes for n < 2^32, in Montgomery form with respect to 2^32: with
+    q = t n^(-1) mod 2^32, the low halves of t and q n agree, so (t - q n)
+    / 2^32 is the difference of their high halves. Entries stay below n.
+*/
+__attribute__((target("avx2")))
+FLINT_FORCE_INLINE __m256i
+_mulredc_avx2(__m256i a, __m256i b, __m256i n, __m256i ninv)
+{
+    __m256i t, q, r;
+
+    t = _mm256_mul_epu32(a, b);
+    q = _mm256_mul_epu32(_mm256_mul_epu32(t, ninv), n);
+    r = _mm256_sub_epi64(_mm256_srli_epi64(t, 32), _mm256_srli_epi64(q, 32));
+
+    return _mm256_add_epi64(r,
+                _mm256_and_si256(_mm256_cmpgt_epi64(_mm256_setzero_si256(), r), n));
+}
+
+__attribute__((target("avx2")))
+FLINT_FORCE_INLINE __m256i
+_dblmod_avx2(__m256i a, __m256i n)
+{
+    __m256i s = _mm256_add_epi64(a, a);
+
+    return _mm256_sub_epi64(s, _mm256_andnot_si256(_mm256_cmpgt_epi64(n, s), n));
+}
+
+__attribute__((target("avx2")))
+FLINT_FORCE_INLINE __m256i
+_submod_avx2(__m256i a, __m256i b, __m256i n)
+{
+    __m256i d = _mm256_sub_epi64(a, b);
+
+    return _mm256_add_epi64(d,
+                _mm256_and_si256(_mm256_cmpgt_epi64(_mm256_setzero_si256(), d), n));
+}
+
+/* d has bit i set, as a lane mask */
+__attribute__((target("avx2")))
+FLINT_FORCE_INLINE __m256i
+_bit_avx2(__m256i d, slong i)
+{
+    __m256i b = _mm256_set1_epi64x(UWORD(1) << i);
+
+    return _mm256_cmpeq_epi64(_mm256_and_si256(d, b), b);
+}
+
+/* the strong base 2 test for 4 odd 2 < n < 2^32 */
+__attribute__((target("avx2")))
+static void
+_is_strong_probabprime2_avx2(int * res, const ulong * n)
+{
+    ulong t[4], u[4], w[4], v[4];
+    __m256i N, NINV, ONE, MINUS, D, S, X, T, R, A, E1, E2;
+    slong i, j, bits, maxs;
+
+    bits = maxs = 0;
+
+    for (j = 0; j < 4; j++)
+    {
+        ulong s = flint_ctz(n[j] - 1);
+
+        t[j] = _inv_2exp(n[j]);
+        u[j] = (UWORD(1) << 32) % n[j];
+        v[j] = s;
+        w[j] = (n[j] - 1) >> s;
+        bits = FLINT_MAX(bits, FLINT_BIT_COUNT(w[j]));
+        maxs = FLINT_MAX(maxs, s);
+    }
+
+    N = _mm256_loadu_si256((const __m256i *) n);
+    NINV = _mm256_loadu_si256((const __m256i *) t);
+    ONE = _mm256_loadu_si256((const __m256i *) u);
+    S = _mm256_loadu_si256((const __m256i *) v);
+    D = _mm256_loadu_si256((const __m256i *) w);
+    MINUS = _mm256_sub_epi64(N, ONE);
+
+    X = ONE;
+
+    for (i = bits - 1; i >= 0; i--)
+    {
+        T = _mulredc_avx2(X, X, N, NINV);
+        X = _mm256_blendv_epi8(T, _dblmod_avx2(T, N), _bit_avx2(D, i));
+    }
+
+    R = _mm256_or_si256(_mm256_cmpeq_epi64(X, ONE), _mm256_cmpeq_epi64(X, MINUS));
+    A = _mm256_cmpeq_epi64(R, _mm256_setzero_si256());
+
+    for (i = 1; i < maxs; i++)
+    {
+        A = _mm256_and_si256(A, _mm256_cmpgt_epi64(S, _mm256_set1_epi64x(i)));
+        X = _mulredc_avx2(X, X, N, NINV);
+        E1 = _mm256_cmpeq_epi64(X, ONE);
+        E2 = _mm256_cmpeq_epi64(X, MINUS);
+        R = _mm256_or_si256(R, _mm256_and_si256(A, E2));
+        A = _mm256_andnot_si256(_mm256_or_si256(E1, E2), A);
+    }
+
+    _mm256_storeu_si256((__m256i *) t, R);
+
+    for (j = 0; j < 4; j++)
+        res[j] = (t[j] != 0);
+}
+
+/* the strong Lucas test for 4 odd 2 < n < 2^32 which are not squares */
+__attribute__((target("avx2")))
+static void
+_is_strong_lucas_avx2(int * res, const ulong * n)
+{
+    ulong t[4], u[4], w[4], v[4], z[4];
+    __m256i N, NINV, ONE, D, S, Q, V, W, Qk, Qk1, M, X, Y, Z, B, R, A, E;
+    slong i, j, bits, maxs, Dj;
+    int done[4];
+
+    bits = maxs = 0;
+
+    for (j = 0; j < 4; j++)
+    {
+        ulong s, q;
+
+        done[j] = _lucas_D(&Dj, n[j]);
+
+        /* Q = (1 - D)/4 */
+        q = ((FLINT_ABS(1 - Dj) / 4) % n[j] << 32) % n[j];
+        z[j] = (Dj > 0) ? _submod(0, q, n[j]) : q;
+
+        s = flint_ctz(n[j] + 1);
+        t[j] = _inv_2exp(n[j]);
+        u[j] = (UWORD(1) << 32) % n[j];
+        v[j] = s;
+        w[j] = (n[j] + 1) >> s;
+        bits = FLINT_MAX(bits, FLINT_BIT_COUNT(w[j]));
+        maxs = FLINT_MAX(maxs, s);
+    }
+
+    N = _mm256_loadu_si256((const __m256i *) n);
+    NINV = _mm256_loadu_si256((const __m256i *) t);
+    ONE = _mm256_loadu_si256((const __m256i *) u);
+    S = _mm256_loadu_si256((const __m256i *) v);
+    D = _mm256_loadu_si256((const __m256i *) w);
+    Q = _mm256_loadu_si256((const __m256i *) z);
+
+    V = _dblmod_avx2(ONE, N);
+    W = ONE;
+    Qk = ONE;
+
+    for (i = bits - 1; i >= 0; i--)
+    {
+        B = _bit_avx2(D, i);
+
+        Qk1 = _mulredc_avx2(Qk, Q, N, NINV);
+        M = _submod_avx2(_mulredc_avx2(V, W, N, NINV), Qk, N);
+
+        X = _mm256_blendv_epi8(V, W, B);
+        Y = _mm256_blendv_epi8(Qk, Qk1, B);
+        Z = _submod_avx2(_mulredc_avx2(X, X, N, NINV), _dblmod_avx2(Y, N), N);
+
+        Qk = _mulredc_avx2(Qk, Y, N, NINV);
+        V = _mm256_blendv_epi8(Z, M, B);
+        W = _mm256_blendv_epi8(M, Z, B);
+    }
+
+    R = _mm256_cmpeq_epi64(_dblmod_avx2(W, N), V);
+    A = _mm256_cmpeq_epi64(R, _mm256_setzero_si256());
+
+    for (i = 0; i < maxs; i++)
+    {
+        A = _mm256_and_si256(A, _mm256_cmpgt_epi64(S, _mm256_set1_epi64x(i)));
+        E = _mm256_cmpeq_epi64(V, _mm256_setzero_si256());
+        R = _mm256_or_si256(R, _mm256_and_si256(A, E));
+        A = _mm256_andnot_si256(E, A);
+
+        V = _submod_avx2(_mulredc_avx2(V, V, N, NINV), _dblmod_avx2(Qk, N), N);
+        Qk = _mulredc_avx2(Qk, Qk, N, NINV);
+    }
+
+    _mm256_storeu_si256((__m256i *) t, R);
+
+    for (j = 0; j < 4; j++)
+        res[j] = (t[j] != 0) && !done[j];
+}
+
+/* the same for 8 odd 2 < n < 2^50, with AVX512 IFMA and REDC by 2^52 */
+__attribute__((target("avx512f,avx512ifma")))
+FLINT_FORCE_INLINE __m512i
+_mulredc_ifma(__m512i a, __m512i b, __m512i n, __m512i ninv)
+{
+    __m512i zero = _mm512_setzero_si512();
+    __m512i lo, hi, q, r;
+
+    lo = _mm512_madd52lo_epu64(zero, a, b);
+    hi = _mm512_madd52hi_epu64(zero, a, b);
+    q = _mm512_madd52lo_epu64(zero, lo, ninv);
+    r = _mm512_sub_epi64(hi, _mm512_madd52hi_epu64(zero, q, n));
+
+    return _mm512_min_epu64(r, _mm512_add_epi64(r, n));
+}
+
+__attribute__((target("avx512f,avx512ifma")))
+FLINT_FORCE_INLINE __m512i
+_dblmod_ifma(__m512i a, __m512i n)
+{
+    __m512i s = _mm512_add_epi64(a, a);
+
+    return _mm512_min_epu64(s, _mm512_sub_epi64(s, n));
+}
+
+__attribute__((target("avx512f,avx512ifma")))
+FLINT_FORCE_INLINE __m512i
+_submod_ifma(__m512i a, __m512i b, __m512i n)
+{
+    __m512i d = _mm512_sub_epi64(a, b);
+
+    return _mm512_min_epu64(d, _mm512_add_epi64(d, n));
+}
+
+__attribute__((target("avx512f,avx512ifma")))
+static void
+_is_strong_probabprime2_ifma(int * res, const ulong * n)
+{
+    ulong t[8], u[8], w[8], v[8];
+    __m512i N, NINV, ONE, MINUS, D, S, X, T;
+    __mmask8 R, A, E1, E2;
+    slong i, j, bits, maxs;
+
+    bits = maxs = 0;
+
+    for (j = 0; j < 8; j++)
+    {
+        ulong s = flint_ctz(n[j] - 1);
+
+        t[j] = _inv_2exp(n[j]);
+        u[j] = (UWORD(1) << 52) % n[j];
+        v[j] = s;
+        w[j] = (n[j] - 1) >> s;
+        bits = FLINT_MAX(bits, FLINT_BIT_COUNT(w[j]));
+        maxs = FLINT_MAX(maxs, s);
+    }
+
+    N = _mm512_loadu_si512((const void *) n);
+    NINV = _mm512_loadu_si512((const void *) t);
+    ONE = _mm512_loadu_si512((const void *) u);
+    S = _mm512_loadu_si512((const void *) v);
+    D = _mm512_loadu_si512((const void *) w);
+    MINUS = _mm512_sub_epi64(N, ONE);
+
+    X = ONE;
+
+    for (i = bits - 1; i >= 0; i--)
+    {
+        T = _mulredc_ifma(X, X, N, NINV);
+        X = _mm512_mask_blend_epi64(_mm512_test_epi64_mask(D,
+                _mm512_set1_epi64(UWORD(1) << i)), T, _dblmod_ifma(T, N));
+    }
+
+    R = _mm512_cmpeq_epi64_mask(X, ONE) | _mm512_cmpeq_epi64_mask(X, MINUS);
+    A = ~R;
+
+    for (i = 1; i < maxs; i++)
+    {
+        A &= _mm512_cmpgt_epi64_mask(S, _mm512_set1_epi64(i));
+        X = _mulredc_ifma(X, X, N, NINV);
+        E1 = _mm512_cmpeq_epi64_mask(X, ONE);
+        E2 = _mm512_cmpeq_epi64_mask(X, MINUS);
+        R |= A & E2;
+        A &= ~(E1 | E2);
+    }
+
+    for (j = 0; j < 8; j++)
+        res[j] = (R >> j) & 1;
+}
+
+__attribute__((target("avx512f,avx512ifma")))
+static void
+_is_strong_lucas_ifma(int * res, const ulong * n)
+{
+    ulong t[8], u[8], w[8], v[8], z[8];
+    __m512i N, NINV, ONE, D, S, Q, V, W, Qk, Qk1, M, X, Y, Z;
+    __mmask8 B, R, A, E;
+    slong i, j, bits, maxs, Dj;
+    int done[8];
+
+    bits = maxs = 0;
+
+    for (j = 0; j < 8; j++)
+    {
+        ulong s, q;
+
+        done[j] = _lucas_D(&Dj, n[j]);
+
+        t[j] = _inv_2exp(n[j]);
+        u[j] = (UWORD(1) << 52) % n[j];
+
+        /* Q = (1 - D)/4 */
+        q = n_mulmod2_preinv((FLINT_ABS(1 - Dj) / 4) % n[j], u[j],
+                                            n[j], n_preinvert_limb(n[j]));
+        z[j] = (Dj > 0) ? _submod(0, q, n[j]) : q;
+
+        s = flint_ctz(n[j] + 1);
+        v[j] = s;
+        w[j] = (n[j] + 1) >> s;
+        bits = FLINT_MAX(bits, FLINT_BIT_COUNT(w[j]));
+        maxs = FLINT_MAX(maxs, s);
+    }
+
+    N = _mm512_loadu_si512((const void *) n);
+    NINV = _mm512_loadu_si512((const void *) t);
+    ONE = _mm512_loadu_si512((const void *) u);
+    S = _mm512_loadu_si512((const void *) v);
+    D = _mm512_loadu_si512((const void *) w);
+    Q = _mm512_loadu_si512((const void *) z);
+
+    V = _dblmod_ifma(ONE, N);
+    W = ONE;
+    Qk = ONE;
+
+    for (i = bits - 1; i >= 0; i--)
+    {
+        B = _mm512_test_epi64_mask(D, _mm512_set1_epi64(UWORD(1) << i));
+
+        Qk1 = _mulredc_ifma(Qk, Q, N, NINV);
+        M = _submod_ifma(_mulredc_ifma(V, W, N, NINV), Qk, N);
+
+        X = _mm512_mask_blend_epi64(B, V, W);
+        Y = _mm512_mask_blend_epi64(B, Qk, Qk1);
+        Z = _submod_ifma(_mulredc_ifma(X, X, N, NINV), _dblmod_ifma(Y, N), N);
+
+        Qk = _mulredc_ifma(Qk, Y, N, NINV);
+        V = _mm512_mask_blend_epi64(B, Z, M);
+        W = _mm512_mask_blend_epi64(B, M, Z);
+    }
+
+    R = _mm512_cmpeq_epi64_mask(_dblmod_ifma(W, N), V);
+    A = ~R;
+
+    for (i = 0; i < maxs; i++)
+    {
+        A &= _mm512_cmpgt_epi64_mask(S, _mm512_set1_epi64(i));
+        E = _mm512_cmpeq_epi64_mask(V, _mm512_setzero_si512());
+        R |= A & E;
+        A &= ~E;
+
+        V = _submod_ifma(_mulredc_ifma(V, V, N, NINV), _dblmod_ifma(Qk, N), N);
+        Qk = _mulredc_ifma(Qk, Qk, N, NINV);
+    }
+
+    for (j = 0; j < 8; j++)
+        res[j] = ((R >> j) & 1) && !done[j];
+}
+
+#endif
+
+/* runs f on the entries of n with indices idx in groups of lanes entries,
+   padding the last group, and returns the entries passing the test */
+static slong
+_run_lanes(slong * idx, ulong * n, slong num,
+                        _is_prime_lanes_func f, slong lanes, int * res)
+{
+    ulong ln[IS_PRIME_MAX_LANES];
+    int lr[IS_PRIME_MAX_LANES];
+    slong i, j, k;
+
+    for (i = k = 0; i < num; i += lanes)
+    {
+        for (j = 0; j < lanes; j++)
+            ln[j] = n[FLINT_MIN(i + j, num - 1)];
+
+        f(lr, ln);
+
+        for (j = 0; j < lanes && i + j < num; j++)
+        {
+            res[idx[i + j]] = lr[j];
+
+            if (lr[j])
+            {
+                idx[k] = idx[i + j];
+                n[k] = n[i + j];
+                k++;
+            }
+        }
+    }
+
+    return k;
+}
+
+void
+n_is_prime_vec(int * res, const ulong * vec, slong len)
+{
+    ulong pinv[IS_PRIME_NUM_TRIAL], plim[IS_PRIME_NUM_TRIAL];
+    ulong divisible[IS_PRIME_BLOCK], cand[IS_PRIME_BLOCK];
+    ulong vcand[IS_PRIME_BLOCK];
+    slong idx[IS_PRIME_BLOCK], vidx[IS_PRIME_BLOCK];
+    slong i, k, start, blen, num, vnum, vlanes = 0;
+    _is_prime_lanes_func vprp = NULL, vlucas = NULL;
+    ulong n, vlimit = 0;
+
+#if FLINT_HAVE_CPU_DISPATCH && FLINT_BITS == 64
+    {
+        int level = flint_cpu_level();
+
+        if (level >= FLINT_CPU_AVX512_IFMA)
+        {
+            vlimit = UWORD(1) << 50;
+            vlanes = 8;
+            vprp = _is_strong_probabprime2_ifma;
+            vlucas = _is_strong_lucas_ifma;
+        }
+        else if (level >= FLINT_CPU_AVX2)
+        {
+            vlimit = UWORD(1) << 32;
+            vlanes = 4;
+            vprp = _is_strong_probabprime2_avx2;
+            vlucas = _is_strong_lucas_avx2;
+        }
+    }
+#endif
+
+    for (k = 0; k < IS_PRIME_NUM_TRIAL; k++)
+    {
+        ulong p = flint_primes_small[k + 1];
+
+        pinv[k] = _inv_2exp(p);
+        plim[k] = UWORD_MAX / p;
+    }
+
+    for (start = 0; start < len; start += IS_PRIME_BLOCK)
+    {
+        blen = FLINT_MIN(IS_PRIME_BLOCK, len - start);
+
+        for (i = 0; i < blen; i++)
+            divisible[i] = 0;
+
+        for (k = 0; k < IS_PRIME_NUM_TRIAL; k++)
+        {
+            ulong pi = pinv[k], pl = plim[k];
+
+            for (i = 0; i < blen; i++)
+                divisible[i] |= (vec[start + i] * pi <= pl);
+        }
+
+        num = vnum = 0;
+
+        for (i = 0; i < blen; i++)
+        {
+            n = vec[start + i];
+
+            if (n < FLINT_PRIMES_TAB_DEFAULT_CUTOFF)
+            {
+                res[start + i] = n_is_prime(n);
+            }
+            else if (n % 2 == 0 || divisible[i])
+            {
+                res[start + i] = 0;
+            }
+            else if (n < vlimit)
+            {
+                vcand[vnum] = n;
+                vidx[vnum] = start + i;
+                vnum++;
+            }
+            else
+            {
+                cand[num] = n;
+                idx[num] = start + i;
+                num++;
+            }
+        }
+
+        num = _run_lanes(idx, cand, num,
+                        _is_strong_probabprime2_lanes, IS_PRIME_LANES, res);
+        _run_lanes(idx, cand, num, _is_strong_lucas_lanes, IS_PRIME_LANES, res);
+
+        if (vnum != 0)
+        {
+            vnum = _run_lanes(vidx, vcand, vnum, vprp, vlanes, res);
+            _run_lanes(vidx, vcand, vnum, vlucas, vlanes, res);
+        }
+    }
+}
@@ -10,6 +10,7 @@
 */
 
 #include "flint.h"
+#include "thread_support.h"
 #include "ulong_extras.h"
 
 const unsigned char FLINT_PRIME_PI_ODD_LOOKUP[] =
@@ -23,6 +24,255 @@ const unsigned char FLINT_PRIME_PI_ODD_LOOKUP[] =
 };
 
 
+/*
+    Meissel-Lehmer: with a = pi(n^(1/4)), b = pi(n^(1/2)), c = pi(n^(1/3)),
+
+    pi(n) = phi(n, a) + (b + a - 2)(b - a + 1)/2 - sum_{a < i <= b} pi(n/p_i)
+            - sum_{a < i <= c} sum_{i <= j <= b_i} (pi(n/(p_i p_j)) - (j - 1))
+
+    where b_i = pi(sqrt(n/p_i)). Values of pi below a limit of about n^(2/3)
+    are read off a sieved table of the odd numbers with cumulative counts;
+    the sums over i are shared out between threads.
+*/
+
+#define PI_TABLE_MAX (UWORD(1) << 28)
+#define PHI_C 6
+#define PHI_PRIMORIAL 30030
+#define PHI_TOTIENT 5760
+
+typedef struct
+{
+    ulong limit;
+    ulong * bits;
+    unsigned int * counts;
+    ulong * primes;
+    slong num_primes;
+    unsigned short * phi_table;
+}
+_pi_table_struct;
+
+typedef struct
+{
+    _pi_table_struct * T;
+    const n_sieve_struct * S;
+    slong nbits;
+}
+_pi_sieve_work_struct;
+
+#define PI_SEGMENT_BITS (WORD(1) << 21)
+
+static void
+_pi_sieve_worker(slong j, void * arg)
+{
+    _pi_sieve_work_struct * w = (_pi_sieve_work_struct *) arg;
+    slong start = j * PI_SEGMENT_BITS;
+
+    n_sieve_segment(w->T->bits + start / FLINT_BITS, 1 + 2 * (ulong) start,
+                    FLINT_MIN(PI_SEGMENT_BITS, w->nbits - start), w->S);
+}
+
+static ulong
+_pi_small(const _pi_table_struct * T, ulong x)
+{
+    ulong g;
+
+    if (x < 3)
+        return (x == 2);
+
+    /* odd numbers 1, 3, ..., 2g + 1 */
+    g = (x - 1) / 2;
+
+    return 1 + T->counts[g / FLINT_BITS] +
+                    n_sieve_count(T->bits + g / FLINT_BITS, g % FLINT_BITS + 1);
+}
+
+static void
+_pi_table_init(_pi_table_struct * T, ulong limit, ulong r)
+{
+    _pi_sieve_work_struct w[1];
+    n_sieve_t S;
+    slong i, nbits, nwords, c;
+    ulong x;
+
+    nbits = (limit - 1) / 2 + 1;
+    nwords = (nbits + FLINT_BITS - 1) / FLINT_BITS;
+
+    T->limit = limit;
+    T->bits = flint_malloc(nwords * sizeof(ulong));
+    T->counts = flint_malloc(nwords * sizeof(unsigned int));
+
+    n_sieve_init(S, n_sqrt(limit));
+    w->T = T;
+    w->S = S;
+    w->nbits = nbits;
+    flint_parallel_do(_pi_sieve_worker, w, (nbits - 1) / PI_SEGMENT_BITS + 1,
+                                                  0, FLINT_PARALLEL_UNIFORM);
+    n_sieve_clear(S);
+
+    for (i = 0, c = 0; i < nwords; i++)
+    {
+        T->counts[i] = c;
+        c += n_sieve_count(T->bits + i, FLINT_BITS);
+    }
+
+    /* primes up to r <= limit, 1-indexed */
+    T->num_primes = _pi_small(T, r);
+    T->primes = flint_malloc((T->num_primes + 2) * sizeof(ulong));
+    T->primes[0] = 1;
+    T->primes[1] = 2;
+    for (x = 3, i = 2; i <= T->num_primes; x += 2)
+        if ((T->bits[x / 2 / FLINT_BITS] >> ((x / 2) % FLINT_BITS)) & 1)
+            T->primes[i++] = x;
+    T->primes[i] = n_nextprime(T->primes[i - 1], 1);
+
+    /* phi(x, PHI_C) for 0 <= x < PHI_PRIMORIAL */
+    T->phi_table = flint_malloc(PHI_PRIMORIAL * sizeof(unsigned short));
+    for (x = 0, c = 0; x < PHI_PRIMORIAL; x++)
+    {
+        if (x != 0 && n_gcd(x, PHI_PRIMORIAL) == 1)
+            c++;
+        T->phi_table[x] = c;
+    }
+}
+
+static void
+_pi_table_clear(_pi_table_struct * T)
+{
+    flint_free(T->bits);
+    flint_free(T->counts);
+    flint_free(T->primes);
+    flint_free(T->phi_table);
+}
+
+/* the number of 1 <= k <= x not divisible by p_1, ..., p_a */
+static ulong
+_phi(ulong x, slong a, const _pi_table_struct * T)
+{
+    ulong s, y;
+    slong i;
+
+    if (a == 0)
+        return x;
+
+    if (x < T->primes[a + 1])
+        return (x != 0);
+
+    if (a < PHI_C)
+        return _phi(x, a - 1, T) - _phi(x / T->primes[a], a - 1, T);
+
+    if (a == PHI_C)
+        return (x / PHI_PRIMORIAL) * PHI_TOTIENT +
+                                              T->phi_table[x % PHI_PRIMORIAL];
+
+    if (x <= T->limit && x / T->primes[a + 1] < T->primes[a + 1])
+        return _pi_small(T, x) - a + 1;
+
+    s = _phi(x, PHI_C, T);
+
+    for (i = PHI_C + 1; i <= a; i++)
+    {
+        y = x / T->primes[i];
+
+        /* phi(y, i - 1) = 1 from here on */
+        if (y < T->primes[i])
+        {
+            s -= a - i + 1;
+            break;
+        }
+
+        s -= _phi(y, i - 1, T);
+    }
+
+    return s;
+}
+
+static ulong _pi_lehmer(ulong x, const _pi_table_struct * T, int threaded);
+
+typedef struct
+{
+    ulong x;
+    slong a;
+    slong b;
+    slong c;
+    const _pi_table_struct * T;
+    slong njobs;
+    ulong * phi;
+    ulong * sum;
+}
+_pi_work_struct;
+
+static void
+_pi_worker(slong j, void * arg)
+{
+    _pi_work_struct * w = (_pi_work_struct *) arg;
+    const _pi_table_struct * T = w->T;
+    ulong s, t, y;
+    slong i, k, bi;
+
+    /* phi(x, a) = phi(x, PHI_C) - sum_{PHI_C < i <= a} phi(x/p_i, i - 1) */
+    for (s = 0, i = PHI_C + 1 + j; i <= w->a; i += w->njobs)
+        s += _phi(w->x / T->primes[i], i - 1, T);
+    w->phi[j] = s;
+
+    for (s = 0, i = w->a + 1 + j; i <= w->b; i += w->njobs)
+    {
+        y = w->x / T->primes[i];
+        s += _pi_lehmer(y, T, 0);
+
+        if (i <= w->c)
+        {
+            bi = _pi_small(T, n_sqrt(y));
+            for (k = i; k <= bi; k++)
+            {
+                t = _pi_lehmer(y / T->primes[k], T, 0);
+                s += t - (k - 1);
+            }
+        }
+    }
+    w->sum[j] = s;
+}
+
+static ulong
+_pi_lehmer(ulong x, const _pi_table_struct * T, int threaded)
+{
+    _pi_work_struct w[1];
+    slong a, b, c, j;
+    ulong s;
+
+    if (x <= T->limit)
+        return _pi_small(T, x);
+
+    a = _pi_small(T, n_root(x, 4));
+    b = _pi_small(T, n_sqrt(x));
+    c = _pi_small(T, n_cbrt(x));
+
+    w->x = x;
+    w->a = a;
+    w->b = b;
+    w->c = c;
+    w->T = T;
+    w->njobs = threaded ? FLINT_MAX(1, 16 * flint_get_num_threads()) : 1;
+    w->phi = flint_malloc(w->njobs * sizeof(ulong));
+    w->sum = flint_malloc(w->njobs * sizeof(ulong));
+
+    s = _phi(x, FLINT_MIN(a, PHI_C), T);
+
+    if (w->njobs == 1)
+        _pi_worker(0, w);
+    else
+        flint_parallel_do(_pi_worker, w, w->njobs, 0, FLINT_PARALLEL_DYNAMIC);
+
+    for (j = 0; j < w->njobs; j++)
+        s -= w->phi[j] + w->sum[j];
+
+    s += (ulong) (b + a - 2) * (b - a + 1) / 2;
+
+    flint_free(w->phi);
+    flint_free(w->sum);
+
+    return s;
+}
+
 ulong n_prime_pi(mp_limb_t n)
 {
     ulong low, mid, high;
@@ -35,6 +285,24 @@ ulong n_prime_pi(mp_limb_t n)
         return FLINT_PRIME_PI_ODD_LOOKUP[(n-1)/2];
     }
 
+    if (n > FLINT_PRIMES_TAB_DEFAULT_CUTOFF)
+    {
+        _pi_table_struct T[1];
+        ulong limit, res;
+
+        /* the table must contain the primes up to sqrt(n) */
+        limit = n_cbrt(n);
+        limit = FLINT_MIN(limit * limit, PI_TABLE_MAX);
+        limit = FLINT_MAX(limit, n_sqrt(n) + 1);
+        limit = FLINT_MAX(limit, UWORD(1000));
+
+        _pi_table_init(T, limit, n_sqrt(n));
+        res = _pi_lehmer(n, T, 1);
+        _pi_table_clear(T);
+
+        return res;
+    }
+
     n_prime_pi_bounds(&low, &high, n);
     primes = n_primes_arr_readonly(high + 1);
 
@@ -0,0 +1,106 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "flint.h"
+#include "thread_support.h"
+#include "ulong_extras.h"
+
+#define COUNT_SEGMENT_BITS (WORD(1) << 21)
+
+typedef struct
+{
+    const n_sieve_struct * S;
+    ulong a;
+    ulong b;
+    ulong low;
+    ulong * count;
+}
+_count_work_struct;
+
+static void
+_count_worker(slong j, void * arg)
+{
+    _count_work_struct * w = (_count_work_struct *) arg;
+    ulong low, skip;
+    slong nbits;
+    ulong * bits;
+
+    low = w->low + 2 * (ulong) j * COUNT_SEGMENT_BITS;
+    nbits = FLINT_MIN(COUNT_SEGMENT_BITS, (w->b - low) / 2 + 1);
+
+    bits = flint_malloc(COUNT_SEGMENT_BITS / FLINT_BITS * sizeof(ulong));
+    n_sieve_segment(bits, low, nbits, w->S);
+
+    /* odd numbers below a in the first segment */
+    skip = (low < w->a) ? (w->a - low + 1) / 2 : 0;
+
+    w->count[j] = n_sieve_count(bits, nbits) - n_sieve_count(bits, skip);
+
+    flint_free(bits);
+}
+
+static int
+_count_func(const ulong * primes, slong len, void * arg)
+{
+    *((ulong *) arg) += len;
+    return 0;
+}
+
+ulong
+n_primes_count_range(ulong a, ulong b)
+{
+    _count_work_struct w[1];
+    n_sieve_t S;
+    ulong num, res;
+    slong i, nseg;
+
+    if (a < 2)
+        a = 2;
+
+    if (b < a)
+        return 0;
+
+    if (b == 2)
+        return 1;
+
+    /*
+        short ranges close to b, and ranges which would need more sieving
+        primes than n_primes_range keeps, are handled by a partial sieve
+    */
+    if ((b - a) / 16 < n_sqrt(b) || n_sqrt(b) > N_PRIMES_RANGE_MAX_SIEVE_BOUND)
+    {
+        res = 0;
+        n_primes_range(a, b, _count_func, &res);
+        return res;
+    }
+
+    n_sieve_init(S, n_sqrt(b));
+
+    w->S = S;
+    w->a = a;
+    w->b = b;
+    w->low = a - ((a - 1) % (2 * FLINT_BITS));
+
+    num = (b - w->low) / 2 + 1;
+    nseg = (num - 1) / COUNT_SEGMENT_BITS + 1;
+    w->count = flint_malloc(nseg * sizeof(ulong));
+
+    flint_parallel_do(_count_worker, w, nseg, 0, FLINT_PARALLEL_DYNAMIC);
+
+    res = (a == 2);
+    for (i = 0; i < nseg; i++)
+        res += w->count[i];
+
+    flint_free(w->count);
+    n_sieve_clear(S);
+
+    return res;
+}
@@ -0,0 +1,159 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "flint.h"
+#include "thread_support.h"
+#include "ulong_extras.h"
+
+/* segments of 2^21 odd numbers, i.e. 256 KB of bits */
+#define RANGE_SEGMENT_BITS (WORD(1) << 21)
+
+typedef struct
+{
+    const n_sieve_struct * S;
+    ulong a;
+    ulong b;
+    ulong low;
+    slong first;
+    int complete;
+    ulong ** bits;
+    ulong ** primes;
+    slong * len;
+    slong * alloc;
+}
+_range_work_struct;
+
+static void
+_range_worker(slong j, void * arg)
+{
+    _range_work_struct * w = (_range_work_struct *) arg;
+    ulong low, p, x, c, sq;
+    slong i, nbits;
+
+    low = w->low + 2 * (ulong) (w->first + j) * RANGE_SEGMENT_BITS;
+    nbits = FLINT_MIN(RANGE_SEGMENT_BITS, (w->b - low) / 2 + 1);
+
+    n_sieve_segment(w->bits[j], low, nbits, w->S);
+
+    c = n_sieve_count(w->bits[j], nbits) + 1;
+    if (c > (ulong) w->alloc[j])
+    {
+        w->primes[j] = flint_realloc(w->primes[j], c * sizeof(ulong));
+        w->alloc[j] = c;
+    }
+
+    w->len[j] = 0;
+
+    if (low <= 2 && w->a <= 2)
+        w->primes[j][w->len[j]++] = 2;
+
+    sq = w->S->bound * w->S->bound;
+
+    for (i = 0; i < (nbits + FLINT_BITS - 1) / FLINT_BITS; i++)
+    {
+        for (x = w->bits[j][i]; x != 0; x &= x - 1)
+        {
+            p = low + 2 * (i * FLINT_BITS + flint_ctz(x));
+
+            if (p < w->a)
+                continue;
+
+            if (!w->complete && p > sq && !n_is_prime(p))
+                continue;
+
+            w->primes[j][w->len[j]++] = p;
+        }
+    }
+}
+
+void
+n_primes_range(ulong a, ulong b,
+        int (* func)(const ulong * primes, slong len, void * arg), void * arg)
+{
+    _range_work_struct w[1];
+    n_sieve_t S;
+    ulong bound, num;
+    slong i, nseg, nthreads, first, n;
+    int stop = 0;
+
+    if (a < 2)
+        a = 2;
+
+    if (b < a)
+        return;
+
+    if (b == 2)
+    {
+        ulong two = 2;
+        func(&two, 1, arg);
+        return;
+    }
+
+    /*
+        A short range close to b does not warrant generating all primes up
+        to sqrt(b); sieve partially and test the survivors instead.
+    */
+    bound = n_sqrt(b);
+    if ((b - a) / 16 < bound)
+        bound = FLINT_MIN(bound, FLINT_MAX(UWORD(65535), 16 * (b - a)));
+    bound = FLINT_MIN(bound, N_PRIMES_RANGE_MAX_SIEVE_BOUND);
+
+    n_sieve_init(S, bound);
+
+    w->S = S;
+    w->a = a;
+    w->b = b;
+    w->low = a - ((a - 1) % (2 * FLINT_BITS));
+    w->complete = (bound == n_sqrt(b));
+
+    num = (b - w->low) / 2 + 1;
+    nseg = (num - 1) / RANGE_SEGMENT_BITS + 1;
+
+    nthreads = FLINT_MAX(1, FLINT_MIN(flint_get_num_threads(), nseg));
+
+    w->bits = flint_malloc(nthreads * sizeof(ulong *));
+    w->primes = flint_malloc(nthreads * sizeof(ulong *));
+    w->len = flint_malloc(nthreads * sizeof(slong));
+    w->alloc = flint_malloc(nthreads * sizeof(slong));
+
+    for (i = 0; i < nthreads; i++)
+    {
+        w->bits[i] = flint_malloc(RANGE_SEGMENT_BITS / FLINT_BITS * sizeof(ulong));
+        w->primes[i] = NULL;
+        w->alloc[i] = 0;
+    }
+
+    /* each round sieves one segment per thread, then reports them in order */
+    for (first = 0; first < nseg && !stop; first += nthreads)
+    {
+        n = FLINT_MIN(nthreads, nseg - first);
+        w->first = first;
+
+        flint_parallel_do(_range_worker, w, n, 0, FLINT_PARALLEL_UNIFORM);
+
+        for (i = 0; i < n && !stop; i++)
+            if (w->len[i] != 0)
+                stop = func(w->primes[i], w->len[i], arg);
+    }
+
+    for (i = 0; i < nthreads; i++)
+    {
+        flint_free(w->bits[i]);
+        flint_free(w->primes[i]);
+    }
+
+    flint_free(w->bits);
+    flint_free(w->primes);
+    flint_free(w->len);
+    flint_free(w->alloc);
+
+    n_sieve_clear(S);
+}
@@ -0,0 +1,203 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include <string.h>
+#include "flint.h"
+#include "ulong_extras.h"
+
+/*
+    Bit k of a segment starting at the odd number low stands for low + 2k.
+    The primes 3, 5, 7, 11 and 13 are removed by copying a precomputed
+    pattern, which has period 15015 words since 3*5*7*11*13 = 15015 is odd;
+    the remaining sieving primes are crossed off one by one.
+*/
+
+#define SIEVE_WHEEL 15015
+#define SIEVE_NUM_WHEEL_PRIMES 5
+
+static const unsigned int sieve_wheel_primes[] = { 3, 5, 7, 11, 13 };
+
+static int
+sieve_popcount(ulong x)
+{
+#if defined(__GNUC__)
+# if FLINT_BITS == 64 && defined(_LONG_LONG_LIMB)
+    return __builtin_popcountll(x);
+# else
+    return __builtin_popcountl(x);
+# endif
+#else
+    int c = 0;
+
+    while (x != 0)
+    {
+        x &= x - 1;
+        c++;
+    }
+
+    return c;
+#endif
+}
+
+ulong
+n_sieve_count(const ulong * bits, slong nbits)
+{
+    slong i, n = nbits / FLINT_BITS;
+    ulong c = 0;
+
+    for (i = 0; i < n; i++)
+        c += sieve_popcount(bits[i]);
+
+    if (nbits % FLINT_BITS != 0)
+        c += sieve_popcount(bits[n] & ((UWORD(1) << (nbits % FLINT_BITS)) - 1));
+
+    return c;
+}
+
+void
+n_sieve_segment(ulong * bits, ulong low, slong nbits, const n_sieve_t S)
+{
+    slong i, nwords, start, len;
+    ulong high, p, k, r;
+
+    /* low must be aligned with the pattern */
+    if (low % (2 * FLINT_BITS) != 1)
+    {
+        flint_printf("Exception (n_sieve_segment). Unaligned segment.\n");
+        flint_abort();
+    }
+
+    nwords = (nbits + FLINT_BITS - 1) / FLINT_BITS;
+    high = low + 2 * (ulong) (nbits - 1);
+
+    /* wheel primes */
+    start = ((low - 1) / (2 * FLINT_BITS)) % SIEVE_WHEEL;
+    for (i = 0; i < nwords; i += len)
+    {
+        len = FLINT_MIN(nwords - i, SIEVE_WHEEL - start);
+        memcpy(bits + i, S->pattern + start, len * sizeof(ulong));
+        start = 0;
+    }
+
+    if (low == 1)
+    {
+        /* 1 is not prime, the wheel primes are */
+        bits[0] &= ~UWORD(1);
+        for (i = 0; i < SIEVE_NUM_WHEEL_PRIMES; i++)
+            bits[0] |= UWORD(1) << (sieve_wheel_primes[i] / 2);
+    }
+
+    /* remaining primes, starting from max(p^2, low) */
+    for (i = 0; i < S->num; i++)
+    {
+        p = S->primes[i];
+
+        if (p * p > high)
+            break;
+
+        if (p * p >= low)
+        {
+            k = (p * p - low) / 2;
+        }
+        else
+        {
+            r = low % p;
+            k = (r == 0) ? 0 : p - r;
+            if (k % 2 == 1)
+                k += p;
+            k /= 2;
+        }
+
+        for ( ; k < (ulong) nbits; k += p)
+            bits[k / FLINT_BITS] &= ~(UWORD(1) << (k % FLINT_BITS));
+    }
+
+    if (nbits % FLINT_BITS != 0)
+        bits[nwords - 1] &= (UWORD(1) << (nbits % FLINT_BITS)) - 1;
+}
+
+#define SIEVE_INIT_BITS (WORD(1) << 18)
+
+void
+n_sieve_init(n_sieve_t S, ulong bound)
+{
+    slong i, j, nbits;
+    ulong p, r, lo, hi, low, w;
+    char * small;
+    ulong * bits;
+
+    /* the wheel pattern */
+    S->pattern = flint_malloc(SIEVE_WHEEL * sizeof(ulong));
+
+    for (i = 0; i < SIEVE_WHEEL; i++)
+        S->pattern[i] = ~UWORD(0);
+
+    for (i = 0; i < SIEVE_NUM_WHEEL_PRIMES; i++)
+    {
+        p = sieve_wheel_primes[i];
+        for (j = p / 2; j < SIEVE_WHEEL * FLINT_BITS; j += p)
+            S->pattern[j / FLINT_BITS] &= ~(UWORD(1) << (j % FLINT_BITS));
+    }
+
+    S->bound = bound;
+    S->num = 0;
+    S->primes = NULL;
+
+    if (bound < 17)
+        return;
+
+    /* sieving primes up to sqrt(bound) */
+    r = n_sqrt(bound);
+    small = flint_malloc(r + 1);
+    memset(small, 1, r + 1);
+
+    for (p = 2; p * p <= r; p++)
+        if (small[p])
+            for (j = p * p; j <= r; j += p)
+                small[j] = 0;
+
+    n_prime_pi_bounds(&lo, &hi, bound);
+    S->primes = flint_malloc((hi + 1) * sizeof(unsigned int));
+
+    for (p = 17; p <= r; p++)
+        if (small[p])
+            S->primes[S->num++] = p;
+
+    flint_free(small);
+
+    /* primes from r to bound, sieving with those up to r */
+    bits = flint_malloc(SIEVE_INIT_BITS / FLINT_BITS * sizeof(ulong));
+
+    for (low = 1; low <= bound; low += 2 * SIEVE_INIT_BITS)
+    {
+        nbits = FLINT_MIN(SIEVE_INIT_BITS, (bound - low) / 2 + 1);
+        n_sieve_segment(bits, low, nbits, S);
+
+        for (i = 0; i < (nbits + FLINT_BITS - 1) / FLINT_BITS; i++)
+        {
+            for (w = bits[i]; w != 0; w &= w - 1)
+            {
+                p = low + 2 * (i * FLINT_BITS + flint_ctz(w));
+                if (p > r && p >= 17)
+                    S->primes[S->num++] = p;
+            }
+        }
+    }
+
+    flint_free(bits);
+}
+
+void
+n_sieve_clear(n_sieve_t S)
+{
+    flint_free(S->primes);
+    flint_free(S->pattern);
+}
@@ -0,0 +1,128 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "flint.h"
+#include "ulong_extras.h"
+
+int main(void)
+{
+    int iter, max_level;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("is_prime_vec....");
+    fflush(stdout);
+
+    max_level = flint_cpu_level();
+
+    for (iter = 0; iter < 1000 * flint_test_multiplier(); iter++)
+    {
+        ulong * vec, a, b;
+        int * res;
+        slong i, len;
+
+        /* exercise the vector lanes of every supported level */
+        flint_set_cpu_level(n_randint(state, max_level + 1));
+
+        len = n_randint(state, 600);
+        vec = flint_malloc(len * sizeof(ulong));
+        res = flint_malloc(len * sizeof(int));
+
+        a = n_randtest(state);
+
+        for (i = 0; i < len; i++)
+        {
+            switch (n_randint(state, 5))
+            {
+                case 0:
+                    vec[i] = n_randtest(state);
+                    break;
+                case 1:
+                    vec[i] = n_randtest_prime(state, 0);
+                    break;
+                case 2:
+                    /* products of two primes */
+                    a = n_randtest_prime(state, 0);
+                    b = n_randtest_prime(state, 0);
+                    if (FLINT_BIT_COUNT(a) + FLINT_BIT_COUNT(b) <= FLINT_BITS)
+                        vec[i] = a * b;
+                    else
+                        vec[i] = a;
+                    break;
+                case 3:
+                    /* squares, including those of 1093 and 3511 */
+                    a = n_randint(state, 2) ? n_randtest_prime(state, 0) :
+                                    (n_randint(state, 2) ? 1093 : 3511);
+                    vec[i] = (FLINT_BIT_COUNT(a) <= FLINT_BITS / 2) ? a * a : a;
+                    break;
+                default:
+                    /* runs of consecutive integers */
+                    vec[i] = a + i;
+                    break;
+            }
+        }
+
+        n_is_prime_vec(res, vec, len);
+
+        for (i = 0; i < len; i++)
+        {
+            if (res[i] != n_is_prime(vec[i]))
+            {
+                flint_printf("FAIL:\n");
+                flint_printf("vec[%wd] = %wu, res = %d\n", i, vec[i], res[i]);
+                fflush(stdout);
+                flint_abort();
+            }
+        }
+
+        flint_free(vec);
+        flint_free(res);
+    }
+
+    /* strong pseudoprimes to several bases */
+    {
+        ulong vec[] = {
+            UWORD(1194649), UWORD(12327121), UWORD(25326001),
+            UWORD(3215031751)
+#if FLINT64
+            , UWORD(2152302898747), UWORD(3474749660383), UWORD(341550071728321),
+            UWORD(3825123056546413051), UWORD(18446744073709551557),
+            UWORD(18446744073709551615)
+#endif
+        };
+        int res[10];
+        slong i, len = sizeof(vec) / sizeof(ulong);
+        int level;
+
+        for (level = 0; level <= max_level; level++)
+        {
+            flint_set_cpu_level(level);
+            n_is_prime_vec(res, vec, len);
+
+            for (i = 0; i < len; i++)
+            {
+                if (res[i] != n_is_prime(vec[i]))
+                {
+                    flint_printf("FAIL:\n");
+                    flint_printf("level = %d, vec[%wd] = %wu, res = %d\n",
+                                                    level, i, vec[i], res[i]);
+                    fflush(stdout);
+                    flint_abort();
+                }
+            }
+        }
+    }
+
+    flint_set_cpu_level(max_level);
+
+    FLINT_TEST_CLEANUP(state);
+    flint_printf("PASS\n");
+    return 0;
+}
@@ -43,6 +43,52 @@ int main(void)
         }
     }
 
+    /* large values, by Meissel-Lehmer */
+    {
+        slong i;
+        ulong x, res;
+        const ulong pi10[] = { UWORD(4), UWORD(25), UWORD(168), UWORD(1229),
+            UWORD(9592), UWORD(78498), UWORD(664579), UWORD(5761455),
+            UWORD(50847534), UWORD(455052511),
+#if FLINT_BITS == 64
+            UWORD(4118054813), UWORD(37607912018)
+#endif
+        };
+
+        for (i = 1, x = 10; i <= FLINT_MIN(12, FLINT_BITS / 3); i++, x *= 10)
+        {
+            flint_set_num_threads(n_randint(state, 4) + 1);
+
+            res = n_prime_pi(x);
+
+            if (res != pi10[i - 1])
+            {
+                flint_printf("FAIL:\n");
+                flint_printf("pi(10^%wd) = %wu\n", i, res);
+                fflush(stdout);
+                flint_abort();
+            }
+        }
+    }
+
+    for (n = 0; n < 10 * flint_test_multiplier(); n++)
+    {
+        ulong x = n_randint(state, UWORD(1) << FLINT_MIN(FLINT_BITS - 1, 30));
+
+        flint_set_num_threads(n_randint(state, 4) + 1);
+
+        if (n_prime_pi(x) != n_primes_count_range(0, x))
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("pi(%wu) = %wu, count = %wu\n", x, n_prime_pi(x),
+                                                    n_primes_count_range(0, x));
+            fflush(stdout);
+            flint_abort();
+        }
+    }
+
+    flint_set_num_threads(1);
+
     FLINT_TEST_CLEANUP(state);
     flint_printf("PASS\n");
     return 0;
@@ -0,0 +1,81 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "flint.h"
+#include "ulong_extras.h"
+
+int main(void)
+{
+    int iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("primes_count_range....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 100 * flint_test_multiplier(); iter++)
+    {
+        ulong a, b, c, d, p;
+
+        flint_set_num_threads(n_randint(state, 4) + 1);
+
+        a = n_randtest_bits(state, n_randint(state, FLINT_BITS) + 1);
+        b = a + n_randint(state, 100000);
+        if (b < a)
+            b = UWORD_MAX;
+
+        c = n_primes_count_range(a, b);
+
+        /* count by hand */
+        d = 0;
+        p = (a <= UWORD_MAX_PRIME) ? n_nextprime(a - (a != 0), 1) : UWORD_MAX;
+        while (p <= b && p <= UWORD_MAX_PRIME)
+        {
+            d++;
+            p = (p < UWORD_MAX_PRIME) ? n_nextprime(p, 1) : UWORD_MAX;
+        }
+
+        if (c != d)
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("a = %wu, b = %wu, c = %wu, d = %wu\n", a, b, c, d);
+            fflush(stdout);
+            flint_abort();
+        }
+    }
+
+    /* against pi */
+    for (iter = 0; iter < 10 * flint_test_multiplier(); iter++)
+    {
+        ulong a, b, c, d;
+
+        flint_set_num_threads(n_randint(state, 4) + 1);
+
+        a = n_randint(state, 10000000);
+        b = a + n_randint(state, 10000000);
+
+        c = n_primes_count_range(a, b);
+        d = n_prime_pi(b) - ((a == 0) ? 0 : n_prime_pi(a - 1));
+
+        if (c != d)
+        {
+            flint_printf("FAIL (pi):\n");
+            flint_printf("a = %wu, b = %wu, c = %wu, d = %wu\n", a, b, c, d);
+            fflush(stdout);
+            flint_abort();
+        }
+    }
+
+    flint_set_num_threads(1);
+
+    FLINT_TEST_CLEANUP(state);
+    flint_printf("PASS\n");
+    return 0;
+}
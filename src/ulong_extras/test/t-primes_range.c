@@ -0,0 +1,95 @@
+/*
+    Copyright (C) 2023 FLINT authors
+
+    This file is part of FLINT.
+
+    FLINT is free software: you can redistribute it and/or modify it under
+    the terms of the GNU Lesser General Public License (LGPL) as published
+    by the Free Software Foundation; either version 2.1 of the License, or
+    (at your option) any later version.  See <https://www.gnu.org/licenses/>.
+*/
+
+#include "flint.h"
+#include "ulong_extras.h"
+
+typedef struct
+{
+    ulong last;
+    ulong count;
+    ulong stop;
+    int ok;
+}
+check_struct;
+
+/* checks that the primes come in order, with nothing in between */
+static int
+check_func(const ulong * primes, slong len, void * arg)
+{
+    check_struct * c = (check_struct *) arg;
+    slong i;
+
+    for (i = 0; i < len; i++)
+    {
+        if (primes[i] <= c->last || n_nextprime(c->last, 1) != primes[i])
+            c->ok = 0;
+
+        c->last = primes[i];
+        c->count++;
+    }
+
+    return c->count >= c->stop;
+}
+
+int main(void)
+{
+    int iter;
+    FLINT_TEST_INIT(state);
+
+    flint_printf("primes_range....");
+    fflush(stdout);
+
+    for (iter = 0; iter < 30 * flint_test_multiplier(); iter++)
+    {
+        check_struct c[1];
+        ulong a, b, bits;
+
+        flint_set_num_threads(n_randint(state, 4) + 1);
+
+        bits = n_randint(state, FLINT_BITS) + 1;
+        a = n_randtest_bits(state, bits);
+
+        if (n_randint(state, 2))
+            b = a + n_randint(state, 100000);
+        else
+            b = a + n_randint(state, 3000000);
+
+        if (b < a)
+            b = UWORD_MAX;
+
+        c->last = (a < 2) ? 1 : a - 1;
+        c->count = 0;
+        c->stop = n_randint(state, 2) ? WORD_MAX : n_randint(state, 1000) + 1;
+        c->ok = 1;
+
+        n_primes_range(a, b, check_func, c);
+
+        /* nothing was left out at the end */
+        if (c->ok && c->count < c->stop && c->last < UWORD_MAX_PRIME &&
+                                                  n_nextprime(c->last, 1) <= b)
+            c->ok = 0;
+
+        if (!c->ok)
+        {
+            flint_printf("FAIL:\n");
+            flint_printf("a = %wu, b = %wu, last = %wu\n", a, b, c->last);
+            fflush(stdout);
+            flint_abort();
+        }
+    }
+
+    flint_set_num_threads(1);
+
+    FLINT_TEST_CLEANUP(state);
+    flint_printf("PASS\n");
+    return 0;
+}